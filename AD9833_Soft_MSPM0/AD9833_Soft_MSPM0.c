@@ -30,23 +30,98 @@
 
 #include "AD9833_Soft_MSPM0.h"
 #include <math.h>
+#include <string.h>
 
-// 频率换算因子: FREQ_REG_MAX / MCLK_Frequency
-// MCLK 为 25MHz
-const double freqScale = (double)FREQ_REG_MAX / 25000000.0;
+#if (AD9833_CHIP_NUM < 1U) || (AD9833_CHIP_NUM > 32U)
+#error "AD9833_CHIP_NUM must be between 1 and 32"
+#endif
 
-// 影子控制寄存器，用于保存每个通道的控制寄存器状态
-// 初始状态: B28=1 (28位频率写入), RESET=1 (芯片处于复位状态)
-static uint16_t s_control_reg_cs1 = AD9833_CMD_CTRLREG | AD9833_CTRL_B28 | AD9833_CTRL_RESET;
-static uint16_t s_control_reg_cs2 = AD9833_CMD_CTRLREG | AD9833_CTRL_B28 | AD9833_CTRL_RESET;
+// 芯片编号 = 选择掩码中最低位的1所在位置 (Cortex-M3/M4 上为 RBIT + CLZ 两条指令)
+#define AD9833_CHIP_INDEX(mask)     ((uint32_t)__builtin_ctz(mask))
 
 /**
- * @brief       通过软件模拟SPI发送一个16位数据
+ * @brief   芯片运行状态, 每片芯片一项, 按芯片编号索引
+ *      @arg mclk: 主时钟频率 (Hz), 默认取标称值 25MHz, 实测后可通过 AD9833_SetMclk() 修正
+ *      @arg freq_scale: 频率换算因子 FREQ_REG_MAX / mclk, 随 mclk 一同更新
+ *      @arg ctrl: 影子控制寄存器
+ *      @arg freq_word: 两个频率寄存器中最近写入的频率字
+ *      @arg phase: 两个相位寄存器的设定相位 (角度, 未补偿)
+ *      @arg skew: 输出的固定延迟 (秒), 正值表示滞后
+ *      @arg comp: 相位补偿表, 为NULL时不使用
+ *      @arg sync_phase: 同步启动时按启动先后预加的相位超前量 (角度)
+ */
+typedef struct
+{
+    double mclk;
+    double freq_scale;
+    uint16_t ctrl;
+    uint32_t freq_word[2];
+    double phase[2];
+    double skew;
+    const AD9833_CompTable* comp;
+    double sync_phase;
+} AD9833_ChipState;
+
+// 片选引脚表 (只读), 与芯片状态表一起构成芯片描述表
+static const AD9833_CsPinTypedef s_cs_pin[AD9833_CHIP_NUM] = AD9833_CS_TABLE;
+
+_Static_assert(sizeof((AD9833_CsPinTypedef[])AD9833_CS_TABLE) == sizeof(s_cs_pin),
+               "AD9833_CS_TABLE must have AD9833_CHIP_NUM entries");
+
+// 芯片状态表, 由 AD9833_Init 填入默认值 (标称MCLK, B28=1, RESET=1)
+static AD9833_ChipState s_chip[AD9833_CHIP_NUM];
+
+// 需要补偿相位 (设置了时差、补偿表或同步启动补偿) 的芯片, 按位对应芯片编号
+static chipChose s_comp_mask = 0;
+
+// 一次16位写入的周期 (秒), 用于同步启动时补偿各组的先后顺序, 为0时不补偿
+static double s_frame_time = 0.0;
+
+// 片选查找表按4片芯片一组
+#define AD9833_CS_GROUPS            ((AD9833_CHIP_NUM + 3U) / 4U)
+
+/**
+ * @brief   片选查找表, 由片选引脚表生成
+ *      @arg port: 片选引脚分布的端口
+ *      @arg port_num: 端口数
+ *      @arg ready: 查找表已生成
+ *      @arg lut: 每组4位选择掩码 (16种组合) 在各端口上对应的引脚
+ * @note    生成后只读, 片选操作不保存任何状态, 主循环和中断可同时使用
+ */
+typedef struct
+{
+    AD9833_CsPort port[AD9833_CS_PORT_MAX];
+    uint8_t port_num;
+    uint8_t ready;
+    uint32_t lut[AD9833_CS_GROUPS][16][AD9833_CS_PORT_MAX];
+} AD9833_CsLut;
+
+static AD9833_CsLut s_cs = {0};
+
+/**
+ * @brief   预置写入的状态, 最后一个SCLK下降沿留给外部触发
+ *      @arg choice: 预置写入选中的芯片, 为0时没有预置
+ *      @arg ctrl: 锁存后各片的控制字
+ *      @arg latched: 已产生第16个下降沿
+ */
+typedef struct
+{
+    volatile chipChose choice;
+    uint16_t ctrl;
+    volatile uint8_t latched;
+} AD9833_StageState;
+
+static AD9833_StageState s_stage = {0};
+
+/**
+ * @brief       通过软件模拟SPI发送一个16位数据的高位
+ * @note        发送16位即完成一次写入, 少于16位时芯片等待剩余的时钟沿
  * @param       TxData: 要发送的16位数据
+ * @param       bits: 从最高位起发送的位数
  */
-static void AD9833_Write_Software(uint16_t TxData)
+static void AD9833_Write_Software(uint16_t TxData, uint8_t bits)
 {
-    for (uint8_t i = 0; i < 16; i++)
+    for (uint8_t i = 0; i < bits; i++)
     {
         // 准备数据
         if (TxData & 0x8000)
@@ -66,64 +141,211 @@ static void AD9833_Write_Software(uint16_t TxData)
     }
 }
 
+/**
+ * @brief       生成片选查找表
+ * @note        由 AD9833_Init() 调用; 在此之前操作片选时自动调用。
+ *              表生成后不再修改
+ * @retval      无
+ */
+static void AD9833_CsLutInit(void)
+{
+    memset(&s_cs, 0, sizeof(s_cs));
+    for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+    {
+        uint32_t p = 0;
+
+        // 查找或登记该芯片片选所在的端口
+        while (p < s_cs.port_num && s_cs.port[p] != s_cs_pin[i].port) p++;
+        if (p == s_cs.port_num)
+        {
+            if (p >= AD9833_CS_PORT_MAX) continue;  // 端口数超出上限, 该芯片无法选中
+            s_cs.port[s_cs.port_num++] = s_cs_pin[i].port;
+        }
+
+        // 该芯片在所在组 (4片一组) 的16种组合中, 凡包含它的组合都加上它的引脚
+        for (uint32_t combo = 0; combo < 16U; combo++)
+        {
+            if (combo & (1U << (i & 3U)))
+            {
+                s_cs.lut[i >> 2][combo][p] |= s_cs_pin[i].pin;
+            }
+        }
+    }
+
+    s_cs.ready = 1;
+}
+
+/**
+ * @brief       改变一组芯片的片选电平
+ * @note        各端口的引脚由查找表按组合并得到, 每个端口只写一次寄存器, 同一
+ *              端口上的所有片选同时跳变; 多个端口时依次写入, 间隔为一次总线访问。
+ *              只读查找表, 结果放在栈上, 可重入。
+ * @param       choice: 片选参数
+ * @param       level: 1: 拉高; 0: 拉低
+ * @retval      无
+ */
+static void AD9833_CsWrite(chipChose choice, uint8_t level)
+{
+    uint32_t pins[AD9833_CS_PORT_MAX] = {0};
+
+    choice &= CS_ALL;
+
+    if (!s_cs.ready) AD9833_CsLutInit();
+
+    for (uint32_t n = 0; n < AD9833_CS_GROUPS; n++)
+    {
+        uint32_t combo = (choice >> (4U * n)) & 0x0FU;
+        if (!combo) continue;
+
+        for (uint32_t p = 0; p < s_cs.port_num; p++)
+        {
+            pins[p] |= s_cs.lut[n][combo][p];
+        }
+    }
+
+    for (uint32_t p = 0; p < s_cs.port_num; p++)
+    {
+        if (!pins[p]) continue;
+
+        if (level) AD9833_CS_PORT_H(s_cs.port[p], pins[p]);
+        else AD9833_CS_PORT_L(s_cs.port[p], pins[p]);
+    }
+}
+
+/**
+ * @brief       拉低一组芯片的片选
+ * @param       choice: 片选参数, 可为任意芯片组合
+ * @retval      无
+ */
+void AD9833_ChipSelect(chipChose choice)
+{
+    AD9833_CsWrite(choice, 0);
+}
+
+/**
+ * @brief       拉高一组芯片的片选
+ * @param       choice: 片选参数, 可为任意芯片组合
+ * @retval      无
+ */
+void AD9833_ChipRelease(chipChose choice)
+{
+    AD9833_CsWrite(choice, 1);
+}
+
 /**
  * @brief       向 AD9833 写入一个 16bit 的数据
- * @note        底层软件SPI发送函数
+ * @note        底层软件SPI发送函数, 选中多片芯片时为广播写入;
+ *              有预置写入 (AD9833_StageCtrl) 未结束时不发送, 返回0。
+ *              所有芯片共用 SCLK/SDATA, 一个字从拉低片选到拉高片选期间关闭中断,
+ *              中断中的写入只能发生在两个字之间。频率等多字写入不是原子的,
+ *              主循环和中断不能同时写同一片芯片。
  * @param       choice: 片选参数
  *                  @arg CS1: 片选1
  *                  @arg CS2: 片选2
  *                  @arg CS_BOTH: 广播模式
+ *                  @arg 其他: AD9833_CS(n) 的任意组合
  * @param       TxData: 要发送的16位数据
- * @retval      无
+ * @retval      1: 已发送; 0: 预置写入未结束或choice无效, 未发送
  */
-void AD9833_Write(chipChose choice, const uint16_t TxData)
+uint8_t AD9833_Write(chipChose choice, const uint16_t TxData)
 {
-    if (choice == CS1)
+    choice &= CS_ALL;
+    if (!choice) return 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (s_stage.choice)             // 有预置写入时总线被占用
     {
-        AD9833_CS1_L();
-        AD9833_Write_Software(TxData);
-        AD9833_CS1_H();
+        __set_PRIMASK(primask);
+        return 0;
     }
-    else if (choice == CS2)
+
+    AD9833_ChipSelect(choice);
+    AD9833_Write_Software(TxData, 16);
+    AD9833_ChipRelease(choice);
+    __set_PRIMASK(primask);
+    return 1;
+}
+
+/**
+ * @brief     	获取芯片状态
+ * @param     	choice: 片选参数, 选中多片时取编号最小的一片
+ * @retval    	指向芯片状态的指针，如果choice无效则返回NULL
+ */
+static AD9833_ChipState* AD9833_GetChip(chipChose choice)
+{
+    choice &= CS_ALL;
+    return choice ? &s_chip[AD9833_CHIP_INDEX(choice)] : NULL;
+}
+
+/**
+ * @brief     	按芯片的补偿设置更新需要补偿的芯片集合
+ * @param     	idx: 芯片编号
+ * @retval    	无
+ */
+static void AD9833_CompMaskUpdate(uint32_t idx)
+{
+    if (s_chip[idx].skew != 0.0 || s_chip[idx].comp != NULL || s_chip[idx].sync_phase != 0.0)
     {
-        AD9833_CS2_L();
-        AD9833_Write_Software(TxData);
-        AD9833_CS2_H();
+        s_comp_mask |= AD9833_CS(idx);
     }
-    else if (choice == CS_BOTH)
+    else
     {
-        AD9833_CS1_L();
-        AD9833_CS2_L();
-        AD9833_Write_Software(TxData);
-        AD9833_CS1_H();
-        AD9833_CS2_H();
+        s_comp_mask &= ~AD9833_CS(idx);
     }
 }
 
 /**
- * @brief     	获取指定通道的影子控制寄存器的指针
+ * @brief     	修改一组芯片的影子控制寄存器并写入
+ * @note      	修改后各片的控制字相同时只做一次 (广播) 写入, 否则逐片写入;
+ *              预置写入未结束时不修改影子寄存器
  * @param     	choice: 片选参数
- *                  @arg CS1: 片选1
- *                  @arg CS2: 片选2
- * @retval    	指向影子控制寄存器的指针，如果choice无效则返回NULL
+ * @param       clear: 要清除的控制位
+ * @param       set: 要置位的控制位
+ * @retval    	1: 已写入; 0: 预置写入未结束或choice无效
  */
-static uint16_t* AD9833_GetShadowCtrlReg(chipChose choice)
+static uint8_t AD9833_CtrlUpdate(chipChose choice, uint16_t clear, uint16_t set)
 {
-    if (choice == CS1)
+    uint16_t ctrl = 0;
+    uint8_t same = 1;
+
+    choice &= CS_ALL;
+    if (!choice || s_stage.choice) return 0;
+
+    for (chipChose m = choice; m; m &= m - 1U)
     {
-        return &s_control_reg_cs1;
+        AD9833_ChipState* chip = &s_chip[AD9833_CHIP_INDEX(m)];
+        chip->ctrl = (uint16_t)((chip->ctrl & ~clear) | set);
+
+        if (m == choice)
+        {
+            ctrl = chip->ctrl;
+        }
+        else if (chip->ctrl != ctrl)
+        {
+            same = 0;
+        }
+    }
+
+    if (same)
+    {
+        return AD9833_Write(choice, ctrl);
     }
-    else if (choice == CS2)
+
+    uint8_t ok = 1;
+    for (chipChose m = choice; m; m &= m - 1U)
     {
-        return &s_control_reg_cs2;
+        uint32_t idx = AD9833_CHIP_INDEX(m);
+        if (!AD9833_Write(AD9833_CS(idx), s_chip[idx].ctrl)) ok = 0;
     }
-    return NULL; // 无效选择
+    return ok;
 }
 
 /**
  * @brief     	初始化 AD9833 片选线，并将芯片置于初始复位状态
  * @note      	仅初始化控制寄存器到复位和B28模式。
  *              实际的频率、相位、波形设置由其他函数完成。
+ *              status 只决定 CS1/CS2 的DAC状态, 其余芯片保持复位。
  * @param     	status: 工作状态选择 (决定哪个通道的DAC关闭)
  *                  @arg CS1_SINGLE: 仅CS1工作，CS2的DAC关闭
  *                  @arg CS2_SINGLE: 仅CS2工作，CS1的DAC关闭
@@ -132,104 +354,248 @@ static uint16_t* AD9833_GetShadowCtrlReg(chipChose choice)
  */
 void AD9833_Init(workStatus status)
 {
-    AD9833_CS1_H();     // 初始化时片选拉高
-    AD9833_CS2_H();
-    AD9833_SCLK_H();    // 确保时钟线初始为高
+    s_stage.choice = 0;         // 放弃未完成的预置写入
+    s_stage.latched = 0;
+    AD9833_CsLutInit();         // 在启用中断之前生成片选查找表
+    AD9833_ChipRelease(CS_ALL); // 初始化时片选拉高
+    AD9833_SCLK_H();            // 确保时钟线初始为高
+
+    // 初始化影子控制寄存器 (B28=1, RESET=1), 未校准的芯片使用标称MCLK
+    for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+    {
+        if (s_chip[i].mclk == 0.0)
+        {
+            s_chip[i].mclk = AD9833_MCLK_NOMINAL;
+            s_chip[i].freq_scale = (double)FREQ_REG_MAX / AD9833_MCLK_NOMINAL;
+        }
+        s_chip[i].ctrl = AD9833_CMD_CTRLREG | AD9833_CTRL_B28 | AD9833_CTRL_RESET;
+        s_chip[i].sync_phase = 0.0;
+        AD9833_CompMaskUpdate(i);
+    }
 
-    // 初始化影子控制寄存器 (B28=1, RESET=1)
-    s_control_reg_cs1 = AD9833_CMD_CTRLREG | AD9833_CTRL_B28 | AD9833_CTRL_RESET;
-    s_control_reg_cs2 = AD9833_CMD_CTRLREG | AD9833_CTRL_B28 | AD9833_CTRL_RESET;
+    AD9833_ChipState* cs1 = AD9833_GetChip(CS1);
+    AD9833_ChipState* cs2 = AD9833_GetChip(CS2);
 
     switch(status)
     {
         case CS1_SINGLE:
             // CS1 正常复位, CS2 DAC关闭
-            s_control_reg_cs2 |= AD9833_CTRL_SLEEP12; // 关闭CS2的DAC
+            if (cs2) cs2->ctrl |= AD9833_CTRL_SLEEP12; // 关闭CS2的DAC
             break;
         case CS2_SINGLE:
             // CS2 正常复位, CS1 DAC关闭
-            s_control_reg_cs1 |= AD9833_CTRL_SLEEP12; // 关闭CS1的DAC
+            if (cs1) cs1->ctrl |= AD9833_CTRL_SLEEP12; // 关闭CS1的DAC
             break;
         case CS1_CS2_DOUBLE:
             // 两者都正常复位，DAC都工作 (SLEEP12默认为0)
             break;
         default:
             // 处理无效状态
-            s_control_reg_cs1 |= AD9833_CTRL_SLEEP1 | AD9833_CTRL_SLEEP12;
-            s_control_reg_cs2 |= AD9833_CTRL_SLEEP1 | AD9833_CTRL_SLEEP12;
+            if (cs1) cs1->ctrl |= AD9833_CTRL_SLEEP1 | AD9833_CTRL_SLEEP12;
+            if (cs2) cs2->ctrl |= AD9833_CTRL_SLEEP1 | AD9833_CTRL_SLEEP12;
             break;
     }
 
-    // 将初始控制状态写入芯片
-    AD9833_Write(CS1, s_control_reg_cs1);
-    AD9833_Write(CS2, s_control_reg_cs2);
+    // 将初始控制状态逐片写入芯片
+    for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+    {
+        AD9833_Write(AD9833_CS(i), s_chip[i].ctrl);
+    }
+}
+
+/**
+ * @brief     	波形对应的控制位
+ * @param       wave: 波形选择, 无效值按正弦波处理
+ * @retval    	MODE/OPBITEN/DIV2 的组合
+ */
+static uint16_t AD9833_WaveBits(waveType wave)
+{
+    switch(wave)
+    {
+        case TRIANGLE_WAVE:
+            return AD9833_CTRL_MODE;                        // MODE = 1
+        case SQUARE_WAVE:
+            return AD9833_CTRL_OPBITEN | AD9833_CTRL_DIV2;  // OPBITEN = 1, DIV2 = 1 (输出MSB)
+                                                            // MODE位在OPBITEN=1时应为0
+        case SINE_WAVE:
+        default:
+            return 0U;                                      // OPBITEN = 0, MODE = 0
+    }
 }
 
 /**
  * @brief     	设置输出波形类型并使芯片退出复位开始输出
- * @note      	此函数会修改影子控制寄存器并写入。
+ * @note      	此函数会修改影子控制寄存器并写入, 选中多片时同时启动。
  * @param     	choice: 片选参数
  *                  @arg CS1: 片选1
  *                  @arg CS2: 片选2
+ *                  @arg 其他: AD9833_CS(n) 的任意组合
  * @param       wave: 波形选择
  *                  @arg SINE_WAVE: 正弦波
  *                  @arg TRIANGLE_WAVE: 三角波
  *                  @arg SQUARE_WAVE: 方波
- * @retval    	无
+ * @retval    	1: 已写入; 0: 预置写入未结束或choice无效, 未写入
  */
-void AD9833_SetWaveformAndStart(chipChose choice, waveType wave)
+uint8_t AD9833_SetWaveformAndStart(chipChose choice, waveType wave)
 {
-    uint16_t* pCtrlReg = AD9833_GetShadowCtrlReg(choice);
-    if (!pCtrlReg) return;
+    // 清除当前波形相关的控制位 (MODE, OPBITEN, DIV2), 并确保芯片退出复位状态 (RESET = 0)
+    return AD9833_CtrlUpdate(choice, AD9833_CTRL_MODE | AD9833_CTRL_OPBITEN | AD9833_CTRL_DIV2 | AD9833_CTRL_RESET,
+                      AD9833_WaveBits(wave));
+}
 
-    // 清除当前波形相关的控制位 (MODE, OPBITEN, DIV2)
-    *pCtrlReg &= ~(AD9833_CTRL_MODE | AD9833_CTRL_OPBITEN | AD9833_CTRL_DIV2);
 
-    // 根据选择设置新的波形位
-    switch(wave)
+/**
+ * @brief     	预置一次控制字写入, 只发出前15位
+ * @note      	各片修改后的控制字必须相同 (广播写入)。预置后片选保持低电平, SCLK为高,
+ *              SDATA已给出最后一位, 由 AD9833_StageLatch() 产生第16个下降沿完成写入,
+ *              用于多块板卡由同一触发信号同时启动或切换寄存器。
+ *              预置期间总线被占用, 其他写入函数不发出数据并返回0。
+ * @param     	choice: 片选参数, AD9833_CS(n) 的任意组合
+ * @param       clear: 要清除的控制位
+ * @param       set: 要置位的控制位
+ * @retval    	1: 成功; 0: 已有预置写入、choice无效或各片控制字不同
+ */
+uint8_t AD9833_StageCtrl(chipChose choice, uint16_t clear, uint16_t set)
+{
+    choice &= CS_ALL;
+    if (!choice || s_stage.choice) return 0;
+
+    uint16_t ctrl = (uint16_t)((s_chip[AD9833_CHIP_INDEX(choice)].ctrl & ~clear) | set);
+    for (chipChose m = choice; m; m &= m - 1U)
     {
-        case SINE_WAVE:
-            // OPBITEN = 0 (默认), MODE = 0 (默认)
-            break;
-        case TRIANGLE_WAVE:
-            *pCtrlReg |= AD9833_CTRL_MODE;      // MODE = 1
-            break;
-        case SQUARE_WAVE:
-            *pCtrlReg |= AD9833_CTRL_OPBITEN;   // OPBITEN = 1
-            *pCtrlReg |= AD9833_CTRL_DIV2;      // DIV2 = 1 (输出MSB, 如果需要MSB/2, 则不设置此位或清除此位)
-                                                // MODE位在OPBITEN=1时应为0
-            break;
-        default:
-            // 默认为正弦波或不改变
-            break;
+        if ((uint16_t)((s_chip[AD9833_CHIP_INDEX(m)].ctrl & ~clear) | set) != ctrl) return 0;
     }
 
-    // 确保芯片退出复位状态以开始输出
-    *pCtrlReg &= ~AD9833_CTRL_RESET; // RESET = 0
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (s_stage.choice)         // 中断中已有预置写入
+    {
+        __set_PRIMASK(primask);
+        return 0;
+    }
+
+    AD9833_ChipSelect(choice);
+    AD9833_Write_Software(ctrl, 15);
+
+    // 给出最后一位, SCLK保持高电平
+    if (ctrl & 0x0001)
+    {
+        AD9833_MOSI_H();
+    } else
+    {
+        AD9833_MOSI_L();
+    }
 
-    // 写入更新后的控制寄存器
-    AD9833_Write(choice, *pCtrlReg);
+    s_stage.ctrl = ctrl;
+    s_stage.latched = 0;
+    s_stage.choice = choice;    // 最后写入, 触发中断以此判断预置已完成
+    __set_PRIMASK(primask);
+    return 1;
 }
 
+/**
+ * @brief     	预置启动命令: 设置波形并退出复位
+ * @note      	与 AD9833_SetWaveformAndStart() 写入的控制字相同, 芯片在
+ *              AD9833_StageLatch() 时开始输出
+ * @param     	choice: 片选参数, 各片当前的控制字须相同
+ * @param       wave: 波形选择
+ * @retval    	同 AD9833_StageCtrl()
+ */
+uint8_t AD9833_StageStart(chipChose choice, waveType wave)
+{
+    return AD9833_StageCtrl(choice, AD9833_CTRL_MODE | AD9833_CTRL_OPBITEN | AD9833_CTRL_DIV2 | AD9833_CTRL_RESET,
+                            AD9833_WaveBits(wave));
+}
+
+/**
+ * @brief     	预置寄存器切换命令: 同时修改 FSELECT 和 PSELECT
+ * @note      	两组寄存器预先写好频率和相位, 即可由触发信号同时跳频
+ * @param     	choice: 片选参数, 各片当前的控制字须相同
+ * @param       freq_reg_num: 切换后使用的频率寄存器 (0 或 1)
+ * @param       phase_reg_num: 切换后使用的相位寄存器 (0 或 1)
+ * @retval    	同 AD9833_StageCtrl()
+ */
+uint8_t AD9833_StageSelect(chipChose choice, uint8_t freq_reg_num, uint8_t phase_reg_num)
+{
+    uint16_t set = 0;
+
+    if (freq_reg_num) set |= AD9833_CTRL_FSELECT;
+    if (phase_reg_num) set |= AD9833_CTRL_PSELECT;
+
+    return AD9833_StageCtrl(choice, AD9833_CTRL_FSELECT | AD9833_CTRL_PSELECT, set);
+}
+
+/**
+ * @brief     	产生预置写入的第16个SCLK下降沿, 芯片在此刻锁存控制字
+ * @note      	供触发中断调用, 检查后立即产生时钟沿; 之后须调用 AD9833_StageRelease()
+ * @retval    	1: 已锁存; 0: 没有预置写入
+ */
+uint8_t AD9833_StageLatch(void)
+{
+    if (!s_stage.choice || s_stage.latched) return 0;
+
+    AD9833_SCLK_L();
+    s_stage.latched = 1;
+    return 1;
+}
+
+/**
+ * @brief     	结束预置写入并释放总线
+ * @note      	已锁存时更新影子控制寄存器; 未锁存时放弃该字 (片选在第16个下降沿
+ *              之前拉高, 芯片不会写入)。检查是否已锁存到释放总线之间关闭中断,
+ *              触发中断 (AD9833_StageLatch) 不会在两者之间锁存
+ * @retval    	1: 写入已完成; 0: 没有预置写入或已放弃
+ */
+uint8_t AD9833_StageRelease(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    chipChose choice = s_stage.choice;
+    uint8_t latched = s_stage.latched;
+
+    if (!choice)
+    {
+        __set_PRIMASK(primask);
+        return 0;
+    }
+
+    AD9833_SCLK_H();
+    AD9833_ChipRelease(choice);
+
+    if (latched)
+    {
+        for (chipChose m = choice; m; m &= m - 1U)
+        {
+            s_chip[AD9833_CHIP_INDEX(m)].ctrl = s_stage.ctrl;
+        }
+    }
+
+    s_stage.latched = 0;
+    s_stage.choice = 0;
+    __set_PRIMASK(primask);
+    return latched;
+}
 
 /**
  * @brief     	向 AD9833 的指定相位寄存器写入一个12位的值
- * @note      	可直接在芯片工作过程中写入，实现相位可控
- * @param     	choice: 片选参数
- *                  @arg CS1: 片选1
- *                  @arg CS2: 片选2
+ * @note      	不做补偿, 相位可为任意值, 自动折算到 0 ~ 360度
+ * @param     	choice: 片选参数, 选中多片时为广播写入
  * @param       phase_reg_num: 相位寄存器编号
  *                  @arg 0: 相位寄存器0
  *                  @arg 1: 相位寄存器1
  * @param       phase: 要写入的相位值 (角度，0到360度)
  * @retval    	无
  */
-void AD9833_PhaseSet(chipChose choice, uint8_t phase_reg_num, double phase)
+static void AD9833_PhaseWrite(chipChose choice, uint8_t phase_reg_num, double phase)
 {
     uint16_t phase_cmd;
 
     // 相位换算 (0 to 360 -> 0 to 4095)
-    uint16_t phase_data_raw = (uint16_t) (fmod(phase, 360.0) / 360.0 * 4096.0); // 使用fmod确保在0-360内
+    phase = fmod(phase, 360.0); // 使用fmod确保在0-360内
+    if (phase < 0.0)
+        phase += 360.0;
+    uint16_t phase_data_raw = (uint16_t) (phase / 360.0 * 4096.0);
     phase_data_raw &= 0x0FFF; // 取低12位
 
     if (phase_reg_num == 0)
@@ -249,34 +615,172 @@ void AD9833_PhaseSet(chipChose choice, uint8_t phase_reg_num, double phase)
     AD9833_Write(choice, phase_cmd | phase_data_raw);
 }
 
+/**
+ * @brief     	按补偿表插值求出频率字对应的补偿相位
+ * @note      	纯整数运算, 每次改频只需一次查表和一次乘法
+ * @param     	table: 补偿表
+ * @param       freq_word: 28位频率字
+ * @retval    	补偿相位 (1/65536 周)
+ */
+static int32_t AD9833_CompLookup(const AD9833_CompTable* table, uint32_t freq_word)
+{
+    uint32_t idx = freq_word >> table->shift;
+
+    if (idx >= (uint32_t)table->count - 1U)
+    {
+        return table->offset[table->count - 1U]; // 超出表格范围取最后一点
+    }
+
+    int32_t p0 = table->offset[idx];
+    int32_t diff = (int16_t)(table->offset[idx + 1U] - p0);         // 按周取模求差值
+    uint32_t frac = freq_word & ((1UL << table->shift) - 1U);       // 区间内的位置
+
+    return p0 + (int32_t)(((int64_t)diff * frac) >> table->shift);
+}
+
+/**
+ * @brief     	按补偿重写单片芯片的相位寄存器
+ * @note      	补偿量为 360 * f * skew 加上补偿表在当前频率字处的插值,
+ *              f 为同编号频率寄存器中的频率; 再加上同步启动的相位超前量
+ * @param     	idx: 芯片编号
+ * @param       reg_num: 寄存器编号 (0 或 1)
+ * @retval    	无
+ */
+static void AD9833_PhaseUpdate(uint32_t idx, uint8_t reg_num)
+{
+    const AD9833_ChipState* chip = &s_chip[idx];
+    double phase = chip->phase[reg_num] + chip->sync_phase;
+
+    if (chip->skew != 0.0)
+    {
+        double freq = (double)chip->freq_word[reg_num] * chip->mclk / (double)FREQ_REG_MAX;
+        phase += 360.0 * freq * chip->skew;
+    }
+    if (chip->comp)
+    {
+        phase += (double)AD9833_CompLookup(chip->comp, chip->freq_word[reg_num]) * (360.0 / 65536.0);
+    }
+
+    AD9833_PhaseWrite(AD9833_CS(idx), reg_num, phase);
+}
+
+/**
+ * @brief     	向 AD9833 的指定相位寄存器写入相位
+ * @note      	可直接在芯片工作过程中写入，实现相位可控。
+ *              设置了时差补偿 (AD9833_SetSkew) 或补偿表 (AD9833_SetCompTable)
+ *              的芯片会按同编号频率寄存器中的频率自动加上补偿量, 因此相位寄存
+ *              器与频率寄存器应按编号配对使用。
+ * @param     	choice: 片选参数
+ *                  @arg CS1: 片选1
+ *                  @arg CS2: 片选2
+ *                  @arg CS_BOTH: 广播模式
+ *                  @arg 其他: AD9833_CS(n) 的任意组合
+ * @param       phase_reg_num: 相位寄存器编号
+ *                  @arg 0: 相位寄存器0
+ *                  @arg 1: 相位寄存器1
+ * @param       phase: 要写入的相位值 (角度，0到360度)
+ * @retval    	1: 已写入; 0: 预置写入未结束或参数无效, 未写入
+ */
+uint8_t AD9833_PhaseSet(chipChose choice, uint8_t phase_reg_num, double phase)
+{
+    choice &= CS_ALL;
+    if (phase_reg_num > 1 || !choice) return 0; // 无效的相位寄存器号
+    if (s_stage.choice) return 0;
+    for (chipChose m = choice; m; m &= m - 1U)
+    {
+        s_chip[AD9833_CHIP_INDEX(m)].phase[phase_reg_num] = phase;
+    }
+
+    // 无补偿的芯片按原方式一次写入 (多片时为广播), 有补偿的芯片逐片写入
+    chipChose plain = choice & ~s_comp_mask;
+    if (plain) AD9833_PhaseWrite(plain, phase_reg_num, phase);
+
+    for (chipChose m = choice & s_comp_mask; m; m &= m - 1U)
+    {
+        AD9833_PhaseUpdate(AD9833_CHIP_INDEX(m), phase_reg_num);
+    }
+    return 1;
+}
+
+/**
+ * @brief     	将频率换算为28位频率字
+ * @note      	按芯片当前主时钟 (AD9833_SetMclk() 设定的值) 换算, 超出 0 ~ MCLK/2 时取边界值
+ * @param     	choice: 片选参数, 选中多片时按编号最小的一片换算, 无效时按0号芯片
+ * @param       freq: 频率值 (Hz)
+ * @retval    	28位频率字
+ */
+uint32_t AD9833_FreqToWord(chipChose choice, double freq)
+{
+    const AD9833_ChipState* chip = AD9833_GetChip(choice);
+    if (!chip) chip = &s_chip[0];
+
+    if (freq < 0)
+        freq = 0;                   // 频率不能为负
+    if (freq > chip->mclk / 2.0)
+        freq = chip->mclk / 2.0;    // 最大频率限制 (奈奎斯特频率)
+
+    uint32_t freq_data_raw = (uint32_t) (freq * chip->freq_scale);
+    return freq_data_raw & 0x0FFFFFFF; // 取28位
+}
+
 /**
  * @brief     	向 AD9833 的指定频率寄存器写入一个28位的值
  * @note      	可直接在芯片工作过程中写入，实现频率可控。
  *              需要两次16位的写操作。确保控制寄存器中的B28位已设为1。
+ *              主时钟相同的芯片频率字相同, 一起 (广播) 写入; 主时钟不同的芯片逐片换算写入。
  * @param     	choice: 片选参数
  *                  @arg CS1: 片选1
  *                  @arg CS2: 片选2
+ *                  @arg CS_BOTH: 广播模式
+ *                  @arg 其他: AD9833_CS(n) 的任意组合
  * @param       freq_reg_num: 频率寄存器编号 (0 或 1)
  *                  @arg 0: 频率寄存器 0
  *                  @arg 1: 频率寄存器 1
  * @param       freq: 要写入的频率值 (Hz)
- * @retval    	无
+ * @retval    	1: 已写入; 0: 预置写入未结束或参数无效, 未写入
  */
-void AD9833_FreqSet(chipChose choice, uint8_t freq_reg_num, double freq)
+uint8_t AD9833_FreqSet(chipChose choice, uint8_t freq_reg_num, double freq)
 {
-    uint16_t freq_cmd;
+    choice &= CS_ALL;
+    if (!choice || freq_reg_num > 1 || s_stage.choice) return 0;
+
+    // 与编号最小的芯片主时钟相同的芯片共用一个频率字
+    const AD9833_ChipState* first = &s_chip[AD9833_CHIP_INDEX(choice)];
+    chipChose same = 0;
+    for (chipChose m = choice; m; m &= m - 1U)
+    {
+        uint32_t idx = AD9833_CHIP_INDEX(m);
+        if (s_chip[idx].mclk == first->mclk) same |= AD9833_CS(idx);
+    }
+
+    AD9833_FreqSetRaw(same, freq_reg_num, AD9833_FreqToWord(same, freq));
+
+    for (chipChose m = choice & ~same; m; m &= m - 1U)
+    {
+        chipChose one = AD9833_CS(AD9833_CHIP_INDEX(m));
+        AD9833_FreqSetRaw(one, freq_reg_num, AD9833_FreqToWord(one, freq));
+    }
+    return 1;
+}
 
-    // 频率换算
-    if (freq < 0) 
-		freq = 0;           // 频率不能为负
-    if (freq > 12500000.0) 
-		freq = 12500000.0;  // 最大频率限制
+/**
+ * @brief     	直接向 AD9833 的指定频率寄存器写入28位频率字
+ * @note      	不经过频率换算, 适用于需要精确控制频率字的场合 (如时钟校准)
+ * @param     	choice: 片选参数, 选中多片时为广播写入
+ * @param       freq_reg_num: 频率寄存器编号 (0 或 1)
+ * @param       freq_word: 28位频率字, 输出频率为 freq_word * MCLK / 2^28
+ * @retval    	1: 已写入; 0: 预置写入未结束或参数无效, 未写入
+ */
+uint8_t AD9833_FreqSetRaw(chipChose choice, uint8_t freq_reg_num, uint32_t freq_word)
+{
+    uint16_t freq_cmd;
 
-    uint32_t freq_data_raw = (uint32_t) (freq * freqScale);
-    freq_data_raw &= 0x0FFFFFFF; // 取28位
+    choice &= CS_ALL;
+    if (!choice || s_stage.choice) return 0;   // 不修改记录的频率字
+    freq_word &= 0x0FFFFFFF; // 取28位
 
-    uint16_t freq_LSB = (uint16_t) (freq_data_raw & 0x3FFF);            // 低14位
-    uint16_t freq_MSB = (uint16_t) ((freq_data_raw >> 14) & 0x3FFF);    // 高14位
+    uint16_t freq_LSB = (uint16_t) (freq_word & 0x3FFF);            // 低14位
+    uint16_t freq_MSB = (uint16_t) ((freq_word >> 14) & 0x3FFF);    // 高14位
 
     if (freq_reg_num == 0)
     {
@@ -288,7 +792,7 @@ void AD9833_FreqSet(chipChose choice, uint8_t freq_reg_num, double freq)
     }
     else
     {
-        return; // 无效的频率寄存器号
+        return 0; // 无效的频率寄存器号
     }
 
     // 确保B28=1已在控制寄存器中设置 (通常在初始化时完成)
@@ -297,6 +801,17 @@ void AD9833_FreqSet(chipChose choice, uint8_t freq_reg_num, double freq)
 
     AD9833_Write(choice, freq_cmd | freq_LSB); // 先写入低14位 (包含指令)
     AD9833_Write(choice, freq_cmd | freq_MSB); // 再写入高14位 (包含指令)
+
+    // 记录频率字, 有补偿的芯片紧接着按新频率重写同编号的相位寄存器
+    for (chipChose m = choice; m; m &= m - 1U)
+    {
+        s_chip[AD9833_CHIP_INDEX(m)].freq_word[freq_reg_num] = freq_word;
+    }
+    for (chipChose m = choice & s_comp_mask; m; m &= m - 1U)
+    {
+        AD9833_PhaseUpdate(AD9833_CHIP_INDEX(m), freq_reg_num);
+    }
+    return 1;
 }
 
 /**
@@ -304,25 +819,16 @@ void AD9833_FreqSet(chipChose choice, uint8_t freq_reg_num, double freq)
  * @param     	choice: 片选参数
  *                  @arg CS1: 片选1
  *                  @arg CS2: 片选2
+ *                  @arg 其他: AD9833_CS(n) 的任意组合
  * @param       freq_reg_num: 要选择的频率寄存器编号 (0 或 1)
  *                  @arg 0: 频率寄存器 0
  *                  @arg 1: 频率寄存器 1
- * @retval    	无
+ * @retval    	同 AD9833_SetWaveformAndStart()
  */
-void AD9833_SelectFreqReg(chipChose choice, uint8_t freq_reg_num)
+uint8_t AD9833_SelectFreqReg(chipChose choice, uint8_t freq_reg_num)
 {
-    uint16_t* pCtrlReg = AD9833_GetShadowCtrlReg(choice);
-    if (!pCtrlReg) return;
-
-    if (freq_reg_num == 0)
-    {
-        *pCtrlReg &= ~AD9833_CTRL_FSELECT; // FSELECT = 0
-    }
-    else
-    {
-        *pCtrlReg |= AD9833_CTRL_FSELECT;  // FSELECT = 1
-    }
-    AD9833_Write(choice, *pCtrlReg);
+    // FSELECT = 0 或 1
+    return AD9833_CtrlUpdate(choice, AD9833_CTRL_FSELECT, freq_reg_num ? AD9833_CTRL_FSELECT : 0U);
 }
 
 /**
@@ -330,25 +836,16 @@ void AD9833_SelectFreqReg(chipChose choice, uint8_t freq_reg_num)
  * @param     	choice: 片选参数
  *                  @arg CS1: 片选1
  *                  @arg CS2: 片选2
+ *                  @arg 其他: AD9833_CS(n) 的任意组合
  * @param       phase_reg_num: 要选择的相位寄存器编号 (0 或 1)
  *                  @arg 0: 相位寄存器 0
  *                  @arg 1: 相位寄存器 1
- * @retval    	无
+ * @retval    	同 AD9833_SetWaveformAndStart()
  */
-void AD9833_SelectPhaseReg(chipChose choice, uint8_t phase_reg_num)
+uint8_t AD9833_SelectPhaseReg(chipChose choice, uint8_t phase_reg_num)
 {
-    uint16_t* pCtrlReg = AD9833_GetShadowCtrlReg(choice);
-    if (!pCtrlReg) return;
-
-    if (phase_reg_num == 0)
-    {
-        *pCtrlReg &= ~AD9833_CTRL_PSELECT; // PSELECT = 0
-    }
-    else
-    {
-        *pCtrlReg |= AD9833_CTRL_PSELECT;  // PSELECT = 1
-    }
-    AD9833_Write(choice, *pCtrlReg);
+    // PSELECT = 0 或 1
+    return AD9833_CtrlUpdate(choice, AD9833_CTRL_PSELECT, phase_reg_num ? AD9833_CTRL_PSELECT : 0U);
 }
 
 /**
@@ -356,25 +853,15 @@ void AD9833_SelectPhaseReg(chipChose choice, uint8_t phase_reg_num)
  * @param     	choice: 片选参数
  *                  @arg CS1: 片选1
  *                  @arg CS2: 片选2
+ *                  @arg 其他: AD9833_CS(n) 的任意组合
  * @param       reset_active:
  *                  @arg 1: 使能复位
  *                  @arg 0: 取消复位
- * @retval    	无
+ * @retval    	同 AD9833_SetWaveformAndStart()
  */
-void AD9833_Reset(chipChose choice, uint8_t reset_active)
+uint8_t AD9833_Reset(chipChose choice, uint8_t reset_active)
 {
-    uint16_t* pCtrlReg = AD9833_GetShadowCtrlReg(choice);
-    if (!pCtrlReg) return;
-
-    if (reset_active)
-    {
-        *pCtrlReg |= AD9833_CTRL_RESET;
-    }
-    else
-    {
-        *pCtrlReg &= ~AD9833_CTRL_RESET;
-    }
-    AD9833_Write(choice, *pCtrlReg);
+    return AD9833_CtrlUpdate(choice, AD9833_CTRL_RESET, reset_active ? AD9833_CTRL_RESET : 0U);
 }
 
 /**
@@ -382,37 +869,36 @@ void AD9833_Reset(chipChose choice, uint8_t reset_active)
  * @param     	choice: 片选参数
  *                  @arg CS1: 片选1
  *                  @arg CS2: 片选2
+ *                  @arg 其他: AD9833_CS(n) 的任意组合
  * @param       sleep1_active:
  *                  @arg 1: 使能SLEEP1 (MCLK关闭)
  *                  @arg 0: 取消
  * @param       sleep12_active:
  *                  @arg 1: 使能SLEEP12 (DAC关闭)
  *                  @arg 0: 取消
- * @retval    	无
+ * @retval    	同 AD9833_SetWaveformAndStart()
  */
-void AD9833_Sleep(chipChose choice, uint8_t sleep1_active, uint8_t sleep12_active)
+uint8_t AD9833_Sleep(chipChose choice, uint8_t sleep1_active, uint8_t sleep12_active)
 {
-    uint16_t* pCtrlReg = AD9833_GetShadowCtrlReg(choice);
-    if (!pCtrlReg) return;
+    uint16_t set = 0;
 
-    if (sleep1_active)
-    {
-        *pCtrlReg |= AD9833_CTRL_SLEEP1;
-    }
-    else
-    {
-        *pCtrlReg &= ~AD9833_CTRL_SLEEP1;
-    }
+    if (sleep1_active) set |= AD9833_CTRL_SLEEP1;
+    if (sleep12_active) set |= AD9833_CTRL_SLEEP12;
 
-    if (sleep12_active)
-    {
-        *pCtrlReg |= AD9833_CTRL_SLEEP12;
-    }
-    else
-    {
-        *pCtrlReg &= ~AD9833_CTRL_SLEEP12;
-    }
-    AD9833_Write(choice, *pCtrlReg);
+    return AD9833_CtrlUpdate(choice, AD9833_CTRL_SLEEP1 | AD9833_CTRL_SLEEP12, set);
+}
+
+/**
+ * @brief     	按影子控制寄存器重写一组芯片的控制字
+ * @note      	直接用 AD9833_Write() 写过控制字 (如停在 B28=0 的半字模式) 之后调用,
+ *              使芯片的控制字与影子寄存器一致, 之后按影子寄存器修改控制位的函数
+ *              才能得到预期的结果。频率、相位寄存器不变。
+ * @param     	choice: 片选参数, 可为任意芯片组合
+ * @retval    	同 AD9833_SetWaveformAndStart()
+ */
+uint8_t AD9833_CtrlRestore(chipChose choice)
+{
+    return AD9833_CtrlUpdate(choice, 0, 0);
 }
 
 /**
@@ -450,50 +936,248 @@ void AD9833_Cmd(AD9833_InitTypedef *AD_InitStruct)
 }
 
 /**
- * @brief     AD9833初始化并以相位相干模式开始输出（双通道）
- * @note      使用广播模式实现两个通道的同步复位和同步启动，此模式下要求两个通道波形相同，且必须都使用0号寄存器
- * @param     AD_InitStruct: 输出初始化结构体, 必须包含两个通道的参数
+ * @brief     多片芯片同步复位并以相位相干模式开始输出
+ * @note      各片保留各自的波形和频率/相位寄存器选择。选中的芯片先同时复位, 在复位
+ *            状态下逐片写入频率和相位, 再按最终控制字分组退出复位: 控制字相同的芯
+ *            片以一次广播写入在同一个 SCLK 边沿启动, 各组紧接着依次写入 (期间关闭
+ *            中断)。控制字只由波形 (3种) 和寄存器选择 (4种) 决定, 最多
+ *            AD9833_SYNC_GROUP_MAX 组, 启动过程最长为同样数量的写入周期。
+ *            第g组比第0组晚启动 g 个写入周期, 设置了写入周期 (AD9833_SetFrameTime)
+ *            时, 这些芯片的相位寄存器预先加上 360 * f * g * T 的超前量, f 为所选
+ *            频率寄存器中的频率; 该补偿随后续改频/改相保留, 直到下次同步启动或初始化。
+ * @param     cfg: 各片芯片的输出参数, 按芯片编号索引, 须包含 choice 中编号最大的芯片
+ * @param     choice: 要启动的芯片, AD9833_CS(n) 的任意组合, 未选中的芯片不受影响
  * @retval    无
  */
-void AD9833_Cmd_Sync(AD9833_InitTypedef *AD_InitStruct)
+void AD9833_Cmd_SyncN(const DDS_InitTypedef cfg[], chipChose choice)
 {
+    uint16_t group_ctrl[AD9833_SYNC_GROUP_MAX];
+    chipChose group_mask[AD9833_SYNC_GROUP_MAX] = {0};
+    uint32_t group_num = 0;
+
+    choice &= CS_ALL;
+    if (!cfg || !choice) return;
+
     /* 同步复位 */
-    // 通过广播模式，同时将两个芯片置于B28和RESET状态
+    // 选中的芯片同时置于B28和RESET状态, 并清除上次同步启动的补偿
     uint16_t reset_cmd = AD9833_CMD_CTRLREG | AD9833_CTRL_B28 | AD9833_CTRL_RESET;
-    AD9833_Write(CS_BOTH, reset_cmd);
-
-    /* 配置参数 (芯片仍处于复位状态) */
-    // 单独配置每个通道的频率和相位
-
-    // 通道 1
-    AD9833_SelectFreqReg(CS1, AD_InitStruct->AD_CS1.freqReg);
-    AD9833_FreqSet(CS1, AD_InitStruct->AD_CS1.freqReg, AD_InitStruct->AD_CS1.freq);
-    AD9833_SelectPhaseReg(CS1, AD_InitStruct->AD_CS1.phaseReg);
-    AD9833_PhaseSet(CS1, AD_InitStruct->AD_CS1.phaseReg, AD_InitStruct->AD_CS1.phase);
-    // 通道 2
-    AD9833_SelectFreqReg(CS2, AD_InitStruct->AD_CS2.freqReg);
-    AD9833_FreqSet(CS2, AD_InitStruct->AD_CS2.freqReg, AD_InitStruct->AD_CS2.freq);
-    AD9833_SelectPhaseReg(CS2, AD_InitStruct->AD_CS2.phaseReg);
-    AD9833_PhaseSet(CS2, AD_InitStruct->AD_CS2.phaseReg, AD_InitStruct->AD_CS2.phase);
+    AD9833_Write(choice, reset_cmd);
+
+    for (chipChose m = choice; m; m &= m - 1U)
+    {
+        uint32_t idx = AD9833_CHIP_INDEX(m);
+        s_chip[idx].ctrl = reset_cmd;
+        s_chip[idx].sync_phase = 0.0;
+        AD9833_CompMaskUpdate(idx);
+    }
+
+    /* 配置参数并按最终控制字分组 (芯片仍处于复位状态) */
+    for (chipChose m = choice; m; m &= m - 1U)
+    {
+        uint32_t idx = AD9833_CHIP_INDEX(m);
+        const DDS_InitTypedef* dds = &cfg[idx];
+        uint8_t freq_reg = dds->freqReg ? 1U : 0U;
+        uint8_t phase_reg = dds->phaseReg ? 1U : 0U;
+
+        AD9833_FreqSet(AD9833_CS(idx), freq_reg, dds->freq);
+        AD9833_PhaseSet(AD9833_CS(idx), phase_reg, dds->phase);
+
+        uint16_t ctrl = AD9833_CMD_CTRLREG | AD9833_CTRL_B28 | AD9833_WaveBits(dds->wave);
+        if (freq_reg) ctrl |= AD9833_CTRL_FSELECT;
+        if (phase_reg) ctrl |= AD9833_CTRL_PSELECT;
+
+        uint32_t g = 0;
+        while (g < group_num && group_ctrl[g] != ctrl) g++;
+        if (g == group_num)
+        {
+            group_ctrl[group_num++] = ctrl;
+        }
+        group_mask[g] |= AD9833_CS(idx);
+    }
+
+    /* 后启动的组预加相位超前量 */
+    for (uint32_t g = 1; g < group_num && s_frame_time > 0.0; g++)
+    {
+        uint8_t freq_reg = (group_ctrl[g] & AD9833_CTRL_FSELECT) ? 1U : 0U;
+
+        for (chipChose m = group_mask[g]; m; m &= m - 1U)
+        {
+            uint32_t idx = AD9833_CHIP_INDEX(m);
+            AD9833_ChipState* chip = &s_chip[idx];
+            double freq = (double)chip->freq_word[freq_reg] * chip->mclk / (double)FREQ_REG_MAX;
+
+            chip->sync_phase = fmod(360.0 * freq * s_frame_time * (double)g, 360.0);
+            AD9833_CompMaskUpdate(idx);
+            AD9833_PhaseUpdate(idx, 0);
+            AD9833_PhaseUpdate(idx, 1);
+        }
+    }
 
     /* 同步启动 */
-    // 准备一个不带RESET位的启动命令
-    // 注意：此模式下，假定两个通道使用相同的波形，以CS1的波形为准。
-    uint16_t start_cmd = AD9833_CMD_CTRLREG | AD9833_CTRL_B28;
-    switch(AD_InitStruct->AD_CS1.wave)
+    // 各组背靠背写入, 关闭中断使相邻两组的启动间隔固定为一个写入周期
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint32_t g = 0; g < group_num; g++)
     {
-        case TRIANGLE_WAVE:
-            start_cmd |= AD9833_CTRL_MODE;
-            break;
-        case SQUARE_WAVE:
-            start_cmd |= (AD9833_CTRL_OPBITEN | AD9833_CTRL_DIV2);
-            break;
-        case SINE_WAVE:
-        default:
-            // 正弦波，无需额外设置
-            break;
+        AD9833_Write(group_mask[g], group_ctrl[g]);
+    }
+    __set_PRIMASK(primask);
+
+    for (uint32_t g = 0; g < group_num; g++)
+    {
+        for (chipChose m = group_mask[g]; m; m &= m - 1U)
+        {
+            s_chip[AD9833_CHIP_INDEX(m)].ctrl = group_ctrl[g];
+        }
+    }
+}
+
+/**
+ * @brief     AD9833初始化并以相位相干模式开始输出（双通道）
+ * @note      由 AD9833_Cmd_SyncN() 实现, 两个通道各自保留波形和寄存器选择;
+ *            波形和寄存器选择都相同时两路在同一个 SCLK 边沿启动
+ * @param     AD_InitStruct: 输出初始化结构体, 必须包含两个通道的参数
+ * @retval    无
+ */
+void AD9833_Cmd_Sync(AD9833_InitTypedef *AD_InitStruct)
+{
+    DDS_InitTypedef cfg[AD9833_CHIP_NUM] = {0};
+
+    if (!AD_InitStruct) return;
+    cfg[0] = AD_InitStruct->AD_CS1;
+#if AD9833_CHIP_NUM > 1U
+    cfg[1] = AD_InitStruct->AD_CS2;
+#endif
+
+    AD9833_Cmd_SyncN(cfg, CS_BOTH);
+}
+
+/**
+ * @brief     设置芯片主时钟的实际频率
+ * @note      之后该芯片的频率换算都以该值为准, 可填入时钟校准 (AD9833_ClkCal) 的实测结果
+ * @param     choice: 片选参数, 可为任意芯片组合 (共用同一时钟源时可用 CS_ALL)
+ * @param     mclk: 主时钟频率 (Hz), 小于等于0时恢复为标称值
+ * @retval    无
+ */
+void AD9833_SetMclk(chipChose choice, double mclk)
+{
+    if (mclk <= 0.0)
+    {
+        mclk = AD9833_MCLK_NOMINAL;
+    }
+
+    for (chipChose m = choice & CS_ALL; m; m &= m - 1U)
+    {
+        AD9833_ChipState* chip = &s_chip[AD9833_CHIP_INDEX(m)];
+        chip->mclk = mclk;
+        chip->freq_scale = (double)FREQ_REG_MAX / mclk;
+    }
+}
+
+/**
+ * @brief     获取芯片当前使用的主时钟频率
+ * @param     choice: 片选参数, 选中多片时取编号最小的一片
+ * @retval    主时钟频率 (Hz), choice无效时返回标称值
+ */
+double AD9833_GetMclk(chipChose choice)
+{
+    const AD9833_ChipState* chip = AD9833_GetChip(choice);
+    return chip ? chip->mclk : AD9833_MCLK_NOMINAL;
+}
+
+/**
+ * @brief     设置芯片输出的固定延迟, 以相位寄存器补偿
+ * @note      两个相位寄存器立即按当前频率重写, 之后每次改频/改相自动更新补偿量。
+ *            通常只需设置各芯片相对参考芯片的延迟 (如 CS1 为0, CS2 为实测值)。
+ * @param     choice: 片选参数
+ *                  @arg CS1: 片选1
+ *                  @arg CS2: 片选2
+ *                  @arg 其他: AD9833_CS(n) 的任意组合, 各片设为相同值
+ * @param     skew: 输出延迟 (秒), 正值表示该芯片滞后, 为0时关闭补偿
+ * @retval    无
+ */
+void AD9833_SetSkew(chipChose choice, double skew)
+{
+    for (chipChose m = choice & CS_ALL; m; m &= m - 1U)
+    {
+        uint32_t idx = AD9833_CHIP_INDEX(m);
+
+        s_chip[idx].skew = skew;
+        AD9833_CompMaskUpdate(idx);
+        AD9833_PhaseUpdate(idx, 0);
+        AD9833_PhaseUpdate(idx, 1);
+    }
+}
+
+/**
+ * @brief     获取芯片输出的延迟补偿值
+ * @param     choice: 片选参数, 选中多片时取编号最小的一片
+ * @retval    输出延迟 (秒), choice无效时返回0
+ */
+double AD9833_GetSkew(chipChose choice)
+{
+    const AD9833_ChipState* chip = AD9833_GetChip(choice);
+    return chip ? chip->skew : 0.0;
+}
+
+/**
+ * @brief     设置芯片的频率相关相位补偿表
+ * @note      两个相位寄存器立即按当前频率重写, 之后每次改频/改相自动按表插值补偿。
+ *            驱动只保存表格指针, 表格须在使用期间保持有效 (可直接指向FLASH)。
+ *            可与时差补偿 (AD9833_SetSkew) 同时使用, 两者叠加。
+ * @param     choice: 片选参数
+ *                  @arg CS1: 片选1
+ *                  @arg CS2: 片选2
+ *                  @arg 其他: AD9833_CS(n) 的任意组合, 各片使用同一张表
+ * @param     table: 补偿表, 为NULL或格式无效时关闭补偿
+ * @retval    无
+ */
+void AD9833_SetCompTable(chipChose choice, const AD9833_CompTable* table)
+{
+    if (table && (table->offset == NULL || table->count == 0 || table->shift > 27))
+    {
+        table = NULL;
+    }
+
+    for (chipChose m = choice & CS_ALL; m; m &= m - 1U)
+    {
+        uint32_t idx = AD9833_CHIP_INDEX(m);
+
+        s_chip[idx].comp = table;
+        AD9833_CompMaskUpdate(idx);
+        AD9833_PhaseUpdate(idx, 0);
+        AD9833_PhaseUpdate(idx, 1);
     }
+}
+
+/**
+ * @brief     获取芯片当前使用的相位补偿表
+ * @param     choice: 片选参数, 选中多片时取编号最小的一片
+ * @retval    补偿表指针, 未设置或choice无效时返回NULL
+ */
+const AD9833_CompTable* AD9833_GetCompTable(chipChose choice)
+{
+    const AD9833_ChipState* chip = AD9833_GetChip(choice);
+    return chip ? chip->comp : NULL;
+}
+
+/**
+ * @brief     设置一次16位写入的周期 (相邻两次写入锁存时刻的间隔)
+ * @note      用于 AD9833_Cmd_SyncN() 补偿各组先后启动的时间差, 取决于传输方式、
+ *            CPU主频和编译优化, 可用 DWT 计数背靠背写入测得; 为0时不补偿
+ * @param     frame_time: 写入周期 (秒)
+ * @retval    无
+ */
+void AD9833_SetFrameTime(double frame_time)
+{
+    s_frame_time = (frame_time > 0.0) ? frame_time : 0.0;
+}
 
-    // 通过广播模式，同时清除RESET位，让两个通道一起开始输出
-    AD9833_Write(CS_BOTH, start_cmd);
+/**
+ * @brief     获取 AD9833_SetFrameTime() 设定的写入周期
+ * @retval    写入周期 (秒), 未设置时为0
+ */
+double AD9833_GetFrameTime(void)
+{
+    return s_frame_time;
 }
@@ -43,17 +43,33 @@
 #define AD9833_MOSI_H()     DL_GPIO_setPins(AD9833_MOSI_PORT, AD9833_MOSI_PIN_MASK)
 #define AD9833_MOSI_L()     DL_GPIO_clearPins(AD9833_MOSI_PORT, AD9833_MOSI_PIN_MASK)
 
-#define AD9833_CS1_H()      DL_GPIO_setPins(AD9833_CS1_PORT, AD9833_CS1_PIN_MASK)
-#define AD9833_CS1_L()      DL_GPIO_clearPins(AD9833_CS1_PORT, AD9833_CS1_PIN_MASK)
-
-#define AD9833_CS2_H()      DL_GPIO_setPins(AD9833_CS2_PORT, AD9833_CS2_PIN_MASK)
-#define AD9833_CS2_L()      DL_GPIO_clearPins(AD9833_CS2_PORT, AD9833_CS2_PIN_MASK)
+/* 拉低、拉高同一端口上的一组片选, 一次写入同时改变所有引脚 */
+#define AD9833_CS_PORT_L(port, pins)    DL_GPIO_clearPins((port), (pins))
+#define AD9833_CS_PORT_H(port, pins)    DL_GPIO_setPins((port), (pins))
 
 /* -------------------------------------------------------------------------- */
 /*                          与原库保持一致的宏定义                           */
 /* -------------------------------------------------------------------------- */
 
 #define FREQ_REG_MAX 268435456ULL  // AD9833 为28位频率寄存器, 使用ULL确保类型正确
+#define AD9833_MCLK_NOMINAL  25000000.0  // 标称主时钟频率 (Hz)
+
+// 芯片数量 (1 到 32), 所有芯片共用时钟线和数据线, 每片占用一路片选
+#ifndef AD9833_CHIP_NUM
+#define AD9833_CHIP_NUM     2U
+#endif
+
+// 片选引脚表 {端口, 引脚}, 按芯片编号排列 (CS1 为0号, CS2 为1号), 项数须等于 AD9833_CHIP_NUM
+// 芯片多于两片时, 在本文件顶部的用户配置区中同时重新定义 AD9833_CHIP_NUM 与本表
+#ifndef AD9833_CS_TABLE
+#define AD9833_CS_TABLE     { {AD9833_CS1_PORT, AD9833_CS1_PIN_MASK}, \
+                              {AD9833_CS2_PORT, AD9833_CS2_PIN_MASK} }
+#endif
+
+// 片选引脚分布的端口数上限, 决定片选查找表的大小
+#ifndef AD9833_CS_PORT_MAX
+#define AD9833_CS_PORT_MAX  ((AD9833_CHIP_NUM < 4U) ? AD9833_CHIP_NUM : 4U)
+#endif
 
 #ifndef PI      // 防止重定义
 #define PI           3.14159265358979323846
@@ -96,16 +112,38 @@ typedef enum{
 } workStatus;
 
 /**
- * @brief   片选选择 (用于函数参数，区分操作哪个芯片)
- *      @arg CS1: 片选1
- *      @arg CS2: 片选2
- *      @arg CS_BOTH: 同时选择，用于广播模式
+ * @brief   片选选择 (用于函数参数，区分操作哪些芯片)
+ * @note    按位表示, 第n位对应n号芯片, 可任意组合, 选中多片时为广播写入
+ *      @arg CS1: 片选1 (0号芯片)
+ *      @arg CS2: 片选2 (1号芯片)
+ *      @arg CS_BOTH: 同时选择CS1和CS2，用于广播模式
+ *      @arg AD9833_CS(n): n号芯片
+ *      @arg CS_ALL: 全部芯片
  */
-typedef enum{
-    CS1 = 1,
-    CS2 = 2,
-    CS_BOTH = 3
-} chipChose;
+typedef uint32_t chipChose;
+
+#define AD9833_CS(n)    ((chipChose)1U << (n))  // n号芯片 (0 到 AD9833_CHIP_NUM-1)
+#define CS1             AD9833_CS(0)
+#define CS2             AD9833_CS(1)
+#define CS_BOTH         (CS1 | CS2)
+#define CS_ALL          ((chipChose)(0xFFFFFFFFUL >> (32U - AD9833_CHIP_NUM)))
+
+// 同步启动时的最大分组数: 3种波形 x 2个频率寄存器 x 2个相位寄存器
+#define AD9833_SYNC_GROUP_MAX   12U
+
+// 片选端口类型
+typedef GPIO_Regs* AD9833_CsPort;
+
+/**
+ * @brief   单片芯片的片选引脚
+ *      @arg port: 端口
+ *      @arg pin: 引脚
+ */
+typedef struct
+{
+    AD9833_CsPort port;
+    uint32_t pin;
+} AD9833_CsPinTypedef;
 
 /**
  * @brief   波形选择
@@ -151,17 +189,51 @@ typedef struct
     DDS_InitTypedef AD_CS2;
 } AD9833_InitTypedef;
 
+/**
+  * @brief 频率相关的相位补偿表
+  * @note  表格按频率字等间隔取点, 第 i 点对应频率字 i << shift, 两点之间线性插值,
+  *        超出最后一点时取最后一点的值。相邻两点的补偿量之差须小于半周。
+  *     @arg offset: 补偿相位数组 (单位 1/65536 周, 即 360/65536 度), 正值使输出超前
+  *     @arg count: 点数 (至少为1)
+  *     @arg shift: 点间距, 为 2^shift 个频率字 (0 到 27)
+  */
+typedef struct
+{
+    const int16_t* offset;
+    uint16_t count;
+    uint8_t shift;
+} AD9833_CompTable;
+
 /* ------------------------------- API 声明 -------------------------------- */
+void AD9833_ChipSelect(chipChose choice);
+void AD9833_ChipRelease(chipChose choice);
 void AD9833_Init(workStatus status);
-void AD9833_Write(chipChose choice, uint16_t TxData);
-void AD9833_PhaseSet(chipChose choice, uint8_t phase_reg_num, double phase);
-void AD9833_FreqSet(chipChose choice, uint8_t freq_reg_num, double freq);
-void AD9833_SetWaveformAndStart(chipChose choice, waveType wave);
+uint8_t AD9833_Write(chipChose choice, uint16_t TxData);
+uint8_t AD9833_PhaseSet(chipChose choice, uint8_t phase_reg_num, double phase);
+uint8_t AD9833_FreqSet(chipChose choice, uint8_t freq_reg_num, double freq);
+uint8_t AD9833_FreqSetRaw(chipChose choice, uint8_t freq_reg_num, uint32_t freq_word);
+uint8_t AD9833_SetWaveformAndStart(chipChose choice, waveType wave);
+uint8_t AD9833_StageCtrl(chipChose choice, uint16_t clear, uint16_t set);
+uint8_t AD9833_StageStart(chipChose choice, waveType wave);
+uint8_t AD9833_StageSelect(chipChose choice, uint8_t freq_reg_num, uint8_t phase_reg_num);
+uint8_t AD9833_StageLatch(void);
+uint8_t AD9833_StageRelease(void);
 void AD9833_Cmd(AD9833_InitTypedef *AD_InitStruct);
-void AD9833_SelectFreqReg(chipChose choice, uint8_t freq_reg_num);
-void AD9833_SelectPhaseReg(chipChose choice, uint8_t phase_reg_num);
-void AD9833_Reset(chipChose choice, uint8_t reset_active);
-void AD9833_Sleep(chipChose choice, uint8_t sleep1_active, uint8_t sleep12_active);
+uint8_t AD9833_SelectFreqReg(chipChose choice, uint8_t freq_reg_num);
+uint8_t AD9833_SelectPhaseReg(chipChose choice, uint8_t phase_reg_num);
+uint8_t AD9833_Reset(chipChose choice, uint8_t reset_active);
+uint8_t AD9833_Sleep(chipChose choice, uint8_t sleep1_active, uint8_t sleep12_active);
+uint8_t AD9833_CtrlRestore(chipChose choice);
 void AD9833_Cmd_Sync(AD9833_InitTypedef *AD_InitStruct);
+void AD9833_Cmd_SyncN(const DDS_InitTypedef cfg[], chipChose choice);
+uint32_t AD9833_FreqToWord(chipChose choice, double freq);
+void AD9833_SetMclk(chipChose choice, double mclk);
+double AD9833_GetMclk(chipChose choice);
+void AD9833_SetSkew(chipChose choice, double skew);
+double AD9833_GetSkew(chipChose choice);
+void AD9833_SetCompTable(chipChose choice, const AD9833_CompTable* table);
+const AD9833_CompTable* AD9833_GetCompTable(chipChose choice);
+void AD9833_SetFrameTime(double frame_time);
+double AD9833_GetFrameTime(void);
 
 #endif /* _AD9833_SOFT_MSPM0_H_ */
\ No newline at end of file
@@ -67,6 +67,11 @@ void Error_Handler(void);
 #define AD9833_MOSI_GPIO_Port GPIOA
 #define AD9833_CS2_Pin GPIO_PIN_4
 #define AD9833_CS2_GPIO_Port GPIOC
+#define AD9833_TRIG_OUT_Pin GPIO_PIN_0
+#define AD9833_TRIG_OUT_GPIO_Port GPIOB
+#define AD9833_TRIG_Pin GPIO_PIN_1
+#define AD9833_TRIG_GPIO_Port GPIOB
+#define AD9833_TRIG_EXTI_IRQn EXTI1_IRQn
 #define LCDCS_Pin GPIO_PIN_8
 #define LCDCS_GPIO_Port GPIOE
 #define LCDRST_Pin GPIO_PIN_9
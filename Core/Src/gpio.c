@@ -63,6 +63,9 @@ void MX_GPIO_Init(void)
   /*Configure GPIO pin Output Level */
   HAL_GPIO_WritePin(AD9833_CS2_GPIO_Port, AD9833_CS2_Pin, GPIO_PIN_SET);
 
+  /*Configure GPIO pin Output Level */
+  HAL_GPIO_WritePin(AD9833_TRIG_OUT_GPIO_Port, AD9833_TRIG_OUT_Pin, GPIO_PIN_SET);
+
   /*Configure GPIO pin Output Level */
   HAL_GPIO_WritePin(GPIOE, LCDCS_Pin|LCDDC_Pin|LCDLED_Pin, GPIO_PIN_SET);
 
@@ -86,6 +89,19 @@ void MX_GPIO_Init(void)
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
   HAL_GPIO_Init(AD9833_CS2_GPIO_Port, &GPIO_InitStruct);
 
+  /*Configure GPIO pin : AD9833_TRIG_OUT_Pin */
+  GPIO_InitStruct.Pin = AD9833_TRIG_OUT_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+  HAL_GPIO_Init(AD9833_TRIG_OUT_GPIO_Port, &GPIO_InitStruct);
+
+  /*Configure GPIO pin : AD9833_TRIG_Pin */
+  GPIO_InitStruct.Pin = AD9833_TRIG_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  HAL_GPIO_Init(AD9833_TRIG_GPIO_Port, &GPIO_InitStruct);
+
   /*Configure GPIO pins : LCDCS_Pin LCDRST_Pin LCDDC_Pin LCDLED_Pin */
   GPIO_InitStruct.Pin = LCDCS_Pin|LCDRST_Pin|LCDDC_Pin|LCDLED_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
@@ -108,6 +124,10 @@ void MX_GPIO_Init(void)
   GPIO_InitStruct.Alternate = GPIO_AF7_USART2;
   HAL_GPIO_Init(GPIOD, &GPIO_InitStruct);
 
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI1_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(EXTI1_IRQn);
+
 }
 
 /* USER CODE BEGIN 2 */
@@ -18,7 +18,10 @@
 /* USER CODE END Header */
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
+#include "adc.h"
+#include "dma.h"
 #include "spi.h"
+#include "tim.h"
 #include "usart.h"
 #include "gpio.h"
 
@@ -26,6 +29,26 @@
 /* USER CODE BEGIN Includes */
 // "AD9833_HAL.h"
 #include "AD9833_Soft.h"
+#if defined(AD9833_BENCH_ENABLE)
+#include "AD9833_Bench.h"
+#endif
+#if defined(AD9833_STRESS_ENABLE)
+#include "AD9833_Stress.h"
+#endif
+#if defined(AD9833_BENCH_ENABLE) || defined(AD9833_STRESS_ENABLE)
+#include <string.h>
+#endif
+#if defined(AD9833_PROF_ENABLE)
+#include "AD9833_Prof.h"
+#endif
+#if defined(AD9833_BUSLOG_ENABLE)
+#include "AD9833_BusLog.h"
+#endif
+#if defined(AD9833_PROTO_ENABLE)
+#include "AD9833_Proto.h"
+#include "AD9833_Seq.h"
+#include "AD9833_Table.h"
+#endif
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -35,6 +58,10 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#if defined(AD9833_PROTO_ENABLE)
+// USART1 接收 DMA 循环缓冲区字节数
+#define PROTO_RX_SIZE 256U
+#endif
 
 /* USER CODE END PD */
 
@@ -46,6 +73,9 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
+#if defined(AD9833_PROTO_ENABLE)
+static uint8_t s_proto_rx[PROTO_RX_SIZE];
+#endif
 
 /* USER CODE END PV */
 
@@ -57,7 +87,111 @@ void SystemClock_Config(void);
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
+#if defined(AD9833_BENCH_ENABLE) || defined(AD9833_STRESS_ENABLE)
+/**
+ * @brief       测量结果经 USART1 输出一行
+ * @param       line: 一行文本 (不含换行符)
+ * @retval      无
+ */
+static void Bench_Output(const char* line)
+{
+  HAL_UART_Transmit(&huart1, (const uint8_t*)line, (uint16_t)strlen(line), HAL_MAX_DELAY);
+  HAL_UART_Transmit(&huart1, (const uint8_t*)"\r\n", 2, HAL_MAX_DELAY);
+}
+#endif
+
+/**
+ * @brief       单字节调试命令: 'p' 输出各接口的周期统计, 'r' 清空统计, 'l' 输出最近传输记录
+ * @param       cmd: 收到的字节
+ * @retval      无
+ */
+static void Debug_Command(uint8_t cmd)
+{
+#if defined(AD9833_PROF_ENABLE)
+  if (cmd == 'p') AD9833_Prof_Dump(&huart1);
+  else if (cmd == 'r') AD9833_Prof_Reset();
+#endif
+#if defined(AD9833_BUSLOG_ENABLE)
+  if (cmd == 'l') AD9833_BusLog_Dump(&huart1);
+#endif
+  (void)cmd;
+}
+
+#if defined(AD9833_PROTO_ENABLE)
+/**
+ * @brief       协议应答经 USART1 发出
+ * @param       data: 应答帧
+ * @param       len: 字节数
+ * @retval      无
+ */
+static void Proto_Send(const uint8_t* data, uint16_t len)
+{
+  HAL_UART_Transmit(&huart1, data, len, HAL_MAX_DELAY);
+}
+
+/**
+ * @brief       启动 USART1 的循环 DMA 接收, 从缓冲区起点写入
+ * @retval      无
+ */
+static void Proto_RxArm(void)
+{
+  if (HAL_UARTEx_ReceiveToIdle_DMA(&huart1, s_proto_rx, PROTO_RX_SIZE) != HAL_OK)
+  {
+    Error_Handler();
+  }
+}
+
+/**
+ * @brief       登记 DMA 缓冲区并启动接收, 命令帧在 DMA 缓冲区中原地解析
+ * @retval      无
+ */
+static void Proto_RxStart(void)
+{
+  AD9833_Proto_RxStart(s_proto_rx, PROTO_RX_SIZE);
+  Proto_RxArm();
+}
 
+/**
+ * @brief       USART1 接收事件 (空闲线、DMA 半满、全满): 记下 DMA 写入位置
+ * @param       huart: 串口
+ * @param       Size: 写入位置
+ * @retval      无
+ */
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size)
+{
+  if (huart == &huart1) AD9833_Proto_RxEvent(Size);
+}
+
+/**
+ * @brief       USART1 接收错误 (噪声、帧错误) 时 HAL 已停止 DMA, 重新启动接收
+ * @note        解析器的状态不在中断中改动, 由主循环的 AD9833_Proto_RxPoll() 重新同步
+ * @param       huart: 串口
+ * @retval      无
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart)
+{
+  if (huart == &huart1)
+  {
+    AD9833_Proto_RxRestart((uint16_t)(PROTO_RX_SIZE - __HAL_DMA_GET_COUNTER(huart->hdmarx)));
+    Proto_RxArm();
+  }
+}
+
+/**
+ * @brief       定时器更新中断: TIM6 以 1kHz (AD9833_SEQ_TICK_HZ、AD9833_TABLE_TICK_HZ) 驱动定时播放
+ * @note        序列和数据字表不会同时播放, 未播放的一方直接返回
+ * @param       htim: 定时器
+ * @retval      无
+ */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim)
+{
+  if (htim == &htim6)
+  {
+    AD9833_Seq_Tick();
+    AD9833_Table_Tick();
+  }
+}
+#endif
 /* USER CODE END 0 */
 
 /**
@@ -89,9 +223,18 @@ int main(void)
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
+  MX_DMA_Init();
   MX_USART1_UART_Init();
   MX_SPI2_Init();
+  MX_ADC1_Init();
+  MX_ADC2_Init();
+  MX_TIM3_Init();
+  MX_TIM5_Init();
+  MX_TIM6_Init();
   /* USER CODE BEGIN 2 */
+#if defined(AD9833_BUSLOG_ENABLE)
+  AD9833_BusLog_Init();         // 保留复位前的最近传输记录
+#endif
   HAL_GPIO_WritePin(LEDG_GPIO_Port, LEDG_Pin, GPIO_PIN_RESET);
   AD9833_InitTypedef AD9833;
   AD9833.AD_CS1.freq = 1000;
@@ -110,6 +253,33 @@ int main(void)
 
   AD9833_Cmd_Sync(&AD9833);
 
+#if defined(AD9833_BENCH_ENABLE)
+  // 测量各接口的耗时后恢复输出
+  AD9833_Bench_Run(&AD9833_Bench_DwtProbe, "soft", AD9833_BENCH_REPEAT, Bench_Output);
+  AD9833_Cmd_Sync(&AD9833);
+#endif
+
+#if defined(AD9833_STRESS_ENABLE)
+  // 各速率下的吞吐、丢弃和延迟, 结束后恢复输出
+  AD9833_Stress_Suite(&AD9833_Stress_DwtClock, "soft", 0, Bench_Output);
+  AD9833_Cmd_Sync(&AD9833);
+#endif
+
+#if defined(AD9833_PROTO_ENABLE)
+  // 上位机命令帧由 AD9833_Proto 解析, 帧外的单字节仍作为调试命令
+  AD9833_Seq_Init();
+#if defined(AD9833_SEQ_TIMED_ENABLE)
+  AD9833_Seq_SetTimed(1);       // 默认定时播放, 上位机也可用 SEQ_MODE 切换
+#endif
+  AD9833_Proto_Init(Proto_Send, Debug_Command);
+  Proto_RxStart();
+  // 没有定时播放时 AD9833_Seq_Tick() / AD9833_Table_Tick() 直接返回
+  if (HAL_TIM_Base_Start_IT(&htim6) != HAL_OK)
+  {
+    Error_Handler();
+  }
+#endif
+
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -120,6 +290,16 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
+#if defined(AD9833_PROTO_ENABLE)
+    AD9833_Proto_RxPoll();
+    AD9833_Seq_Poll();
+#else
+    uint8_t rx;
+    if (HAL_UART_Receive(&huart1, &rx, 1, 0) == HAL_OK)
+    {
+      Debug_Command(rx);
+    }
+#endif
   }
   /* USER CODE END 3 */
 }
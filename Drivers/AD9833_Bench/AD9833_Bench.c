@@ -0,0 +1,289 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Bench.c
+  * @brief          : 驱动各接口的写入开销测量, 输出CSV供回归比较
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-14
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 对驱动的每个接口 (初始化、Cmd、同步启动、改频、改相、扫频和几种跳频
+  * 方式) 重复调用N次，每次调用前后由测量方法 (AD9833_BenchProbe) 取数，
+  * 汇总后按行输出CSV：
+  *
+  *     # ad9833_bench,<格式版本>
+  *     transport,op,calls,words,cs_toggles,bus_ns,cycles_min,cycles_mean,cycles_max
+  *     soft,freq_set_cs1,100,3,6,5342,897,897,897
+  *
+  * words / cs_toggles / bus_ns 为每次调用的平均值。同一份代码在两处运行：
+  * - 目标板: 使用 `AD9833_Bench_DwtProbe` (DWT周期计数器，测量期间关中断)，
+  *   只能得到CPU周期，words 和 cs_toggles 为空，bus_ns 由周期折算。
+  * - 主机: Host/Bench 中的测试程序以模拟层的记录实现测量方法，得到全部
+  *   四项，并与仓库中的基线文件比较，写入次数变化或耗时变长即报错。
+  *
+  * 传输方式在编译时选择：定义 AD9833_BENCH_HAL 时测量硬件SPI驱动 (SPI句柄
+  * 由 AD9833_BENCH_HSPI 指定，默认 &hspi2)，定义 AD9833_BENCH_MSPM0 时测量
+  * MSPM0 软件SPI驱动，否则测量 STM32 软件SPI驱动。硬件SPI驱动没有预置写入，
+  * 不测量 hop_staged 项。
+  *
+  * 测量会改写两路输出，结束时两路停在最后一次写入的频率上。
+  *
+  * 使用方法：
+  * 1. 将本文件加入工程，按上面的说明定义传输方式。
+  * 2. 实现一个输出一行文本的函数 (如通过串口发送并补上换行)。
+  * 3. 调用 `AD9833_Bench_Run(&AD9833_Bench_DwtProbe, "soft", AD9833_BENCH_REPEAT, output)`。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_Bench.h"
+#include <stdio.h>
+
+#if defined(AD9833_BENCH_HAL)
+#include "spi.h"
+#ifndef AD9833_BENCH_HSPI
+#define AD9833_BENCH_HSPI           (&hspi2)
+#endif
+#define AD9833_BENCH_CALL(fn, ...)  fn(AD9833_BENCH_HSPI, __VA_ARGS__)
+#else
+#define AD9833_BENCH_CALL(fn, ...)  fn(__VA_ARGS__)
+#endif
+
+/**
+ * @brief   测量项: 名称与一次调用
+ */
+typedef struct
+{
+    const char* name;
+    void (*run)(uint32_t i);
+} AD9833_BenchCase;
+
+static AD9833_InitTypedef s_cfg = {
+    .status = CS1_CS2_DOUBLE,
+    .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+    .AD_CS2 = { SINE_WAVE, 1000.0, 90.0, 0, 0 },
+};
+
+static DDS_InitTypedef s_cfg_n[AD9833_CHIP_NUM] = {0};
+
+// 跳频项当前输出使用的频率寄存器
+static uint8_t s_active = 0;
+
+static void AD9833_Bench_Init(uint32_t i)       { (void)i; AD9833_BENCH_CALL(AD9833_Init, CS1_CS2_DOUBLE); }
+static void AD9833_Bench_Cmd(uint32_t i)        { (void)i; AD9833_Cmd(&s_cfg); }
+static void AD9833_Bench_CmdSync(uint32_t i)    { (void)i; AD9833_Cmd_Sync(&s_cfg); }
+static void AD9833_Bench_CmdSyncN(uint32_t i)   { (void)i; AD9833_BENCH_CALL(AD9833_Cmd_SyncN, s_cfg_n, CS_ALL); }
+static void AD9833_Bench_FreqCs1(uint32_t i)    { AD9833_BENCH_CALL(AD9833_FreqSet, CS1, 0, 1000.0 + i); }
+static void AD9833_Bench_FreqBoth(uint32_t i)   { AD9833_BENCH_CALL(AD9833_FreqSet, CS_BOTH, 0, 1000.0 + i); }
+static void AD9833_Bench_PhaseCs1(uint32_t i)   { AD9833_BENCH_CALL(AD9833_PhaseSet, CS1, 0, (double)(i % 360U)); }
+static void AD9833_Bench_SelectFreq(uint32_t i) { AD9833_BENCH_CALL(AD9833_SelectFreqReg, CS_BOTH, (uint8_t)(i & 1U)); }
+
+/**
+ * @brief       扫频: 连续 AD9833_BENCH_SWEEP_STEPS 步改写正在使用的频率寄存器
+ * @param       i: 调用序号
+ * @retval      无
+ */
+static void AD9833_Bench_Sweep(uint32_t i)
+{
+    (void)i;
+    for (uint32_t k = 0; k < AD9833_BENCH_SWEEP_STEPS; k++)
+    {
+        AD9833_BENCH_CALL(AD9833_FreqSet, CS_BOTH, s_active, 1000.0 + 10.0 * k);
+    }
+}
+
+/**
+ * @brief       跳频: 直接改写正在使用的频率寄存器 (两半字之间有中间频率)
+ * @param       i: 调用序号
+ * @retval      无
+ */
+static void AD9833_Bench_HopActive(uint32_t i)
+{
+    AD9833_BENCH_CALL(AD9833_FreqSet, CS_BOTH, s_active, (i & 1U) ? 2000.0 : 1000.0);
+}
+
+/**
+ * @brief       跳频: 写入空闲的频率寄存器后切换 (乒乓)
+ * @param       i: 调用序号
+ * @retval      无
+ */
+static void AD9833_Bench_HopPingPong(uint32_t i)
+{
+    uint8_t next = s_active ^ 1U;
+
+    AD9833_BENCH_CALL(AD9833_FreqSet, CS_BOTH, next, (i & 1U) ? 2000.0 : 1000.0);
+    AD9833_BENCH_CALL(AD9833_SelectFreqReg, CS_BOTH, next);
+    s_active = next;
+}
+
+#if !defined(AD9833_BENCH_HAL)
+/**
+ * @brief       跳频: 写入空闲的频率寄存器, 预置切换后两路同时锁存
+ * @param       i: 调用序号
+ * @retval      无
+ */
+static void AD9833_Bench_HopStaged(uint32_t i)
+{
+    uint8_t next = s_active ^ 1U;
+
+    AD9833_FreqSet(CS_BOTH, next, (i & 1U) ? 2000.0 : 1000.0);
+    AD9833_StageSelect(CS_BOTH, next, 0);
+    AD9833_StageLatch();
+    AD9833_StageRelease();
+    s_active = next;
+}
+#endif
+
+static const AD9833_BenchCase s_case[] = {
+    { "init",               AD9833_Bench_Init },
+    { "cmd",                AD9833_Bench_Cmd },
+    { "cmd_sync",           AD9833_Bench_CmdSync },
+    { "cmd_sync_n",         AD9833_Bench_CmdSyncN },
+    { "freq_set_cs1",       AD9833_Bench_FreqCs1 },
+    { "freq_set_both",      AD9833_Bench_FreqBoth },
+    { "phase_set_cs1",      AD9833_Bench_PhaseCs1 },
+    { "select_freq_both",   AD9833_Bench_SelectFreq },
+    { "sweep_100",          AD9833_Bench_Sweep },
+    { "hop_active",         AD9833_Bench_HopActive },
+    { "hop_pingpong",       AD9833_Bench_HopPingPong },
+#if !defined(AD9833_BENCH_HAL)
+    { "hop_staged",         AD9833_Bench_HopStaged },
+#endif
+};
+
+/**
+ * @brief       将累计值折算为每次调用的平均值 (四舍五入)
+ * @param       sum: 累计值
+ * @param       calls: 调用次数
+ * @retval      平均值
+ */
+static uint32_t AD9833_Bench_Mean(uint64_t sum, uint32_t calls)
+{
+    return (uint32_t)((sum + calls / 2U) / calls);
+}
+
+/**
+ * @brief       运行全部测量项并逐行输出CSV
+ * @note        先将两路恢复到 s_cfg 的初始状态, 各项依次运行, 互相之间不恢复
+ * @param       probe: 测量方法
+ * @param       transport: 写入 transport 列的传输方式名称
+ * @param       repeat: 每项的调用次数 (0 时取 AD9833_BENCH_REPEAT)
+ * @param       output: 输出一行的函数
+ * @retval      无
+ */
+void AD9833_Bench_Run(const AD9833_BenchProbe* probe, const char* transport, uint32_t repeat, AD9833_BenchOutput output)
+{
+    char line[AD9833_BENCH_LINE_MAX];
+
+    if (repeat == 0) repeat = AD9833_BENCH_REPEAT;
+
+#if defined(AD9833_BENCH_HAL)
+    s_cfg.hspi = AD9833_BENCH_HSPI;
+#endif
+    for (uint32_t n = 0; n < AD9833_CHIP_NUM; n++)
+    {
+        s_cfg_n[n] = (DDS_InitTypedef){ SINE_WAVE, 1000.0, 90.0 * (n % 4U), 0, 0 };
+    }
+    AD9833_Cmd(&s_cfg);
+    s_active = 0;
+
+    snprintf(line, sizeof(line), "# ad9833_bench,%u", (unsigned)AD9833_BENCH_FORMAT);
+    output(line);
+    output("transport,op,calls,words,cs_toggles,bus_ns,cycles_min,cycles_mean,cycles_max");
+
+    for (uint32_t c = 0; c < sizeof(s_case) / sizeof(s_case[0]); c++)
+    {
+        uint64_t words = 0, cs = 0, ns = 0, cycles = 0;
+        uint32_t cycles_min = UINT32_MAX, cycles_max = 0;
+        uint8_t counted = 1;
+
+        for (uint32_t i = 0; i < repeat; i++)
+        {
+            AD9833_BenchResult r = { -1, -1, 0, 0 };
+
+            probe->begin();
+            s_case[c].run(i);
+            probe->end(&r);
+
+            if (r.words < 0 || r.cs_toggles < 0) counted = 0;
+            words += (uint32_t)r.words;
+            cs += (uint32_t)r.cs_toggles;
+            ns += r.bus_ns;
+            cycles += r.cycles;
+            if (r.cycles < cycles_min) cycles_min = r.cycles;
+            if (r.cycles > cycles_max) cycles_max = r.cycles;
+        }
+
+        if (counted)
+        {
+            snprintf(line, sizeof(line), "%s,%s,%u,%u,%u,%u,%u,%u,%u",
+                     transport, s_case[c].name, (unsigned)repeat,
+                     (unsigned)AD9833_Bench_Mean(words, repeat), (unsigned)AD9833_Bench_Mean(cs, repeat),
+                     (unsigned)AD9833_Bench_Mean(ns, repeat), (unsigned)cycles_min,
+                     (unsigned)AD9833_Bench_Mean(cycles, repeat), (unsigned)cycles_max);
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "%s,%s,%u,,,%u,%u,%u,%u",
+                     transport, s_case[c].name, (unsigned)repeat,
+                     (unsigned)AD9833_Bench_Mean(ns, repeat), (unsigned)cycles_min,
+                     (unsigned)AD9833_Bench_Mean(cycles, repeat), (unsigned)cycles_max);
+        }
+        output(line);
+    }
+}
+
+#if !defined(AD9833_BENCH_MSPM0)
+// 读取计数器本身的开销 (周期), 首次测量前标定
+static uint32_t s_dwt_overhead = 0;
+static uint32_t s_dwt_start = 0;
+static uint32_t s_dwt_primask = 0;
+
+/**
+ * @brief       DWT测量: 使能计数器, 关中断后记下起点
+ * @retval      无
+ */
+static void AD9833_Bench_DwtBegin(void)
+{
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+        uint32_t t0 = DWT->CYCCNT;
+        uint32_t t1 = DWT->CYCCNT;
+        s_dwt_overhead = t1 - t0;
+    }
+
+    s_dwt_primask = __get_PRIMASK();
+    __disable_irq();
+    s_dwt_start = DWT->CYCCNT;
+}
+
+/**
+ * @brief       DWT测量: 取终点并恢复中断, 周期折算为纳秒
+ * @param       result: 测量结果, words 和 cs_toggles 无法测量, 填 -1
+ * @retval      无
+ */
+static void AD9833_Bench_DwtEnd(AD9833_BenchResult* result)
+{
+    uint32_t cycles = DWT->CYCCNT - s_dwt_start;
+
+    __set_PRIMASK(s_dwt_primask);
+
+    cycles = (cycles > s_dwt_overhead) ? cycles - s_dwt_overhead : 0U;
+    result->words = -1;
+    result->cs_toggles = -1;
+    result->cycles = cycles;
+    result->bus_ns = (uint32_t)((uint64_t)cycles * 1000000000ULL / SystemCoreClock);
+}
+
+const AD9833_BenchProbe AD9833_Bench_DwtProbe = {
+    AD9833_Bench_DwtBegin,
+    AD9833_Bench_DwtEnd,
+};
+#endif
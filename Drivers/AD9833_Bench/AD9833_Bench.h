@@ -0,0 +1,64 @@
+#ifndef _AD9833_BENCH_H
+#define _AD9833_BENCH_H
+
+#include <stdint.h>
+
+// 传输方式由编译选项选择, 与工程中实际编译的驱动一致
+#if defined(AD9833_BENCH_HAL)
+#include "AD9833_HAL.h"
+#elif defined(AD9833_BENCH_MSPM0)
+#include "AD9833_Soft_MSPM0.h"
+#else
+#include "AD9833_Soft.h"
+#endif
+
+// 输出格式版本, 列定义变化时加1
+#define AD9833_BENCH_FORMAT         1U
+
+// 每项默认重复次数
+#define AD9833_BENCH_REPEAT         100U
+
+// 扫频项的步数
+#define AD9833_BENCH_SWEEP_STEPS    100U
+
+// 一行输出的最大长度 (含结尾的 '\0')
+#define AD9833_BENCH_LINE_MAX       128U
+
+/**
+  * @brief 一次调用的测量结果
+  * @note  目标板上无法得到总线上的数据字数和片选跳变数, 这两项填 -1, 输出为空
+  *     @arg words: 总线上的16位数据字数 (广播写入计1)
+  *     @arg cs_toggles: 片选引脚的跳变数 (拉低和拉高各计1)
+  *     @arg bus_ns: 调用耗时 (纳秒)
+  *     @arg cycles: 调用耗时 (CPU周期)
+  */
+typedef struct
+{
+    int32_t words;
+    int32_t cs_toggles;
+    uint32_t bus_ns;
+    uint32_t cycles;
+} AD9833_BenchResult;
+
+/**
+  * @brief 测量方法
+  *     @arg begin: 被测调用前执行
+  *     @arg end: 被测调用后执行, 填写测量结果
+  */
+typedef struct
+{
+    void (*begin)(void);
+    void (*end)(AD9833_BenchResult* result);
+} AD9833_BenchProbe;
+
+// 输出一行 (不含换行符)
+typedef void (*AD9833_BenchOutput)(const char* line);
+
+/* 函数声明 */
+void AD9833_Bench_Run(const AD9833_BenchProbe* probe, const char* transport, uint32_t repeat, AD9833_BenchOutput output);
+
+#if !defined(AD9833_BENCH_MSPM0)
+extern const AD9833_BenchProbe AD9833_Bench_DwtProbe;
+#endif
+
+#endif /* _AD9833_BENCH_H */
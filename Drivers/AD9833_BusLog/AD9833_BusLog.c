@@ -0,0 +1,148 @@
+/**
+******************************************************************************
+  * @file           : AD9833_BusLog.c
+  * @brief          : 常开的最近传输记录, 放在 CCMRAM 中, 复位后可读出
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-16
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 定义 AD9833_BUSLOG_ENABLE 后，驱动 (AD9833_Soft / AD9833_HAL) 的
+  * `AD9833_Write()` 每写一个数据字就把 (时刻, 芯片掩码, 数据字) 写入一个
+  * 环形缓冲区，只保留最近 AD9833_BUSLOG_DEPTH 条。与 AD9833_Trace 不同，
+  * 它不需要启动，也不会写满停止，用于事后查看出错前发出了什么。
+  *
+  * - 每条12字节，256条共3KB，放在原先未使用的 CCMRAM (.ccmram_noinit 段，
+  *   NOLOAD)。启动代码不清零该段，HardFault/看门狗复位后记录仍在。
+  * - 记录为内联的 LDREX/STREX 占号加四次存储，不关中断，中断中写入也
+  *   不会互相覆盖；每条的 lap 最后写入，读出时据此丢弃被打断或已被覆盖
+  *   的条目。
+  * - AD9833_BusLog_Init() 在 magic 有效时保留记录，并把当前 head 记为
+  *   boot_head，输出时在此处标出复位点。
+  *
+  * 输出格式 (AD9833_BusLog_Dump)：
+  *
+  *     # ad9833_buslog,<格式版本>,<时钟Hz>,<head>,<boot_head>,<resets>
+  *     seq,time,mask,word
+  *     1021,83412,0x03,0x2100
+  *     # boot                      (复位点, 之后为本次启动的记录)
+  *     ...
+  *
+  * 使用方法：
+  * 1. 在编译选项中定义 AD9833_BUSLOG_ENABLE，将本文件加入工程，链接脚本中
+  *    需有 .ccmram_noinit 段。
+  * 2. 在 main() 中外设初始化后、第一次调用驱动前调用 `AD9833_BusLog_Init()`。
+  * 3. 需要时调用 `AD9833_BusLog_Dump(&huart1)`；或在调试器中查看
+  *    `AD9833_BusLog`，最新一条为 entry[(head - 1) % AD9833_BUSLOG_DEPTH]。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_BusLog.h"
+
+#if defined(AD9833_BUSLOG_ENABLE)
+
+#include <stdio.h>
+#include <string.h>
+
+AD9833_BusLogTypedef AD9833_BusLog AD9833_BUSLOG_SECTION;
+
+/**
+ * @brief       启动时调用一次, 保留复位前的记录
+ * @note        上电后 magic 无效时清空; 有效时 resets 加1, 并记下复位点
+ * @retval      无
+ */
+void AD9833_BusLog_Init(void)
+{
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+#endif
+    if (AD9833_BusLog.magic != AD9833_BUSLOG_MAGIC)
+    {
+        AD9833_BusLog_Clear();
+        return;
+    }
+    AD9833_BusLog.boot_head = AD9833_BusLog.head;
+    AD9833_BusLog.resets++;
+}
+
+/**
+ * @brief       清空记录
+ * @retval      无
+ */
+void AD9833_BusLog_Clear(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(&AD9833_BusLog, 0, sizeof(AD9833_BusLog));
+    AD9833_BusLog.magic = AD9833_BUSLOG_MAGIC;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief       已写入的总条数
+ * @retval      下一条的序号
+ */
+uint32_t AD9833_BusLog_Head(void)
+{
+    return AD9833_BusLog.head;
+}
+
+/**
+ * @brief       读取一条记录
+ * @param       seq: 序号, 有效范围为 head - AD9833_BUSLOG_DEPTH 到 head - 1
+ * @param       entry: 输出
+ * @retval      1: 有效; 0: 超出范围、已被覆盖或写入未完成
+ */
+uint8_t AD9833_BusLog_Read(uint32_t seq, AD9833_BusLogEntry* entry)
+{
+    uint32_t head = AD9833_BusLog.head;
+
+    if (head - seq - 1U >= AD9833_BUSLOG_DEPTH) return 0;  // 无符号差, 回绕时同样成立
+    *entry = *(const volatile AD9833_BusLogEntry*)&AD9833_BusLog.entry[seq & (AD9833_BUSLOG_DEPTH - 1U)];
+
+    return (entry->lap == (uint16_t)(seq / AD9833_BUSLOG_DEPTH)) ? 1U : 0U;
+}
+
+/**
+ * @brief       通过串口输出记录, 从旧到新
+ * @note        阻塞发送; 输出期间新写入的条目可能覆盖尚未输出的旧条目, 这些条目被跳过
+ * @param       huart: 串口句柄
+ * @retval      无
+ */
+void AD9833_BusLog_Dump(UART_HandleTypeDef* huart)
+{
+    char line[80];
+    int len;
+    uint32_t head = AD9833_BusLog.head;
+    uint32_t seq = (head > AD9833_BUSLOG_DEPTH) ? head - AD9833_BUSLOG_DEPTH : 0U;
+    AD9833_BusLogEntry e;
+
+    len = snprintf(line, sizeof(line), "# ad9833_buslog,%u,%lu,%lu,%lu,%lu\r\nseq,time,mask,word\r\n",
+                   (unsigned)AD9833_BUSLOG_FORMAT, (unsigned long)SystemCoreClock, (unsigned long)head,
+                   (unsigned long)AD9833_BusLog.boot_head, (unsigned long)AD9833_BusLog.resets);
+    HAL_UART_Transmit(huart, (const uint8_t*)line, (uint16_t)len, HAL_MAX_DELAY);
+
+    for (; seq != head; seq++)
+    {
+        if (seq == AD9833_BusLog.boot_head && AD9833_BusLog.resets)
+        {
+            HAL_UART_Transmit(huart, (const uint8_t*)"# boot\r\n", 8, HAL_MAX_DELAY);
+        }
+        if (!AD9833_BusLog_Read(seq, &e)) continue;
+
+        len = snprintf(line, sizeof(line), "%lu,%lu,0x%02lX,0x%04X\r\n", (unsigned long)seq,
+                       (unsigned long)e.time, (unsigned long)e.mask, (unsigned)e.word);
+        HAL_UART_Transmit(huart, (const uint8_t*)line, (uint16_t)len, HAL_MAX_DELAY);
+    }
+}
+
+#endif /* AD9833_BUSLOG_ENABLE */
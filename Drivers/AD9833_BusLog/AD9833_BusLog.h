@@ -0,0 +1,95 @@
+#ifndef _AD9833_BUSLOG_H
+#define _AD9833_BUSLOG_H
+
+#include "main.h"
+
+// 保留最近的数据字个数, 必须为2的幂 (每条12字节)
+#ifndef AD9833_BUSLOG_DEPTH
+#define AD9833_BUSLOG_DEPTH         256U
+#endif
+
+// 输出格式版本, 格式变化时加1
+#define AD9833_BUSLOG_FORMAT        2U
+
+// 记录有效标志, 上电后 CCMRAM 为随机值, 与此不符时清空; 低字节为格式版本,
+// 更新固件后复位前的旧格式记录同样被清空
+#define AD9833_BUSLOG_MAGIC         (0x41443900UL | AD9833_BUSLOG_FORMAT)
+
+// 记录所在的段: 链接脚本中 CCMRAM 的 .ccmram_noinit (NOLOAD), 启动代码不清零, 复位后保留
+#ifndef AD9833_BUSLOG_SECTION
+#define AD9833_BUSLOG_SECTION       __attribute__((section(".ccmram_noinit")))
+#endif
+
+// 时间戳来源, 默认为 DWT 周期计数器
+#ifndef AD9833_BUSLOG_TIME
+#define AD9833_BUSLOG_TIME()        (DWT->CYCCNT)
+#endif
+
+/**
+  * @brief 一条记录
+  *     @arg time: 写入时刻 (DWT->CYCCNT)
+  *     @arg mask: 接收该字的芯片掩码 (chipChose, 全部 AD9833_CHIP_NUM 片)
+  *     @arg word: 16位数据字
+  *     @arg lap: 序号 / AD9833_BUSLOG_DEPTH 的低16位, 最后写入; 与序号不符说明
+  *               该条已被覆盖或写入被打断
+  */
+typedef struct
+{
+    uint32_t time;
+    uint32_t mask;
+    uint16_t word;
+    uint16_t lap;
+} AD9833_BusLogEntry;
+
+/**
+  * @brief 记录区 (调试器中查看全局变量 AD9833_BusLog 即可)
+  *     @arg magic: AD9833_BUSLOG_MAGIC
+  *     @arg head: 已写入的总条数, 即下一条的序号; 序号 n 的记录在 entry[n % DEPTH]
+  *     @arg boot_head: 本次启动时的 head, 之前的记录来自复位前
+  *     @arg resets: 记录被保留下来的复位次数
+  *     @arg entry: 环形缓冲区
+  */
+typedef struct
+{
+    uint32_t magic;
+    volatile uint32_t head;
+    uint32_t boot_head;
+    uint32_t resets;
+    AD9833_BusLogEntry entry[AD9833_BUSLOG_DEPTH];
+} AD9833_BusLogTypedef;
+
+extern AD9833_BusLogTypedef AD9833_BusLog;
+
+/**
+ * @brief       记录一个数据字
+ * @note        内联在驱动的 AD9833_Write() 中; 用 LDREX/STREX 占用序号, 不关中断,
+ *              可在中断中调用; 被打断的一条由 lap 标出
+ * @param       mask: 接收该字的芯片掩码
+ * @param       word: 数据字
+ * @retval      无
+ */
+static inline void AD9833_BusLog_Record(uint32_t mask, uint16_t word)
+{
+    uint32_t seq;
+
+    do
+    {
+        seq = __LDREXW(&AD9833_BusLog.head);
+    } while (__STREXW(seq + 1U, &AD9833_BusLog.head));
+
+    // volatile 保证 lap 最后写入
+    volatile AD9833_BusLogEntry* e = &AD9833_BusLog.entry[seq & (AD9833_BUSLOG_DEPTH - 1U)];
+    e->time = AD9833_BUSLOG_TIME();
+    e->word = word;
+    e->mask = mask;
+    e->lap = (uint16_t)(seq / AD9833_BUSLOG_DEPTH);
+}
+
+/* 函数声明 */
+void AD9833_BusLog_Init(void);
+void AD9833_BusLog_Clear(void);
+uint32_t AD9833_BusLog_Head(void);
+uint8_t AD9833_BusLog_Read(uint32_t seq, AD9833_BusLogEntry* entry);
+void AD9833_BusLog_Dump(UART_HandleTypeDef* huart);
+
+#endif /* _AD9833_BUSLOG_H */
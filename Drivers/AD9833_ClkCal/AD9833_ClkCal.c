@@ -0,0 +1,177 @@
+/**
+******************************************************************************
+  * @file           : AD9833_ClkCal.c
+  * @brief          : AD9833 主时钟 (MCLK) 频率实测与校准
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-04
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 驱动默认按标称 25MHz 换算频率字，而实际晶振存在几十ppm的偏差，会
+  * 直接反映到输出频率上。本模块将一个通道切换为方波 (MSB) 输出，用
+  * TIM5 (32位) 输入捕获对其做倒数计数：在一段较长的闸门时间内记录第
+  * 一个与最后一个捕获时刻，以整周期数除以两者之差得到输入频率。由于
+  * 计时起止都对齐在信号边沿上，分辨率只取决于闸门时间内的计数器时钟
+  * 数，与被测频率无关。
+  *
+  * 测量频率字取2的整数次幂，方波每个周期恰为整数个MCLK，因此边沿没有
+  * DDS 截断带来的周期抖动。由实测频率反推出 MCLK 后调用
+  * `AD9833_SetMclk()`，之后该芯片的频率换算都以实测值为准。多片芯片共用
+  * 同一时钟源时，可测量其中一片后以 `AD9833_SetMclk(CS_ALL, ...)` 应用。
+  *
+  * 注意：测量结果以 STM32 的 HSE 为基准，精度不会高于 HSE 本身。
+  *
+  * 硬件连接：
+  * - PA0 (TIM5_CH1): 被测通道的 VOUT
+  *
+  * 使用方法：
+  * 1. 在CubeMX中按上述引脚配置 TIM5 通道1为输入捕获 (8分频) 并打开中断。
+  * 2. 调用 `AD9833_ClkCal_Run()` 测量并应用校准结果，被测通道的输出会
+  * 被改写为方波，测量完成后需重新配置输出。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_ClkCal.h"
+
+// 第一个与最后一个捕获时刻 (计数器值)
+static volatile uint32_t s_first = 0;
+static volatile uint32_t s_last = 0;
+
+// 闸门时间内的捕获次数
+static volatile uint32_t s_count = 0;
+
+/**
+ * @brief       输入捕获回调, 记录首末捕获时刻并计数
+ * @param       htim: 定时器句柄
+ * @retval      无
+ */
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef* htim)
+{
+    if (htim->Instance == TIM5 && htim->Channel == HAL_TIM_ACTIVE_CHANNEL_1)
+    {
+        uint32_t t = HAL_TIM_ReadCapturedValue(htim, TIM_CHANNEL_1);
+
+        if (s_count == 0)
+        {
+            s_first = t;
+        }
+        s_last = t;
+        s_count++;
+    }
+}
+
+/**
+ * @brief       获取 TIM5 的计数时钟频率
+ * @note        APB1 分频系数不为1时, 定时器时钟为 PCLK1 的两倍
+ * @retval      计数时钟频率 (Hz)
+ */
+static uint32_t AD9833_ClkCal_TimerClock(void)
+{
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+    {
+        pclk1 *= 2U;
+    }
+    return pclk1;
+}
+
+/**
+ * @brief       测量指定通道的主时钟频率
+ * @note        会将该通道改写为方波输出, 测量期间 TIM5 中断频率约为 12kHz
+ * @param       choice: 被测通道, 须为单片芯片 (CS1, CS2 或 AD9833_CS(n))
+ * @param       gate_ms: 闸门时间 (毫秒), 为0时使用 AD9833_CLKCAL_GATE_MS
+ * @param       mclk: 输出实测的主时钟频率 (Hz)
+ * @retval      HAL_OK: 成功; HAL_ERROR: 参数错误、无信号或结果超出合理范围
+ */
+HAL_StatusTypeDef AD9833_ClkCal_Measure(chipChose choice, uint32_t gate_ms, double* mclk)
+{
+    if (!mclk || (choice & CS_ALL) != choice || choice == 0 || (choice & (choice - 1U)) != 0)
+    {
+        return HAL_ERROR;   // 须为单片芯片
+    }
+    if (gate_ms == 0) gate_ms = AD9833_CLKCAL_GATE_MS;
+    if (gate_ms > AD9833_CLKCAL_GATE_MAX_MS) return HAL_ERROR;
+
+    // TIM5 通道1与相位测量 (AD9833_PhaseMeter) 共用, 每次测量前重新配置
+    TIM_IC_InitTypeDef sConfigIC = {0};
+    sConfigIC.ICPolarity = TIM_INPUTCHANNELPOLARITY_RISING;
+    sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    sConfigIC.ICPrescaler = TIM_ICPSC_DIV8;
+    sConfigIC.ICFilter = 0;
+    if (HAL_TIM_IC_ConfigChannel(&htim5, &sConfigIC, TIM_CHANNEL_1) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+
+    // 切换为方波输出, 频率字直接写入, 不经过 MCLK 换算
+    AD9833_Reset(choice, 1);
+    AD9833_Sleep(choice, 0, 0);
+    AD9833_FreqSetRaw(choice, 0, AD9833_CLKCAL_FREQ_WORD);
+    AD9833_SelectFreqReg(choice, 0);
+    AD9833_SetWaveformAndStart(choice, SQUARE_WAVE);
+
+    s_count = 0;
+    if (HAL_TIM_IC_Start_IT(&htim5, TIM_CHANNEL_1) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    HAL_Delay(gate_ms);
+    HAL_TIM_IC_Stop_IT(&htim5, TIM_CHANNEL_1);
+
+    if (s_count < 2)
+    {
+        return HAL_ERROR;   // 无输入信号
+    }
+
+    // 32位无符号差值, 闸门时间内最多溢出一次也能得到正确结果
+    uint32_t ticks = s_last - s_first;
+    double periods = (double)(s_count - 1U) * AD9833_CLKCAL_IC_DIV;
+    double fin = periods * (double)AD9833_ClkCal_TimerClock() / (double)ticks;
+
+    // fout = FTW * MCLK / 2^28
+    double result = fin * (double)FREQ_REG_MAX / (double)AD9833_CLKCAL_FREQ_WORD;
+
+    double ppm = (result / AD9833_MCLK_NOMINAL - 1.0) * 1e6;
+    if (ppm > AD9833_CLKCAL_MAX_PPM || ppm < -AD9833_CLKCAL_MAX_PPM)
+    {
+        return HAL_ERROR;
+    }
+
+    *mclk = result;
+    return HAL_OK;
+}
+
+/**
+ * @brief       测量主时钟并应用到该芯片的频率换算中
+ * @param       choice: 被测通道, 须为单片芯片
+ * @param       gate_ms: 闸门时间 (毫秒), 为0时使用默认值
+ * @param       ppm: 输出相对标称值的偏差 (ppm), 可为NULL
+ * @retval      同 AD9833_ClkCal_Measure(), 失败时不修改当前设置
+ */
+HAL_StatusTypeDef AD9833_ClkCal_Run(chipChose choice, uint32_t gate_ms, double* ppm)
+{
+    double mclk;
+
+    HAL_StatusTypeDef status = AD9833_ClkCal_Measure(choice, gate_ms, &mclk);
+    if (status != HAL_OK) return status;
+
+    AD9833_SetMclk(choice, mclk);
+
+    if (ppm) *ppm = AD9833_ClkCal_GetPpm(choice);
+    return HAL_OK;
+}
+
+/**
+ * @brief       获取芯片当前使用的主时钟相对标称值的偏差
+ * @param       choice: 片选参数, 选中多片时取编号最小的一片
+ * @retval      偏差 (ppm), 未校准时为0
+ */
+double AD9833_ClkCal_GetPpm(chipChose choice)
+{
+    return (AD9833_GetMclk(choice) / AD9833_MCLK_NOMINAL - 1.0) * 1e6;
+}
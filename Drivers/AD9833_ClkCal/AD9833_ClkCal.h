@@ -0,0 +1,29 @@
+#ifndef _AD9833_CLKCAL_H
+#define _AD9833_CLKCAL_H
+
+#include "main.h"
+#include "tim.h"
+#include "AD9833_Soft.h"
+
+// 测量用频率字: 取2的整数次幂, 方波每个周期恰为整数个MCLK, 边沿无抖动
+// 2^20 对应 MCLK / 256, 标称约 97.66kHz
+#define AD9833_CLKCAL_FREQ_WORD     (1UL << 20)
+
+// 输入捕获分频系数, 与测量时配置的 TIM_ICPSC_DIV8 对应
+#define AD9833_CLKCAL_IC_DIV        8U
+
+// 默认闸门时间 (毫秒), 1秒闸门对应的计数分辨率约为 0.012ppm
+#define AD9833_CLKCAL_GATE_MS       1000U
+
+// 最长闸门时间 (毫秒), 32位计数器在84MHz下约51秒溢出一次
+#define AD9833_CLKCAL_GATE_MAX_MS   50000U
+
+// 实测偏差的合理范围 (ppm), 超出时认为接线或信号有误
+#define AD9833_CLKCAL_MAX_PPM       1000.0
+
+/* 函数声明 */
+HAL_StatusTypeDef AD9833_ClkCal_Measure(chipChose choice, uint32_t gate_ms, double* mclk);
+HAL_StatusTypeDef AD9833_ClkCal_Run(chipChose choice, uint32_t gate_ms, double* ppm);
+double AD9833_ClkCal_GetPpm(chipChose choice);
+
+#endif /* _AD9833_CLKCAL_H */
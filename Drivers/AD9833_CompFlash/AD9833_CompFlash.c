@@ -0,0 +1,225 @@
+/**
+******************************************************************************
+  * @file           : AD9833_CompFlash.c
+  * @brief          : 频率相关相位补偿表的生成与FLASH存储
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-09
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 输出端的重建滤波器和放大器引入的群延时随通道而不同，`DDS_InitTypedef`
+  * 中的固定相位只在一个频率下成立。驱动为每个通道提供了相位补偿表
+  * (`AD9833_SetCompTable()`)：表格按频率字等间隔取点，每次改频时驱动以
+  * 整数插值求出补偿量，并紧接着频率字写入修正后的相位字。
+  *
+  * 本模块负责补偿表的来源与保存：
+  * - 由 AD9833_PhaseCal 的校准结果生成 CS2 的补偿表 (CS2 扣除相对 CS1
+  *   的附加相移)，点间距按校准频段自动选取。
+  * - 补偿表以带CRC的映像整体保存在 FLASH 扇区7 (链接脚本中的 CALIB
+  *   区域，程序不占用该扇区)，上电后直接指向 FLASH 使用，不占用RAM。
+  *
+  * 补偿表按频率字取点，与主时钟校准 (AD9833_SetMclk) 无关。
+  *
+  * 使用方法：
+  * 1. 调用 `AD9833_PhaseCal_Build()` 建立校准表。
+  * 2. 调用 `AD9833_CompFlash_FromPhaseCal()` 生成并应用补偿表，再调用
+  * `AD9833_CompFlash_Save()` 保存 (擦除扇区约需1~2秒)。
+  * 3. 之后上电时调用 `AD9833_CompFlash_Load()` 即可，改频直接使用
+  * `AD9833_FreqSet()`，不要再使用 `AD9833_PhaseCal_Retune()`，否则会重复补偿。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_CompFlash.h"
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+// 链接脚本中 CALIB 区域的起始地址
+extern const uint32_t _scalib[];
+#define AD9833_COMPFLASH_IMAGE      ((const AD9833_CompImage*)_scalib)
+
+// 生成补偿表用的RAM映像
+static AD9833_CompImage s_image = {0};
+
+// 交给驱动的补偿表描述, 驱动只保存指针, 须为静态变量
+static AD9833_CompTable s_table[2] = {0};
+
+/**
+ * @brief       计算CRC32 (多项式 0xEDB88320)
+ * @param       data: 数据
+ * @param       len: 字节数
+ * @retval      CRC32
+ */
+static uint32_t AD9833_CompFlash_Crc32(const uint8_t* data, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    while (len--)
+    {
+        crc ^= *data++;
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            crc = (crc & 1U) ? (crc >> 1) ^ 0xEDB88320UL : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @brief       计算映像的CRC (不含crc字段本身)
+ * @param       image: 映像
+ * @retval      CRC32
+ */
+static uint32_t AD9833_CompFlash_ImageCrc(const AD9833_CompImage* image)
+{
+    return AD9833_CompFlash_Crc32((const uint8_t*)image, offsetof(AD9833_CompImage, crc));
+}
+
+/**
+ * @brief       检查映像是否有效
+ * @param       image: 映像
+ * @retval      1: 有效; 0: 无效
+ */
+static uint8_t AD9833_CompFlash_Valid(const AD9833_CompImage* image)
+{
+    return (image->magic == AD9833_COMPFLASH_MAGIC &&
+            image->version == AD9833_COMPFLASH_VERSION &&
+            image->count >= 1U && image->count <= AD9833_COMPFLASH_MAX_POINTS &&
+            image->shift <= 27U &&
+            image->crc == AD9833_CompFlash_ImageCrc(image)) ? 1U : 0U;
+}
+
+/**
+ * @brief       将映像中的补偿表交给驱动
+ * @note        驱动直接引用映像中的数组, 映像须在使用期间保持有效
+ * @param       image: 映像 (RAM 或 FLASH)
+ * @retval      无
+ */
+static void AD9833_CompFlash_Apply(const AD9833_CompImage* image)
+{
+    for (uint8_t n = 0; n < 2; n++)
+    {
+        chipChose one = (n == 0) ? CS1 : CS2;
+
+        if (image->mask & (1U << n))
+        {
+            s_table[n].offset = image->offset[n];
+            s_table[n].count = image->count;
+            s_table[n].shift = (uint8_t)image->shift;
+            AD9833_SetCompTable(one, &s_table[n]);
+        }
+        else
+        {
+            AD9833_SetCompTable(one, NULL);
+        }
+    }
+}
+
+/**
+ * @brief       由相位校准表生成 CS2 的补偿表并立即应用
+ * @note        点间距取能覆盖校准频段的最小 2^shift, 超出校准频段的点取端点值;
+ *              CS1 不做补偿
+ * @retval      HAL_OK: 成功; HAL_ERROR: 校准表为空
+ */
+HAL_StatusTypeDef AD9833_CompFlash_FromPhaseCal(void)
+{
+    const AD9833_PhaseCalTable* cal = AD9833_PhaseCal_GetTable();
+
+    if (cal->count == 0) return HAL_ERROR;
+
+    // 选取点间距, 使 MAX_POINTS 个点覆盖到校准表的最高频率
+    uint32_t word_stop = AD9833_FreqToWord(CS2, cal->point[cal->count - 1U].freq);
+    uint32_t shift = 0;
+    while (((AD9833_COMPFLASH_MAX_POINTS - 1UL) << shift) < word_stop && shift < 27U)
+    {
+        shift++;
+    }
+
+    memset(&s_image, 0, sizeof(s_image));
+    s_image.magic = AD9833_COMPFLASH_MAGIC;
+    s_image.version = AD9833_COMPFLASH_VERSION;
+    s_image.mask = 1U << 1;     // 仅 CS2
+    s_image.count = AD9833_COMPFLASH_MAX_POINTS;
+    s_image.shift = shift;
+
+    for (uint16_t i = 0; i < AD9833_COMPFLASH_MAX_POINTS; i++)
+    {
+        double freq = (double)((uint32_t)i << shift) * AD9833_GetMclk(CS2) / (double)FREQ_REG_MAX;
+
+        // CS2 扣除附加相移, 折算为 1/65536 周并按周取模
+        long word = lround(-(double)AD9833_PhaseCal_GetOffset(freq) / 360.0 * 65536.0);
+        s_image.offset[1][i] = (int16_t)(uint16_t)(word & 0xFFFF);
+    }
+
+    s_image.crc = AD9833_CompFlash_ImageCrc(&s_image);
+    AD9833_CompFlash_Apply(&s_image);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief       将当前补偿表写入FLASH, 之后驱动改为引用FLASH中的表
+ * @note        擦除扇区期间CPU暂停取指, 约需1~2秒
+ * @retval      HAL_OK: 成功; HAL_ERROR: 没有可保存的补偿表或写入校验失败; 其他: FLASH操作失败
+ */
+HAL_StatusTypeDef AD9833_CompFlash_Save(void)
+{
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t sector_error = 0;
+    HAL_StatusTypeDef status;
+
+    if (!AD9833_CompFlash_Valid(&s_image)) return HAL_ERROR;
+
+    // 擦除前先让驱动改用RAM中的表
+    AD9833_CompFlash_Apply(&s_image);
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Sector = AD9833_COMPFLASH_SECTOR;
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+    HAL_FLASH_Unlock();
+    status = HAL_FLASHEx_Erase(&erase, &sector_error);
+
+    const uint32_t* src = (const uint32_t*)&s_image;
+    uint32_t addr = (uint32_t)_scalib;
+    for (uint32_t i = 0; status == HAL_OK && i < sizeof(s_image) / 4U; i++)
+    {
+        status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr + i * 4U, src[i]);
+    }
+    HAL_FLASH_Lock();
+
+    if (status != HAL_OK) return status;
+    if (memcmp(AD9833_COMPFLASH_IMAGE, &s_image, sizeof(s_image)) != 0) return HAL_ERROR;
+
+    AD9833_CompFlash_Apply(AD9833_COMPFLASH_IMAGE);
+    return HAL_OK;
+}
+
+/**
+ * @brief       从FLASH加载补偿表并应用
+ * @note        驱动直接引用FLASH中的表, 不复制到RAM
+ * @retval      HAL_OK: 成功; HAL_ERROR: FLASH中没有有效的补偿表, 当前补偿不变
+ */
+HAL_StatusTypeDef AD9833_CompFlash_Load(void)
+{
+    if (!AD9833_CompFlash_Valid(AD9833_COMPFLASH_IMAGE)) return HAL_ERROR;
+
+    AD9833_CompFlash_Apply(AD9833_COMPFLASH_IMAGE);
+    return HAL_OK;
+}
+
+/**
+ * @brief       关闭两个通道的补偿表
+ * @note        不擦除FLASH, 下次调用 AD9833_CompFlash_Load() 仍可恢复
+ * @retval      无
+ */
+void AD9833_CompFlash_Clear(void)
+{
+    AD9833_SetCompTable(CS_BOTH, NULL);
+    s_image.magic = 0;
+}
@@ -0,0 +1,45 @@
+#ifndef _AD9833_COMPFLASH_H
+#define _AD9833_COMPFLASH_H
+
+#include "main.h"
+#include "AD9833_Soft.h"
+#include "AD9833_PhaseCal.h"
+
+// 补偿表所在的FLASH扇区, 须与链接脚本中的 CALIB 区域 (_scalib) 一致
+#define AD9833_COMPFLASH_SECTOR     FLASH_SECTOR_7
+
+// 每个通道补偿表的最大点数
+#define AD9833_COMPFLASH_MAX_POINTS 129U
+
+// 存储格式标识 ("ADCT") 与版本, 格式改变时须修改版本号
+#define AD9833_COMPFLASH_MAGIC      0x54434441UL
+#define AD9833_COMPFLASH_VERSION    1U
+
+/**
+  * @brief 补偿表存储映像, 以字为单位整体写入FLASH
+  *     @arg magic: 存储格式标识
+  *     @arg version: 存储格式版本
+  *     @arg mask: 有效通道 (bit0: CS1, bit1: CS2)
+  *     @arg count: 每个通道的点数
+  *     @arg shift: 点间距, 为 2^shift 个频率字
+  *     @arg offset: 两个通道的补偿相位 (1/65536 周), 末尾多留一点使映像按字对齐
+  *     @arg crc: 以上内容的CRC32
+  */
+typedef struct
+{
+    uint32_t magic;
+    uint8_t version;
+    uint8_t mask;
+    uint16_t count;
+    uint32_t shift;
+    int16_t offset[2][AD9833_COMPFLASH_MAX_POINTS + 1U];
+    uint32_t crc;
+} AD9833_CompImage;
+
+/* 函数声明 */
+HAL_StatusTypeDef AD9833_CompFlash_FromPhaseCal(void);
+HAL_StatusTypeDef AD9833_CompFlash_Save(void);
+HAL_StatusTypeDef AD9833_CompFlash_Load(void);
+void AD9833_CompFlash_Clear(void);
+
+#endif /* _AD9833_COMPFLASH_H */
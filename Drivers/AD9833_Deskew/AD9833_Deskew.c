@@ -0,0 +1,210 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Deskew.c
+  * @brief          : 双芯片广播写入的时差测量与补偿
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-07
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * AD9833 在 FSYNC 为低期间的第16个 SCLK 下降沿锁存数据字，两片芯片共用
+  * SCLK/SDATA，只要两路片选都在第一个时钟沿之前拉低，广播写入的锁存时
+  * 刻就完全相同。驱动中的 `AD9833_ChipSelect()` 已将同端口的片选合并为
+  * 一次寄存器写入 (不同端口时为相邻的几次写入)，片选本身引入的时差只
+  * 是建立时间上的余量问题，本模块用 DWT 周期计数器测量这一间隔以供确认。
+  *
+  * 剩下的时差来自芯片内部 MCLK 同步 (最多1个MCLK周期) 和输出端的模拟
+  * 通路，表现为一个固定的时间延迟 dt，对应的相位差随频率线性变化：
+  *
+  *     phase = offset - 360 * f * dt
+  *
+  * 本模块将两路同步启动为方波，用 AD9833_PhaseMeter 在两个频率下测量平
+  * 均相位差，由斜率求出 dt，再调用 `AD9833_SetSkew()` 交给驱动补偿：之
+  * 后每次改频，驱动都会按当前频率重写 CS2 的相位寄存器。
+  *
+  * 此外 `AD9833_Cmd_SyncN()` 在各芯片控制字不同时分组依次启动，需要知
+  * 道一次写入的周期才能补偿各组的先后顺序。本模块同样用 DWT 测量背靠背
+  * 写入的周期，`AD9833_Deskew_Run()` 会一并交给驱动
+  * (`AD9833_SetFrameTime()`)。
+  *
+  * 测量结果只对当前的接线和软件SPI的时序有效，更换接线后需重新测量。
+  *
+  * 本模块只基于软件SPI驱动 (AD9833_Soft) 和 STM32 的 DWT、相位计
+  * (AD9833_PhaseMeter)。HAL硬件SPI驱动和 MSPM0 版本没有对应的测量，
+  * 须用示波器等方法测得时差后直接调用各自的 `AD9833_SetSkew()`。
+  *
+  * 使用方法：
+  * 1. 按 AD9833_PhaseMeter.c 文件头说明连接两路输出。
+  * 2. 调用 `AD9833_Deskew_Run()` 测量并应用补偿，两路输出会被改写，
+  *    完成后需重新配置输出。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_Deskew.h"
+
+/**
+ * @brief       使能 DWT 周期计数器
+ * @retval      无
+ */
+static void AD9833_Deskew_DwtInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief       测量广播写入时拉低两路片选的CPU周期数
+ * @note        扣除了读取计数器本身的开销, 包含函数调用的开销; 两路片选在同一
+ *              端口时只有一次写入, 两个边沿之间没有时差
+ * @retval      CPU周期数
+ */
+uint32_t AD9833_Deskew_CsCycles(void)
+{
+    uint32_t t0, t1, t2;
+
+    AD9833_Deskew_DwtInit();
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    t0 = DWT->CYCCNT;
+    t1 = DWT->CYCCNT;
+    AD9833_ChipSelect(CS_BOTH);
+    t2 = DWT->CYCCNT;
+    AD9833_ChipRelease(CS_BOTH);
+    __set_PRIMASK(primask);
+
+    uint32_t overhead = t1 - t0;
+    uint32_t cycles = t2 - t1;
+    return (cycles > overhead) ? cycles - overhead : 0U;
+}
+
+/**
+ * @brief       测量一次16位写入的CPU周期数
+ * @note        按同步启动时的方式背靠背写入, 片选交替为 CS1/CS2, 取平均值; 写入的
+ *              是复位控制字, 测量后两路处于复位状态, 需重新启动输出
+ * @retval      CPU周期数
+ */
+uint32_t AD9833_Deskew_FrameCycles(void)
+{
+    const uint16_t reset_cmd = AD9833_CMD_CTRLREG | AD9833_CTRL_B28 | AD9833_CTRL_RESET;
+    uint32_t t0, t1, t2;
+
+    AD9833_Deskew_DwtInit();
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    t0 = DWT->CYCCNT;
+    t1 = DWT->CYCCNT;
+    for (uint8_t i = 0; i < AD9833_DESKEW_FRAME_REPEAT; i++)
+    {
+        AD9833_Write(CS1, reset_cmd);
+        AD9833_Write(CS2, reset_cmd);
+    }
+    t2 = DWT->CYCCNT;
+    __set_PRIMASK(primask);
+
+    uint32_t overhead = t1 - t0;
+    uint32_t cycles = t2 - t1;
+    cycles = (cycles > overhead) ? cycles - overhead : 0U;
+    return cycles / (2U * AD9833_DESKEW_FRAME_REPEAT);
+}
+
+/**
+ * @brief       以方波同步启动两路并测量平均相位差
+ * @param       freq: 频率 (Hz)
+ * @param       phase: 输出平均相位差 (角度, CS2 超前为正)
+ * @retval      HAL_OK: 成功; HAL_ERROR: 无信号或测量溢出
+ */
+static HAL_StatusTypeDef AD9833_Deskew_Phase(double freq, float* phase)
+{
+    AD9833_InitTypedef AD9833 = {0};
+    AD9833_PhaseMeterStat stat;
+
+    AD9833.status = CS1_CS2_DOUBLE;
+    AD9833.AD_CS1.wave = SQUARE_WAVE;
+    AD9833.AD_CS1.freq = freq;
+    AD9833.AD_CS2.wave = SQUARE_WAVE;
+    AD9833.AD_CS2.freq = freq;
+    AD9833_Cmd_Sync(&AD9833);
+
+    HAL_Delay(AD9833_DESKEW_SETTLE_MS);
+
+    if (AD9833_PhaseMeter_Start() != HAL_OK) return HAL_ERROR;
+
+    uint32_t tickstart = HAL_GetTick();
+    while (HAL_GetTick() - tickstart < AD9833_DESKEW_GATE_MS)
+    {
+        AD9833_PhaseMeter_Process();
+    }
+
+    AD9833_PhaseMeter_Stop();
+    AD9833_PhaseMeter_GetStat(&stat);
+
+    if (stat.count == 0 || stat.overrun != 0) return HAL_ERROR;
+
+    *phase = stat.mean;
+    return HAL_OK;
+}
+
+/**
+ * @brief       测量 CS2 相对 CS1 的输出时差
+ * @note        测量期间暂时关闭驱动中的时差补偿, 结束后恢复原值
+ * @param       result: 输出测量结果
+ * @retval      HAL_OK: 成功; HAL_ERROR: 相位测量失败
+ */
+HAL_StatusTypeDef AD9833_Deskew_Measure(AD9833_DeskewResult* result)
+{
+    HAL_StatusTypeDef status;
+
+    if (!result) return HAL_ERROR;
+
+    result->cs_cycles = AD9833_Deskew_CsCycles();
+    result->frame_cycles = AD9833_Deskew_FrameCycles();
+
+    double skew_cs1 = AD9833_GetSkew(CS1);
+    double skew_cs2 = AD9833_GetSkew(CS2);
+    AD9833_SetSkew(CS_BOTH, 0.0);
+
+    status = AD9833_Deskew_Phase(AD9833_DESKEW_F1, &result->phase1);
+    if (status == HAL_OK)
+    {
+        status = AD9833_Deskew_Phase(AD9833_DESKEW_F2, &result->phase2);
+    }
+
+    AD9833_SetSkew(CS1, skew_cs1);
+    AD9833_SetSkew(CS2, skew_cs2);
+
+    if (status != HAL_OK) return status;
+
+    // phase = offset - 360 * f * dt, 两点求斜率
+    double slope = ((double)result->phase2 - (double)result->phase1) / (AD9833_DESKEW_F2 - AD9833_DESKEW_F1);
+    result->skew = -slope / 360.0;
+    result->offset = (float)((double)result->phase1 + 360.0 * AD9833_DESKEW_F1 * result->skew);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief       测量输出时差并交给驱动补偿
+ * @note        补偿只加在 CS2 上, CS1 的补偿值清零; 同时设置驱动的写入周期
+ * @param       result: 输出测量结果, 可为NULL
+ * @retval      同 AD9833_Deskew_Measure(), 失败时不修改当前补偿
+ */
+HAL_StatusTypeDef AD9833_Deskew_Run(AD9833_DeskewResult* result)
+{
+    AD9833_DeskewResult local;
+    AD9833_DeskewResult* r = result ? result : &local;
+
+    HAL_StatusTypeDef status = AD9833_Deskew_Measure(r);
+    if (status != HAL_OK) return status;
+
+    AD9833_SetSkew(CS1, 0.0);
+    AD9833_SetSkew(CS2, r->skew);
+    AD9833_SetFrameTime((double)r->frame_cycles / (double)SystemCoreClock);
+    return HAL_OK;
+}
@@ -0,0 +1,47 @@
+#ifndef _AD9833_DESKEW_H
+#define _AD9833_DESKEW_H
+
+#include "main.h"
+#include "AD9833_Soft.h"
+#include "AD9833_PhaseMeter.h"
+
+// 测量用的两个频率 (Hz), 由两点相位差的斜率求出时差
+// 高频点须满足 360 * F2 * |skew| < 180度, 1MHz 对应可测时差 ±500ns
+#define AD9833_DESKEW_F1            100000.0
+#define AD9833_DESKEW_F2            1000000.0
+
+// 每个频点的相位统计时间 (毫秒)
+#define AD9833_DESKEW_GATE_MS       200U
+
+// 同步启动后等待输出稳定的时间 (毫秒)
+#define AD9833_DESKEW_SETTLE_MS     2U
+
+// 测量写入周期时的重复次数 (每次写 CS1/CS2 各一次)
+#define AD9833_DESKEW_FRAME_REPEAT  8U
+
+/**
+  * @brief 时差测量结果
+  *     @arg cs_cycles: 广播写入时拉低两路片选所用的CPU周期数 (DWT)
+  *     @arg frame_cycles: 背靠背写入时一次16位写入的CPU周期数 (DWT)
+  *     @arg skew: CS2 相对 CS1 的输出时差 (秒), 正值表示 CS2 滞后
+  *     @arg offset: 与频率无关的固定相位差 (角度)
+  *     @arg phase1: 频点1 的平均相位差 (角度, CS2 超前为正)
+  *     @arg phase2: 频点2 的平均相位差 (角度, CS2 超前为正)
+  */
+typedef struct
+{
+    uint32_t cs_cycles;
+    uint32_t frame_cycles;
+    double skew;
+    float offset;
+    float phase1;
+    float phase2;
+} AD9833_DeskewResult;
+
+/* 函数声明 */
+uint32_t AD9833_Deskew_CsCycles(void);
+uint32_t AD9833_Deskew_FrameCycles(void);
+HAL_StatusTypeDef AD9833_Deskew_Measure(AD9833_DeskewResult* result);
+HAL_StatusTypeDef AD9833_Deskew_Run(AD9833_DeskewResult* result);
+
+#endif /* _AD9833_DESKEW_H */
@@ -0,0 +1,253 @@
+/**
+******************************************************************************
+  * @file           : AD9833_DualAdc.c
+  * @brief          : 双ADC同步采样与单频点相位/幅度提取
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-02
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 本模块使用 ADC1/ADC2 双重规则同步模式 (Dual Regular Simultaneous)，
+  * 由 TIM3 TRGO 以固定采样率触发，两路ADC在同一时刻采样，DMA以32位
+  * 字 (ADC2<<16 | ADC1) 搬运到内存。两路通道间不存在采样时刻差，因此
+  * 测得的相对相位只包含被测信号本身的相位差。
+  *
+  * 单频点分析使用 CMSIS-DSP 的 Q15 点积 (arm_dot_prod_q15) 与本地生成
+  * 的正交参考序列做相关，得到该频点的复数分量 (等效单点DFT)。当信号
+  * 频率高于 Fs/2 时按欠采样处理，自动折算到第一奈奎斯特区并修正相位
+  * 符号，注意避开混叠后落在直流或 Fs/2 附近的频率。
+  *
+  * 硬件连接：
+  * - PC0 (ADC1_IN10): 通道一 (CS1) 输出
+  * - PC1 (ADC2_IN11): 通道二 (CS2) 输出
+  *
+  * 使用方法：
+  * 1. 在CubeMX中按上述引脚配置ADC1/ADC2双重同步模式、DMA2_Stream0和TIM3。
+  * 2. 调用 `AD9833_DualAdc_Measure()` 采集并提取指定频率的复数分量。
+  * 3. 用 `AD9833_DualAdc_RelPhase()` 和 `AD9833_DualAdc_Magnitude()`
+  * 计算相对相位和幅度。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_DualAdc.h"
+#include <math.h>
+
+// DMA原始数据, 每个字的低16位为ADC1, 高16位为ADC2
+static uint32_t s_raw[AD9833_DUALADC_SAMPLES];
+
+// 拆分并去直流后的两路采样 (Q15)
+static q15_t s_ch1[AD9833_DUALADC_SAMPLES];
+static q15_t s_ch2[AD9833_DUALADC_SAMPLES];
+
+// 正交参考序列 (Q15)，按频率缓存，频率不变时无需重新生成
+static q15_t s_cos[AD9833_DUALADC_SAMPLES];
+static q15_t s_sin[AD9833_DUALADC_SAMPLES];
+static double s_ref_freq = -1.0;
+static uint8_t s_ref_conj = 0;
+
+// 采集完成标志, 在DMA完成回调中置位
+static volatile uint8_t s_capture_done = 0;
+
+/**
+ * @brief       ADC转换完成回调 (DMA传输完成)
+ * @param       hadc: ADC句柄
+ * @retval      无
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
+{
+    if (hadc->Instance == ADC1)
+    {
+        s_capture_done = 1;
+    }
+}
+
+/**
+ * @brief       将一路采样从原始数据中拆出, 缩放为Q15并去除直流分量
+ * @param       dst: 目标数组
+ * @param       shift: 该路数据在32位字中的位置 (0: ADC1, 16: ADC2)
+ * @retval      无
+ */
+static void AD9833_DualAdc_Split(q15_t* dst, uint8_t shift)
+{
+    q15_t mean;
+
+    for (uint32_t n = 0; n < AD9833_DUALADC_SAMPLES; n++)
+    {
+        // 12位结果左移3位, 满量程对应Q15的 0 ~ 0.9998
+        dst[n] = (q15_t)(((s_raw[n] >> shift) & 0x0FFFU) << 3);
+    }
+
+    arm_mean_q15(dst, AD9833_DUALADC_SAMPLES, &mean);
+    arm_offset_q15(dst, (q15_t)(-mean), dst, AD9833_DUALADC_SAMPLES);
+}
+
+/**
+ * @brief       生成指定频率的正交参考序列
+ * @note        频率高于 Fs/2 时折算到第一奈奎斯特区, 落在镜像区时
+ *              采样序列相当于原信号取共轭, 需要记录以修正相位符号
+ * @param       freq: 信号频率 (Hz)
+ * @retval      无
+ */
+static void AD9833_DualAdc_RefGen(double freq)
+{
+    if (freq == s_ref_freq) return;
+
+    double fa = fmod(freq, AD9833_DUALADC_FS);
+    s_ref_conj = 0;
+    if (fa > AD9833_DUALADC_FS / 2.0)
+    {
+        fa = AD9833_DUALADC_FS - fa;
+        s_ref_conj = 1;
+    }
+
+    // 32位相位累加器, 高15位即为 arm_sin_q15 所需的归一化角度 [0, 1)
+    uint32_t step = (uint32_t)(fa / AD9833_DUALADC_FS * 4294967296.0);
+    uint32_t acc = 0;
+    for (uint32_t n = 0; n < AD9833_DUALADC_SAMPLES; n++)
+    {
+        q15_t angle = (q15_t)(acc >> 17);
+        s_cos[n] = arm_cos_q15(angle);
+        s_sin[n] = arm_sin_q15(angle);
+        acc += step;
+    }
+
+    s_ref_freq = freq;
+}
+
+/**
+ * @brief       一路采样与参考序列做相关, 得到复数分量
+ * @param       x: 去直流后的采样 (Q15)
+ * @param       bin: 输出复数分量
+ * @retval      无
+ */
+static void AD9833_DualAdc_Correlate(const q15_t* x, AD9833_BinTypedef* bin)
+{
+    q63_t c, s;
+
+    arm_dot_prod_q15(x, s_cos, AD9833_DUALADC_SAMPLES, &c);
+    arm_dot_prod_q15(x, s_sin, AD9833_DUALADC_SAMPLES, &s);
+
+    // 每个乘积为Q30, 右移 log2N 得到均值 (Q30), 再左移1位得到Q31
+    bin->re = (q31_t)(c >> (AD9833_DUALADC_LOG2N - 1));
+    bin->im = (q31_t)(-(s >> (AD9833_DUALADC_LOG2N - 1)));
+
+    if (s_ref_conj)
+    {
+        bin->im = -bin->im;
+    }
+}
+
+/**
+ * @brief       启动一次双ADC同步采集, 阻塞等待完成
+ * @note        采集完成后两路数据已拆分、缩放为Q15并去除直流
+ * @retval      HAL_OK: 成功; HAL_ERROR: 启动失败; HAL_TIMEOUT: 超时
+ */
+HAL_StatusTypeDef AD9833_DualAdc_Capture(void)
+{
+    s_capture_done = 0;
+
+    // 从ADC须先使能, 由主ADC统一触发
+    if (HAL_ADC_Start(&hadc2) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    if (HAL_ADCEx_MultiModeStart_DMA(&hadc1, s_raw, AD9833_DUALADC_SAMPLES) != HAL_OK)
+    {
+        HAL_ADC_Stop(&hadc2);
+        return HAL_ERROR;
+    }
+    HAL_TIM_Base_Start(&htim3);
+
+    uint32_t tickstart = HAL_GetTick();
+    while (!s_capture_done)
+    {
+        if (HAL_GetTick() - tickstart > AD9833_DUALADC_TIMEOUT)
+        {
+            break;
+        }
+    }
+
+    HAL_TIM_Base_Stop(&htim3);
+    HAL_ADCEx_MultiModeStop_DMA(&hadc1);
+    HAL_ADC_Stop(&hadc2);
+
+    if (!s_capture_done)
+    {
+        return HAL_TIMEOUT;
+    }
+
+    AD9833_DualAdc_Split(s_ch1, 0);
+    AD9833_DualAdc_Split(s_ch2, 16);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief       从最近一次采集的数据中提取指定频率的复数分量
+ * @param       freq: 信号频率 (Hz), 可高于 Fs/2 (欠采样)
+ * @param       ch1: 通道一 (ADC1) 结果, 可为NULL
+ * @param       ch2: 通道二 (ADC2) 结果, 可为NULL
+ * @retval      无
+ */
+void AD9833_DualAdc_Bin(double freq, AD9833_BinTypedef* ch1, AD9833_BinTypedef* ch2)
+{
+    AD9833_DualAdc_RefGen(freq);
+
+    if (ch1) AD9833_DualAdc_Correlate(s_ch1, ch1);
+    if (ch2) AD9833_DualAdc_Correlate(s_ch2, ch2);
+}
+
+/**
+ * @brief       采集并提取指定频率的复数分量
+ * @param       freq: 信号频率 (Hz)
+ * @param       ch1: 通道一结果
+ * @param       ch2: 通道二结果
+ * @retval      同 AD9833_DualAdc_Capture()
+ */
+HAL_StatusTypeDef AD9833_DualAdc_Measure(double freq, AD9833_BinTypedef* ch1, AD9833_BinTypedef* ch2)
+{
+    HAL_StatusTypeDef status = AD9833_DualAdc_Capture();
+    if (status != HAL_OK) return status;
+
+    AD9833_DualAdc_Bin(freq, ch1, ch2);
+    return HAL_OK;
+}
+
+/**
+ * @brief       计算 sig 相对于 ref 的相位差
+ * @param       ref: 参考通道复数分量
+ * @param       sig: 被测通道复数分量
+ * @retval      相位差 (角度, -180 到 180度), sig超前为正
+ */
+float AD9833_DualAdc_RelPhase(const AD9833_BinTypedef* ref, const AD9833_BinTypedef* sig)
+{
+    float32_t rr = (float32_t)ref->re / 2147483648.0f;
+    float32_t ri = (float32_t)ref->im / 2147483648.0f;
+    float32_t sr = (float32_t)sig->re / 2147483648.0f;
+    float32_t si = (float32_t)sig->im / 2147483648.0f;
+    float32_t angle;
+
+    // sig * conj(ref)
+    arm_atan2_f32(si * rr - sr * ri, sr * rr + si * ri, &angle);
+
+    return angle * (float32_t)(180.0 / PI);
+}
+
+/**
+ * @brief       计算复数分量的幅度
+ * @param       bin: 复数分量
+ * @retval      幅度 (以ADC满量程为1, 正弦峰值的一半)
+ */
+float AD9833_DualAdc_Magnitude(const AD9833_BinTypedef* bin)
+{
+    q31_t mag;
+
+    // 输出为Q2.30
+    arm_cmplx_mag_q31((const q31_t*)bin, &mag, 1);
+
+    return (float)mag / 1073741824.0f;
+}
@@ -0,0 +1,38 @@
+#ifndef _AD9833_DUALADC_H
+#define _AD9833_DUALADC_H
+
+#include "main.h"
+#include "adc.h"
+#include "tim.h"
+
+// 每次采集的样点数, 必须为2的整数次幂
+#define AD9833_DUALADC_LOG2N        10U
+#define AD9833_DUALADC_SAMPLES      (1U << AD9833_DUALADC_LOG2N)
+
+// 采样率 (Hz), 由 TIM3 TRGO 触发: 84MHz / (83 + 1) = 1MHz
+#define AD9833_DUALADC_FS           1000000.0
+
+// 单次采集超时时间 (毫秒)
+#define AD9833_DUALADC_TIMEOUT      (20U)
+
+/**
+  * @brief 单频点复数分量 (Q31)
+  * @note  对输入 x[n] = A*cos(w*n + phi), 结果约为 (A/2)*e^(j*phi),
+  *        幅度以ADC满量程为1归一化
+  *     @arg re: 实部 (同相分量)
+  *     @arg im: 虚部 (正交分量)
+  */
+typedef struct
+{
+    q31_t re;
+    q31_t im;
+} AD9833_BinTypedef;
+
+/* 函数声明 */
+HAL_StatusTypeDef AD9833_DualAdc_Capture(void);
+void AD9833_DualAdc_Bin(double freq, AD9833_BinTypedef* ch1, AD9833_BinTypedef* ch2);
+HAL_StatusTypeDef AD9833_DualAdc_Measure(double freq, AD9833_BinTypedef* ch1, AD9833_BinTypedef* ch2);
+float AD9833_DualAdc_RelPhase(const AD9833_BinTypedef* ref, const AD9833_BinTypedef* sig);
+float AD9833_DualAdc_Magnitude(const AD9833_BinTypedef* bin);
+
+#endif /* _AD9833_DUALADC_H */
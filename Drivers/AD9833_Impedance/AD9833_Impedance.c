@@ -0,0 +1,265 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Impedance.c
+  * @brief          : 扫频阻抗分析 (AD9833激励 + 双ADC同步采样)
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-06
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 以 CS1 的正弦输出经被测件 (DUT) 与已知参考电阻 Rref 串联到地，双ADC
+  * 同步采样 DUT 两端的电压：
+  *
+  *     CS1 VOUT ──┬── DUT ──┬── Rref ── GND
+  *                Va        Vb
+  *             (ADC1/PC0) (ADC2/PC1)
+  *
+  * 回路电流 I = Vb / Rref，DUT 两端电压 Vdut = Va - Vb，因此
+  *
+  *     Z = Rref * (Va - Vb) / Vb
+  *
+  * 两路在同一时刻采样，Va、Vb 的复数分量由 AD9833_DualAdc 以相关运算
+  * 求得，阻抗的计算全部使用 CMSIS-DSP 的 Q31 定点函数：复数相减、共轭
+  * 相乘求相角 (arm_atan2_q31)，分别求模后定点相除得到模值之比，只在最
+  * 后乘以 Rref 时转为浮点。
+  *
+  * 扫频时每个频点的结果以 CSV 格式 (频率,|Z|,相角) 通过串口输出，扫频
+  * 结束后在 |Z| 曲线上以抛物线插值检测串联/并联谐振点并一同输出。
+  *
+  * 使用方法：
+  * 1. 按上图连接，ADC 配置见 AD9833_DualAdc.c 文件头说明。
+  * 2. 用 `AD9833_Impedance_SetRref()` 设置参考电阻的实际阻值，阻值应与
+  * 被测阻抗在同一数量级。
+  * 3. 调用 `AD9833_Impedance_Sweep()` 扫频，CS2 在扫频期间关闭。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_Impedance.h"
+#include <stdio.h>
+#include <math.h>
+
+// 参考电阻阻值 (欧姆)
+static double s_rref = AD9833_IMPEDANCE_RREF;
+
+// 最近一次扫频的结果与参数
+static AD9833_ImpedancePoint s_points[AD9833_IMPEDANCE_MAX_POINTS];
+static uint16_t s_count = 0;
+static double s_start = 0.0;
+static double s_stop = 0.0;
+static uint8_t s_log = 0;
+
+/**
+ * @brief       设置参考电阻阻值
+ * @param       rref: 参考电阻 (欧姆), 须大于0
+ * @retval      无
+ */
+void AD9833_Impedance_SetRref(double rref)
+{
+    if (rref > 0.0)
+    {
+        s_rref = rref;
+    }
+}
+
+/**
+ * @brief       测量单个频点的阻抗
+ * @note        只做采集与计算, 不改变 AD9833 的输出频率
+ * @param       freq: 当前激励频率 (Hz)
+ * @param       point: 输出阻抗
+ * @retval      HAL_OK: 成功; HAL_ERROR: 参考电阻上无信号 (开路); 其他: 采集失败
+ */
+HAL_StatusTypeDef AD9833_Impedance_Measure(double freq, AD9833_ImpedancePoint* point)
+{
+    AD9833_BinTypedef va, vb, vdut, vb_conj, prod;
+    q31_t mag_dut, mag_ref, quotient, angle;
+    int16_t shift;
+
+    if (!point) return HAL_ERROR;
+
+    HAL_StatusTypeDef status = AD9833_DualAdc_Measure(freq, &va, &vb);
+    if (status != HAL_OK) return status;
+
+    // Vdut = Va - Vb
+    arm_sub_q31((const q31_t*)&va, (const q31_t*)&vb, (q31_t*)&vdut, 2);
+
+    // |Vdut| 与 |Vb|, 均为 Q2.30
+    arm_cmplx_mag_q31((const q31_t*)&vdut, &mag_dut, 1);
+    arm_cmplx_mag_q31((const q31_t*)&vb, &mag_ref, 1);
+
+    if ((float)mag_ref / 1073741824.0f < AD9833_IMPEDANCE_MIN_MAG)
+    {
+        return HAL_ERROR;
+    }
+
+    // arg(Z) = arg(Vdut * conj(Vb)), 乘积为 Q3.29, 相角为 Q2.29 弧度
+    arm_cmplx_conj_q31((const q31_t*)&vb, (q31_t*)&vb_conj, 1);
+    arm_cmplx_mult_cmplx_q31((const q31_t*)&vdut, (const q31_t*)&vb_conj, (q31_t*)&prod, 1);
+    arm_atan2_q31(prod.im, prod.re, &angle);
+
+    // |Z| / Rref = |Vdut| / |Vb| = quotient * 2^shift (quotient 为 Q31)
+    arm_divide_q31(mag_dut, mag_ref, &quotient, &shift);
+
+    point->freq = freq;
+    point->mag = (float)(s_rref * ldexp((double)quotient, shift - 31));
+    point->phase = (float)angle / 536870912.0f * (float)(180.0 / PI);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief       计算扫频第 idx 个点的频率
+ * @note        idx 可为小数, 用于插值后换算谐振频率
+ * @param       idx: 点序号
+ * @retval      频率 (Hz)
+ */
+static double AD9833_Impedance_FreqAt(double idx)
+{
+    double t = (s_count > 1) ? idx / (double)(s_count - 1) : 0.0;
+
+    if (s_log)
+    {
+        return s_start * pow(s_stop / s_start, t);
+    }
+    return s_start + (s_stop - s_start) * t;
+}
+
+/**
+ * @brief       扫频测量阻抗, 并通过串口输出结果
+ * @note        使用 CS1 的0号频率/相位寄存器输出正弦波, 扫频中改频不复位,
+ *              相位连续; 单个频点测量失败时该点模值与相角记为0
+ * @param       freq_start: 起始频率 (Hz)
+ * @param       freq_stop: 终止频率 (Hz), 须大于起始频率
+ * @param       points: 频点数 (2 到 AD9833_IMPEDANCE_MAX_POINTS)
+ * @param       log_scale: 频点分布
+ *                  @arg 0: 线性等间隔
+ *                  @arg 1: 对数等间隔
+ * @retval      HAL_OK: 成功; HAL_ERROR: 参数错误
+ */
+HAL_StatusTypeDef AD9833_Impedance_Sweep(double freq_start, double freq_stop, uint16_t points, uint8_t log_scale)
+{
+    AD9833_InitTypedef AD9833 = {0};
+    AD9833_ResonanceTypedef res;
+
+    if (points < 2 || points > AD9833_IMPEDANCE_MAX_POINTS || freq_stop <= freq_start)
+    {
+        return HAL_ERROR;
+    }
+    if (log_scale && freq_start <= 0.0)
+    {
+        return HAL_ERROR;
+    }
+
+    s_start = freq_start;
+    s_stop = freq_stop;
+    s_log = log_scale;
+    s_count = points;
+
+    // CS1 单独输出正弦波激励
+    AD9833.status = CS1_SINGLE;
+    AD9833.AD_CS1.wave = SINE_WAVE;
+    AD9833.AD_CS1.freq = freq_start;
+    AD9833_Cmd(&AD9833);
+
+    printf("freq_hz,z_ohm,phase_deg\r\n");
+
+    for (uint16_t i = 0; i < points; i++)
+    {
+        double freq = AD9833_Impedance_FreqAt(i);
+
+        AD9833_FreqSet(CS1, 0, freq);
+        HAL_Delay(AD9833_IMPEDANCE_SETTLE_MS);
+
+        if (AD9833_Impedance_Measure(freq, &s_points[i]) != HAL_OK)
+        {
+            s_points[i].freq = freq;
+            s_points[i].mag = 0.0f;
+            s_points[i].phase = 0.0f;
+        }
+
+        printf("%.3f,%.4g,%.2f\r\n", s_points[i].freq, s_points[i].mag, s_points[i].phase);
+    }
+
+    AD9833_Impedance_FindResonance(&res);
+    if (res.found)
+    {
+        printf("# fr=%.3f Hz, |Z|=%.4g ohm; fa=%.3f Hz, |Z|=%.4g ohm; keff=%.4f\r\n",
+               res.fr, res.zr, res.fa, res.za, res.keff);
+    }
+    else
+    {
+        printf("# resonance not found\r\n");
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief       在极值点附近做抛物线插值
+ * @param       k: 极值点序号 (1 到 count-2)
+ * @param       value: 输出插值后的极值
+ * @retval      插值后的序号 (小数)
+ */
+static double AD9833_Impedance_Parabolic(uint16_t k, float* value)
+{
+    float y0 = s_points[k - 1].mag;
+    float y1 = s_points[k].mag;
+    float y2 = s_points[k + 1].mag;
+    float den = y0 - 2.0f * y1 + y2;
+    float delta = 0.0f;
+
+    if (den != 0.0f)
+    {
+        delta = 0.5f * (y0 - y2) / den;
+    }
+
+    *value = y1 - 0.25f * (y0 - y2) * delta;
+    return (double)k + (double)delta;
+}
+
+/**
+ * @brief       在最近一次扫频结果中检测谐振点
+ * @param       res: 输出谐振检测结果
+ * @retval      无
+ */
+void AD9833_Impedance_FindResonance(AD9833_ResonanceTypedef* res)
+{
+    uint16_t kmin = 0, kmax = 0;
+
+    if (!res) return;
+    res->found = 0;
+    if (s_count < 3) return;
+
+    // 测量失败的点模值为0, 不参与极小值搜索
+    for (uint16_t i = 1; i < s_count; i++)
+    {
+        if (s_points[i].mag > 0.0f &&
+            (s_points[kmin].mag <= 0.0f || s_points[i].mag < s_points[kmin].mag)) kmin = i;
+        if (s_points[i].mag > s_points[kmax].mag) kmax = i;
+    }
+
+    // 极值在端点时说明谐振点不在扫频范围内
+    if (kmin == 0 || kmin == s_count - 1 || kmax == 0 || kmax == s_count - 1)
+    {
+        return;
+    }
+
+    res->fr = AD9833_Impedance_FreqAt(AD9833_Impedance_Parabolic(kmin, &res->zr));
+    res->fa = AD9833_Impedance_FreqAt(AD9833_Impedance_Parabolic(kmax, &res->za));
+    res->keff = (res->fa > res->fr) ? (float)sqrt(1.0 - (res->fr / res->fa) * (res->fr / res->fa)) : 0.0f;
+    res->found = 1;
+}
+
+/**
+ * @brief       获取最近一次扫频的结果
+ * @param       count: 输出点数, 可为NULL
+ * @retval      指向结果数组的指针
+ */
+const AD9833_ImpedancePoint* AD9833_Impedance_GetResult(uint16_t* count)
+{
+    if (count) *count = s_count;
+    return s_points;
+}
@@ -0,0 +1,61 @@
+#ifndef _AD9833_IMPEDANCE_H
+#define _AD9833_IMPEDANCE_H
+
+#include "main.h"
+#include "AD9833_Soft.h"
+#include "AD9833_DualAdc.h"
+
+// 参考电阻默认阻值 (欧姆), 可用 AD9833_Impedance_SetRref() 修改
+#define AD9833_IMPEDANCE_RREF       1000.0
+
+// 单次扫频最大点数
+#define AD9833_IMPEDANCE_MAX_POINTS 201U
+
+// 改变频率后等待被测件稳定的时间 (毫秒)
+#define AD9833_IMPEDANCE_SETTLE_MS  2U
+
+// 参考电阻上的最小有效幅度 (以ADC满量程为1), 低于此值认为回路开路
+#define AD9833_IMPEDANCE_MIN_MAG    0.002f
+
+/**
+  * @brief 单个频点的阻抗
+  *     @arg freq: 频率 (Hz)
+  *     @arg mag: 阻抗模值 (欧姆)
+  *     @arg phase: 阻抗相角 (角度, -180 到 180度), 感性为正
+  */
+typedef struct
+{
+    double freq;
+    float mag;
+    float phase;
+} AD9833_ImpedancePoint;
+
+/**
+  * @brief 谐振检测结果
+  * @note  以抛物线插值求出 |Z| 极小值 (串联谐振) 与极大值 (并联谐振) 的位置,
+  *        极值落在扫频端点时视为未检测到
+  *     @arg found: 1: 同时检测到两个谐振点; 0: 未检测到
+  *     @arg fr: 串联谐振频率 (Hz)
+  *     @arg zr: 串联谐振处的 |Z| (欧姆)
+  *     @arg fa: 并联谐振频率 (Hz)
+  *     @arg za: 并联谐振处的 |Z| (欧姆)
+  *     @arg keff: 有效机电耦合系数, sqrt(1 - (fr/fa)^2), 仅对压电器件有意义
+  */
+typedef struct
+{
+    uint8_t found;
+    double fr;
+    float zr;
+    double fa;
+    float za;
+    float keff;
+} AD9833_ResonanceTypedef;
+
+/* 函数声明 */
+void AD9833_Impedance_SetRref(double rref);
+HAL_StatusTypeDef AD9833_Impedance_Measure(double freq, AD9833_ImpedancePoint* point);
+HAL_StatusTypeDef AD9833_Impedance_Sweep(double freq_start, double freq_stop, uint16_t points, uint8_t log_scale);
+void AD9833_Impedance_FindResonance(AD9833_ResonanceTypedef* res);
+const AD9833_ImpedancePoint* AD9833_Impedance_GetResult(uint16_t* count);
+
+#endif /* _AD9833_IMPEDANCE_H */
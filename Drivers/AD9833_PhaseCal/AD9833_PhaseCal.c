@@ -0,0 +1,226 @@
+/**
+******************************************************************************
+  * @file           : AD9833_PhaseCal.c
+  * @brief          : 双通道相位自动校准 (基于双ADC同步采样)
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-02
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * `AD9833_Cmd_Sync()` 只能保证两片芯片内部相位累加器同时启动，但输出
+  * 端的重建滤波器、放大器和走线会引入随频率变化的附加相移，使两路实际
+  * 输出的相位差偏离设定值。
+  *
+  * 本模块用双ADC同步采样两路输出，以相关运算测得两路的实际相位差，与
+  * 设定值比较得到附加相移，并在一组频点上建立校准表。之后调用
+  * `AD9833_PhaseCal_Retune()` 改频时，会按校准表插值得到当前频率的附加
+  * 相移，并在写入CS2的相位寄存器时自动扣除。
+  *
+  * 使用方法：
+  * 1. 按 AD9833_DualAdc.c 文件头说明连接两路输出到ADC输入。
+  * 2. 调用 `AD9833_PhaseCal_Build()` 在工作频段内建立校准表
+  * (校准过程中两路输出会被改写为同频同相的正弦波)。
+  * 3. 之后用 `AD9833_PhaseCal_Retune()` 代替 `AD9833_FreqSet()` 与
+  * `AD9833_PhaseSet()` 改频改相，相位补偿自动生效。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_PhaseCal.h"
+#include <math.h>
+
+// 校准表, 保存在RAM中
+static AD9833_PhaseCalTable s_table = {0};
+
+/**
+ * @brief       将角度折算到 [0, 360) 范围内
+ * @param       phase: 角度
+ * @retval      折算后的角度
+ */
+static double AD9833_PhaseCal_Wrap(double phase)
+{
+    phase = fmod(phase, 360.0);
+    if (phase < 0.0)
+    {
+        phase += 360.0;
+    }
+    return phase;
+}
+
+/**
+ * @brief       测量指定频率下CS2相对CS1的附加相移
+ * @note        会以同频同相的正弦波同步启动两个通道, 覆盖当前输出
+ * @param       freq: 测量频率 (Hz)
+ * @param       offset: 输出附加相移 (角度, -180 到 180度)
+ * @retval      HAL_OK: 成功; HAL_ERROR: 信号幅度过小; 其他: 采集失败
+ */
+HAL_StatusTypeDef AD9833_PhaseCal_Measure(double freq, float* offset)
+{
+    AD9833_InitTypedef AD9833 = {0};
+    AD9833_BinTypedef ch1, ch2;
+    float32_t sum_cos = 0.0f, sum_sin = 0.0f;
+
+    if (!offset) return HAL_ERROR;
+
+    // 两路设定为同频同相, 测得的相位差即为附加相移
+    AD9833.status = CS1_CS2_DOUBLE;
+    AD9833.AD_CS1.wave = SINE_WAVE;
+    AD9833.AD_CS1.freq = freq;
+    AD9833.AD_CS2.wave = SINE_WAVE;
+    AD9833.AD_CS2.freq = freq;
+    AD9833_Cmd_Sync(&AD9833);
+
+    HAL_Delay(AD9833_PHASECAL_SETTLE_MS);
+
+    // 以单位向量求平均, 避免 ±180度 附近直接平均出错
+    for (uint8_t i = 0; i < AD9833_PHASECAL_AVERAGE; i++)
+    {
+        HAL_StatusTypeDef status = AD9833_DualAdc_Measure(freq, &ch1, &ch2);
+        if (status != HAL_OK) return status;
+
+        if (AD9833_DualAdc_Magnitude(&ch1) < AD9833_PHASECAL_MIN_MAG ||
+            AD9833_DualAdc_Magnitude(&ch2) < AD9833_PHASECAL_MIN_MAG)
+        {
+            return HAL_ERROR;
+        }
+
+        float32_t angle = AD9833_DualAdc_RelPhase(&ch1, &ch2);
+        sum_cos += arm_cos_f32(angle * (float32_t)(PI / 180.0));
+        sum_sin += arm_sin_f32(angle * (float32_t)(PI / 180.0));
+    }
+
+    float32_t mean;
+    arm_atan2_f32(sum_sin, sum_cos, &mean);
+    *offset = mean * (float32_t)(180.0 / PI);
+
+    return HAL_OK;
+}
+
+/**
+ * @brief       在频段内等间隔测量并建立校准表
+ * @note        相邻频点的附加相移会做相位展开, 保证插值连续; 测量期间暂时关闭
+ *              驱动中的相位补偿表, 结束后恢复
+ * @param       freq_start: 起始频率 (Hz)
+ * @param       freq_stop: 终止频率 (Hz), 须大于起始频率
+ * @param       points: 频点数 (2 到 AD9833_PHASECAL_MAX_POINTS)
+ * @retval      HAL_OK: 成功; 其他: 某个频点测量失败, 校准表被清空
+ */
+HAL_StatusTypeDef AD9833_PhaseCal_Build(double freq_start, double freq_stop, uint16_t points)
+{
+    if (points < 2 || points > AD9833_PHASECAL_MAX_POINTS || freq_stop <= freq_start)
+    {
+        return HAL_ERROR;
+    }
+
+    s_table.count = 0;
+
+    const AD9833_CompTable* comp_cs1 = AD9833_GetCompTable(CS1);
+    const AD9833_CompTable* comp_cs2 = AD9833_GetCompTable(CS2);
+    AD9833_SetCompTable(CS_BOTH, NULL);
+
+    for (uint16_t i = 0; i < points; i++)
+    {
+        double freq = freq_start + (freq_stop - freq_start) * i / (points - 1);
+        float offset;
+
+        HAL_StatusTypeDef status = AD9833_PhaseCal_Measure(freq, &offset);
+        if (status != HAL_OK)
+        {
+            s_table.count = 0;
+            AD9833_SetCompTable(CS1, comp_cs1);
+            AD9833_SetCompTable(CS2, comp_cs2);
+            return status;
+        }
+
+        // 相位展开
+        if (i > 0)
+        {
+            float prev = s_table.point[i - 1].offset;
+            while (offset - prev > 180.0f) offset -= 360.0f;
+            while (offset - prev < -180.0f) offset += 360.0f;
+        }
+
+        s_table.point[i].freq = freq;
+        s_table.point[i].offset = offset;
+    }
+
+    s_table.count = points;
+    AD9833_SetCompTable(CS1, comp_cs1);
+    AD9833_SetCompTable(CS2, comp_cs2);
+    return HAL_OK;
+}
+
+/**
+ * @brief       按校准表线性插值得到指定频率的附加相移
+ * @note        超出校准频段时取端点值, 校准表为空时返回0
+ * @param       freq: 频率 (Hz)
+ * @retval      附加相移 (角度)
+ */
+float AD9833_PhaseCal_GetOffset(double freq)
+{
+    const AD9833_PhaseCalPoint* p = s_table.point;
+    uint16_t n = s_table.count;
+
+    if (n == 0) return 0.0f;
+    if (freq <= p[0].freq) return p[0].offset;
+    if (freq >= p[n - 1].freq) return p[n - 1].offset;
+
+    // 二分查找所在区间 [lo, lo + 1]
+    uint16_t lo = 0, hi = n - 1;
+    while (hi - lo > 1)
+    {
+        uint16_t mid = (lo + hi) / 2;
+        if (p[mid].freq <= freq)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    double t = (freq - p[lo].freq) / (p[hi].freq - p[lo].freq);
+    return (float)(p[lo].offset + t * (p[hi].offset - p[lo].offset));
+}
+
+/**
+ * @brief       带相位补偿的改频
+ * @note        两个通道写入相同的频率字, CS2的相位按校准表扣除附加相移,
+ *              使两路实际输出的相位差等于 phase_cs2 - phase_cs1
+ * @param       freq_reg: 频率寄存器编号 (0 或 1)
+ * @param       phase_reg: 相位寄存器编号 (0 或 1)
+ * @param       freq: 频率 (Hz)
+ * @param       phase_cs1: 通道一相位 (角度)
+ * @param       phase_cs2: 通道二相位 (角度)
+ * @retval      无
+ */
+void AD9833_PhaseCal_Retune(uint8_t freq_reg, uint8_t phase_reg, double freq, double phase_cs1, double phase_cs2)
+{
+    float offset = AD9833_PhaseCal_GetOffset(freq);
+
+    AD9833_FreqSet(CS_BOTH, freq_reg, freq);
+    AD9833_PhaseSet(CS1, phase_reg, AD9833_PhaseCal_Wrap(phase_cs1));
+    AD9833_PhaseSet(CS2, phase_reg, AD9833_PhaseCal_Wrap(phase_cs2 - offset));
+}
+
+/**
+ * @brief       清空校准表, 之后的改频不再补偿
+ * @retval      无
+ */
+void AD9833_PhaseCal_Clear(void)
+{
+    s_table.count = 0;
+}
+
+/**
+ * @brief       获取当前校准表
+ * @retval      指向校准表的指针
+ */
+const AD9833_PhaseCalTable* AD9833_PhaseCal_GetTable(void)
+{
+    return &s_table;
+}
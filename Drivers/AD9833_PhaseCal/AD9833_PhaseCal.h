@@ -0,0 +1,50 @@
+#ifndef _AD9833_PHASECAL_H
+#define _AD9833_PHASECAL_H
+
+#include "main.h"
+#include "AD9833_Soft.h"
+#include "AD9833_DualAdc.h"
+
+// 校准表最大频点数
+#define AD9833_PHASECAL_MAX_POINTS  32U
+
+// 改变频率后等待输出滤波器稳定的时间 (毫秒)
+#define AD9833_PHASECAL_SETTLE_MS   5U
+
+// 每个频点的采集平均次数
+#define AD9833_PHASECAL_AVERAGE     4U
+
+// 有效信号的最小幅度 (以ADC满量程为1), 低于此值认为通道无输出
+#define AD9833_PHASECAL_MIN_MAG     0.01f
+
+/**
+  * @brief 校准表中的单个频点
+  *     @arg freq: 频率 (Hz)
+  *     @arg offset: 该频率下CS2相对CS1的附加相移 (角度), 由外部滤波器、走线等引入
+  */
+typedef struct
+{
+    double freq;
+    float offset;
+} AD9833_PhaseCalPoint;
+
+/**
+  * @brief 相位校准表, 频点按频率升序排列
+  *     @arg count: 有效频点数
+  *     @arg point: 频点数组
+  */
+typedef struct
+{
+    uint16_t count;
+    AD9833_PhaseCalPoint point[AD9833_PHASECAL_MAX_POINTS];
+} AD9833_PhaseCalTable;
+
+/* 函数声明 */
+HAL_StatusTypeDef AD9833_PhaseCal_Measure(double freq, float* offset);
+HAL_StatusTypeDef AD9833_PhaseCal_Build(double freq_start, double freq_stop, uint16_t points);
+float AD9833_PhaseCal_GetOffset(double freq);
+void AD9833_PhaseCal_Retune(uint8_t freq_reg, uint8_t phase_reg, double freq, double phase_cs1, double phase_cs2);
+void AD9833_PhaseCal_Clear(void);
+const AD9833_PhaseCalTable* AD9833_PhaseCal_GetTable(void);
+
+#endif /* _AD9833_PHASECAL_H */
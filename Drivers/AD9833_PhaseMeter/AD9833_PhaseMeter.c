@@ -0,0 +1,331 @@
+/**
+******************************************************************************
+  * @file           : AD9833_PhaseMeter.c
+  * @brief          : 基于定时器输入捕获的双通道方波相位测量
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-05
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 两片 AD9833 都输出方波 (SQUARE_WAVE) 时，用同一个32位定时器 (TIM5)
+  * 的两个通道捕获两路上升沿，两路时间戳来自同一个计数器，可直接相减
+  * 得到边沿时间差，再除以周期换算为相位差。无需ADC，适合生产测试中
+  * 快速检查 `AD9833_Cmd_Sync()` 的同步效果和长时间的相位漂移。
+  *
+  * 捕获值由 DMA (循环模式) 直接搬入两个环形缓冲区，不使用任何中断，
+  * 所有计算都在主循环调用 `AD9833_PhaseMeter_Process()` 时完成：
+  * - 频率: 以统计开始以来通道一的总周期数除以总计数时长 (倒数计数)。
+  * - 相位: 两路按边沿顺序配对，时间差对周期取模并折算到 ±180 度，
+  *   因此配对时两路相差整数个周期不影响结果。
+  * - 统计: 每次处理的一批数据先以当前均值为中心求和，再与总体合并
+  *   (Welford/Chan 合并算法)，均值和方差在长时间运行下也不损失精度。
+  *
+  * 硬件连接：
+  * - PA0 (TIM5_CH1): CS1 的 VOUT
+  * - PA1 (TIM5_CH2): CS2 的 VOUT
+  *
+  * 使用方法：
+  * 1. 在CubeMX中配置 TIM5 通道1/2为输入捕获，并分别添加 DMA1_Stream2/
+  * DMA1_Stream4 (循环模式, 字传输)。
+  * 2. 将两路配置为同频方波输出，调用 `AD9833_PhaseMeter_Start()`。
+  * 3. 在主循环中周期性调用 `AD9833_PhaseMeter_Process()`，两次调用间隔
+  * 内的边沿数不能超过环形缓冲区长度，用 `AD9833_PhaseMeter_GetStat()`
+  * 读取结果。
+  * 4. 本模块与 AD9833_ClkCal 共用 TIM5，两者不能同时运行。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_PhaseMeter.h"
+#include <math.h>
+
+// DMA 环形缓冲区, 保存两路的捕获值
+static uint32_t s_ring1[AD9833_PHASEMETER_RING];
+static uint32_t s_ring2[AD9833_PHASEMETER_RING];
+
+// 两路的读位置
+static uint32_t s_rd1 = 0;
+static uint32_t s_rd2 = 0;
+
+// 通道一上一个边沿的时间戳, 用于累计周期
+static uint32_t s_prev_t1 = 0;
+static uint8_t s_prev_valid = 0;
+
+// 上次处理时的计数器值, 用于判断缓冲区是否被覆盖
+static uint32_t s_last_cnt = 0;
+
+// 通道一的累计计数时长与周期数
+static uint64_t s_ticks = 0;
+static uint32_t s_periods = 0;
+
+// 统计量
+static uint32_t s_count = 0;
+static double s_mean = 0.0;
+static double s_m2 = 0.0;
+static float s_min = 0.0f;
+static float s_max = 0.0f;
+static float s_phase = 0.0f;
+static uint32_t s_overrun = 0;
+
+static uint8_t s_running = 0;
+
+/**
+ * @brief       获取 TIM5 的计数时钟频率
+ * @note        APB1 分频系数不为1时, 定时器时钟为 PCLK1 的两倍
+ * @retval      计数时钟频率 (Hz)
+ */
+static uint32_t AD9833_PhaseMeter_TimerClock(void)
+{
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+    {
+        pclk1 *= 2U;
+    }
+    return pclk1;
+}
+
+/**
+ * @brief       获取 DMA 当前的写位置
+ * @param       hdma: DMA句柄
+ * @retval      下一个将被写入的下标
+ */
+static uint32_t AD9833_PhaseMeter_WritePos(DMA_HandleTypeDef* hdma)
+{
+    return (AD9833_PHASEMETER_RING - __HAL_DMA_GET_COUNTER(hdma)) % AD9833_PHASEMETER_RING;
+}
+
+/**
+ * @brief       将输入捕获通道配置为不分频的上升沿捕获
+ * @param       channel: 定时器通道
+ * @retval      HAL状态
+ */
+static HAL_StatusTypeDef AD9833_PhaseMeter_ConfigChannel(uint32_t channel)
+{
+    TIM_IC_InitTypeDef sConfigIC = {0};
+
+    sConfigIC.ICPolarity = TIM_INPUTCHANNELPOLARITY_RISING;
+    sConfigIC.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    sConfigIC.ICPrescaler = TIM_ICPSC_DIV1;
+    sConfigIC.ICFilter = 0;
+    return HAL_TIM_IC_ConfigChannel(&htim5, &sConfigIC, channel);
+}
+
+/**
+ * @brief       启动相位测量
+ * @note        统计量会被清零
+ * @retval      HAL_OK: 成功; HAL_ERROR: 配置或DMA启动失败
+ */
+HAL_StatusTypeDef AD9833_PhaseMeter_Start(void)
+{
+    if (s_running) AD9833_PhaseMeter_Stop();
+
+    if (AD9833_PhaseMeter_ConfigChannel(TIM_CHANNEL_1) != HAL_OK ||
+        AD9833_PhaseMeter_ConfigChannel(TIM_CHANNEL_2) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+
+    // 只启动DMA, 不打开DMA和定时器的中断
+    if (HAL_DMA_Start(htim5.hdma[TIM_DMA_ID_CC1], (uint32_t)&htim5.Instance->CCR1,
+                      (uint32_t)s_ring1, AD9833_PHASEMETER_RING) != HAL_OK)
+    {
+        return HAL_ERROR;
+    }
+    if (HAL_DMA_Start(htim5.hdma[TIM_DMA_ID_CC2], (uint32_t)&htim5.Instance->CCR2,
+                      (uint32_t)s_ring2, AD9833_PHASEMETER_RING) != HAL_OK)
+    {
+        HAL_DMA_Abort(htim5.hdma[TIM_DMA_ID_CC1]);
+        return HAL_ERROR;
+    }
+
+    s_rd1 = 0;
+    s_rd2 = 0;
+    s_prev_valid = 0;
+    s_overrun = 0;
+    AD9833_PhaseMeter_ResetStat();
+
+    __HAL_TIM_ENABLE_DMA(&htim5, TIM_DMA_CC1 | TIM_DMA_CC2);
+    TIM_CCxChannelCmd(htim5.Instance, TIM_CHANNEL_1, TIM_CCx_ENABLE);
+    TIM_CCxChannelCmd(htim5.Instance, TIM_CHANNEL_2, TIM_CCx_ENABLE);
+    s_last_cnt = __HAL_TIM_GET_COUNTER(&htim5);
+    __HAL_TIM_ENABLE(&htim5);
+
+    s_running = 1;
+    return HAL_OK;
+}
+
+/**
+ * @brief       停止相位测量, 统计结果保留
+ * @retval      无
+ */
+void AD9833_PhaseMeter_Stop(void)
+{
+    __HAL_TIM_DISABLE_DMA(&htim5, TIM_DMA_CC1 | TIM_DMA_CC2);
+    TIM_CCxChannelCmd(htim5.Instance, TIM_CHANNEL_1, TIM_CCx_DISABLE);
+    TIM_CCxChannelCmd(htim5.Instance, TIM_CHANNEL_2, TIM_CCx_DISABLE);
+    __HAL_TIM_DISABLE(&htim5);
+
+    HAL_DMA_Abort(htim5.hdma[TIM_DMA_ID_CC1]);
+    HAL_DMA_Abort(htim5.hdma[TIM_DMA_ID_CC2]);
+
+    s_running = 0;
+}
+
+/**
+ * @brief       处理新捕获的边沿, 更新频率与相位统计
+ * @note        在主循环中调用, 两次调用间隔内的边沿数须小于
+ *              AD9833_PHASEMETER_RING - AD9833_PHASEMETER_MARGIN,
+ *              否则丢弃本批数据并记一次溢出
+ * @retval      本次处理的边沿对数
+ */
+uint32_t AD9833_PhaseMeter_Process(void)
+{
+    if (!s_running) return 0;
+
+    uint32_t now = __HAL_TIM_GET_COUNTER(&htim5);
+    uint32_t wr1 = AD9833_PhaseMeter_WritePos(htim5.hdma[TIM_DMA_ID_CC1]);
+    uint32_t wr2 = AD9833_PhaseMeter_WritePos(htim5.hdma[TIM_DMA_ID_CC2]);
+
+    // 按经过的时间估算边沿数, 超过缓冲区长度说明数据已被覆盖, 重新同步
+    if (s_periods > 0)
+    {
+        float period = (float)s_ticks / (float)s_periods;
+        if ((float)(now - s_last_cnt) / period > (float)(AD9833_PHASEMETER_RING - AD9833_PHASEMETER_MARGIN))
+        {
+            s_rd1 = wr1;
+            s_rd2 = wr2;
+            s_prev_valid = 0;
+            s_last_cnt = now;
+            s_overrun++;
+            return 0;
+        }
+    }
+    s_last_cnt = now;
+
+    uint32_t avail1 = (wr1 + AD9833_PHASEMETER_RING - s_rd1) % AD9833_PHASEMETER_RING;
+    uint32_t avail2 = (wr2 + AD9833_PHASEMETER_RING - s_rd2) % AD9833_PHASEMETER_RING;
+    uint32_t pairs = (avail1 < avail2) ? avail1 : avail2;
+
+    // 通道一的全部边沿用于累计周期
+    uint32_t rd = s_rd1;
+    for (uint32_t i = 0; i < avail1; i++)
+    {
+        uint32_t t1 = s_ring1[rd];
+        if (s_prev_valid)
+        {
+            s_ticks += (uint32_t)(t1 - s_prev_t1);
+            s_periods++;
+        }
+        s_prev_t1 = t1;
+        s_prev_valid = 1;
+        rd = (rd + 1U) % AD9833_PHASEMETER_RING;
+    }
+
+    if (s_periods == 0 || pairs == 0)
+    {
+        s_rd1 = wr1;
+        return 0;
+    }
+
+    float period = (float)s_ticks / (float)s_periods;
+
+    // 以当前均值为中心展开本批数据, 首批以第一个样点为中心
+    float center = (float)s_mean;
+    float sum = 0.0f, sum_sq = 0.0f;
+    uint8_t first = (s_count == 0);
+
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        int32_t dt = (int32_t)(s_ring2[s_rd2] - s_ring1[s_rd1]);
+        s_rd1 = (s_rd1 + 1U) % AD9833_PHASEMETER_RING;
+        s_rd2 = (s_rd2 + 1U) % AD9833_PHASEMETER_RING;
+
+        // CS2 的边沿晚于 CS1 即为滞后, 相位差为负
+        float cycles = (float)dt / period;
+        float phase = -(cycles - roundf(cycles)) * 360.0f;
+        s_phase = phase;
+
+        if (first)
+        {
+            center = phase;
+            first = 0;
+        }
+        float x = phase - center;
+        if (x > 180.0f) x -= 360.0f;
+        if (x < -180.0f) x += 360.0f;
+
+        if (s_count == 0 && i == 0)
+        {
+            s_min = x + center;
+            s_max = x + center;
+        }
+        if (x + center < s_min) s_min = x + center;
+        if (x + center > s_max) s_max = x + center;
+
+        sum += x;
+        sum_sq += x * x;
+    }
+
+    // 合并本批统计量
+    double nb = (double)pairs;
+    double na = (double)s_count;
+    double mean_b = (double)center + (double)sum / nb;
+    double m2_b = (double)sum_sq - (double)sum * (double)sum / nb;
+    double delta = mean_b - s_mean;
+
+    s_count += pairs;
+    s_mean += delta * nb / (double)s_count;
+    s_m2 += m2_b + delta * delta * na * nb / (double)s_count;
+
+    // 剩余的边沿: 通道一已全部用于周期累计, 通道二最多保留一个待配对
+    s_rd1 = wr1;
+    if ((wr2 + AD9833_PHASEMETER_RING - s_rd2) % AD9833_PHASEMETER_RING > 1U)
+    {
+        s_rd2 = (wr2 + AD9833_PHASEMETER_RING - 1U) % AD9833_PHASEMETER_RING;
+    }
+
+    return pairs;
+}
+
+/**
+ * @brief       读取当前统计结果
+ * @param       stat: 输出统计结果
+ * @retval      无
+ */
+void AD9833_PhaseMeter_GetStat(AD9833_PhaseMeterStat* stat)
+{
+    if (!stat) return;
+
+    double mean = fmod(s_mean, 360.0);
+    if (mean > 180.0) mean -= 360.0;
+    if (mean <= -180.0) mean += 360.0;
+
+    stat->count = s_count;
+    stat->freq = (s_ticks > 0) ? (double)s_periods * AD9833_PhaseMeter_TimerClock() / (double)s_ticks : 0.0;
+    stat->phase = s_phase;
+    stat->mean = (float)mean;
+    stat->std = (s_count > 1) ? (float)sqrt(s_m2 / (double)(s_count - 1U)) : 0.0f;
+    stat->min = s_min;
+    stat->max = s_max;
+    stat->overrun = s_overrun;
+}
+
+/**
+ * @brief       清零统计量 (包括频率), 溢出计数保留
+ * @retval      无
+ */
+void AD9833_PhaseMeter_ResetStat(void)
+{
+    s_ticks = 0;
+    s_periods = 0;
+    s_count = 0;
+    s_mean = 0.0;
+    s_m2 = 0.0;
+    s_min = 0.0f;
+    s_max = 0.0f;
+    s_phase = 0.0f;
+}
@@ -0,0 +1,43 @@
+#ifndef _AD9833_PHASEMETER_H
+#define _AD9833_PHASEMETER_H
+
+#include "main.h"
+#include "tim.h"
+
+// 每个通道的捕获环形缓冲区长度 (边沿数), 两次处理之间的边沿数不能超过此值
+#define AD9833_PHASEMETER_RING      256U
+
+// 溢出判定余量 (边沿数), 距上次处理的边沿数超过 RING - MARGIN 即认为数据已被覆盖
+#define AD9833_PHASEMETER_MARGIN    8U
+
+/**
+  * @brief 相位测量统计结果
+  *     @arg count: 参与统计的边沿对数
+  *     @arg freq: 通道一频率 (Hz), 以统计开始以来的全部周期求得
+  *     @arg phase: 最近一对边沿的相位差 (角度, -180 到 180度), CS2超前为正
+  *     @arg mean: 平均相位差 (角度)
+  *     @arg std: 相位差标准差 (角度)
+  *     @arg min: 最小相位差 (角度, 以平均值为中心展开)
+  *     @arg max: 最大相位差 (角度, 以平均值为中心展开)
+  *     @arg overrun: 处理不及时导致数据被覆盖的次数
+  */
+typedef struct
+{
+    uint32_t count;
+    double freq;
+    float phase;
+    float mean;
+    float std;
+    float min;
+    float max;
+    uint32_t overrun;
+} AD9833_PhaseMeterStat;
+
+/* 函数声明 */
+HAL_StatusTypeDef AD9833_PhaseMeter_Start(void);
+void AD9833_PhaseMeter_Stop(void);
+uint32_t AD9833_PhaseMeter_Process(void);
+void AD9833_PhaseMeter_GetStat(AD9833_PhaseMeterStat* stat);
+void AD9833_PhaseMeter_ResetStat(void);
+
+#endif /* _AD9833_PHASEMETER_H */
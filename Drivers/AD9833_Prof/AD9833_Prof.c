@@ -0,0 +1,161 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Prof.c
+  * @brief          : 驱动接口的DWT周期计数统计
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-14
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 定义 AD9833_PROF_ENABLE 后，驱动 (AD9833_Soft / AD9833_HAL) 的每个公开
+  * 接口和每次传输层发送在入口和出口各读一次 DWT->CYCCNT，差值按函数累计
+  * 为次数、最短、最长和总和，保存在RAM中。测量只增加两次计数器读取和几条
+  * 比较加法；不定义时所有测量点展开为空语句，本文件也不参与编译输出。
+  *
+  * 注意：
+  * - 耗时包含中断服务程序，被中断的调用会拉高 max，min 和平均值更可靠。
+  * - 接口内部调用其他接口时两者各自计数，例如 AD9833_FreqSet() 的耗时包含
+  *   其中的 AD9833_Write()，不要将各行相加。
+  * - 其他模块 (如 AD9833_Deskew) 会将 CYCCNT 清零，测量点正在计时时清零会
+  *   得到一个异常大的 max，调用 `AD9833_Prof_Reset()` 即可清除。
+  * - MSPM0 (Cortex-M0+) 没有 DWT 周期计数器，不支持本模块。
+  *
+  * 使用方法：
+  * 1. 在编译选项中定义 AD9833_PROF_ENABLE，第一次调用 `AD9833_Init()` 时
+  *    使能计数器并清空统计，之后可随时调用 `AD9833_Prof_Reset()` 重新开始。
+  * 2. 需要时调用 `AD9833_Prof_Dump(&huart1)` 输出CSV，每个测量点一行：
+  *    name,count,min,max,mean (CPU周期)。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_Prof.h"
+
+#if defined(AD9833_PROF_ENABLE)
+
+#include <stdio.h>
+
+// 输出格式版本, 列定义变化时加1
+#define AD9833_PROF_FORMAT          1U
+
+AD9833_ProfRecord AD9833_Prof_Table[AD9833_PROF_NUM];
+
+static const char* const s_name[AD9833_PROF_NUM] = {
+    [AD9833_PROF_XFER]          = "xfer",
+    [AD9833_PROF_WRITE]         = "AD9833_Write",
+    [AD9833_PROF_INIT]          = "AD9833_Init",
+    [AD9833_PROF_FREQ_SET]      = "AD9833_FreqSet",
+    [AD9833_PROF_FREQ_SET_RAW]  = "AD9833_FreqSetRaw",
+    [AD9833_PROF_PHASE_SET]     = "AD9833_PhaseSet",
+    [AD9833_PROF_SET_WAVE]      = "AD9833_SetWaveformAndStart",
+    [AD9833_PROF_SELECT_FREQ]   = "AD9833_SelectFreqReg",
+    [AD9833_PROF_SELECT_PHASE]  = "AD9833_SelectPhaseReg",
+    [AD9833_PROF_RESET]         = "AD9833_Reset",
+    [AD9833_PROF_SLEEP]         = "AD9833_Sleep",
+    [AD9833_PROF_CMD]           = "AD9833_Cmd",
+    [AD9833_PROF_CMD_SYNC]      = "AD9833_Cmd_Sync",
+    [AD9833_PROF_CMD_SYNC_N]    = "AD9833_Cmd_SyncN",
+    [AD9833_PROF_STAGE_CTRL]    = "AD9833_StageCtrl",
+    [AD9833_PROF_STAGE_LATCH]   = "AD9833_StageLatch",
+    [AD9833_PROF_STAGE_RELEASE] = "AD9833_StageRelease",
+};
+
+// 统计是否已清空过
+static uint8_t s_ready = 0;
+
+/**
+ * @brief       使能 DWT 周期计数器, 首次调用时清空统计
+ * @note        由 AD9833_Init() 调用, 之后再调用 (如每次 AD9833_Cmd()) 不清空统计;
+ *              计数器已在运行时不清零, 以免打断其他模块的测量
+ * @retval      无
+ */
+void AD9833_Prof_Init(void)
+{
+    if (s_ready) return;
+
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    AD9833_Prof_Reset();
+    s_ready = 1;
+}
+
+/**
+ * @brief       清空全部测量点的统计
+ * @retval      无
+ */
+void AD9833_Prof_Reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    for (uint32_t i = 0; i < AD9833_PROF_NUM; i++)
+    {
+        AD9833_Prof_Table[i] = (AD9833_ProfRecord){ 0, UINT32_MAX, 0, 0 };
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief       读取一个测量点的统计
+ * @note        关中断复制, 得到的四项彼此一致; 没有调用过时 min 为 0
+ * @param       id: 测量点编号
+ * @param       record: 输出的统计
+ * @retval      无
+ */
+void AD9833_Prof_Get(AD9833_ProfId id, AD9833_ProfRecord* record)
+{
+    if (id >= AD9833_PROF_NUM || !record) return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *record = AD9833_Prof_Table[id];
+    __set_PRIMASK(primask);
+
+    if (record->count == 0) record->min = 0;
+}
+
+/**
+ * @brief       测量点名称
+ * @param       id: 测量点编号
+ * @retval      名称, 编号无效时为 "?"
+ */
+const char* AD9833_Prof_Name(AD9833_ProfId id)
+{
+    return (id < AD9833_PROF_NUM) ? s_name[id] : "?";
+}
+
+/**
+ * @brief       通过串口输出全部测量点的统计 (CSV)
+ * @note        阻塞发送; 第一行为 "# ad9833_prof,<格式版本>,<内核时钟Hz>"
+ * @param       huart: 串口句柄
+ * @retval      无
+ */
+void AD9833_Prof_Dump(UART_HandleTypeDef* huart)
+{
+    char line[96];
+    int len;
+
+    len = snprintf(line, sizeof(line), "# ad9833_prof,%u,%lu\r\nname,count,min,max,mean\r\n",
+                   (unsigned)AD9833_PROF_FORMAT, (unsigned long)SystemCoreClock);
+    HAL_UART_Transmit(huart, (const uint8_t*)line, (uint16_t)len, HAL_MAX_DELAY);
+
+    for (uint32_t i = 0; i < AD9833_PROF_NUM; i++)
+    {
+        AD9833_ProfRecord rec;
+        AD9833_Prof_Get((AD9833_ProfId)i, &rec);
+
+        uint32_t mean = rec.count ? (uint32_t)((rec.sum + rec.count / 2U) / rec.count) : 0U;
+        len = snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu\r\n", s_name[i],
+                       (unsigned long)rec.count, (unsigned long)rec.min, (unsigned long)rec.max, (unsigned long)mean);
+        HAL_UART_Transmit(huart, (const uint8_t*)line, (uint16_t)len, HAL_MAX_DELAY);
+    }
+}
+
+#endif /* AD9833_PROF_ENABLE */
@@ -0,0 +1,89 @@
+#ifndef _AD9833_PROF_H
+#define _AD9833_PROF_H
+
+#include "main.h"
+
+/**
+  * @brief 测量点编号, 每个被测函数一项
+  * @note  AD9833_PROF_XFER 为传输层一次发送 (软件SPI移位或 HAL_SPI_Transmit),
+  *        其余为同名的公开接口; 接口内部调用的其他接口和发送同时各自计数
+  */
+typedef enum
+{
+    AD9833_PROF_XFER = 0,
+    AD9833_PROF_WRITE,
+    AD9833_PROF_INIT,
+    AD9833_PROF_FREQ_SET,
+    AD9833_PROF_FREQ_SET_RAW,
+    AD9833_PROF_PHASE_SET,
+    AD9833_PROF_SET_WAVE,
+    AD9833_PROF_SELECT_FREQ,
+    AD9833_PROF_SELECT_PHASE,
+    AD9833_PROF_RESET,
+    AD9833_PROF_SLEEP,
+    AD9833_PROF_CMD,
+    AD9833_PROF_CMD_SYNC,
+    AD9833_PROF_CMD_SYNC_N,
+    AD9833_PROF_STAGE_CTRL,
+    AD9833_PROF_STAGE_LATCH,
+    AD9833_PROF_STAGE_RELEASE,
+    AD9833_PROF_NUM
+} AD9833_ProfId;
+
+/**
+  * @brief 一个测量点的累计结果 (CPU周期, 含函数内部的全部开销)
+  *     @arg count: 调用次数
+  *     @arg min: 最短耗时
+  *     @arg max: 最长耗时
+  *     @arg sum: 累计耗时, 平均值 = sum / count
+  */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} AD9833_ProfRecord;
+
+#if defined(AD9833_PROF_ENABLE)
+
+extern AD9833_ProfRecord AD9833_Prof_Table[AD9833_PROF_NUM];
+
+/**
+ * @brief       累计一次测量
+ * @note        内联在被测函数的出口, 只有几条比较和加法
+ * @param       id: 测量点编号
+ * @param       cycles: 本次耗时 (CPU周期)
+ * @retval      无
+ */
+static inline void AD9833_Prof_Record(AD9833_ProfId id, uint32_t cycles)
+{
+    AD9833_ProfRecord* rec = &AD9833_Prof_Table[id];
+
+    rec->count++;
+    rec->sum += cycles;
+    if (cycles < rec->min) rec->min = cycles;
+    if (cycles > rec->max) rec->max = cycles;
+}
+
+// 在被测函数入口 (参数检查之后) 和每个出口成对使用
+#define AD9833_PROF_BEGIN(id)       uint32_t ad9833_prof_start_ = DWT->CYCCNT
+#define AD9833_PROF_END(id)         AD9833_Prof_Record((id), DWT->CYCCNT - ad9833_prof_start_)
+#define AD9833_PROF_INIT()          AD9833_Prof_Init()
+
+#else
+
+#define AD9833_PROF_BEGIN(id)       ((void)0)
+#define AD9833_PROF_END(id)         ((void)0)
+#define AD9833_PROF_INIT()          ((void)0)
+
+#endif /* AD9833_PROF_ENABLE */
+
+/* 函数声明 */
+void AD9833_Prof_Init(void);
+void AD9833_Prof_Reset(void);
+void AD9833_Prof_Get(AD9833_ProfId id, AD9833_ProfRecord* record);
+const char* AD9833_Prof_Name(AD9833_ProfId id);
+void AD9833_Prof_Dump(UART_HandleTypeDef* huart);
+
+#endif /* _AD9833_PROF_H */
@@ -0,0 +1,684 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Proto.c
+  * @brief          : 上位机串口命令协议的解析与执行
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-17
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 帧格式：
+  *
+  *     0xA5 | LEN | CMD | 数据 (LEN 字节) | CRC8
+  *
+  * CRC8 为多项式 0x07、初值 0 的 CRC，覆盖 LEN、CMD 和数据。每个校验通过的
+  * 帧回复一个应答帧，命令字为 CMD | 0x80，数据段第一个字节为
+  * AD9833_ProtoStatus，之后为该命令的应答数据。
+  *
+  * 解析器逐字节接收，在不超过一帧长度的窗口内查找帧头；长度超限或校验
+  * 错误时只丢弃帧头字节，从窗口中的下一个 0xA5 重新同步，因此数据中出现
+  * 的 0xA5 或半帧不会吞掉后面的有效帧。帧内两次收到数据的间隔超过
+  * AD9833_PROTO_TIMEOUT_MS 时丢弃未收完的帧。解析本身不等待、不分配内存，
+  * 每个字节的处理时间有上界；序列播放由 AD9833_Seq_Poll() 在主循环中或
+  * AD9833_Seq_Tick() 在定时器中断中进行 (SEQ_MODE 切换)，不在解析中执行。
+  *
+  * 窗口是环形缓冲区中的一段 (起点 rd、长度 n)，丢弃字节只移动起点。
+  * `AD9833_Proto_Input()` 把数据逐字节放进内部的窗口缓冲区；
+  * `AD9833_Proto_RxStart()` 之后窗口直接建在串口接收 DMA 的循环缓冲区上：
+  * DMA 以 HAL_UARTEx_ReceiveToIdle_DMA 循环接收，空闲线 (IDLE)、半满 (HT)、
+  * 全满 (TC) 中断中调用 `AD9833_Proto_RxEvent()` 记下写入位置，
+  * `AD9833_Proto_RxPoll()` 在 DMA 缓冲区中原地解析到该位置，逐字节的处理与
+  * Input 完全相同，没有逐字节中断，也不复制数据；只有数据段跨过缓冲区末尾
+  * 的帧才拷贝一次数据段再执行。HT/TC 保证写入位置至少每半个缓冲区上报一
+  * 次，未收完的帧加上两次上报之间的半个缓冲区不能超过缓冲区，因此缓冲区
+  * 至少两帧长 (AD9833_PROTO_RX_MIN)。两次 RxPoll 的间隔须小于半个缓冲区的
+  * 传输时间 (256 字节、115200bps 时约 11ms)；间隔过长、DMA 已覆盖尚未解析的数据时，丢弃窗口和未解析的
+  * 字节 (计入 lost) 后从最新位置重新同步。接收错误 (噪声、帧错误) 时 HAL 中止
+  * DMA，错误回调中调用 `AD9833_Proto_RxRestart()` 记下出错时的写入位置再重新
+  * 启动接收，DMA 从缓冲区起点写入；回调只置标志，下一次 RxPoll 在主循环中
+  * 丢弃窗口和出错前未解析的字节 (计入 lost) 后从缓冲区起点继续解析。
+  *
+  * 数据字表 (AD9833_Table，主机上由 ad9833_plan 编译) 用 TABLE_WRITE 分段
+  * 写入 AD9833_PROTO_TABLE_SIZE 字节的缓冲区，TABLE_RUN 检查后开始播放。
+  * 序列和数据字表互斥，任一正在播放时另一个的 RUN 和直接写入芯片的命令
+  * 返回 AD9833_PROTO_ERR_BUSY。数据字表不经过驱动的影子控制寄存器，结束时
+  * 芯片可能停在 B28=0 的半字模式；表结束或停止后，下一条直接写入芯片的
+  * 命令或 SEQ_RUN 先调用 `AD9833_CtrlRestore()` 按影子寄存器重写表中芯片的
+  * 控制字 (频率、相位寄存器保持表写入的值)。
+  *
+  * 本模块基于软件SPI驱动 (AD9833_Soft)。
+  *
+  * 使用方法：
+  * 1. 调用 `AD9833_Proto_Init()` 设定应答的发送函数和帧外字节的处理函数。
+  * 2. 收到数据后调用 `AD9833_Proto_Input()` (可以是任意长度的片段)；
+  *    或者调用 `AD9833_Proto_RxStart()` 登记 DMA 循环缓冲区后启动接收，
+  *    在接收事件回调中调用 `AD9833_Proto_RxEvent()`，在接收错误回调中调用
+  *    `AD9833_Proto_RxRestart()` 后重新启动接收，在主循环中调用
+  *    `AD9833_Proto_RxPoll()` (两种方式不混用)。
+  * 3. 在主循环中调用 `AD9833_Seq_Poll()`，在定时器更新中断中调用
+  *    `AD9833_Seq_Tick()` 和 `AD9833_Table_Tick()`。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_Proto.h"
+#include "AD9833_Soft.h"
+#include "AD9833_Seq.h"
+#include "AD9833_Table.h"
+#include <string.h>
+
+/**
+ * @brief   解析状态
+ *      @arg send: 应答发送函数
+ *      @arg other: 帧外字节处理函数
+ *      @arg win: Input 方式的窗口缓冲区
+ *      @arg frame: 跨过缓冲区末尾的数据段的拷贝
+ *      @arg buf: 窗口所在的环形缓冲区 (win 或 DMA 缓冲区)
+ *      @arg size: 环形缓冲区字节数
+ *      @arg rd: 窗口起点, buf[rd] 为帧头
+ *      @arg n: 窗口中的字节数
+ *      @arg t_last: 最近一次收到数据的时刻 (HAL_GetTick)
+ *      @arg rx_total: DMA 已写入的总字节数 (接收事件中更新)
+ *      @arg rx_head: 上一次接收事件时 DMA 的写入位置
+ *      @arg rx_read: 已送入解析的总字节数
+ *      @arg rx_restart: 接收错误后 DMA 已从缓冲区起点重新写入, 等待 RxPoll 重新同步
+ *      @arg rx_restart_total: 重新启动时 DMA 已写入的总字节数
+ *      @arg table_chips: 播放过数据字表、控制字尚未按影子寄存器重写的芯片
+ *      @arg stat: 统计
+ */
+typedef struct
+{
+    AD9833_ProtoSend send;
+    AD9833_ProtoOther other;
+    uint8_t win[AD9833_PROTO_FRAME_MAX];
+    uint8_t frame[AD9833_PROTO_PAYLOAD_MAX];
+    const uint8_t* buf;
+    uint32_t size;
+    uint32_t rd;
+    uint32_t n;
+    uint32_t t_last;
+    volatile uint32_t rx_total;
+    uint32_t rx_head;
+    uint32_t rx_read;
+    volatile uint8_t rx_restart;
+    volatile uint32_t rx_restart_total;
+    chipChose table_chips;
+    AD9833_ProtoStat stat;
+} AD9833_ProtoParser;
+
+static AD9833_ProtoParser s_proto;
+
+// TABLE_WRITE 写入、TABLE_RUN 播放的数据字表
+static uint8_t s_table[AD9833_PROTO_TABLE_SIZE];
+
+/**
+ * @brief       初始化解析器
+ * @note        同时停止数据字表的播放并清空表缓冲区, 不重写表中芯片的控制字,
+ *              之后用 AD9833_Init() 或 AD9833_Cmd() 初始化芯片
+ * @param       send: 应答发送函数, NULL 时不应答
+ * @param       other: 帧外字节处理函数, 可为 NULL
+ * @retval      无
+ */
+void AD9833_Proto_Init(AD9833_ProtoSend send, AD9833_ProtoOther other)
+{
+    AD9833_Table_Stop();
+    memset(s_table, 0, sizeof(s_table));
+    memset(&s_proto, 0, sizeof(s_proto));
+    s_proto.send = send;
+    s_proto.other = other;
+    s_proto.buf = s_proto.win;
+    s_proto.size = sizeof(s_proto.win);
+}
+
+/**
+ * @brief       改为在串口接收 DMA 的循环缓冲区中原地解析
+ * @note        在启动 DMA 接收之前调用, DMA 从 ring[0] 开始写入
+ * @param       ring: DMA 循环缓冲区
+ * @param       size: 字节数, 不小于 AD9833_PROTO_RX_MIN
+ * @retval      HAL_OK: 成功; HAL_ERROR: 缓冲区过小
+ */
+HAL_StatusTypeDef AD9833_Proto_RxStart(const uint8_t* ring, uint16_t size)
+{
+    if (!ring || size < AD9833_PROTO_RX_MIN) return HAL_ERROR;
+
+    s_proto.buf = ring;
+    s_proto.size = size;
+    s_proto.rd = 0;
+    s_proto.n = 0;
+    s_proto.rx_total = 0;
+    s_proto.rx_head = 0;
+    s_proto.rx_read = 0;
+    return HAL_OK;
+}
+
+/**
+ * @brief       CRC8 加入一个字节
+ * @param       crc: 当前值
+ * @param       byte: 字节
+ * @retval      新的值
+ */
+static uint8_t AD9833_Proto_CrcByte(uint8_t crc, uint8_t byte)
+{
+    crc ^= byte;
+    for (uint8_t b = 0; b < 8U; b++)
+    {
+        crc = (crc & 0x80U) ? (uint8_t)((crc << 1) ^ 0x07U) : (uint8_t)(crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * @brief       CRC8 (多项式 0x07, 初值 0)
+ * @param       data: 数据
+ * @param       len: 字节数
+ * @retval      CRC
+ */
+uint8_t AD9833_Proto_Crc8(const uint8_t* data, uint32_t len)
+{
+    uint8_t crc = 0;
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc = AD9833_Proto_CrcByte(crc, data[i]);
+    }
+    return crc;
+}
+
+/**
+ * @brief       组帧
+ * @param       cmd: 命令字
+ * @param       payload: 数据, len 为0时可为 NULL
+ * @param       len: 数据字节数
+ * @param       frame: 输出, 至少 len + 4 字节
+ * @retval      帧的字节数, 数据过长时为0
+ */
+uint16_t AD9833_Proto_Encode(uint8_t cmd, const uint8_t* payload, uint8_t len, uint8_t* frame)
+{
+    if (len > AD9833_PROTO_PAYLOAD_MAX) return 0;
+
+    frame[0] = AD9833_PROTO_SOF;
+    frame[1] = len;
+    frame[2] = cmd;
+    if (len) memcpy(&frame[3], payload, len);
+    frame[3U + len] = AD9833_Proto_Crc8(&frame[1], len + 2U);
+
+    return (uint16_t)(len + 4U);
+}
+
+/**
+ * @brief       发送应答
+ * @param       cmd: 请求的命令字
+ * @param       status: 执行结果
+ * @param       data: 应答数据
+ * @param       len: 应答数据字节数
+ * @retval      无
+ */
+static void AD9833_Proto_Reply(uint8_t cmd, AD9833_ProtoStatus status, const uint8_t* data, uint8_t len)
+{
+    uint8_t payload[16];
+    uint8_t frame[sizeof(payload) + 4U];
+
+    if (status != AD9833_PROTO_OK) s_proto.stat.rejected++;
+    if (!s_proto.send) return;
+
+    payload[0] = (uint8_t)status;
+    if (len) memcpy(&payload[1], data, len);
+    s_proto.send(frame, AD9833_Proto_Encode(cmd | AD9833_PROTO_REPLY, payload, (uint8_t)(len + 1U), frame));
+}
+
+/**
+ * @brief       芯片掩码是否有效
+ * @param       mask: 掩码
+ * @retval      1: 有效; 0: 无效
+ */
+static uint8_t AD9833_Proto_MaskOk(uint8_t mask)
+{
+    return (mask && !(mask & ~CS_ALL)) ? 1U : 0U;
+}
+
+/**
+ * @brief       序列或数据字表是否正在播放
+ * @retval      1: 正在播放; 0: 空闲
+ */
+static uint8_t AD9833_Proto_Playing(void)
+{
+    AD9833_SeqState seq;
+    AD9833_TableState table;
+
+    AD9833_Seq_GetState(&seq);
+    AD9833_Table_GetState(&table);
+    return (seq.running || table.running) ? 1U : 0U;
+}
+
+/**
+ * @brief       数据字表结束后按影子寄存器重写表中芯片的控制字
+ * @note        在经过驱动的命令之前调用; 表仍在播放时不调用
+ * @retval      HAL_OK: 无需重写或已重写; HAL_BUSY: 预置写入未结束, 下次再重写
+ */
+static HAL_StatusTypeDef AD9833_Proto_TableRestore(void)
+{
+    if (!s_proto.table_chips) return HAL_OK;
+    if (AD9833_CtrlRestore(s_proto.table_chips) != HAL_OK) return HAL_BUSY;
+    s_proto.table_chips = 0;
+    return HAL_OK;
+}
+
+/**
+ * @brief       执行数据字表命令
+ * @param       cmd: 命令字
+ * @param       p: 数据
+ * @param       len: 数据字节数
+ * @param       data: 应答数据 (至少12字节)
+ * @param       data_len: 应答数据字节数
+ * @retval      执行结果
+ */
+static AD9833_ProtoStatus AD9833_Proto_Table(uint8_t cmd, const uint8_t* p, uint8_t len, uint8_t* data, uint8_t* data_len)
+{
+    AD9833_TableState table;
+    uint16_t arg = (len >= 2U) ? (uint16_t)(p[0] | (p[1] << 8)) : 0U;
+
+    AD9833_Table_GetState(&table);
+    switch (cmd)
+    {
+    case AD9833_PROTO_TABLE_WRITE:
+        if (len < 3U) return AD9833_PROTO_ERR_LEN;
+        if ((uint32_t)arg + len - 2U > AD9833_PROTO_TABLE_SIZE) return AD9833_PROTO_ERR_ARG;
+        if (table.running) return AD9833_PROTO_ERR_BUSY;     // 正在播放的表不能改写
+        memcpy(&s_table[arg], &p[2], len - 2U);
+        return AD9833_PROTO_OK;
+    case AD9833_PROTO_TABLE_RUN:
+        if (len != 3U) return AD9833_PROTO_ERR_LEN;
+        if (arg > AD9833_PROTO_TABLE_SIZE) return AD9833_PROTO_ERR_ARG;
+        if (AD9833_Proto_Playing()) return AD9833_PROTO_ERR_BUSY;
+        if (AD9833_Table_Load(s_table, arg) != HAL_OK) return AD9833_PROTO_ERR_ARG;
+        AD9833_Table_GetState(&table);
+        s_proto.table_chips |= table.chips;
+        AD9833_Table_Run(p[2]);
+        return AD9833_PROTO_OK;
+    case AD9833_PROTO_TABLE_STOP:
+        if (len) return AD9833_PROTO_ERR_LEN;
+        AD9833_Table_Stop();
+        (void)AD9833_Proto_TableRestore();  // 预置写入未结束时留给下一条命令
+        return AD9833_PROTO_OK;
+    default:    // AD9833_PROTO_TABLE_STATUS
+        if (len) return AD9833_PROTO_ERR_LEN;
+        data[0] = table.running;
+        data[1] = table.loops;
+        data[2] = (uint8_t)table.step;
+        data[3] = (uint8_t)(table.step >> 8);
+        for (uint32_t i = 0; i < 4U; i++)
+        {
+            data[4U + i] = (uint8_t)(table.steps >> (8U * i));
+            data[8U + i] = (uint8_t)(table.words >> (8U * i));
+        }
+        *data_len = 12;
+        return AD9833_PROTO_OK;
+    }
+}
+
+/**
+ * @brief       执行直接写入芯片的命令
+ * @param       cmd: 命令字
+ * @param       p: 数据
+ * @param       len: 数据字节数
+ * @retval      执行结果
+ */
+static AD9833_ProtoStatus AD9833_Proto_Direct(uint8_t cmd, const uint8_t* p, uint8_t len)
+{
+    static const uint8_t s_len[] = { 0, 0, 6, 4, 2, 3, 2, 6 }; // 按命令字
+    HAL_StatusTypeDef ret;
+
+    if (len != s_len[cmd]) return AD9833_PROTO_ERR_LEN;
+    if (!AD9833_Proto_MaskOk(p[0])) return AD9833_PROTO_ERR_ARG;
+    if (AD9833_Proto_Playing()) return AD9833_PROTO_ERR_BUSY;
+    if (AD9833_Proto_TableRestore() != HAL_OK) return AD9833_PROTO_ERR_BUSY;
+
+    switch (cmd)
+    {
+    case AD9833_PROTO_FREQ:
+    {
+        uint32_t freq = (uint32_t)p[2] | ((uint32_t)p[3] << 8) | ((uint32_t)p[4] << 16) | ((uint32_t)p[5] << 24);
+        if (p[1] > 1U || freq > AD9833_SEQ_FREQ_MAX) return AD9833_PROTO_ERR_ARG;
+        ret = AD9833_FreqSet(p[0], p[1], freq / 100.0);
+        break;
+    }
+    case AD9833_PROTO_FREQ_RAW:
+    {
+        uint32_t word = (uint32_t)p[2] | ((uint32_t)p[3] << 8) | ((uint32_t)p[4] << 16) | ((uint32_t)p[5] << 24);
+        if (p[1] > 1U || word > AD9833_SEQ_WORD_MAX) return AD9833_PROTO_ERR_ARG;
+        ret = AD9833_FreqSetRaw(p[0], p[1], word);
+        break;
+    }
+    case AD9833_PROTO_PHASE:
+    {
+        uint16_t phase = (uint16_t)(p[2] | (p[3] << 8));
+        if (p[1] > 1U || phase >= 36000U) return AD9833_PROTO_ERR_ARG;
+        ret = AD9833_PhaseSet(p[0], p[1], phase / 100.0);
+        break;
+    }
+    case AD9833_PROTO_WAVE:
+        if (p[1] < SINE_WAVE || p[1] > SQUARE_WAVE) return AD9833_PROTO_ERR_ARG;
+        ret = AD9833_SetWaveformAndStart(p[0], (waveType)p[1]);
+        break;
+    case AD9833_PROTO_SELECT:
+        if (p[1] > 1U || p[2] > 1U) return AD9833_PROTO_ERR_ARG;
+        ret = AD9833_SelectFreqReg(p[0], p[1]);
+        if (ret == HAL_OK) ret = AD9833_SelectPhaseReg(p[0], p[2]);
+        break;
+    default:    // AD9833_PROTO_RESET
+        if (p[1] > 1U) return AD9833_PROTO_ERR_ARG;
+        ret = AD9833_Reset(p[0], p[1]);
+        break;
+    }
+    // 参数已检查, 失败只可能是预置写入 (外部触发) 未结束
+    return (ret == HAL_OK) ? AD9833_PROTO_OK : (ret == HAL_BUSY) ? AD9833_PROTO_ERR_BUSY : AD9833_PROTO_ERR_ARG;
+}
+
+/**
+ * @brief       执行一帧
+ * @param       cmd: 命令字
+ * @param       p: 数据
+ * @param       len: 数据字节数
+ * @retval      无
+ */
+static void AD9833_Proto_Dispatch(uint8_t cmd, const uint8_t* p, uint8_t len)
+{
+    AD9833_ProtoStatus status = AD9833_PROTO_OK;
+    uint8_t data[12];
+    uint8_t data_len = 0;
+    AD9833_SeqState seq;
+
+    switch (cmd)
+    {
+    case AD9833_PROTO_PING:
+        if (len) { status = AD9833_PROTO_ERR_LEN; break; }
+        data[0] = AD9833_PROTO_VERSION;
+        data[1] = AD9833_PROTO_PAYLOAD_MAX;
+        data_len = 2;
+        break;
+    case AD9833_PROTO_FREQ:
+    case AD9833_PROTO_PHASE:
+    case AD9833_PROTO_WAVE:
+    case AD9833_PROTO_SELECT:
+    case AD9833_PROTO_RESET:
+    case AD9833_PROTO_FREQ_RAW:
+        status = AD9833_Proto_Direct(cmd, p, len);
+        break;
+    case AD9833_PROTO_SEQ_LOAD:
+    {
+        if (len < 1U + AD9833_SEQ_STEP_SIZE || (len - 1U) % AD9833_SEQ_STEP_SIZE) { status = AD9833_PROTO_ERR_LEN; break; }
+        HAL_StatusTypeDef ret = AD9833_Seq_Load(p[0], &p[1], (len - 1U) / AD9833_SEQ_STEP_SIZE);
+        status = (ret == HAL_OK) ? AD9833_PROTO_OK : (ret == HAL_BUSY) ? AD9833_PROTO_ERR_BUSY : AD9833_PROTO_ERR_ARG;
+        break;
+    }
+    case AD9833_PROTO_SEQ_RUN:
+    {
+        if (len != 3U) { status = AD9833_PROTO_ERR_LEN; break; }
+        if (AD9833_Proto_Playing() || AD9833_Proto_TableRestore() != HAL_OK) { status = AD9833_PROTO_ERR_BUSY; break; }
+        HAL_StatusTypeDef ret = AD9833_Seq_Run(p[0], p[1], p[2]);
+        status = (ret == HAL_OK) ? AD9833_PROTO_OK : (ret == HAL_BUSY) ? AD9833_PROTO_ERR_BUSY : AD9833_PROTO_ERR_ARG;
+        break;
+    }
+    case AD9833_PROTO_SEQ_STOP:
+        if (len) { status = AD9833_PROTO_ERR_LEN; break; }
+        AD9833_Seq_Stop();
+        break;
+    case AD9833_PROTO_SEQ_STATUS:
+        if (len) { status = AD9833_PROTO_ERR_LEN; break; }
+        AD9833_Seq_GetState(&seq);
+        data[0] = seq.running;
+        data[1] = seq.index;
+        data[2] = seq.loops;
+        data[3] = (uint8_t)seq.steps;
+        data[4] = (uint8_t)(seq.steps >> 8);
+        data[5] = (uint8_t)(seq.steps >> 16);
+        data[6] = (uint8_t)(seq.steps >> 24);
+        data_len = 7;
+        break;
+    case AD9833_PROTO_SEQ_MODE:
+        if (len != 1U) { status = AD9833_PROTO_ERR_LEN; break; }
+        if (p[0] > 1U) { status = AD9833_PROTO_ERR_ARG; break; }
+        status = (AD9833_Seq_SetTimed(p[0]) == HAL_OK) ? AD9833_PROTO_OK : AD9833_PROTO_ERR_BUSY;
+        break;
+    case AD9833_PROTO_TABLE_WRITE:
+    case AD9833_PROTO_TABLE_RUN:
+    case AD9833_PROTO_TABLE_STOP:
+    case AD9833_PROTO_TABLE_STATUS:
+        status = AD9833_Proto_Table(cmd, p, len, data, &data_len);
+        break;
+    default:
+        status = AD9833_PROTO_ERR_CMD;
+        break;
+    }
+
+    AD9833_Proto_Reply(cmd, status, data, (status == AD9833_PROTO_OK) ? data_len : 0U);
+}
+
+/**
+ * @brief       环形缓冲区下标回绕
+ * @param       idx: 下标, 小于 2 * size
+ * @retval      回绕后的下标
+ */
+static inline uint32_t AD9833_Proto_Wrap(uint32_t idx)
+{
+    return (idx >= s_proto.size) ? idx - s_proto.size : idx;
+}
+
+/**
+ * @brief       窗口中的第 i 个字节
+ * @param       i: 序号, 0 为帧头
+ * @retval      字节
+ */
+static inline uint8_t AD9833_Proto_At(uint32_t i)
+{
+    return s_proto.buf[AD9833_Proto_Wrap(s_proto.rd + i)];
+}
+
+/**
+ * @brief       丢弃窗口开头的若干字节
+ * @param       count: 字节数
+ * @retval      无
+ */
+static void AD9833_Proto_Drop(uint32_t count)
+{
+    s_proto.n -= count;
+    s_proto.rd = AD9833_Proto_Wrap(s_proto.rd + count);
+}
+
+/**
+ * @brief       窗口中完整帧的数据段
+ * @note        连续时直接指向缓冲区, 跨过缓冲区末尾时拷贝到 frame
+ * @param       len: 数据字节数
+ * @retval      数据
+ */
+static const uint8_t* AD9833_Proto_Payload(uint8_t len)
+{
+    uint32_t idx = AD9833_Proto_Wrap(s_proto.rd + 3U);
+
+    if (idx + len <= s_proto.size) return &s_proto.buf[idx];
+    for (uint32_t i = 0; i < len; i++)
+    {
+        s_proto.frame[i] = AD9833_Proto_At(3U + i);
+    }
+    return s_proto.frame;
+}
+
+/**
+ * @brief       在窗口中查找并执行完整的帧
+ * @retval      无
+ */
+static void AD9833_Proto_Scan(void)
+{
+    while (s_proto.n)
+    {
+        if (AD9833_Proto_At(0) != AD9833_PROTO_SOF)
+        {
+            s_proto.stat.junk++;            // 重新同步时跳过的字节
+            AD9833_Proto_Drop(1);
+            continue;
+        }
+        if (s_proto.n < 2U) return;
+
+        uint8_t len = AD9833_Proto_At(1);
+        if (len > AD9833_PROTO_PAYLOAD_MAX)
+        {
+            s_proto.stat.overruns++;
+            AD9833_Proto_Drop(1);
+            continue;
+        }
+        if (s_proto.n < len + 4U) return;
+
+        uint8_t crc = 0;
+        for (uint32_t i = 1; i < len + 3U; i++)
+        {
+            crc = AD9833_Proto_CrcByte(crc, AD9833_Proto_At(i));
+        }
+        if (crc != AD9833_Proto_At(3U + len))
+        {
+            s_proto.stat.crc_errors++;
+            AD9833_Proto_Drop(1);
+            continue;
+        }
+        s_proto.stat.frames++;
+        AD9833_Proto_Dispatch(AD9833_Proto_At(2), AD9833_Proto_Payload(len), len);
+        AD9833_Proto_Drop(len + 4U);
+    }
+}
+
+/**
+ * @brief       解析紧接在窗口之后的一个字节
+ * @note        字节已在缓冲区中 (窗口第 n 个字节的位置)
+ * @retval      无
+ */
+static void AD9833_Proto_Next(void)
+{
+    uint8_t byte = AD9833_Proto_At(s_proto.n);
+
+    if (!s_proto.n && byte != AD9833_PROTO_SOF)
+    {
+        s_proto.stat.junk++;
+        if (s_proto.other) s_proto.other(byte);
+        s_proto.rd = AD9833_Proto_Wrap(s_proto.rd + 1U);
+        return;
+    }
+    s_proto.n++;
+    AD9833_Proto_Scan();
+}
+
+/**
+ * @brief       收到新数据时检查帧内间隔, 超时则丢弃未收完的帧
+ * @retval      无
+ */
+static void AD9833_Proto_CheckTimeout(void)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (s_proto.n && now - s_proto.t_last > AD9833_PROTO_TIMEOUT_MS)
+    {
+        s_proto.stat.timeouts++;
+        AD9833_Proto_Drop(s_proto.n);
+    }
+    s_proto.t_last = now;
+}
+
+/**
+ * @brief       输入收到的数据
+ * @param       data: 数据
+ * @param       len: 字节数
+ * @retval      无
+ */
+void AD9833_Proto_Input(const uint8_t* data, uint32_t len)
+{
+    if (!len) return;
+    AD9833_Proto_CheckTimeout();
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        s_proto.win[AD9833_Proto_Wrap(s_proto.rd + s_proto.n)] = data[i];
+        AD9833_Proto_Next();
+    }
+}
+
+/**
+ * @brief       接收事件: 记下 DMA 的写入位置
+ * @note        在 HAL_UARTEx_RxEventCallback (IDLE、HT、TC) 中调用
+ * @param       head: 写入位置, 即回调的 Size 参数 (缓冲区写满时等于 size)
+ * @retval      无
+ */
+void AD9833_Proto_RxEvent(uint16_t head)
+{
+    uint32_t pos = (head >= s_proto.size) ? 0U : head;
+    uint32_t delta = (pos >= s_proto.rx_head) ? pos - s_proto.rx_head : pos + s_proto.size - s_proto.rx_head;
+
+    s_proto.rx_head = pos;
+    s_proto.rx_total += delta;
+}
+
+/**
+ * @brief       接收错误后 DMA 将从缓冲区起点重新写入 (在接收错误回调中调用)
+ * @note        只记下位置和标志, 重新同步由主循环中的 RxPoll 完成; 调用之后再
+ *              重新启动 DMA 接收
+ * @param       head: 出错时 DMA 的写入位置 (缓冲区字节数 - NDTR)
+ * @retval      无
+ */
+void AD9833_Proto_RxRestart(uint16_t head)
+{
+    AD9833_Proto_RxEvent(head);     // 出错前写入、尚未上报的字节
+    s_proto.rx_restart_total = s_proto.rx_total;
+    s_proto.rx_head = 0;
+    s_proto.rx_restart = 1;
+}
+
+/**
+ * @brief       在 DMA 缓冲区中原地解析到最近一次接收事件的位置
+ * @retval      无
+ */
+void AD9833_Proto_RxPoll(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t total = s_proto.rx_total;
+    uint8_t restart = s_proto.rx_restart;
+    uint32_t restart_total = s_proto.rx_restart_total;
+    s_proto.rx_restart = 0;
+    __set_PRIMASK(primask);
+
+    if (restart)
+    {
+        // 接收出错后 DMA 从缓冲区起点重新写入, 丢弃窗口和出错前未解析的字节
+        s_proto.stat.lost += s_proto.n + (restart_total - s_proto.rx_read);
+        s_proto.rd = 0;
+        s_proto.n = 0;
+        s_proto.rx_read = restart_total;
+    }
+    if (total == s_proto.rx_read) return;
+    if (total - (s_proto.rx_read - s_proto.n) > s_proto.size)
+    {
+        // DMA 已覆盖窗口或尚未解析的数据, 从最新位置重新同步
+        s_proto.stat.lost += s_proto.n + (total - s_proto.rx_read);
+        s_proto.rd = (s_proto.rd + s_proto.n + (total - s_proto.rx_read) % s_proto.size) % s_proto.size;
+        s_proto.n = 0;
+        s_proto.rx_read = total;
+        return;
+    }
+    AD9833_Proto_CheckTimeout();
+
+    while (s_proto.rx_read != total)
+    {
+        s_proto.rx_read++;
+        AD9833_Proto_Next();
+    }
+}
+
+/**
+ * @brief       读取解析统计
+ * @param       stat: 输出
+ * @retval      无
+ */
+void AD9833_Proto_GetStat(AD9833_ProtoStat* stat)
+{
+    *stat = s_proto.stat;
+}
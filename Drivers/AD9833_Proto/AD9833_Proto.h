@@ -0,0 +1,129 @@
+#ifndef _AD9833_PROTO_H
+#define _AD9833_PROTO_H
+
+#include "main.h"
+
+// 帧头
+#define AD9833_PROTO_SOF            0xA5U
+
+// 协议版本, PING 的应答中返回
+#define AD9833_PROTO_VERSION        1U
+
+// 数据段最大字节数
+#define AD9833_PROTO_PAYLOAD_MAX    64U
+
+// 一帧最大字节数: 帧头 + 长度 + 命令 + 数据 + CRC
+#define AD9833_PROTO_FRAME_MAX      (AD9833_PROTO_PAYLOAD_MAX + 4U)
+
+// DMA 接收缓冲区的最小字节数: 未收完的帧 + 两次接收事件之间的半个缓冲区
+#define AD9833_PROTO_RX_MIN         (2U * AD9833_PROTO_FRAME_MAX)
+
+// 帧内两次收到数据的最大间隔 (毫秒), 超过时丢弃未收完的帧
+#define AD9833_PROTO_TIMEOUT_MS     20U
+
+// 应答的命令字为请求命令字加上此标志
+#define AD9833_PROTO_REPLY          0x80U
+
+// 上位机写入的数据字表 (AD9833_Table) 缓冲区字节数
+#ifndef AD9833_PROTO_TABLE_SIZE
+#define AD9833_PROTO_TABLE_SIZE     2048U
+#endif
+
+/**
+  * @brief 命令 (数据段中的多字节数均为低字节在前)
+  *     @arg AD9833_PROTO_PING: 无数据; 应答 版本, 数据段最大字节数
+  *     @arg AD9833_PROTO_FREQ: 芯片掩码, 寄存器号, 频率 (uint32, 0.01Hz)
+  *     @arg AD9833_PROTO_PHASE: 芯片掩码, 寄存器号, 相位 (uint16, 0.01°)
+  *     @arg AD9833_PROTO_WAVE: 芯片掩码, 波形 (waveType)
+  *     @arg AD9833_PROTO_SELECT: 芯片掩码, 频率寄存器号, 相位寄存器号
+  *     @arg AD9833_PROTO_RESET: 芯片掩码, 1 复位 / 0 释放
+  *     @arg AD9833_PROTO_FREQ_RAW: 芯片掩码, 寄存器号, 28位频率字 (uint32)
+  *     @arg AD9833_PROTO_SEQ_LOAD: 起始序号, 之后每8字节一步 (见 AD9833_SeqStep)
+  *     @arg AD9833_PROTO_SEQ_RUN: 起始序号, 步数, 遍数 (0 为无限循环)
+  *     @arg AD9833_PROTO_SEQ_STOP: 无数据
+  *     @arg AD9833_PROTO_SEQ_STATUS: 无数据; 应答 播放中, 下一步序号, 剩余遍数, 已执行步数 (uint32)
+  *     @arg AD9833_PROTO_SEQ_MODE: 1 定时播放 (AD9833_Seq_Tick) / 0 主循环播放, 播放期间不能切换
+  *     @arg AD9833_PROTO_TABLE_WRITE: 偏移 (uint16), 之后为写入数据字表缓冲区的字节
+  *     @arg AD9833_PROTO_TABLE_RUN: 表的字节数 (uint16), 遍数 (0 为无限循环); 检查缓冲区中的表后
+  *          由 AD9833_Table_Tick() 播放; 结束或停止后, 下一条写入芯片的命令之前按驱动的
+  *          影子寄存器重写表中芯片的控制字 (AD9833_CtrlRestore)
+  *     @arg AD9833_PROTO_TABLE_STOP: 无数据
+  *     @arg AD9833_PROTO_TABLE_STATUS: 无数据; 应答 播放中, 剩余遍数, 下一步序号 (uint16),
+  *          已执行步数 (uint32), 已写出数据字数 (uint32)
+  */
+typedef enum
+{
+    AD9833_PROTO_PING = 0x01,
+    AD9833_PROTO_FREQ = 0x02,
+    AD9833_PROTO_PHASE = 0x03,
+    AD9833_PROTO_WAVE = 0x04,
+    AD9833_PROTO_SELECT = 0x05,
+    AD9833_PROTO_RESET = 0x06,
+    AD9833_PROTO_FREQ_RAW = 0x07,
+    AD9833_PROTO_SEQ_LOAD = 0x10,
+    AD9833_PROTO_SEQ_RUN = 0x11,
+    AD9833_PROTO_SEQ_STOP = 0x12,
+    AD9833_PROTO_SEQ_STATUS = 0x13,
+    AD9833_PROTO_SEQ_MODE = 0x14,
+    AD9833_PROTO_TABLE_WRITE = 0x20,
+    AD9833_PROTO_TABLE_RUN = 0x21,
+    AD9833_PROTO_TABLE_STOP = 0x22,
+    AD9833_PROTO_TABLE_STATUS = 0x23
+} AD9833_ProtoCmd;
+
+/**
+  * @brief 应答数据段的第一个字节
+  *     @arg AD9833_PROTO_OK: 已执行
+  *     @arg AD9833_PROTO_ERR_CMD: 未知命令
+  *     @arg AD9833_PROTO_ERR_LEN: 数据段长度不符
+  *     @arg AD9833_PROTO_ERR_ARG: 参数超出范围
+  *     @arg AD9833_PROTO_ERR_BUSY: 序列或数据字表正在播放, 或预置写入 (外部触发) 未结束
+  */
+typedef enum
+{
+    AD9833_PROTO_OK = 0,
+    AD9833_PROTO_ERR_CMD,
+    AD9833_PROTO_ERR_LEN,
+    AD9833_PROTO_ERR_ARG,
+    AD9833_PROTO_ERR_BUSY
+} AD9833_ProtoStatus;
+
+/**
+  * @brief 解析统计
+  *     @arg frames: 校验通过的帧数
+  *     @arg rejected: 其中应答不为 AD9833_PROTO_OK 的帧数
+  *     @arg crc_errors: 校验错误 (丢弃帧头后重新同步)
+  *     @arg overruns: 长度超过 AD9833_PROTO_PAYLOAD_MAX (同上)
+  *     @arg timeouts: 帧内间隔超时, 丢弃未收完的帧
+  *     @arg junk: 帧外的字节数
+  *     @arg lost: DMA 缓冲区在解析之前被覆盖, 或接收出错后重新启动而丢弃的字节数
+  */
+typedef struct
+{
+    uint32_t frames;
+    uint32_t rejected;
+    uint32_t crc_errors;
+    uint32_t overruns;
+    uint32_t timeouts;
+    uint32_t junk;
+    uint32_t lost;
+} AD9833_ProtoStat;
+
+// 发送应答帧
+typedef void (*AD9833_ProtoSend)(const uint8_t* data, uint16_t len);
+
+// 帧外收到的单个字节 (可用作调试命令)
+typedef void (*AD9833_ProtoOther)(uint8_t byte);
+
+/* 函数声明 */
+void AD9833_Proto_Init(AD9833_ProtoSend send, AD9833_ProtoOther other);
+void AD9833_Proto_Input(const uint8_t* data, uint32_t len);
+HAL_StatusTypeDef AD9833_Proto_RxStart(const uint8_t* ring, uint16_t size);
+void AD9833_Proto_RxEvent(uint16_t head);
+void AD9833_Proto_RxRestart(uint16_t head);
+void AD9833_Proto_RxPoll(void);
+uint8_t AD9833_Proto_Crc8(const uint8_t* data, uint32_t len);
+uint16_t AD9833_Proto_Encode(uint8_t cmd, const uint8_t* payload, uint8_t len, uint8_t* frame);
+void AD9833_Proto_GetStat(AD9833_ProtoStat* stat);
+
+#endif /* _AD9833_PROTO_H */
@@ -0,0 +1,97 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Queue.c
+  * @brief          : 频率/相位/控制更新的单生产者单消费者队列
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 生产者 (定时器中断、协议解析等) 把更新放入队列，消费者 (主循环) 取出后
+  * 调用驱动写入芯片。head 只由生产者写、tail 只由消费者写，两者都是单次
+  * 32位读写，不需要关中断；元素先写入、再更新 head (中间有内存屏障)，
+  * 消费者看到新的 head 时元素已完整。
+  *
+  * 队列满时新的更新被丢弃并计数 (dropped)；high_water 为入队后队列长度
+  * 的最大值，两者用于确定所需的队列深度。
+  *
+  * 使用方法：
+  * 1. 定义 AD9833_Queue 变量，调用 `AD9833_Queue_Init()` 设定深度。
+  * 2. 生产者调用 `AD9833_Queue_Push()`，消费者调用 `AD9833_Queue_Pop()`。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_Queue.h"
+#include "main.h"
+#include <string.h>
+
+/**
+ * @brief       初始化队列
+ * @param       q: 队列
+ * @param       depth: 深度, 2的幂且不超过 AD9833_QUEUE_DEPTH_MAX
+ * @retval      1: 成功; 0: 深度无效
+ */
+uint8_t AD9833_Queue_Init(AD9833_Queue* q, uint32_t depth)
+{
+    if (!depth || depth > AD9833_QUEUE_DEPTH_MAX || (depth & (depth - 1U))) return 0;
+
+    memset(q, 0, sizeof(*q));
+    q->mask = depth - 1U;
+    return 1;
+}
+
+/**
+ * @brief       入队 (生产者)
+ * @param       q: 队列
+ * @param       update: 更新
+ * @retval      1: 成功; 0: 队列满, 已丢弃
+ */
+uint8_t AD9833_Queue_Push(AD9833_Queue* q, const AD9833_Update* update)
+{
+    uint32_t head = q->head;
+    uint32_t count = head - q->tail;
+
+    if (count > q->mask)
+    {
+        q->dropped++;
+        return 0;
+    }
+    q->buf[head & q->mask] = *update;
+    __DMB();                    // 元素写完后再发布 head
+    q->head = head + 1U;
+
+    if (count + 1U > q->high_water) q->high_water = count + 1U;
+    return 1;
+}
+
+/**
+ * @brief       出队 (消费者)
+ * @param       q: 队列
+ * @param       update: 输出
+ * @retval      1: 成功; 0: 队列空
+ */
+uint8_t AD9833_Queue_Pop(AD9833_Queue* q, AD9833_Update* update)
+{
+    uint32_t tail = q->tail;
+
+    if (tail == q->head) return 0;
+    __DMB();                    // 读到 head 之后再读元素
+    *update = q->buf[tail & q->mask];
+    __DMB();                    // 元素读完后再释放位置
+    q->tail = tail + 1U;
+    return 1;
+}
+
+/**
+ * @brief       队列中的更新数
+ * @param       q: 队列
+ * @retval      个数
+ */
+uint32_t AD9833_Queue_Count(const AD9833_Queue* q)
+{
+    return q->head - q->tail;
+}
@@ -0,0 +1,68 @@
+#ifndef _AD9833_QUEUE_H
+#define _AD9833_QUEUE_H
+
+#include <stdint.h>
+
+// 队列容量上限, 实际深度在 AD9833_Queue_Init() 中设定 (2的幂, 不超过此值)
+#ifndef AD9833_QUEUE_DEPTH_MAX
+#define AD9833_QUEUE_DEPTH_MAX      64U
+#endif
+
+/**
+  * @brief 更新操作
+  *     @arg AD9833_UPDATE_FREQ: 写频率寄存器 arg, value 为28位频率字
+  *     @arg AD9833_UPDATE_PHASE: 写相位寄存器 arg, value 为相位 (0.01°)
+  *     @arg AD9833_UPDATE_SELECT: 选择频率寄存器 arg
+  *     @arg AD9833_UPDATE_WAVE: 切换波形并启动, arg 为 waveType
+  */
+typedef enum
+{
+    AD9833_UPDATE_FREQ = 1,
+    AD9833_UPDATE_PHASE,
+    AD9833_UPDATE_SELECT,
+    AD9833_UPDATE_WAVE
+} AD9833_UpdateOp;
+
+/**
+  * @brief 一次更新
+  *     @arg t: 产生时刻 (时钟计数, 由生产者填写, 用于统计延迟)
+  *     @arg value: 频率字或相位
+  *     @arg op: AD9833_UpdateOp
+  *     @arg arg: 寄存器号或波形
+  *     @arg mask: 芯片掩码
+  */
+typedef struct
+{
+    uint32_t t;
+    uint32_t value;
+    uint8_t op;
+    uint8_t arg;
+    uint8_t mask;
+} AD9833_Update;
+
+/**
+  * @brief 单生产者单消费者队列 (生产者可在中断中)
+  *     @arg head: 写入位置, 只由生产者修改
+  *     @arg tail: 读出位置, 只由消费者修改
+  *     @arg mask: 深度 - 1
+  *     @arg high_water: 入队后队列长度的最大值
+  *     @arg dropped: 队列满时丢弃的更新数
+  *     @arg buf: 缓冲区
+  */
+typedef struct
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    uint32_t mask;
+    uint32_t high_water;
+    uint32_t dropped;
+    AD9833_Update buf[AD9833_QUEUE_DEPTH_MAX];
+} AD9833_Queue;
+
+/* 函数声明 */
+uint8_t AD9833_Queue_Init(AD9833_Queue* q, uint32_t depth);
+uint8_t AD9833_Queue_Push(AD9833_Queue* q, const AD9833_Update* update);
+uint8_t AD9833_Queue_Pop(AD9833_Queue* q, AD9833_Update* update);
+uint32_t AD9833_Queue_Count(const AD9833_Queue* q);
+
+#endif /* _AD9833_QUEUE_H */
@@ -0,0 +1,294 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Seq.c
+  * @brief          : 由上位机装入的频率/相位序列表及其非阻塞播放
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-17
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 序列表共 AD9833_SEQ_LEN 步，每步为一次写入 (频率、相位、波形或寄存器
+  * 选择) 加停留时间。上位机通过串口协议 (AD9833_Proto) 分段装入，每段在
+  * 全部检查通过后才写入表中，任何一步无效时整段不装入。
+  *
+  * 播放不阻塞，有两种方式：
+  * - 主循环播放 (默认): `AD9833_Seq_Poll()` 在主循环中调用，每次最多执行
+  *   一步，到达上一步的停留时间 (HAL_GetTick) 后才执行下一步。停留时间从
+  *   上一步执行完的那个毫秒算起，误差随步数累积。
+  * - 定时播放: `AD9833_Seq_SetTimed(1)` 后由定时器更新中断以
+  *   AD9833_SEQ_TICK_HZ 调用 `AD9833_Seq_Tick()`，第k步在开始后第
+  *   (前k步停留时间之和) 个节拍执行，不累积误差；停留时间为0的步与下一步
+  *   相隔一个节拍。此时 Run/Stop 在主循环或其他中断中调用，
+  *   `AD9833_Seq_Poll()` 不执行。
+  * 播放期间不能装入序列，也不能切换播放方式。
+  *
+  * 注意：
+  * - 预置写入 (AD9833_StageCtrl，外部触发) 未结束时驱动拒绝一切写入并返回
+  *   HAL_BUSY，这期间执行的步不会写入芯片但照常计入步数，即该步丢失。
+  *   触发待命期间不要播放序列。
+  * - 定时播放时主循环不要再写序列中的芯片：驱动保证每个字完整，但频率的
+  *   两个字之间可被中断插入。
+  *
+  * 使用方法：
+  * 1. 调用 `AD9833_Seq_Init()` 清空序列表。
+  * 2. 调用 `AD9833_Seq_Load()` 装入 (通常由协议解析调用)。
+  * 3. 调用 `AD9833_Seq_Run()` 开始播放，在主循环中调用 `AD9833_Seq_Poll()`；
+  *    定时播放时改为在定时器更新中断 (HAL_TIM_PeriodElapsedCallback) 中
+  *    调用 `AD9833_Seq_Tick()`。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_Seq.h"
+#include <string.h>
+
+/**
+ * @brief   播放控制
+ *      @arg state: 对外的状态
+ *      @arg start: 播放范围的起点
+ *      @arg end: 播放范围的终点 (不含)
+ *      @arg dwell: 当前步的停留时间
+ *      @arg t_step: 当前步的执行时刻 (HAL_GetTick)
+ *      @arg wait: 定时播放时执行下一步前还要等待的节拍数
+ */
+typedef struct
+{
+    AD9833_SeqState state;
+    uint8_t start;
+    uint8_t end;
+    uint16_t dwell;
+    uint32_t t_step;
+    uint32_t wait;
+} AD9833_SeqPlayer;
+
+static AD9833_SeqStep s_table[AD9833_SEQ_LEN];
+static AD9833_SeqPlayer s_player;
+
+/**
+ * @brief       清空序列表并停止播放
+ * @retval      无
+ */
+void AD9833_Seq_Init(void)
+{
+    memset(s_table, 0, sizeof(s_table));
+    memset(&s_player, 0, sizeof(s_player));
+}
+
+/**
+ * @brief       解码并检查一步
+ * @param       data: 8字节
+ * @param       step: 输出
+ * @retval      1: 有效; 0: 无效
+ */
+static uint8_t AD9833_Seq_Decode(const uint8_t* data, AD9833_SeqStep* step)
+{
+    step->op = data[0] >> 4;
+    step->arg = data[0] & 0x0FU;
+    step->mask = data[1];
+    step->dwell_ms = (uint16_t)(data[2] | (data[3] << 8));
+    step->value = (uint32_t)data[4] | ((uint32_t)data[5] << 8) | ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+
+    if (!step->mask || (step->mask & ~CS_ALL)) return 0;
+
+    switch (step->op)
+    {
+    case AD9833_SEQ_FREQ:
+        return (step->arg <= 1U && step->value <= AD9833_SEQ_FREQ_MAX) ? 1U : 0U;
+    case AD9833_SEQ_PHASE:
+        return (step->arg <= 1U && step->value < 36000U) ? 1U : 0U;
+    case AD9833_SEQ_WAVE:
+        return (step->arg >= SINE_WAVE && step->arg <= SQUARE_WAVE && step->value == 0U) ? 1U : 0U;
+    case AD9833_SEQ_SELECT:
+        return (step->arg <= 3U && step->value == 0U) ? 1U : 0U;
+    case AD9833_SEQ_FREQ_RAW:
+        return (step->arg <= 1U && step->value <= AD9833_SEQ_WORD_MAX) ? 1U : 0U;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief       装入一段序列
+ * @param       index: 第一步的序号
+ * @param       data: 每步8字节, 共 count 步
+ * @param       count: 步数
+ * @retval      HAL_OK: 已装入; HAL_BUSY: 正在播放; HAL_ERROR: 范围越界或有无效的步 (整段不装入)
+ */
+HAL_StatusTypeDef AD9833_Seq_Load(uint8_t index, const uint8_t* data, uint32_t count)
+{
+    AD9833_SeqStep step;
+
+    if (s_player.state.running) return HAL_BUSY;
+    if (!count || count > AD9833_SEQ_LEN || index > AD9833_SEQ_LEN - count) return HAL_ERROR;
+
+    // 先全部检查, 再写入表中
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (!AD9833_Seq_Decode(&data[i * AD9833_SEQ_STEP_SIZE], &step)) return HAL_ERROR;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        (void)AD9833_Seq_Decode(&data[i * AD9833_SEQ_STEP_SIZE], &s_table[index + i]);
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief       开始播放
+ * @note        第一步在下一次 AD9833_Seq_Poll() 时执行
+ * @param       start: 起始序号
+ * @param       count: 步数
+ * @param       loops: 遍数, 0 为无限循环
+ * @retval      HAL_OK: 已开始; HAL_BUSY: 正在播放; HAL_ERROR: 范围越界或包含未装入的步
+ */
+HAL_StatusTypeDef AD9833_Seq_Run(uint8_t start, uint8_t count, uint8_t loops)
+{
+    if (s_player.state.running) return HAL_BUSY;
+    if (!count || count > AD9833_SEQ_LEN || start > AD9833_SEQ_LEN - count) return HAL_ERROR;
+
+    for (uint32_t i = start; i < (uint32_t)start + count; i++)
+    {
+        if (!s_table[i].op) return HAL_ERROR;
+    }
+
+    s_player.start = start;
+    s_player.end = (uint8_t)(start + count);
+    s_player.dwell = 0;
+    s_player.t_step = HAL_GetTick();
+    s_player.wait = 0;
+    s_player.state.index = start;
+    s_player.state.loops = loops;
+    s_player.state.running = 1;     // 最后置位, 定时播放的中断此后才开始执行
+
+    return HAL_OK;
+}
+
+/**
+ * @brief       停止播放, 输出保持最后一步的状态
+ * @retval      无
+ */
+void AD9833_Seq_Stop(void)
+{
+    s_player.state.running = 0;
+}
+
+/**
+ * @brief       执行一步
+ * @param       step: 步
+ * @retval      无
+ */
+static void AD9833_Seq_Exec(const AD9833_SeqStep* step)
+{
+    switch (step->op)
+    {
+    case AD9833_SEQ_FREQ:
+        AD9833_FreqSet(step->mask, step->arg, step->value / 100.0);
+        break;
+    case AD9833_SEQ_PHASE:
+        AD9833_PhaseSet(step->mask, step->arg, step->value / 100.0);
+        break;
+    case AD9833_SEQ_WAVE:
+        AD9833_SetWaveformAndStart(step->mask, (waveType)step->arg);
+        break;
+    case AD9833_SEQ_SELECT:
+        AD9833_SelectFreqReg(step->mask, step->arg & 1U);
+        AD9833_SelectPhaseReg(step->mask, (step->arg >> 1) & 1U);
+        break;
+    case AD9833_SEQ_FREQ_RAW:
+        AD9833_FreqSetRaw(step->mask, step->arg, step->value);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief       执行当前步并前进到下一步
+ * @retval      当前步
+ */
+static const AD9833_SeqStep* AD9833_Seq_Step(void)
+{
+    AD9833_SeqState* st = &s_player.state;
+    const AD9833_SeqStep* step = &s_table[st->index];
+
+    AD9833_Seq_Exec(step);
+    st->steps++;
+
+    if (++st->index >= s_player.end)
+    {
+        st->index = s_player.start;
+        if (st->loops && --st->loops == 0) st->running = 0;
+    }
+    return step;
+}
+
+/**
+ * @brief       播放, 在主循环中调用
+ * @note        上一步的停留时间已到时执行一步, 每次调用最多一步; 定时播放时不执行
+ * @retval      无
+ */
+void AD9833_Seq_Poll(void)
+{
+    if (!s_player.state.running || s_player.state.timed) return;
+    if (HAL_GetTick() - s_player.t_step < s_player.dwell) return;
+
+    const AD9833_SeqStep* step = AD9833_Seq_Step();
+    s_player.t_step = HAL_GetTick();
+    s_player.dwell = step->dwell_ms;
+}
+
+/**
+ * @brief       选择播放方式
+ * @param       timed: 1 为定时播放 (AD9833_Seq_Tick), 0 为主循环播放 (AD9833_Seq_Poll)
+ * @retval      HAL_OK: 已切换; HAL_BUSY: 正在播放
+ */
+HAL_StatusTypeDef AD9833_Seq_SetTimed(uint8_t timed)
+{
+    if (s_player.state.running) return HAL_BUSY;
+
+    s_player.state.timed = timed ? 1U : 0U;
+    return HAL_OK;
+}
+
+/**
+ * @brief       定时播放, 在定时器更新中断中以 AD9833_SEQ_TICK_HZ 调用
+ * @note        等待的节拍数到0时执行一步, 然后按该步的停留时间重新计数
+ * @retval      无
+ */
+void AD9833_Seq_Tick(void)
+{
+    if (!s_player.state.running || !s_player.state.timed) return;
+    if (s_player.wait)
+    {
+        s_player.wait--;
+        return;
+    }
+
+    const AD9833_SeqStep* step = AD9833_Seq_Step();
+    uint32_t ticks = (uint32_t)step->dwell_ms * (AD9833_SEQ_TICK_HZ / 1000U);
+    s_player.wait = ticks ? ticks - 1U : 0U;
+}
+
+/**
+ * @brief       读取序列表中的一步
+ * @param       index: 序号
+ * @retval      步, 序号越界时为 NULL
+ */
+const AD9833_SeqStep* AD9833_Seq_Get(uint8_t index)
+{
+    return (index < AD9833_SEQ_LEN) ? &s_table[index] : NULL;
+}
+
+/**
+ * @brief       读取播放状态
+ * @param       state: 输出
+ * @retval      无
+ */
+void AD9833_Seq_GetState(AD9833_SeqState* state)
+{
+    *state = s_player.state;
+}
@@ -0,0 +1,86 @@
+#ifndef _AD9833_SEQ_H
+#define _AD9833_SEQ_H
+
+#include "main.h"
+#include "AD9833_Soft.h"
+
+// 序列表的步数
+#define AD9833_SEQ_LEN              64U
+
+// 一步在串口协议中的字节数
+#define AD9833_SEQ_STEP_SIZE        8U
+
+// 定时播放时 AD9833_Seq_Tick() 的调用频率 (Hz), 须为1000的整数倍
+#ifndef AD9833_SEQ_TICK_HZ
+#define AD9833_SEQ_TICK_HZ          1000U
+#endif
+
+// 频率上限 (0.01Hz), 即 MCLK/2
+#define AD9833_SEQ_FREQ_MAX         ((uint32_t)(AD9833_MCLK_NOMINAL / 2.0 * 100.0))
+
+// 28位频率字的上限
+#define AD9833_SEQ_WORD_MAX         0x0FFFFFFFU
+
+/**
+  * @brief 一步的操作
+  *     @arg AD9833_SEQ_FREQ: 写频率寄存器 arg, value 为频率 (0.01Hz)
+  *     @arg AD9833_SEQ_PHASE: 写相位寄存器 arg, value 为相位 (0.01°, 小于36000)
+  *     @arg AD9833_SEQ_WAVE: 切换波形并启动, arg 为 waveType
+  *     @arg AD9833_SEQ_SELECT: 选择寄存器, arg 的 bit0 为频率寄存器, bit1 为相位寄存器
+  *     @arg AD9833_SEQ_FREQ_RAW: 写频率寄存器 arg, value 为28位频率字 (如主机杂散规划的结果)
+  */
+typedef enum
+{
+    AD9833_SEQ_FREQ = 1,
+    AD9833_SEQ_PHASE,
+    AD9833_SEQ_WAVE,
+    AD9833_SEQ_SELECT,
+    AD9833_SEQ_FREQ_RAW
+} AD9833_SeqOp;
+
+/**
+  * @brief 一步 (串口上为8字节: op<<4|arg, mask, dwell_ms 低字节在前, value 低字节在前)
+  *     @arg op: AD9833_SeqOp
+  *     @arg arg: 寄存器号 / 波形 / 寄存器选择
+  *     @arg mask: 芯片掩码
+  *     @arg dwell_ms: 执行后停留的时间 (毫秒)
+  *     @arg value: 频率、相位或频率字
+  */
+typedef struct
+{
+    uint8_t op;
+    uint8_t arg;
+    uint8_t mask;
+    uint16_t dwell_ms;
+    uint32_t value;
+} AD9833_SeqStep;
+
+/**
+  * @brief 播放状态
+  *     @arg running: 正在播放
+  *     @arg index: 下一步的序号
+  *     @arg loops: 剩余遍数 (0 为无限循环)
+  *     @arg steps: 已执行的总步数
+  *     @arg timed: 1 为定时播放 (AD9833_Seq_Tick), 0 为主循环播放 (AD9833_Seq_Poll)
+  */
+typedef struct
+{
+    uint8_t running;
+    uint8_t timed;
+    uint8_t index;
+    uint8_t loops;
+    uint32_t steps;
+} AD9833_SeqState;
+
+/* 函数声明 */
+void AD9833_Seq_Init(void);
+HAL_StatusTypeDef AD9833_Seq_Load(uint8_t index, const uint8_t* data, uint32_t count);
+HAL_StatusTypeDef AD9833_Seq_Run(uint8_t start, uint8_t count, uint8_t loops);
+void AD9833_Seq_Stop(void);
+void AD9833_Seq_Poll(void);
+HAL_StatusTypeDef AD9833_Seq_SetTimed(uint8_t timed);
+void AD9833_Seq_Tick(void);
+const AD9833_SeqStep* AD9833_Seq_Get(uint8_t index);
+void AD9833_Seq_GetState(AD9833_SeqState* state);
+
+#endif /* _AD9833_SEQ_H */
@@ -0,0 +1,331 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Stress.c
+  * @brief          : 持续混合更新的压力测试, 测出各传输方式的实际吞吐上限
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 生产者按设定速率产生更新 (频率、相位、寄存器选择和波形切换交替，分别
+  * 发往 CS1、CS2 和两片同时)，放入 AD9833_Queue；消费者取出后调用驱动写入。
+  * 两者在同一个循环中交替运行：每写完一个更新，生产者就补上这段时间内
+  * 到期的更新，队列满时丢弃。每项统计：
+  * - 产生、写入、丢弃的更新数，队列长度的最大值 (high_water)；
+  * - 延迟: 从更新的预定时刻到写完，超过截止时间计为迟到 (late)；
+  * - 实际写入速率 (achieved_hz)。
+  *
+  * AD9833_Stress_Suite() 依次运行一组速率和队列深度，逐行输出CSV：
+  *
+  *     # ad9833_stress,<格式版本>,<截止时间us>
+  *     transport,opt,rate_hz,depth,offered,executed,dropped,late,high_water,achieved_hz,lat_mean_ns,lat_max_ns
+  *     soft,Os,100000,16,10000,10000,0,0,1,100007,4547,5856
+  *     ...
+  *     # ceiling,<transport>,<opt>,<无丢弃无迟到的最高速率>,<最大吞吐>
+  *
+  * rate_hz 为 0 的行不按速率产生，队列一空即补满，测得的 achieved_hz 即为
+  * 该配置的最大吞吐。opt 列为 AD9833_STRESS_OPT (默认由编译器的优化宏得到)，
+  * 同一传输方式在不同优化设置下各运行一次，即可比较。
+  *
+  * 同一份代码在两处运行：
+  * - 目标板: 使用 `AD9833_Stress_DwtClock` (DWT周期计数器扩展为64位)，忙等
+  *   下一次更新，结果包含驱动的全部CPU开销。
+  * - 主机: Host/Bench 中的程序以模拟层的虚拟时间为时钟，空闲时直接推进
+  *   时间；模拟时间只计入总线操作，结果为传输层本身的上限，与优化设置无关。
+  *
+  * 传输方式在编译时选择：定义 AD9833_STRESS_HAL 时测试硬件SPI驱动 (SPI句柄
+  * 由 AD9833_STRESS_HSPI 指定，默认 &hspi2)，否则测试软件SPI驱动。
+  *
+  * 测试会改写两路输出，结束时停在最后一次写入的状态。
+  *
+  * 使用方法：
+  * 1. 将本文件和 AD9833_Queue.c 加入工程，按上面的说明定义传输方式。
+  * 2. 实现一个输出一行文本的函数 (如通过串口发送并补上换行)。
+  * 3. 调用 `AD9833_Stress_Suite(&AD9833_Stress_DwtClock, "soft", 0, output)`，
+  *    或用 `AD9833_Stress_Run()` 运行单项。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_Stress.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(AD9833_STRESS_HAL)
+#include "spi.h"
+#ifndef AD9833_STRESS_HSPI
+#define AD9833_STRESS_HSPI          (&hspi2)
+#endif
+#define AD9833_STRESS_CALL(fn, ...) fn(AD9833_STRESS_HSPI, __VA_ARGS__)
+#else
+#define AD9833_STRESS_CALL(fn, ...) fn(__VA_ARGS__)
+#endif
+
+/**
+ * @brief   测试项: 速率与队列深度
+ */
+typedef struct
+{
+    uint32_t rate_hz;
+    uint32_t depth;
+} AD9833_StressCase;
+
+// 速率从低到高越过两种传输方式的上限; 过载时再比较不同的队列深度
+static const AD9833_StressCase s_case[] = {
+    { 10000,  16 },
+    { 50000,  16 },
+    { 100000, 16 },
+    { 150000, 16 },
+    { 200000, 16 },
+    { 250000, 16 },
+    { 300000, 16 },
+    { 400000, 16 },
+    { 0,      16 },
+    { 300000, 4 },
+    { 300000, 64 },
+};
+
+static AD9833_InitTypedef s_cfg = {
+    .status = CS1_CS2_DOUBLE,
+    .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+    .AD_CS2 = { SINE_WAVE, 1000.0, 90.0, 0, 0 },
+};
+
+static AD9833_Queue s_queue;
+
+/**
+ * @brief       产生第k个更新
+ * @note        8个一组: 4次改频, 2次改相, 1次寄存器选择, 1次波形切换,
+ *              分别发往 CS1、CS2 和两片同时; 寄存器号每组交替
+ * @param       k: 序号
+ * @param       t: 预定时刻 (相对测试开始)
+ * @param       update: 输出
+ * @retval      无
+ */
+static void AD9833_Stress_Make(uint32_t k, uint32_t t, AD9833_Update* update)
+{
+    uint8_t reg = (uint8_t)((k >> 3) & 1U);
+    uint32_t word = 0x00100000UL + (k & 0xFFFFU) * 7U;
+
+    update->t = t;
+    update->arg = reg;
+    update->value = word;
+    switch (k & 7U)
+    {
+    case 0:  update->op = AD9833_UPDATE_FREQ;   update->mask = CS1;     break;
+    case 1:  update->op = AD9833_UPDATE_FREQ;   update->mask = CS2;     break;
+    case 2:  update->op = AD9833_UPDATE_PHASE;  update->mask = CS_BOTH; update->value = (k * 100U) % 36000U; break;
+    case 3:  update->op = AD9833_UPDATE_FREQ;   update->mask = CS_BOTH; break;
+    case 4:  update->op = AD9833_UPDATE_SELECT; update->mask = CS_BOTH; break;
+    case 5:  update->op = AD9833_UPDATE_PHASE;  update->mask = CS1;     update->value = (k * 100U) % 36000U; break;
+    case 6:  update->op = AD9833_UPDATE_FREQ;   update->mask = CS2;     break;
+    default: update->op = AD9833_UPDATE_WAVE;   update->mask = CS2;     update->arg = reg ? TRIANGLE_WAVE : SINE_WAVE; break;
+    }
+}
+
+/**
+ * @brief       写入一个更新
+ * @param       update: 更新
+ * @retval      无
+ */
+static void AD9833_Stress_Execute(const AD9833_Update* update)
+{
+    chipChose mask = (chipChose)update->mask;
+
+    switch (update->op)
+    {
+    case AD9833_UPDATE_FREQ:
+        AD9833_STRESS_CALL(AD9833_FreqSetRaw, mask, update->arg, update->value);
+        break;
+    case AD9833_UPDATE_PHASE:
+        AD9833_STRESS_CALL(AD9833_PhaseSet, mask, update->arg, update->value / 100.0);
+        break;
+    case AD9833_UPDATE_SELECT:
+        AD9833_STRESS_CALL(AD9833_SelectFreqReg, mask, update->arg);
+        break;
+    default:
+        AD9833_STRESS_CALL(AD9833_SetWaveformAndStart, mask, (waveType)update->arg);
+        break;
+    }
+}
+
+/**
+ * @brief       计数折算为纳秒
+ * @param       ticks: 计数
+ * @param       hz: 计数频率
+ * @retval      纳秒 (超出范围时取最大值)
+ */
+static uint32_t AD9833_Stress_Ns(uint64_t ticks, uint32_t hz)
+{
+    uint64_t ns = ticks * 1000000000ULL / hz;
+    return (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+}
+
+/**
+ * @brief       运行一项压力测试
+ * @note        更新的预定时刻按 rate_hz 均匀分布 (整数部分加余数累计, 不漂移);
+ *              rate_hz 为 0 时预定时刻为入队时刻
+ * @param       clock: 时钟
+ * @param       cfg: 测试参数
+ * @param       result: 结果
+ * @retval      1: 完成; 0: 参数无效
+ */
+uint8_t AD9833_Stress_Run(const AD9833_StressClock* clock, const AD9833_StressConfig* cfg, AD9833_StressResult* result)
+{
+    uint32_t hz = clock->hz ? clock->hz : SystemCoreClock;
+    uint32_t rate = cfg->rate_hz;
+    uint32_t step = rate ? hz / rate : 0U;
+    uint32_t rem = rate ? hz % rate : 0U;
+    uint32_t frac = 0, k = 0;
+    uint64_t lat_sum = 0, lat_max = 0;
+
+    if (!hz || !AD9833_Queue_Init(&s_queue, cfg->depth)) return 0;
+    memset(result, 0, sizeof(*result));
+
+    uint64_t deadline = (uint64_t)cfg->deadline_us * hz / 1000000U;
+    uint64_t t0 = clock->now();
+    uint64_t end = t0 + (uint64_t)cfg->duration_ms * hz / 1000U;
+    uint64_t next = t0, last = t0;
+
+    for (;;)
+    {
+        uint64_t now = clock->now();
+        AD9833_Update update;
+
+        // 生产: 补上到期的更新
+        if (rate)
+        {
+            while (next <= now && next < end)
+            {
+                AD9833_Stress_Make(k++, (uint32_t)(next - t0), &update);
+                AD9833_Queue_Push(&s_queue, &update);
+                next += step;
+                frac += rem;
+                if (frac >= rate)
+                {
+                    frac -= rate;
+                    next++;
+                }
+            }
+        }
+        else
+        {
+            while (now < end && AD9833_Queue_Count(&s_queue) <= s_queue.mask)
+            {
+                AD9833_Stress_Make(k++, (uint32_t)(now - t0), &update);
+                AD9833_Queue_Push(&s_queue, &update);
+            }
+        }
+
+        // 消费: 写入一个更新
+        if (AD9833_Queue_Pop(&s_queue, &update))
+        {
+            AD9833_Stress_Execute(&update);
+            last = clock->now();
+
+            uint64_t lat = last - t0 - update.t;
+            lat_sum += lat;
+            if (lat > lat_max) lat_max = lat;
+            if (lat > deadline) result->late++;
+            result->executed++;
+            continue;
+        }
+
+        if (rate ? (next >= end) : (now >= end)) break;
+        if (clock->idle) clock->idle(next);
+    }
+
+    result->offered = k;
+    result->dropped = s_queue.dropped;
+    result->high_water = s_queue.high_water;
+    if (last > t0) result->achieved_hz = (uint32_t)((uint64_t)result->executed * hz / (last - t0));
+    if (result->executed) result->lat_mean_ns = AD9833_Stress_Ns(lat_sum / result->executed, hz);
+    result->lat_max_ns = AD9833_Stress_Ns(lat_max, hz);
+    return 1;
+}
+
+/**
+ * @brief       运行全部测试项并逐行输出CSV
+ * @note        先将两路恢复到 s_cfg 的初始状态; 最后一行为吞吐上限
+ * @param       clock: 时钟
+ * @param       transport: 写入 transport 列的传输方式名称
+ * @param       duration_ms: 每项持续时间 (0 时取 AD9833_STRESS_DURATION_MS)
+ * @param       output: 输出一行的函数
+ * @retval      无
+ */
+void AD9833_Stress_Suite(const AD9833_StressClock* clock, const char* transport, uint32_t duration_ms, AD9833_StressOutput output)
+{
+    char line[AD9833_STRESS_LINE_MAX];
+    uint32_t sustained = 0, ceiling = 0;
+
+    if (duration_ms == 0) duration_ms = AD9833_STRESS_DURATION_MS;
+
+#if defined(AD9833_STRESS_HAL)
+    s_cfg.hspi = AD9833_STRESS_HSPI;
+#endif
+    AD9833_Cmd(&s_cfg);
+
+    snprintf(line, sizeof(line), "# ad9833_stress,%u,%u", (unsigned)AD9833_STRESS_FORMAT, (unsigned)AD9833_STRESS_DEADLINE_US);
+    output(line);
+    output("transport,opt,rate_hz,depth,offered,executed,dropped,late,high_water,achieved_hz,lat_mean_ns,lat_max_ns");
+
+    for (uint32_t c = 0; c < sizeof(s_case) / sizeof(s_case[0]); c++)
+    {
+        AD9833_StressConfig cfg = { s_case[c].rate_hz, s_case[c].depth, duration_ms, AD9833_STRESS_DEADLINE_US };
+        AD9833_StressResult r;
+
+        if (!AD9833_Stress_Run(clock, &cfg, &r)) continue;
+
+        snprintf(line, sizeof(line), "%s,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu",
+                 transport, AD9833_STRESS_OPT, (unsigned long)cfg.rate_hz, (unsigned long)cfg.depth,
+                 (unsigned long)r.offered, (unsigned long)r.executed, (unsigned long)r.dropped,
+                 (unsigned long)r.late, (unsigned long)r.high_water, (unsigned long)r.achieved_hz,
+                 (unsigned long)r.lat_mean_ns, (unsigned long)r.lat_max_ns);
+        output(line);
+
+        if (cfg.rate_hz == 0)
+        {
+            if (r.achieved_hz > ceiling) ceiling = r.achieved_hz;
+        }
+        else if (!r.dropped && !r.late && cfg.rate_hz > sustained)
+        {
+            sustained = cfg.rate_hz;
+        }
+    }
+
+    snprintf(line, sizeof(line), "# ceiling,%s,%s,%lu,%lu", transport, AD9833_STRESS_OPT,
+             (unsigned long)sustained, (unsigned long)ceiling);
+    output(line);
+}
+
+static uint32_t s_dwt_last = 0;
+static uint64_t s_dwt_high = 0;
+
+/**
+ * @brief       DWT时钟: 周期计数器扩展为64位
+ * @note        两次调用的间隔须小于计数器一圈 (168MHz 时约25秒)
+ * @retval      周期数
+ */
+static uint64_t AD9833_Stress_DwtNow(void)
+{
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    uint32_t now = DWT->CYCCNT;
+    s_dwt_high += (uint32_t)(now - s_dwt_last);
+    s_dwt_last = now;
+    return s_dwt_high;
+}
+
+const AD9833_StressClock AD9833_Stress_DwtClock = {
+    AD9833_Stress_DwtNow,
+    0,
+    NULL,
+};
@@ -0,0 +1,98 @@
+#ifndef _AD9833_STRESS_H
+#define _AD9833_STRESS_H
+
+#include <stdint.h>
+#include "AD9833_Queue.h"
+
+// 传输方式由编译选项选择, 与工程中实际编译的驱动一致
+#if defined(AD9833_STRESS_HAL)
+#include "AD9833_HAL.h"
+#else
+#include "AD9833_Soft.h"
+#endif
+
+// 输出格式版本, 列定义变化时加1
+#define AD9833_STRESS_FORMAT        1U
+
+// 写入 opt 列的优化设置名称, 工程可传入构建类型 (如 "Release")
+#ifndef AD9833_STRESS_OPT
+#if !defined(__OPTIMIZE__)
+#define AD9833_STRESS_OPT           "O0"
+#elif defined(__OPTIMIZE_SIZE__)
+#define AD9833_STRESS_OPT           "Os"
+#else
+#define AD9833_STRESS_OPT           "O2"
+#endif
+#endif
+
+// 每项默认持续时间 (毫秒)
+#define AD9833_STRESS_DURATION_MS   100U
+
+// 默认截止时间: 更新从产生到写完超过此值计为迟到 (微秒)
+#define AD9833_STRESS_DEADLINE_US   50U
+
+// 一行输出的最大长度 (含结尾的 '\0')
+#define AD9833_STRESS_LINE_MAX      128U
+
+/**
+  * @brief 时钟
+  *     @arg now: 当前时刻 (计数, 单调递增)
+  *     @arg hz: 计数频率, 0 表示 SystemCoreClock
+  *     @arg idle: 队列空且下一次更新未到时调用, 参数为下一次更新的时刻;
+  *                为 NULL 时忙等 (目标板), 主机上用于推进模拟时间
+  */
+typedef struct
+{
+    uint64_t (*now)(void);
+    uint32_t hz;
+    void (*idle)(uint64_t until);
+} AD9833_StressClock;
+
+/**
+  * @brief 一项压力测试
+  *     @arg rate_hz: 产生更新的速率 (次/秒), 0 表示队列一空即补满 (测最大吞吐)
+  *     @arg depth: 队列深度 (2的幂, 不超过 AD9833_QUEUE_DEPTH_MAX)
+  *     @arg duration_ms: 产生更新的持续时间, 结束后写完队列中剩余的更新
+  *     @arg deadline_us: 截止时间
+  */
+typedef struct
+{
+    uint32_t rate_hz;
+    uint32_t depth;
+    uint32_t duration_ms;
+    uint32_t deadline_us;
+} AD9833_StressConfig;
+
+/**
+  * @brief 一项压力测试的结果
+  *     @arg offered: 产生的更新数
+  *     @arg executed: 写入芯片的更新数
+  *     @arg dropped: 队列满而丢弃的更新数
+  *     @arg late: 超过截止时间的更新数
+  *     @arg high_water: 队列长度的最大值
+  *     @arg achieved_hz: 实际写入速率 (次/秒)
+  *     @arg lat_mean_ns: 平均延迟 (产生到写完)
+  *     @arg lat_max_ns: 最大延迟
+  */
+typedef struct
+{
+    uint32_t offered;
+    uint32_t executed;
+    uint32_t dropped;
+    uint32_t late;
+    uint32_t high_water;
+    uint32_t achieved_hz;
+    uint32_t lat_mean_ns;
+    uint32_t lat_max_ns;
+} AD9833_StressResult;
+
+// 输出一行 (不含换行符)
+typedef void (*AD9833_StressOutput)(const char* line);
+
+/* 函数声明 */
+uint8_t AD9833_Stress_Run(const AD9833_StressClock* clock, const AD9833_StressConfig* cfg, AD9833_StressResult* result);
+void AD9833_Stress_Suite(const AD9833_StressClock* clock, const char* transport, uint32_t duration_ms, AD9833_StressOutput output);
+
+extern const AD9833_StressClock AD9833_Stress_DwtClock;
+
+#endif /* _AD9833_STRESS_H */
@@ -0,0 +1,200 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Table.c
+  * @brief          : 播放主机编译好的数据字表
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 扫频/跳频计划由主机上的 `ad9833_plan` (Host/Plan) 编译成数据字表：频率字
+  * 换算、半字 (B28=0/HLB) 更新和重复写入的消除都在主机上完成，固件只按
+  * 节拍把每一步的数据字原样写出，不做任何浮点运算。表可以放在RAM中，
+  * 也可以作为 const 数组 (`ad9833_plan -c`) 链接进Flash，播放时直接读取，
+  * 不复制。
+  *
+  * 格式 (多字节数均为低字节在前，全部按16位对齐)：
+  *
+  *     表头 16字节: magic "AD9T" (u32) | version (u8) | chips (u8) | tick_hz (u16)
+  *                  | steps (u16) | loop_step (u16) | words (u32)
+  *     每一步:      dwell (u16, 节拍数, >= 1) | count (u16) | count 个数据字 (u16)
+  *
+  * 所有数据字广播写入 chips 中的芯片。第0步把芯片设为最后一步之后的状态，
+  * 循环播放时从 loop_step 继续，因此每一步只需写出相对上一步变化的部分。
+  * 播放直接写数据字，不经过驱动的控制字缓存：播放结束后使用驱动的其他
+  * 接口前，先调用 `AD9833_CtrlRestore()` 按缓存重写控制字，或者调用
+  * `AD9833_Cmd()`、`AD9833_Init()` 重新初始化。
+  *
+  * 预置写入 (AD9833_StageCtrl，外部触发) 未结束时驱动拒绝写入 (HAL_BUSY)，
+  * 这期间的数据字丢失，不计入状态中的 words；由于每一步只写变化的部分，
+  * 丢失后芯片状态一直与表不符，触发待命期间不要播放。播放期间主循环也
+  * 不要写 chips 中的芯片。
+  *
+  * 使用方法：
+  * 1. 调用 `AD9833_Table_Load()` 检查并登记表 (表在播放期间须保持有效)。
+  * 2. 调用 `AD9833_Table_Run()` 开始播放。
+  * 3. 在 AD9833_TABLE_TICK_HZ 的定时器更新中断中调用 `AD9833_Table_Tick()`。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Table.h"
+
+/**
+ * @brief   播放控制
+ *      @arg state: 对外的状态
+ *      @arg table: 表
+ *      @arg chips: 芯片掩码
+ *      @arg steps: 总步数
+ *      @arg loop_step: 循环时回到的步
+ *      @arg loop_pos: loop_step 在表中的偏移
+ *      @arg pos: 下一步在表中的偏移
+ *      @arg wait: 执行下一步前还要等待的节拍数
+ */
+typedef struct
+{
+    AD9833_TableState state;
+    const uint8_t* table;
+    chipChose chips;
+    uint16_t steps;
+    uint16_t loop_step;
+    uint32_t loop_pos;
+    uint32_t pos;
+    uint32_t wait;
+} AD9833_TablePlayer;
+
+static AD9833_TablePlayer s_player;
+
+/**
+ * @brief       读取16位数 (低字节在前)
+ */
+static uint16_t AD9833_Table_U16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief       检查并登记一张表
+ * @note        检查表头、每一步的长度和数据字总数, 不检查数据字的内容
+ * @param       table: 表 (播放期间须保持有效, 可在Flash中)
+ * @param       len: 字节数
+ * @retval      HAL_OK: 已登记; HAL_BUSY: 正在播放; HAL_ERROR: 格式错误或节拍频率不符
+ */
+HAL_StatusTypeDef AD9833_Table_Load(const uint8_t* table, uint32_t len)
+{
+    if (s_player.state.running) return HAL_BUSY;
+    if (!table || len < AD9833_TABLE_HEADER_SIZE) return HAL_ERROR;
+
+    uint32_t magic = (uint32_t)AD9833_Table_U16(table) | ((uint32_t)AD9833_Table_U16(&table[2]) << 16);
+    uint8_t chips = table[5];
+    uint16_t steps = AD9833_Table_U16(&table[8]);
+    uint16_t loop_step = AD9833_Table_U16(&table[10]);
+    uint32_t words = (uint32_t)AD9833_Table_U16(&table[12]) | ((uint32_t)AD9833_Table_U16(&table[14]) << 16);
+
+    if (magic != AD9833_TABLE_MAGIC || table[4] != AD9833_TABLE_VERSION) return HAL_ERROR;
+    if (!chips || (chips & ~CS_ALL) || AD9833_Table_U16(&table[6]) != AD9833_TABLE_TICK_HZ) return HAL_ERROR;
+    if (!steps || loop_step >= steps) return HAL_ERROR;
+
+    uint32_t pos = AD9833_TABLE_HEADER_SIZE, loop_pos = 0, total = 0;
+    for (uint32_t i = 0; i < steps; i++)
+    {
+        if (len - pos < AD9833_TABLE_STEP_SIZE) return HAL_ERROR;
+        uint16_t dwell = AD9833_Table_U16(&table[pos]);
+        uint16_t count = AD9833_Table_U16(&table[pos + 2U]);
+        if (!dwell || (len - pos - AD9833_TABLE_STEP_SIZE) / 2U < count) return HAL_ERROR;
+
+        if (i == loop_step) loop_pos = pos;
+        pos += AD9833_TABLE_STEP_SIZE + 2U * count;
+        total += count;
+    }
+    if (pos != len || total != words) return HAL_ERROR;
+
+    s_player.table = table;
+    s_player.chips = chips;
+    s_player.state.chips = chips;
+    s_player.steps = steps;
+    s_player.loop_step = loop_step;
+    s_player.loop_pos = loop_pos;
+    return HAL_OK;
+}
+
+/**
+ * @brief       从第0步开始播放
+ * @param       loops: 播放遍数, 0 为无限循环 (第0步只执行一次)
+ * @retval      HAL_OK: 已开始; HAL_BUSY: 正在播放; HAL_ERROR: 没有登记表
+ */
+HAL_StatusTypeDef AD9833_Table_Run(uint8_t loops)
+{
+    if (s_player.state.running) return HAL_BUSY;
+    if (!s_player.table) return HAL_ERROR;
+
+    s_player.pos = AD9833_TABLE_HEADER_SIZE;
+    s_player.wait = 0;
+    s_player.state.step = 0;
+    s_player.state.loops = loops;
+    s_player.state.steps = 0;
+    s_player.state.words = 0;
+    s_player.state.running = 1;     // 最后置位, 中断此后才开始执行
+
+    return HAL_OK;
+}
+
+/**
+ * @brief       停止播放
+ * @note        芯片保持当前输出; 之后使用驱动的其他接口前先调用 AD9833_CtrlRestore()
+ * @retval      无
+ */
+void AD9833_Table_Stop(void)
+{
+    s_player.state.running = 0;
+}
+
+/**
+ * @brief       播放, 在定时器更新中断中以 AD9833_TABLE_TICK_HZ 调用
+ * @note        等待的节拍数到0时写出一步的全部数据字, 然后按该步的停留节拍重新计数
+ * @retval      无
+ */
+void AD9833_Table_Tick(void)
+{
+    AD9833_TableState* st = &s_player.state;
+
+    if (!st->running) return;
+    if (s_player.wait)
+    {
+        s_player.wait--;
+        return;
+    }
+
+    const uint8_t* p = &s_player.table[s_player.pos];
+    uint16_t dwell = AD9833_Table_U16(p);
+    uint16_t count = AD9833_Table_U16(&p[2]);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (AD9833_Write(s_player.chips, AD9833_Table_U16(&p[AD9833_TABLE_STEP_SIZE + 2U * i])) == HAL_OK)
+        {
+            st->words++;
+        }
+    }
+    st->steps++;
+    s_player.wait = dwell - 1U;
+
+    s_player.pos += AD9833_TABLE_STEP_SIZE + 2U * count;
+    if (++st->step < s_player.steps) return;
+
+    st->step = s_player.loop_step;
+    s_player.pos = s_player.loop_pos;
+    if (st->loops && --st->loops == 0) st->running = 0;
+}
+
+/**
+ * @brief       读取播放状态
+ * @param       state: 输出
+ * @retval      无
+ */
+void AD9833_Table_GetState(AD9833_TableState* state)
+{
+    *state = s_player.state;
+}
@@ -0,0 +1,46 @@
+#ifndef _AD9833_TABLE_H
+#define _AD9833_TABLE_H
+
+#include "main.h"
+#include "AD9833_Soft.h"
+
+// 数据字表的标识 "AD9T" 和格式版本
+#define AD9833_TABLE_MAGIC          0x54394441U
+#define AD9833_TABLE_VERSION        1U
+
+// 表头和每步记录头的字节数
+#define AD9833_TABLE_HEADER_SIZE    16U
+#define AD9833_TABLE_STEP_SIZE      4U
+
+// AD9833_Table_Tick() 的调用频率 (Hz), 表头中的节拍频率必须与此相同
+#ifndef AD9833_TABLE_TICK_HZ
+#define AD9833_TABLE_TICK_HZ        1000U
+#endif
+
+/**
+  * @brief 播放状态
+  *     @arg running: 正在播放
+  *     @arg loops: 剩余遍数 (0 为无限循环)
+  *     @arg step: 下一步的序号
+  *     @arg steps: 已执行的总步数
+  *     @arg words: 已写出的数据字数 (不含预置写入期间被拒绝的)
+  *     @arg chips: 登记的表写入的芯片掩码
+  */
+typedef struct
+{
+    uint8_t running;
+    uint8_t loops;
+    uint16_t step;
+    uint32_t steps;
+    uint32_t words;
+    chipChose chips;
+} AD9833_TableState;
+
+/* 函数声明 */
+HAL_StatusTypeDef AD9833_Table_Load(const uint8_t* table, uint32_t len);
+HAL_StatusTypeDef AD9833_Table_Run(uint8_t loops);
+void AD9833_Table_Stop(void);
+void AD9833_Table_Tick(void);
+void AD9833_Table_GetState(AD9833_TableState* state);
+
+#endif /* _AD9833_TABLE_H */
@@ -0,0 +1,171 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Trace.c
+  * @brief          : 驱动发出的数据字记录, 用于与基准记录比较
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-15
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 定义 AD9833_TRACE_ENABLE 后，驱动 (AD9833_Soft / AD9833_HAL) 在传输层每发出
+  * 一个完整的数据字就调用 `AD9833_Trace_Record()`，记下时刻、芯片掩码和数据
+  * 字。预置写入 (AD9833_StageCtrl) 在 `AD9833_StageLatch()` 产生第16个下降沿时
+  * 记录，未锁存就放弃的字不记录。不定义时记录点为空语句，本文件也不参与
+  * 编译输出。
+  *
+  * 记录的文本格式 (每个场景一段，可多段拼接为一个文件)：
+  *
+  *     # ad9833_trace,<格式版本>,<时间戳时钟Hz>
+  *     @ <场景名>
+  *     <time>,<mask>,<word>
+  *     0,0x00000003,0x2100
+  *     ...
+  *
+  * time 为十进制周期数，mask 和 word 为十六进制。主机上的
+  * `ad9833_trace_diff` 比较两份记录 (Host/Trace)，按场景报告数据字数的增减，
+  * 并用行为模型判断序列变化后芯片的最终寄存器是否相同。
+  *
+  * 使用方法：
+  * 1. 在编译选项中定义 AD9833_TRACE_ENABLE，将本文件加入工程。
+  * 2. 调用 `AD9833_Trace_Start()` 清空记录并开始，执行要记录的操作。
+  * 3. 调用 `AD9833_Trace_Dump(&huart1, "场景名")` 输出，或用
+  *    `AD9833_Trace_Get()` 逐条读取。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_Trace.h"
+
+#if defined(AD9833_TRACE_ENABLE)
+
+#include <stdio.h>
+#include <string.h>
+
+static AD9833_TraceEntry s_entry[AD9833_TRACE_DEPTH];
+static volatile uint32_t s_count = 0;
+static volatile uint32_t s_dropped = 0;
+static volatile uint8_t s_running = 0;
+static uint32_t s_start = 0;
+
+/**
+ * @brief       清空记录并开始记录
+ * @note        时间戳来源为 DWT 时使能周期计数器
+ * @retval      无
+ */
+void AD9833_Trace_Start(void)
+{
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk))
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+#endif
+    s_running = 0;
+    s_count = 0;
+    s_dropped = 0;
+    s_start = AD9833_TRACE_TIME();
+    s_running = 1;
+}
+
+/**
+ * @brief       停止记录, 已有记录保留
+ * @retval      无
+ */
+void AD9833_Trace_Stop(void)
+{
+    s_running = 0;
+}
+
+/**
+ * @brief       记录一个数据字
+ * @note        由驱动的传输层调用, 可在中断中调用 (短暂关中断)
+ * @param       mask: 接收该字的芯片掩码
+ * @param       word: 数据字
+ * @retval      无
+ */
+void AD9833_Trace_Record(uint32_t mask, uint16_t word)
+{
+    if (!s_running) return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (s_count < AD9833_TRACE_DEPTH)
+    {
+        AD9833_TraceEntry* e = &s_entry[s_count];
+        e->time = AD9833_TRACE_TIME() - s_start;
+        e->mask = mask;
+        e->word = word;
+        s_count++;
+    }
+    else
+    {
+        s_dropped++;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief       已记录的数据字数
+ * @retval      条数
+ */
+uint32_t AD9833_Trace_Count(void)
+{
+    return s_count;
+}
+
+/**
+ * @brief       记满后丢弃的数据字数
+ * @retval      条数, 不为0时记录不完整
+ */
+uint32_t AD9833_Trace_Dropped(void)
+{
+    return s_dropped;
+}
+
+/**
+ * @brief       读取一条记录
+ * @param       index: 序号 (0 起)
+ * @retval      记录, 序号超出时为 NULL
+ */
+const AD9833_TraceEntry* AD9833_Trace_Get(uint32_t index)
+{
+    return (index < s_count) ? &s_entry[index] : NULL;
+}
+
+/**
+ * @brief       通过串口输出记录 (一个场景一段)
+ * @note        阻塞发送; 有丢弃时在段尾输出 "# dropped,<条数>", 比较工具视为错误
+ * @param       huart: 串口句柄
+ * @param       scenario: 场景名 (不含空白和逗号)
+ * @retval      无
+ */
+void AD9833_Trace_Dump(UART_HandleTypeDef* huart, const char* scenario)
+{
+    char line[64];
+    int len;
+
+    len = snprintf(line, sizeof(line), "# ad9833_trace,%u,%lu\r\n@ ",
+                   (unsigned)AD9833_TRACE_FORMAT, (unsigned long)SystemCoreClock);
+    HAL_UART_Transmit(huart, (const uint8_t*)line, (uint16_t)len, HAL_MAX_DELAY);
+    HAL_UART_Transmit(huart, (const uint8_t*)scenario, (uint16_t)strlen(scenario), HAL_MAX_DELAY);
+    HAL_UART_Transmit(huart, (const uint8_t*)"\r\n", 2, HAL_MAX_DELAY);
+
+    for (uint32_t i = 0; i < s_count; i++)
+    {
+        len = snprintf(line, sizeof(line), "%lu,0x%08lX,0x%04X\r\n", (unsigned long)s_entry[i].time,
+                       (unsigned long)s_entry[i].mask, (unsigned)s_entry[i].word);
+        HAL_UART_Transmit(huart, (const uint8_t*)line, (uint16_t)len, HAL_MAX_DELAY);
+    }
+    if (s_dropped)
+    {
+        len = snprintf(line, sizeof(line), "# dropped,%lu\r\n", (unsigned long)s_dropped);
+        HAL_UART_Transmit(huart, (const uint8_t*)line, (uint16_t)len, HAL_MAX_DELAY);
+    }
+}
+
+#endif /* AD9833_TRACE_ENABLE */
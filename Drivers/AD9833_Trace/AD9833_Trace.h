@@ -0,0 +1,41 @@
+#ifndef _AD9833_TRACE_H
+#define _AD9833_TRACE_H
+
+#include "main.h"
+
+// 记录的数据字个数上限, 记满后丢弃并计数
+#ifndef AD9833_TRACE_DEPTH
+#define AD9833_TRACE_DEPTH          512U
+#endif
+
+// 输出格式版本, 格式变化时加1
+#define AD9833_TRACE_FORMAT         1U
+
+// 时间戳来源, 默认为 DWT 周期计数器
+#ifndef AD9833_TRACE_TIME
+#define AD9833_TRACE_TIME()         (DWT->CYCCNT)
+#endif
+
+/**
+  * @brief 一个数据字的记录
+  *     @arg time: 开始发送的时刻 (CPU周期, 相对 AD9833_Trace_Start())
+  *     @arg mask: 接收该字的芯片掩码 (与 chipChose 相同, 广播写入为多位)
+  *     @arg word: 16位数据字
+  */
+typedef struct
+{
+    uint32_t time;
+    uint32_t mask;
+    uint16_t word;
+} AD9833_TraceEntry;
+
+/* 函数声明 */
+void AD9833_Trace_Start(void);
+void AD9833_Trace_Stop(void);
+void AD9833_Trace_Record(uint32_t mask, uint16_t word);
+uint32_t AD9833_Trace_Count(void);
+uint32_t AD9833_Trace_Dropped(void);
+const AD9833_TraceEntry* AD9833_Trace_Get(uint32_t index);
+void AD9833_Trace_Dump(UART_HandleTypeDef* huart, const char* scenario);
+
+#endif /* _AD9833_TRACE_H */
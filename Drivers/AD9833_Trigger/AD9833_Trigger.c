@@ -0,0 +1,297 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Trigger.c
+  * @brief          : 多块板卡通过公共触发线同步启动/跳频
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-11
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 多块 STM32 + 双AD9833 板卡级联时，各板卡的写入时刻由各自的CPU决定，
+  * 软件上无法对齐。AD9833 在 FSYNC 为低期间的第16个 SCLK 下降沿锁存数
+  * 据字，本模块利用这一点：每块板卡预先发出启动 (或寄存器切换) 命令的
+  * 前15位，片选保持低电平，最后一位已放在 SDATA 上 (见驱动中的
+  * `AD9833_StageCtrl()`)；公共触发线上的下降沿进入各板卡的 EXTI 中断，
+  * 中断入口处立即产生第16个下降沿，所有板卡在几十个CPU周期内同时锁存。
+  *
+  * 板卡间的时差来自中断响应时间的抖动 (指令完成、FLASH等待、同优先级
+  * 中断)，与软件执行路径无关。主机用自己的触发输出回环测量触发到锁存的
+  * 延迟，所有板卡运行相同的中断代码，其 max - min 即为板卡间时差的上界。
+  * EXTI1 使用最高优先级0，同为优先级0的 DMA 中断正在执行时会增加一次延迟，
+  * 要求更严格时可将其他中断的优先级降低。
+  *
+  * 接线 (每块板卡)：
+  * - PB1 (AD9833_TRIG): 触发输入, 上拉, 下降沿中断, 连接公共触发线。
+  * - PB0 (AD9833_TRIG_OUT): 开漏输出, 仅主机使用, 连接公共触发线。
+  * - 各板卡共地, 触发线空闲时为高电平。
+  *
+  * 本模块基于软件SPI驱动 (AD9833_Soft)，硬件SPI无法停在一帧的最后一位，
+  * 不支持此功能。预置期间SPI总线被占用，其他写入函数不会发出数据。
+  *
+  * 使用方法：
+  * 1. 各板卡调用 `AD9833_Trigger_Init()` 设定角色，在 stm32f4xx_it.c 的
+  * EXTI1_IRQHandler 用户代码段0中调用 `AD9833_Trigger_IRQHandler()`。
+  * 2. 同步启动：各板卡调用 `AD9833_Init()` 并写入频率/相位 (芯片保持复位)，
+  * 然后调用 `AD9833_Trigger_ArmStart()`；同步跳频：在未使用的寄存器中
+  * 写好新的频率/相位，调用 `AD9833_Trigger_ArmHop()`。
+  * 3. 所有板卡预置完成后，主机调用 `AD9833_Trigger_Fire()`，从机可调用
+  * `AD9833_Trigger_Wait()` 等待触发完成。
+  * 4. 主机可调用 `AD9833_Trigger_Measure()` 重复触发以统计延迟和抖动，
+  * 结果由 `AD9833_Trigger_GetStat()` 读取。
+  *
+  ******************************************************************************
+  */
+
+
+#include "AD9833_Trigger.h"
+#include <math.h>
+
+/**
+ * @brief   触发状态
+ *      @arg role: 本板卡的角色
+ *      @arg armed: 已预置写入, 等待触发
+ *      @arg fired: 最近一次预置已由触发完成
+ *      @arg t_fire: 主机拉低触发线时的 DWT 计数
+ *      @arg latency: 最近一次触发到锁存的周期数
+ *      @arg count: 完成锁存的触发次数
+ *      @arg spurious: 没有预置写入时收到的触发次数
+ *      @arg samples: 参与延迟统计的次数
+ *      @arg min: 最小延迟
+ *      @arg max: 最大延迟
+ *      @arg mean: 平均延迟
+ *      @arg m2: 延迟与均值之差的平方和 (Welford)
+ */
+typedef struct
+{
+    AD9833_TriggerRole role;
+    volatile uint8_t armed;
+    volatile uint8_t fired;
+    volatile uint32_t t_fire;
+    volatile uint32_t latency;
+    volatile uint32_t count;
+    volatile uint32_t spurious;
+    uint32_t samples;
+    uint32_t min;
+    uint32_t max;
+    double mean;
+    double m2;
+} AD9833_TriggerState;
+
+static AD9833_TriggerState s_trig = {0};
+
+/**
+ * @brief       使能 DWT 周期计数器
+ * @retval      无
+ */
+static void AD9833_Trigger_DwtInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief       设置本板卡的角色并清零统计
+ * @note        触发输出释放为高阻 (开漏高电平), 从机不驱动触发线
+ * @param       role: 角色
+ *                  @arg AD9833_TRIGGER_SLAVE: 从机
+ *                  @arg AD9833_TRIGGER_MASTER: 主机
+ * @retval      无
+ */
+void AD9833_Trigger_Init(AD9833_TriggerRole role)
+{
+    AD9833_Trigger_DwtInit();
+
+    AD9833_Trigger_Disarm();
+    WRITE_REG(AD9833_TRIG_OUT_GPIO_Port->BSRR, AD9833_TRIG_OUT_Pin);
+    __HAL_GPIO_EXTI_CLEAR_IT(AD9833_TRIG_Pin);
+
+    s_trig.role = role;
+    s_trig.fired = 0;
+    AD9833_Trigger_ResetStat();
+}
+
+/**
+ * @brief       根据预置结果更新状态
+ * @param       staged: AD9833_StageCtrl() 系列函数的返回值
+ * @retval      HAL_OK: 已预置; HAL_BUSY: 已有预置写入; HAL_ERROR: 参数无效或各片控制字不同
+ */
+static HAL_StatusTypeDef AD9833_Trigger_Armed(uint8_t staged)
+{
+    if (!staged) return s_trig.armed ? HAL_BUSY : HAL_ERROR;
+
+    s_trig.fired = 0;
+    s_trig.armed = 1;
+    return HAL_OK;
+}
+
+/**
+ * @brief       预置启动命令, 触发时芯片退出复位开始输出
+ * @note        芯片应处于复位状态且已写好频率和相位, 各片当前的控制字须相同
+ * @param       choice: 片选参数, AD9833_CS(n) 的任意组合
+ * @param       wave: 波形选择
+ * @retval      HAL_OK: 已预置; HAL_BUSY: 已有预置写入; HAL_ERROR: 参数无效或各片控制字不同
+ */
+HAL_StatusTypeDef AD9833_Trigger_ArmStart(chipChose choice, waveType wave)
+{
+    return AD9833_Trigger_Armed(AD9833_StageStart(choice, wave));
+}
+
+/**
+ * @brief       预置寄存器切换命令, 触发时同时切换频率和相位寄存器
+ * @param       choice: 片选参数, AD9833_CS(n) 的任意组合, 各片当前的控制字须相同
+ * @param       freq_reg_num: 切换后使用的频率寄存器 (0 或 1)
+ * @param       phase_reg_num: 切换后使用的相位寄存器 (0 或 1)
+ * @retval      同 AD9833_Trigger_ArmStart()
+ */
+HAL_StatusTypeDef AD9833_Trigger_ArmHop(chipChose choice, uint8_t freq_reg_num, uint8_t phase_reg_num)
+{
+    return AD9833_Trigger_Armed(AD9833_StageSelect(choice, freq_reg_num, phase_reg_num));
+}
+
+/**
+ * @brief       放弃未触发的预置写入
+ * @note        片选在第16个下降沿之前拉高, 芯片不会写入
+ * @retval      无
+ */
+void AD9833_Trigger_Disarm(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (s_trig.armed)
+    {
+        AD9833_StageRelease();
+        s_trig.armed = 0;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief       等待预置写入由触发完成
+ * @param       timeout_ms: 超时时间 (毫秒)
+ * @retval      HAL_OK: 已完成; HAL_TIMEOUT: 超时, 预置仍然有效
+ */
+HAL_StatusTypeDef AD9833_Trigger_Wait(uint32_t timeout_ms)
+{
+    uint32_t tickstart = HAL_GetTick();
+
+    while (!s_trig.fired)
+    {
+        if (HAL_GetTick() - tickstart >= timeout_ms) return HAL_TIMEOUT;
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief       主机拉低触发线, 等待本板卡锁存后释放
+ * @note        低电平保持到本板卡锁存之后 (至少一次中断响应时间, 远大于 EXTI 要求的
+ *              最小脉宽); 本板卡锁存成功时记录一次触发到锁存的延迟
+ * @retval      HAL_OK: 成功; HAL_ERROR: 不是主机或本板卡没有预置; HAL_TIMEOUT: 没有收到触发
+ */
+HAL_StatusTypeDef AD9833_Trigger_Fire(void)
+{
+    if (s_trig.role != AD9833_TRIGGER_MASTER || !s_trig.armed) return HAL_ERROR;
+
+    s_trig.t_fire = DWT->CYCCNT;
+    WRITE_REG(AD9833_TRIG_OUT_GPIO_Port->BSRR, (uint32_t)AD9833_TRIG_OUT_Pin << 16U);
+
+    HAL_StatusTypeDef status = AD9833_Trigger_Wait(AD9833_TRIGGER_TIMEOUT_MS);
+    WRITE_REG(AD9833_TRIG_OUT_GPIO_Port->BSRR, AD9833_TRIG_OUT_Pin);
+
+    if (status != HAL_OK) return status;
+
+    // Welford 累计延迟统计
+    uint32_t latency = s_trig.latency;
+    double delta = (double)latency - s_trig.mean;
+
+    s_trig.samples++;
+    s_trig.mean += delta / (double)s_trig.samples;
+    s_trig.m2 += delta * ((double)latency - s_trig.mean);
+    if (latency < s_trig.min) s_trig.min = latency;
+    if (latency > s_trig.max) s_trig.max = latency;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief       主机重复触发以统计触发到锁存的延迟
+ * @note        每次重写 choice 当前的控制字, 输出不受影响; 从机此时不应预置,
+ *              其 spurious 计数会随之增加
+ * @param       choice: 片选参数, 各片当前的控制字须相同
+ * @param       times: 触发次数
+ * @retval      HAL_OK: 成功; 其他: 同 AD9833_Trigger_Fire(), 预置失败时返回 HAL_ERROR
+ */
+HAL_StatusTypeDef AD9833_Trigger_Measure(chipChose choice, uint32_t times)
+{
+    HAL_StatusTypeDef status = HAL_OK;
+
+    for (uint32_t i = 0; i < times && status == HAL_OK; i++)
+    {
+        status = AD9833_Trigger_Armed(AD9833_StageCtrl(choice, 0U, 0U));
+        if (status == HAL_OK)
+        {
+            status = AD9833_Trigger_Fire();
+        }
+    }
+
+    if (status != HAL_OK) AD9833_Trigger_Disarm();
+    return status;
+}
+
+/**
+ * @brief       触发线下降沿中断处理
+ * @note        在 EXTI1_IRQHandler 的用户代码段0中调用, 入口处即产生锁存沿;
+ *              EXTI 标志由随后的 HAL_GPIO_EXTI_IRQHandler() 清除
+ * @retval      无
+ */
+void AD9833_Trigger_IRQHandler(void)
+{
+    if (!AD9833_StageLatch())
+    {
+        s_trig.spurious++;
+        return;
+    }
+    uint32_t t_latch = DWT->CYCCNT;
+
+    AD9833_StageRelease();
+
+    s_trig.latency = t_latch - s_trig.t_fire;
+    s_trig.count++;
+    s_trig.armed = 0;
+    s_trig.fired = 1;
+}
+
+/**
+ * @brief       读取触发统计
+ * @param       stat: 输出统计结果, 没有延迟样本时 min/max/mean/std 为0
+ * @retval      无
+ */
+void AD9833_Trigger_GetStat(AD9833_TriggerStat* stat)
+{
+    if (!stat) return;
+
+    stat->count = s_trig.count;
+    stat->spurious = s_trig.spurious;
+    stat->samples = s_trig.samples;
+    stat->last = s_trig.samples ? s_trig.latency : 0U;
+    stat->min = s_trig.samples ? s_trig.min : 0U;
+    stat->max = s_trig.max;
+    stat->mean = (float)s_trig.mean;
+    stat->std = (s_trig.samples > 1U) ? (float)sqrt(s_trig.m2 / (double)(s_trig.samples - 1U)) : 0.0f;
+}
+
+/**
+ * @brief       清零触发统计
+ * @retval      无
+ */
+void AD9833_Trigger_ResetStat(void)
+{
+    s_trig.count = 0;
+    s_trig.spurious = 0;
+    s_trig.samples = 0;
+    s_trig.min = UINT32_MAX;
+    s_trig.max = 0;
+    s_trig.mean = 0.0;
+    s_trig.m2 = 0.0;
+}
@@ -0,0 +1,56 @@
+#ifndef _AD9833_TRIGGER_H
+#define _AD9833_TRIGGER_H
+
+#include "main.h"
+#include "AD9833_Soft.h"
+
+// 等待触发的默认超时 (毫秒)
+#define AD9833_TRIGGER_TIMEOUT_MS   100U
+
+/**
+  * @brief 板卡在触发线上的角色
+  *     @arg AD9833_TRIGGER_SLAVE: 从机, 只接收触发
+  *     @arg AD9833_TRIGGER_MASTER: 主机, 驱动触发线并测量触发到锁存的延迟
+  */
+typedef enum
+{
+    AD9833_TRIGGER_SLAVE = 0,
+    AD9833_TRIGGER_MASTER
+} AD9833_TriggerRole;
+
+/**
+  * @brief 触发统计
+  *     @arg count: 完成锁存的触发次数
+  *     @arg spurious: 没有预置写入时收到的触发次数
+  *     @arg samples: 参与延迟统计的次数 (仅主机)
+  *     @arg last: 最近一次触发到锁存的延迟 (CPU周期)
+  *     @arg min: 最小延迟 (CPU周期)
+  *     @arg max: 最大延迟 (CPU周期), max - min 即板卡间时差的上界
+  *     @arg mean: 平均延迟 (CPU周期)
+  *     @arg std: 延迟的标准差 (CPU周期)
+  */
+typedef struct
+{
+    uint32_t count;
+    uint32_t spurious;
+    uint32_t samples;
+    uint32_t last;
+    uint32_t min;
+    uint32_t max;
+    float mean;
+    float std;
+} AD9833_TriggerStat;
+
+/* 函数声明 */
+void AD9833_Trigger_Init(AD9833_TriggerRole role);
+HAL_StatusTypeDef AD9833_Trigger_ArmStart(chipChose choice, waveType wave);
+HAL_StatusTypeDef AD9833_Trigger_ArmHop(chipChose choice, uint8_t freq_reg_num, uint8_t phase_reg_num);
+void AD9833_Trigger_Disarm(void);
+HAL_StatusTypeDef AD9833_Trigger_Fire(void);
+HAL_StatusTypeDef AD9833_Trigger_Wait(uint32_t timeout_ms);
+HAL_StatusTypeDef AD9833_Trigger_Measure(chipChose choice, uint32_t times);
+void AD9833_Trigger_IRQHandler(void);
+void AD9833_Trigger_GetStat(AD9833_TriggerStat* stat);
+void AD9833_Trigger_ResetStat(void);
+
+#endif /* _AD9833_TRIGGER_H */
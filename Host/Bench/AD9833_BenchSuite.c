@@ -0,0 +1,317 @@
+/**
+******************************************************************************
+  * @file           : AD9833_BenchSuite.c
+  * @brief          : 在模拟层上运行 AD9833_Bench 并与基线比较
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-14
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 同一份源文件按传输方式分别编译 (AD9833_BENCH_HAL / AD9833_BENCH_MSPM0 /
+  * 默认软件SPI)，与目标板使用同一个 AD9833_Bench 模块，只把测量方法换成
+  * 模拟层的计数：
+  * - words: 总线上完成的16位数据字数 (Mock_Counters.bus_words)
+  * - cs_toggles: 片选引脚的上升沿与下降沿数
+  * - bus_ns: 模拟时间 (Mock_HAL 默认时间模型)
+  * - cycles: 模拟时间按内核时钟折算 (STM32F407 168MHz, MSPM0 32MHz)
+  *
+  * CSV 输出到标准输出，说明与比较结果输出到标准错误。参数：
+  *   -n <次数>     每项调用次数 (默认 AD9833_BENCH_REPEAT)
+  *   -o <文件>     同时写入文件
+  *   -b <文件>     与基线比较: 取基线中同一传输方式的行，words 和 cs_toggles
+  *                 须完全相同，bus_ns 和 cycles_mean 不得超过基线的
+  *                 (1 + BENCH_TOLERANCE)；两边的测量项须一一对应。
+  *
+  * 驱动改动有意改变了写入序列或耗时时，重新生成基线 (三个程序的输出依次
+  * 拼接即可，表头行在比较时忽略)：
+  *   for t in soft hal mspm0; do build-host/ad9833_benchsuite_$t; done > Host/Bench/AD9833_Bench_Baseline.csv
+  *
+  ******************************************************************************
+  */
+
+#include "Mock_HAL.h"
+#include "AD9833_Bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(AD9833_BENCH_HAL)
+#include "spi.h"
+#define BENCH_TRANSPORT             "hal"
+#define BENCH_PORT(port)            Mock_STM32_Port(port)
+#define BENCH_CS1                   { BENCH_PORT(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin }
+#define BENCH_CS2                   { BENCH_PORT(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin }
+#define BENCH_CORE_HZ               168000000ULL
+#elif defined(AD9833_BENCH_MSPM0)
+#define BENCH_TRANSPORT             "mspm0"
+#define BENCH_PORT(port)            Mock_DL_Port(port)
+#define BENCH_SCLK                  { BENCH_PORT(AD9833_SCLK_PORT), AD9833_SCLK_PIN_MASK }
+#define BENCH_SDATA                 { BENCH_PORT(AD9833_MOSI_PORT), AD9833_MOSI_PIN_MASK }
+#define BENCH_CS1                   { BENCH_PORT(AD9833_CS1_PORT), AD9833_CS1_PIN_MASK }
+#define BENCH_CS2                   { BENCH_PORT(AD9833_CS2_PORT), AD9833_CS2_PIN_MASK }
+#define BENCH_CORE_HZ               32000000ULL
+#else
+#define BENCH_TRANSPORT             "soft"
+#define BENCH_PORT(port)            Mock_STM32_Port(port)
+#define BENCH_SCLK                  { BENCH_PORT(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin }
+#define BENCH_SDATA                 { BENCH_PORT(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin }
+#define BENCH_CS1                   { BENCH_PORT(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin }
+#define BENCH_CS2                   { BENCH_PORT(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin }
+#define BENCH_CORE_HZ               168000000ULL
+#endif
+
+// 耗时允许的相对增长
+#define BENCH_TOLERANCE             0.02
+
+// 输出行数上限
+#define BENCH_ROW_MAX               32U
+
+/**
+ * @brief   一行测量结果 (words / cs_toggles 为 -1 表示空)
+ */
+typedef struct
+{
+    char transport[32];
+    char op[32];
+    long words;
+    long cs_toggles;
+    unsigned long bus_ns;
+    unsigned long cycles_mean;
+} Bench_Row;
+
+static Bench_Row s_row[BENCH_ROW_MAX];
+static uint32_t s_row_num = 0;
+static FILE* s_out = NULL;
+
+static Mock_Counters s_start_cnt;
+static uint64_t s_start_ns;
+
+/**
+ * @brief       模拟层测量: 记下起点的计数和时间
+ * @retval      无
+ */
+static void Bench_MockBegin(void)
+{
+    Mock_GetCounters(&s_start_cnt);
+    s_start_ns = Mock_Now();
+}
+
+/**
+ * @brief       模拟层测量: 取计数和时间的增量
+ * @param       result: 测量结果
+ * @retval      无
+ */
+static void Bench_MockEnd(AD9833_BenchResult* result)
+{
+    Mock_Counters cnt;
+    uint64_t ns = Mock_Now() - s_start_ns;
+
+    Mock_GetCounters(&cnt);
+    result->words = (int32_t)(cnt.bus_words - s_start_cnt.bus_words);
+    result->cs_toggles = (int32_t)((cnt.cs_falls - s_start_cnt.cs_falls) + (cnt.cs_rises - s_start_cnt.cs_rises));
+    result->bus_ns = (uint32_t)ns;
+    result->cycles = (uint32_t)(ns * BENCH_CORE_HZ / 1000000000ULL);
+}
+
+static const AD9833_BenchProbe s_mock_probe = {
+    Bench_MockBegin,
+    Bench_MockEnd,
+};
+
+/**
+ * @brief       解析一行CSV (跳过注释和表头)
+ * @param       line: 一行文本
+ * @param       row: 解析结果
+ * @retval      1: 数据行; 0: 其他
+ */
+static int Bench_Parse(const char* line, Bench_Row* row)
+{
+    char field[9][32];
+    uint32_t n = 0, k = 0;
+
+    if (line[0] == '#' || strncmp(line, "transport,", 10) == 0) return 0;
+
+    memset(field, 0, sizeof(field));
+    for (const char* p = line; *p && *p != '\n' && *p != '\r'; p++)
+    {
+        if (*p == ',')
+        {
+            if (++n >= 9U) return 0;
+            k = 0;
+        }
+        else if (k < sizeof(field[0]) - 1U)
+        {
+            field[n][k++] = *p;
+        }
+    }
+    if (n != 8U) return 0;
+
+    snprintf(row->transport, sizeof(row->transport), "%s", field[0]);
+    snprintf(row->op, sizeof(row->op), "%s", field[1]);
+    row->words = field[3][0] ? strtol(field[3], NULL, 10) : -1;
+    row->cs_toggles = field[4][0] ? strtol(field[4], NULL, 10) : -1;
+    row->bus_ns = strtoul(field[5], NULL, 10);
+    row->cycles_mean = strtoul(field[7], NULL, 10);
+    return 1;
+}
+
+/**
+ * @brief       AD9833_Bench 的输出: 写标准输出和文件, 并保存数据行供比较
+ * @param       line: 一行文本
+ * @retval      无
+ */
+static void Bench_Output(const char* line)
+{
+    printf("%s\n", line);
+    if (s_out) fprintf(s_out, "%s\n", line);
+    if (s_row_num < BENCH_ROW_MAX && Bench_Parse(line, &s_row[s_row_num])) s_row_num++;
+}
+
+/**
+ * @brief       比较耗时, 超过容差时报告
+ * @param       op: 测量项名称
+ * @param       what: 列名
+ * @param       now: 本次结果
+ * @param       base: 基线
+ * @retval      1: 超过容差; 0: 未超过
+ */
+static int Bench_Slower(const char* op, const char* what, unsigned long now, unsigned long base)
+{
+    if ((double)now > (double)base * (1.0 + BENCH_TOLERANCE))
+    {
+        fprintf(stderr, "  REGRESSION %s: %s %lu > baseline %lu\n", op, what, now, base);
+        return 1;
+    }
+    if ((double)now < (double)base * (1.0 - BENCH_TOLERANCE))
+    {
+        fprintf(stderr, "  note %s: %s %lu < baseline %lu (update the baseline)\n", op, what, now, base);
+    }
+    return 0;
+}
+
+/**
+ * @brief       与基线文件比较
+ * @param       path: 基线文件
+ * @retval      不符合的项数
+ */
+static uint32_t Bench_Compare(const char* path)
+{
+    FILE* fp = fopen(path, "r");
+    char line[AD9833_BENCH_LINE_MAX * 2U];
+    uint8_t seen[BENCH_ROW_MAX] = {0};
+    uint32_t fail = 0, base_num = 0;
+
+    if (!fp)
+    {
+        fprintf(stderr, "  cannot open baseline %s\n", path);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), fp))
+    {
+        Bench_Row base;
+        uint32_t i;
+
+        if (!Bench_Parse(line, &base) || strcmp(base.transport, BENCH_TRANSPORT) != 0) continue;
+        base_num++;
+
+        for (i = 0; i < s_row_num; i++)
+        {
+            if (strcmp(s_row[i].op, base.op) == 0) break;
+        }
+        if (i == s_row_num)
+        {
+            fprintf(stderr, "  MISSING %s: in baseline but not measured\n", base.op);
+            fail++;
+            continue;
+        }
+        seen[i] = 1;
+
+        if (s_row[i].words != base.words || s_row[i].cs_toggles != base.cs_toggles)
+        {
+            fprintf(stderr, "  CHANGED %s: words %ld cs_toggles %ld, baseline %ld / %ld\n", base.op,
+                    s_row[i].words, s_row[i].cs_toggles, base.words, base.cs_toggles);
+            fail++;
+        }
+        fail += (uint32_t)Bench_Slower(base.op, "bus_ns", s_row[i].bus_ns, base.bus_ns);
+        fail += (uint32_t)Bench_Slower(base.op, "cycles_mean", s_row[i].cycles_mean, base.cycles_mean);
+    }
+    fclose(fp);
+
+    for (uint32_t i = 0; i < s_row_num; i++)
+    {
+        if (!seen[i])
+        {
+            fprintf(stderr, "  NEW %s: measured but not in baseline\n", s_row[i].op);
+            fail++;
+        }
+    }
+    if (base_num == 0)
+    {
+        fprintf(stderr, "  no '%s' rows in baseline %s\n", BENCH_TRANSPORT, path);
+        fail++;
+    }
+    return fail;
+}
+
+/**
+ * @brief       登记当前传输方式的总线引脚并复位模拟层
+ * @retval      无
+ */
+static void Bench_SetBus(void)
+{
+    Mock_Bus bus = {0};
+
+#if defined(AD9833_BENCH_HAL)
+    bus.sclk = (Mock_Pin){ hspi2.sck_port, hspi2.sck_pin };
+    bus.sdata = (Mock_Pin){ hspi2.mosi_port, hspi2.mosi_pin };
+#else
+    bus.sclk = (Mock_Pin)BENCH_SCLK;
+    bus.sdata = (Mock_Pin)BENCH_SDATA;
+#endif
+    bus.cs[0] = (Mock_Pin)BENCH_CS1;
+    bus.cs[1] = (Mock_Pin)BENCH_CS2;
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_Reset();
+#if defined(AD9833_BENCH_HAL)
+    MX_SPI2_Init();
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    const char* baseline = NULL;
+    const char* out = NULL;
+    uint32_t repeat = AD9833_BENCH_REPEAT;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) repeat = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out = argv[++i];
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) baseline = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [-n repeat] [-o out.csv] [-b baseline.csv]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (out && !(s_out = fopen(out, "w")))
+    {
+        fprintf(stderr, "cannot write %s\n", out);
+        return 2;
+    }
+
+    Bench_SetBus();
+    AD9833_Bench_Run(&s_mock_probe, BENCH_TRANSPORT, repeat, Bench_Output);
+    if (s_out) fclose(s_out);
+
+    if (!baseline) return 0;
+
+    uint32_t fail = Bench_Compare(baseline);
+    fprintf(stderr, "[%s] baseline %s (%u differences)\n", BENCH_TRANSPORT, fail ? "FAILED" : "PASSED", (unsigned)fail);
+    return fail ? 1 : 0;
+}
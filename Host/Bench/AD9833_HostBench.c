@@ -0,0 +1,492 @@
+/**
+******************************************************************************
+  * @file           : AD9833_HostBench.c
+  * @brief          : 主机构建的驱动测试与接口开销统计
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 同一份源文件按传输方式分别编译 (AD9833_HOST_SOFT / AD9833_HOST_HAL /
+  * AD9833_HOST_MSPM0)，链接对应的驱动和模拟层：
+  * 1. 检查: 在模拟层组帧得到的数据字上检查各接口的写入序列 (帧数、内容、
+  *    片选掩码、不完整帧)，任何一项不符时返回非0。
+  * 2. 统计: 每个接口重复调用N次 (默认1000, 可由第一个参数指定)，输出每次
+  *    调用平均的GPIO操作数、引脚边沿数、SPI调用数、帧数和模拟总线时间。
+  * 3. 模型: 由 AD9833_Model 按引脚边沿解码 AD9833_Cmd() 的写入，检查寄存器
+  *    和时序，并逐步缩短时间参数，给出不违反时序的最高 SCLK 频率。
+  *
+  * 总线时间取 Mock_HAL 的默认时间模型，用于比较不同接口和传输方式的相对
+  * 开销，实际数值以目标板上的测量为准。
+  *
+  ******************************************************************************
+  */
+
+#include "Mock_HAL.h"
+#include "AD9833_Model.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Host_Check.h"
+
+#if defined(AD9833_HOST_HAL)
+#include "AD9833_HAL.h"
+#define AD9833_CALL(fn, ...)        fn(&hspi2, __VA_ARGS__)
+#define BENCH_TRANSPORT             "hal"
+#define BENCH_PORT(port)            Mock_STM32_Port(port)
+#define BENCH_CS1                   { BENCH_PORT(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin }
+#define BENCH_CS2                   { BENCH_PORT(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin }
+#define BENCH_SPEED_PARAM           spi_bit_ns
+#elif defined(AD9833_HOST_MSPM0)
+#include "AD9833_Soft_MSPM0.h"
+#define AD9833_CALL(fn, ...)        fn(__VA_ARGS__)
+#define BENCH_TRANSPORT             "mspm0"
+#define BENCH_PORT(port)            Mock_DL_Port(port)
+#define BENCH_SCLK                  { BENCH_PORT(AD9833_SCLK_PORT), AD9833_SCLK_PIN_MASK }
+#define BENCH_SDATA                 { BENCH_PORT(AD9833_MOSI_PORT), AD9833_MOSI_PIN_MASK }
+#define BENCH_CS1                   { BENCH_PORT(AD9833_CS1_PORT), AD9833_CS1_PIN_MASK }
+#define BENCH_CS2                   { BENCH_PORT(AD9833_CS2_PORT), AD9833_CS2_PIN_MASK }
+#define BENCH_STAGE                 1
+#define BENCH_REFUSED               0U
+#define BENCH_SPEED_PARAM           dl_write_ns
+#else
+#include "AD9833_Soft.h"
+#define AD9833_CALL(fn, ...)        fn(__VA_ARGS__)
+#define BENCH_TRANSPORT             "soft"
+#define BENCH_PORT(port)            Mock_STM32_Port(port)
+#define BENCH_SCLK                  { BENCH_PORT(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin }
+#define BENCH_SDATA                 { BENCH_PORT(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin }
+#define BENCH_CS1                   { BENCH_PORT(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin }
+#define BENCH_CS2                   { BENCH_PORT(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin }
+#define BENCH_STAGE                 1
+#define BENCH_REFUSED               HAL_BUSY
+#define BENCH_SPEED_PARAM           gpio_call_ns
+#endif
+
+#define BENCH_STR_(x)               #x
+#define BENCH_STR(x)                BENCH_STR_(x)
+
+#define BENCH_DEFAULT_TIMES         1000U
+
+/**
+ * @brief   统计项: 名称与一次调用
+ */
+typedef struct
+{
+    const char* name;
+    void (*run)(uint32_t i);
+} Bench_Case;
+
+static Mock_Bus s_bus = {0};
+
+/**
+ * @brief       登记当前传输方式的总线引脚
+ * @retval      无
+ */
+static void Bench_SetBus(void)
+{
+    Mock_Bus bus = {0};
+
+#if defined(AD9833_HOST_HAL)
+    bus.sclk = (Mock_Pin){ hspi2.sck_port, hspi2.sck_pin };
+    bus.sdata = (Mock_Pin){ hspi2.mosi_port, hspi2.mosi_pin };
+#else
+    bus.sclk = (Mock_Pin)BENCH_SCLK;
+    bus.sdata = (Mock_Pin)BENCH_SDATA;
+#endif
+    bus.cs[0] = (Mock_Pin)BENCH_CS1;
+    bus.cs[1] = (Mock_Pin)BENCH_CS2;
+    bus.cs_num = 2;
+    s_bus = bus;
+    Mock_SetBus(&bus);
+#if defined(AD9833_HOST_HAL)
+    MX_SPI2_Init();
+#endif
+}
+
+/**
+ * @brief       复位模拟层并初始化驱动, 清空初始化产生的记录
+ * @retval      无
+ */
+static void Bench_Restart(void)
+{
+    Mock_Reset();
+#if defined(AD9833_HOST_HAL)
+    MX_SPI2_Init();
+#endif
+    AD9833_CALL(AD9833_Init, CS1_CS2_DOUBLE);
+    Mock_ClearTrace();
+}
+
+/**
+ * @brief       取出记录中的帧事件和放弃事件
+ * @param       out: 输出数组
+ * @param       max: 数组容量
+ * @retval      事件数
+ */
+static uint32_t Bench_Words(Mock_Event* out, uint32_t max)
+{
+    uint32_t count = 0, n = 0;
+    const Mock_Event* ev = Mock_GetTrace(&count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (ev[i].type != MOCK_EVENT_FRAME && ev[i].type != MOCK_EVENT_ABORT) continue;
+        if (n < max) out[n] = ev[i];
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief       检查记录的时间戳不减
+ * @retval      无
+ */
+static void Check_Monotonic(const char* what)
+{
+    uint32_t count = 0;
+    const Mock_Event* ev = Mock_GetTrace(&count);
+
+    for (uint32_t i = 1; i < count; i++)
+    {
+        if (ev[i].time_ns < ev[i - 1U].time_ns)
+        {
+            CHECK(0, "%s: time goes back at event %u", what, (unsigned)i);
+            return;
+        }
+    }
+}
+
+static void Check_Write(void)
+{
+    Mock_Event w[4];
+    Mock_Counters cnt;
+
+    Bench_Restart();
+    AD9833_CALL(AD9833_Write, CS1, 0x2100);
+    CHECK(Bench_Words(w, 4) == 1, "Write(CS1): expected 1 word");
+    CHECK(w[0].type == MOCK_EVENT_FRAME && w[0].word == 0x2100 && w[0].pin == 0x1,
+          "Write(CS1): got word 0x%04X mask 0x%X", w[0].word, (unsigned)w[0].pin);
+    Check_Monotonic("Write(CS1)");
+
+    Bench_Restart();
+    Mock_GetCounters(&cnt);
+    uint32_t falls = cnt.cs_falls;
+    AD9833_CALL(AD9833_Write, CS_BOTH, 0x1234);
+    Mock_GetCounters(&cnt);
+    CHECK(Bench_Words(w, 4) == 1, "Write(CS_BOTH): expected 1 broadcast word");
+    CHECK(w[0].word == 0x1234 && w[0].pin == 0x3,
+          "Write(CS_BOTH): got word 0x%04X mask 0x%X", w[0].word, (unsigned)w[0].pin);
+    CHECK(cnt.cs_falls - falls == 2, "Write(CS_BOTH): expected 2 CS falls");
+}
+
+static void Check_FreqSet(void)
+{
+    Mock_Event w[8];
+    const uint32_t word = 0x0ABCDEF;
+
+    Bench_Restart();
+    AD9833_CALL(AD9833_FreqSetRaw, CS2, 1, word);
+    CHECK(Bench_Words(w, 8) == 2, "FreqSetRaw: expected 2 words");
+    CHECK(w[0].word == (0x8000 | (word & 0x3FFF)) && w[1].word == (0x8000 | (word >> 14)),
+          "FreqSetRaw: got 0x%04X 0x%04X", w[0].word, w[1].word);
+    CHECK(w[0].pin == 0x2 && w[1].pin == 0x2, "FreqSetRaw: wrong chip");
+
+    // 1kHz @ 25MHz: 频率字 = 1000 * 2^28 / 25e6 = 10737.4 -> 10737
+    Bench_Restart();
+    AD9833_CALL(AD9833_FreqSet, CS1, 0, 1000.0);
+    CHECK(Bench_Words(w, 8) == 2, "FreqSet(CS1): expected 2 words");
+    CHECK(w[0].word == (0x4000 | 10737) && w[1].word == 0x4000,
+          "FreqSet(CS1): got 0x%04X 0x%04X", w[0].word, w[1].word);
+
+    Bench_Restart();
+    AD9833_CALL(AD9833_FreqSet, CS_BOTH, 0, 1000.0);
+    CHECK(Bench_Words(w, 8) == 2 && w[0].pin == 0x3 && w[1].pin == 0x3,
+          "FreqSet(CS_BOTH): expected 2 broadcast words");
+}
+
+static void Check_PhaseSet(void)
+{
+    Mock_Event w[4];
+
+    Bench_Restart();
+    AD9833_CALL(AD9833_PhaseSet, CS_BOTH, 1, 90.0);
+    CHECK(Bench_Words(w, 4) == 1, "PhaseSet(CS_BOTH): expected 1 word");
+    CHECK(w[0].word == (0xE000 | 1024) && w[0].pin == 0x3,
+          "PhaseSet(CS_BOTH): got word 0x%04X mask 0x%X", w[0].word, (unsigned)w[0].pin);
+}
+
+static void Check_Cmd(void)
+{
+    Mock_Counters cnt;
+    AD9833_InitTypedef cfg = {
+        .status = CS1_CS2_DOUBLE,
+        .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+        .AD_CS2 = { TRIANGLE_WAVE, 2000.0, 90.0, 1, 1 },
+    };
+#if defined(AD9833_HOST_HAL)
+    cfg.hspi = &hspi2;
+#endif
+
+    Bench_Restart();
+    AD9833_Cmd(&cfg);
+    Mock_GetCounters(&cnt);
+    CHECK(cnt.frames > 0 && cnt.aborts == 0, "Cmd: %u words, %u incomplete",
+          (unsigned)cnt.frames, (unsigned)cnt.aborts);
+    Check_Monotonic("Cmd");
+
+    Bench_Restart();
+    AD9833_Cmd_Sync(&cfg);
+    Mock_GetCounters(&cnt);
+    CHECK(cnt.frames > 0 && cnt.aborts == 0, "Cmd_Sync: %u words, %u incomplete",
+          (unsigned)cnt.frames, (unsigned)cnt.aborts);
+}
+
+#if defined(BENCH_STAGE)
+static void Check_Stage(void)
+{
+    Mock_Event w[4];
+
+    Bench_Restart();
+    CHECK(AD9833_StageStart(CS_BOTH, SINE_WAVE), "StageStart: rejected");
+    CHECK(Bench_Words(w, 4) == 0, "StageStart: word latched before the last edge");
+    // 预置期间其他写入被拒绝并报告, 不操作总线
+    Mock_Counters cnt;
+    Mock_GetCounters(&cnt);
+    uint32_t calls = cnt.gpio_calls;
+    CHECK(AD9833_FreqSetRaw(CS1, 0, 0x1234567U) == BENCH_REFUSED, "FreqSetRaw while staged: not refused");
+    CHECK(AD9833_SelectFreqReg(CS2, 1) == BENCH_REFUSED, "SelectFreqReg while staged: not refused");
+    Mock_GetCounters(&cnt);
+    CHECK(cnt.gpio_calls == calls, "write while staged: %u GPIO writes", (unsigned)(cnt.gpio_calls - calls));
+    AD9833_StageLatch();
+    CHECK(Bench_Words(w, 4) == 1 && w[0].pin == 0x3, "StageLatch: expected 1 broadcast word");
+    AD9833_StageRelease();
+    CHECK(Bench_Words(w, 4) == 1, "StageRelease: unexpected word");
+
+    // 未锁存即释放: 两片各放弃15位 (片选在不同端口上时分两次释放)
+    Bench_Restart();
+    AD9833_StageSelect(CS_BOTH, 1, 1);
+    AD9833_StageRelease();
+    uint32_t n = Bench_Words(w, 4), mask = 0;
+    for (uint32_t i = 0; i < n && i < 4; i++)
+    {
+        if (w[i].type == MOCK_EVENT_ABORT && w[i].level == 15) mask |= w[i].pin;
+    }
+    CHECK(mask == 0x3, "StageRelease without latch: expected a 15-bit abort on both chips");
+}
+#endif
+
+#if defined(AD9833_HOST_HAL)
+static void Check_SpiMode(void)
+{
+    Mock_Event w[4];
+    SPI_InitTypeDef keep = hspi2.Init;
+
+    // Core/Src/spi.c 中的8位配置每次只发出低8位, 芯片收不满16位
+    hspi2.Init.DataSize = SPI_DATASIZE_8BIT;
+    hspi2.Init.CLKPolarity = SPI_POLARITY_LOW;
+    Bench_Restart();
+    AD9833_Write(&hspi2, CS1, 0x2100);
+    CHECK(Bench_Words(w, 4) == 1 && w[0].type == MOCK_EVENT_ABORT && w[0].level == 8,
+          "8-bit SPI: expected an 8-bit abort");
+
+    hspi2.Init = keep;
+    Bench_Restart();
+}
+#endif
+
+/**
+ * @brief       在模型上执行一次 AD9833_Cmd(), 返回两片模型
+ * @param       cfg: 配置
+ * @param       chip: 输出两片模型
+ * @retval      无
+ */
+static void Bench_ModelCmd(AD9833_InitTypedef* cfg, AD9833_Model chip[2])
+{
+    AD9833_ModelBus mb;
+
+    Bench_Restart();
+    AD9833_Model_Init(&chip[0]);
+    AD9833_Model_Init(&chip[1]);
+    AD9833_ModelBus_Init(&mb, chip, 2, &s_bus);
+    AD9833_ModelBus_Attach(&mb);
+    AD9833_Cmd(cfg);
+    AD9833_ModelBus_Detach();
+}
+
+static void Check_Model(void)
+{
+    AD9833_Model chip[2];
+    AD9833_InitTypedef cfg = {
+        .status = CS1_CS2_DOUBLE,
+        .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+        .AD_CS2 = { TRIANGLE_WAVE, 2000.0, 90.0, 1, 1 },
+    };
+#if defined(AD9833_HOST_HAL)
+    cfg.hspi = &hspi2;
+#endif
+
+    Bench_ModelCmd(&cfg, chip);
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        CHECK(AD9833_Model_Violations(&chip[i]) == 0 && chip[i].aborts == 0,
+              "model chip %u: first violation %s at %llu ns", (unsigned)i,
+              AD9833_Model_CheckName(chip[i].first_check), (unsigned long long)chip[i].first_time);
+    }
+    CHECK(chip[0].ctrl == AD9833_CTRL_B28, "model CS1 ctrl 0x%04X", chip[0].ctrl);
+    CHECK(chip[0].freq[0] == AD9833_FreqToWord(CS1, 1000.0), "model CS1 FREQ0 0x%07X", (unsigned)chip[0].freq[0]);
+    CHECK(chip[1].ctrl == (AD9833_CTRL_B28 | AD9833_CTRL_FSELECT | AD9833_CTRL_PSELECT | AD9833_CTRL_MODE),
+          "model CS2 ctrl 0x%04X", chip[1].ctrl);
+    CHECK(chip[1].freq[1] == AD9833_FreqToWord(CS2, 2000.0), "model CS2 FREQ1 0x%07X", (unsigned)chip[1].freq[1]);
+    CHECK(chip[1].phase[1] == 1024, "model CS2 PHASE1 %u", chip[1].phase[1]);
+}
+
+/* 统计项 */
+static void Run_Write(uint32_t i)        { AD9833_CALL(AD9833_Write, CS1, (uint16_t)(0x4000 | (i & 0x3FFF))); }
+static void Run_WriteBoth(uint32_t i)    { AD9833_CALL(AD9833_Write, CS_BOTH, (uint16_t)(0x4000 | (i & 0x3FFF))); }
+static void Run_FreqSetRaw(uint32_t i)   { AD9833_CALL(AD9833_FreqSetRaw, CS1, 0, 0x100000U + i); }
+static void Run_FreqSet(uint32_t i)      { AD9833_CALL(AD9833_FreqSet, CS1, 0, 1000.0 + i); }
+static void Run_FreqSetBoth(uint32_t i)  { AD9833_CALL(AD9833_FreqSet, CS_BOTH, 0, 1000.0 + i); }
+static void Run_PhaseSet(uint32_t i)     { AD9833_CALL(AD9833_PhaseSet, CS1, 0, (double)(i % 360U)); }
+static void Run_SelectFreq(uint32_t i)   { AD9833_CALL(AD9833_SelectFreqReg, CS_BOTH, (uint8_t)(i & 1U)); }
+static void Run_WaveStart(uint32_t i)    { AD9833_CALL(AD9833_SetWaveformAndStart, CS1, (waveType)(SINE_WAVE + i % 3U)); }
+static void Run_Init(uint32_t i)         { (void)i; AD9833_CALL(AD9833_Init, CS1_CS2_DOUBLE); }
+
+static AD9833_InitTypedef s_cfg = {
+    .status = CS1_CS2_DOUBLE,
+    .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+    .AD_CS2 = { SINE_WAVE, 1000.0, 90.0, 0, 0 },
+};
+
+static void Run_Cmd(uint32_t i)          { (void)i; AD9833_Cmd(&s_cfg); }
+static void Run_CmdSync(uint32_t i)      { (void)i; AD9833_Cmd_Sync(&s_cfg); }
+
+#if defined(BENCH_STAGE)
+static void Run_Stage(uint32_t i)
+{
+    AD9833_StageSelect(CS_BOTH, (uint8_t)(i & 1U), 0);
+    AD9833_StageLatch();
+    AD9833_StageRelease();
+}
+#endif
+
+/**
+ * @brief       逐步缩短传输方式的时间参数, 找出模型不报时序违反的最小值
+ * @note        软件SPI缩短一次引脚写入的时间, 硬件SPI缩短每位时间; 以 AD9833_Cmd()
+ *              的全部写入为准
+ * @retval      无
+ */
+static void Bench_Margin(void)
+{
+    Mock_Timing keep = *Mock_GetTiming();
+    Mock_Timing timing = keep;
+    AD9833_Model chip[2];
+    uint32_t best = 0, period = 0;
+    AD9833_ModelCheck fail = AD9833_MODEL_CHECK_NUM;
+
+    for (uint32_t ns = keep.BENCH_SPEED_PARAM; ns >= 1U; ns--)
+    {
+        timing.BENCH_SPEED_PARAM = ns;
+        Mock_SetTiming(&timing);
+        Bench_ModelCmd(&s_cfg, chip);
+
+        if (AD9833_Model_Violations(&chip[0]) || AD9833_Model_Violations(&chip[1]))
+        {
+            fail = (AD9833_ModelCheck)(AD9833_Model_Violations(&chip[0]) ? chip[0].first_check : chip[1].first_check);
+            break;
+        }
+        best = ns;
+        period = (chip[0].period_min < chip[1].period_min) ? chip[0].period_min : chip[1].period_min;
+    }
+    Mock_SetTiming(&keep);
+
+    CHECK(best != 0, "no violation-free setting at the default timing");
+    printf("\n[%s] timing margin: %s >= %u ns, SCLK period %u ns (%.1f MHz)",
+           BENCH_TRANSPORT, BENCH_STR(BENCH_SPEED_PARAM), (unsigned)best, (unsigned)period,
+           period ? 1000.0 / period : 0.0);
+    if (fail != AD9833_MODEL_CHECK_NUM) printf(", below that: %s", AD9833_Model_CheckName(fail));
+    printf("\n");
+}
+
+static const Bench_Case s_case[] = {
+    { "Write(CS1)",                 Run_Write },
+    { "Write(CS_BOTH)",             Run_WriteBoth },
+    { "FreqSetRaw(CS1)",            Run_FreqSetRaw },
+    { "FreqSet(CS1)",               Run_FreqSet },
+    { "FreqSet(CS_BOTH)",           Run_FreqSetBoth },
+    { "PhaseSet(CS1)",              Run_PhaseSet },
+    { "SelectFreqReg(CS_BOTH)",     Run_SelectFreq },
+    { "SetWaveformAndStart(CS1)",   Run_WaveStart },
+    { "Init",                       Run_Init },
+    { "Cmd",                        Run_Cmd },
+    { "Cmd_Sync",                   Run_CmdSync },
+#if defined(BENCH_STAGE)
+    { "StageSelect+Latch+Release",  Run_Stage },
+#endif
+};
+
+/**
+ * @brief       逐项统计并输出
+ * @param       times: 每项调用次数
+ * @retval      无
+ */
+static void Bench_Run(uint32_t times)
+{
+    printf("\n[%s] %u calls per API, per-call averages\n", BENCH_TRANSPORT, (unsigned)times);
+    printf("%-28s %8s %8s %8s %8s %8s %10s\n", "API", "gpio", "edges", "spi", "cs_fall", "words", "bus_us");
+
+    Mock_TraceEnable(0);
+    for (uint32_t c = 0; c < sizeof(s_case) / sizeof(s_case[0]); c++)
+    {
+        Mock_Counters a, b;
+
+        Bench_Restart();
+        Mock_GetCounters(&a);
+        uint64_t t0 = Mock_Now();
+        for (uint32_t i = 0; i < times; i++) s_case[c].run(i);
+        uint64_t t1 = Mock_Now();
+        Mock_GetCounters(&b);
+
+        CHECK(b.frames > a.frames && b.aborts == a.aborts, "%s: no words or incomplete words", s_case[c].name);
+        printf("%-28s %8.1f %8.1f %8.1f %8.1f %8.1f %10.3f\n", s_case[c].name,
+               (double)(b.gpio_calls - a.gpio_calls) / times,
+               (double)(b.pin_edges - a.pin_edges) / times,
+               (double)(b.spi_calls - a.spi_calls) / times,
+               (double)(b.cs_falls - a.cs_falls) / times,
+               (double)(b.frames - a.frames) / times,
+               (double)(t1 - t0) / times / 1000.0);
+    }
+    Mock_TraceEnable(1);
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t times = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_TIMES;
+    if (times == 0) times = BENCH_DEFAULT_TIMES;
+
+    Bench_SetBus();
+#if defined(AD9833_HOST_HAL)
+    s_cfg.hspi = &hspi2;
+#endif
+
+    printf("[%s] checks\n", BENCH_TRANSPORT);
+    Check_Write();
+    Check_FreqSet();
+    Check_PhaseSet();
+    Check_Cmd();
+#if defined(BENCH_STAGE)
+    Check_Stage();
+#endif
+#if defined(AD9833_HOST_HAL)
+    Check_SpiMode();
+#endif
+    Check_Model();
+
+    Bench_Run(times);
+    Bench_Margin();
+
+    printf("\n[%s] %s (%u failures)\n", BENCH_TRANSPORT, s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
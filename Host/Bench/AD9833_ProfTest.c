@@ -0,0 +1,208 @@
+/**
+******************************************************************************
+  * @file           : AD9833_ProfTest.c
+  * @brief          : AD9833_Prof 测量点的主机测试
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-14
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 驱动以 AD9833_PROF_ENABLE 编译 (AD9833_HOST_SOFT / AD9833_HOST_HAL 各一份)，
+  * 模拟层的 DWT->CYCCNT 由虚拟时间换算，因此可以检查：
+  * - 每个接口的调用次数，以及内部调用 (Write、发送) 的计数关系；
+  * - 一次调用的周期数与模拟时间一致，min <= mean <= max；
+  * - AD9833_Cmd() 再次调用 AD9833_Init() 时不清空统计；
+  * - AD9833_Prof_Dump() 的CSV格式。
+  *
+  ******************************************************************************
+  */
+
+#include "Mock_HAL.h"
+#include "AD9833_Prof.h"
+#include <stdio.h>
+#include <string.h>
+#include "Host_Check.h"
+
+#if defined(AD9833_HOST_HAL)
+#include "AD9833_HAL.h"
+#include "spi.h"
+#define AD9833_CALL(fn, ...)        fn(&hspi2, __VA_ARGS__)
+#define PROF_TRANSPORT              "hal"
+#else
+#include "AD9833_Soft.h"
+#define AD9833_CALL(fn, ...)        fn(__VA_ARGS__)
+#define PROF_TRANSPORT              "soft"
+#endif
+
+#define PROF_TIMES                  50U
+
+static AD9833_InitTypedef s_cfg = {
+    .status = CS1_CS2_DOUBLE,
+    .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+    .AD_CS2 = { SINE_WAVE, 1000.0, 90.0, 0, 0 },
+};
+
+/**
+ * @brief       读取一个测量点
+ * @param       id: 测量点编号
+ * @retval      统计
+ */
+static AD9833_ProfRecord Prof_Get(AD9833_ProfId id)
+{
+    AD9833_ProfRecord rec;
+    AD9833_Prof_Get(id, &rec);
+    return rec;
+}
+
+/**
+ * @brief       调用次数和内部调用的计数关系
+ * @retval      无
+ */
+static void Test_Count(void)
+{
+    AD9833_Prof_Reset();
+    for (uint32_t i = 0; i < PROF_TIMES; i++)
+    {
+        AD9833_CALL(AD9833_FreqSet, CS1, 0, 1000.0 + i);
+    }
+    AD9833_CALL(AD9833_PhaseSet, CS_BOTH, 1, 45.0);
+
+    AD9833_ProfRecord freq = Prof_Get(AD9833_PROF_FREQ_SET);
+    AD9833_ProfRecord raw = Prof_Get(AD9833_PROF_FREQ_SET_RAW);
+    AD9833_ProfRecord write = Prof_Get(AD9833_PROF_WRITE);
+    AD9833_ProfRecord xfer = Prof_Get(AD9833_PROF_XFER);
+    AD9833_ProfRecord phase = Prof_Get(AD9833_PROF_PHASE_SET);
+
+    CHECK(freq.count == PROF_TIMES, "FreqSet count %u", (unsigned)freq.count);
+    CHECK(raw.count == PROF_TIMES, "FreqSetRaw count %u", (unsigned)raw.count);
+    CHECK(write.count == 2U * PROF_TIMES + 1U, "Write count %u", (unsigned)write.count);
+    CHECK(xfer.count == write.count, "xfer count %u != Write count %u", (unsigned)xfer.count, (unsigned)write.count);
+    CHECK(phase.count == 1U, "PhaseSet count %u", (unsigned)phase.count);
+    CHECK(Prof_Get(AD9833_PROF_CMD).count == 0, "Cmd counted without a call");
+}
+
+/**
+ * @brief       周期数与模拟时间一致, 外层接口包含内层
+ * @retval      无
+ */
+static void Test_Cycles(void)
+{
+    AD9833_Prof_Reset();
+
+    uint64_t t0 = Mock_Now();
+    AD9833_CALL(AD9833_FreqSet, CS_BOTH, 1, 12345.0);
+    uint64_t ns = Mock_Now() - t0;
+    uint32_t expect = (uint32_t)(ns * SystemCoreClock / 1000000000ULL);
+
+    AD9833_ProfRecord freq = Prof_Get(AD9833_PROF_FREQ_SET);
+    AD9833_ProfRecord write = Prof_Get(AD9833_PROF_WRITE);
+    AD9833_ProfRecord xfer = Prof_Get(AD9833_PROF_XFER);
+
+    CHECK(freq.max + 1U >= expect && freq.max <= expect + 1U,
+          "FreqSet %u cycles, mock time gives %u", (unsigned)freq.max, (unsigned)expect);
+    CHECK(write.count == 2U && freq.max >= write.min + write.max,
+          "FreqSet %u cycles < two writes %u + %u", (unsigned)freq.max, (unsigned)write.min, (unsigned)write.max);
+    CHECK(xfer.max > 0U && xfer.max <= write.min, "xfer %u cycles, Write %u", (unsigned)xfer.max, (unsigned)write.min);
+
+    for (uint32_t i = 0; i < PROF_TIMES; i++)
+    {
+        AD9833_CALL(AD9833_SelectFreqReg, (i & 1U) ? CS1 : CS_BOTH, (uint8_t)(i & 1U));
+    }
+    AD9833_ProfRecord sel = Prof_Get(AD9833_PROF_SELECT_FREQ);
+    uint32_t mean = (uint32_t)(sel.sum / sel.count);
+    CHECK(sel.min > 0U && sel.min <= mean && mean <= sel.max, "SelectFreqReg min %u mean %u max %u",
+          (unsigned)sel.min, (unsigned)mean, (unsigned)sel.max);
+}
+
+/**
+ * @brief       AD9833_Cmd() 再次初始化时保留统计
+ * @retval      无
+ */
+static void Test_Keep(void)
+{
+    AD9833_Prof_Reset();
+    AD9833_CALL(AD9833_FreqSet, CS1, 0, 2000.0);
+    AD9833_Cmd(&s_cfg);
+    AD9833_Cmd_Sync(&s_cfg);
+
+    CHECK(Prof_Get(AD9833_PROF_FREQ_SET).count == 1U + 2U + 2U,
+          "FreqSet count %u after Cmd", (unsigned)Prof_Get(AD9833_PROF_FREQ_SET).count);
+    CHECK(Prof_Get(AD9833_PROF_INIT).count == 1U, "Init count %u", (unsigned)Prof_Get(AD9833_PROF_INIT).count);
+    CHECK(Prof_Get(AD9833_PROF_CMD).count == 1U, "Cmd count %u", (unsigned)Prof_Get(AD9833_PROF_CMD).count);
+    CHECK(Prof_Get(AD9833_PROF_CMD_SYNC).count == 1U && Prof_Get(AD9833_PROF_CMD_SYNC_N).count == 1U,
+          "Cmd_Sync / Cmd_SyncN not counted once");
+    CHECK(Prof_Get(AD9833_PROF_CMD_SYNC).min >= Prof_Get(AD9833_PROF_CMD_SYNC_N).min,
+          "Cmd_Sync shorter than the Cmd_SyncN it calls");
+
+#if !defined(AD9833_HOST_HAL)
+    CHECK(AD9833_StageSelect(CS_BOTH, 1, 0) && AD9833_StageLatch() && AD9833_StageRelease(), "staged hop failed");
+    CHECK(Prof_Get(AD9833_PROF_STAGE_CTRL).count == 1U && Prof_Get(AD9833_PROF_STAGE_LATCH).count == 1U &&
+          Prof_Get(AD9833_PROF_STAGE_RELEASE).count == 1U, "stage calls not counted once");
+#endif
+}
+
+/**
+ * @brief       CSV 输出格式
+ * @retval      无
+ */
+static void Test_Dump(void)
+{
+    static char buf[4096];
+    UART_HandleTypeDef uart = { buf, sizeof(buf), 0 };
+    char expect[64];
+    uint32_t lines = 0;
+
+    AD9833_Prof_Reset();
+    for (uint32_t i = 0; i < 3U; i++)
+    {
+        AD9833_CALL(AD9833_PhaseSet, CS1, 0, 10.0 * i);
+    }
+    AD9833_Prof_Dump(&uart);
+
+    for (const char* p = buf; *p; p++)
+    {
+        if (*p == '\n') lines++;
+    }
+    snprintf(expect, sizeof(expect), "# ad9833_prof,1,%lu\r\n", (unsigned long)SystemCoreClock);
+
+    CHECK(strncmp(buf, expect, strlen(expect)) == 0, "header: %.40s", buf);
+    CHECK(strstr(buf, "\r\nname,count,min,max,mean\r\n") != NULL, "column line missing");
+    CHECK(lines == AD9833_PROF_NUM + 2U, "%u lines", (unsigned)lines);
+    CHECK(strstr(buf, "\r\nAD9833_PhaseSet,3,") != NULL, "PhaseSet row missing");
+    CHECK(strstr(buf, "\r\nAD9833_Cmd,0,0,0,0\r\n") != NULL, "unused row not zeroed");
+}
+
+int main(void)
+{
+    Mock_Bus bus = {0};
+
+#if defined(AD9833_HOST_HAL)
+    bus.sclk = (Mock_Pin){ hspi2.sck_port, hspi2.sck_pin };
+    bus.sdata = (Mock_Pin){ hspi2.mosi_port, hspi2.mosi_pin };
+    s_cfg.hspi = &hspi2;
+#else
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+#endif
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_Reset();
+#if defined(AD9833_HOST_HAL)
+    MX_SPI2_Init();
+#endif
+
+    AD9833_Cmd(&s_cfg);
+    CHECK((Mock_DWT.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0, "AD9833_Init() did not enable CYCCNT");
+
+    Test_Count();
+    Test_Cycles();
+    Test_Keep();
+    Test_Dump();
+
+    printf("[%s] prof %s (%u failures)\n", PROF_TRANSPORT, s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
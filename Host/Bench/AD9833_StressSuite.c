@@ -0,0 +1,327 @@
+/**
+******************************************************************************
+  * @file           : AD9833_StressSuite.c
+  * @brief          : 在模拟层上运行 AD9833_Stress 并与基线比较
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 同一份源文件按传输方式分别编译 (AD9833_STRESS_HAL / 默认软件SPI)，与目标
+  * 板使用同一个 AD9833_Stress 模块，只把时钟换成模拟层的虚拟时间 (纳秒)：
+  * 写入更新时时间随总线操作前进，队列空时直接跳到下一次更新的时刻。
+  * 虚拟时间不计CPU开销，结果是传输层本身的上限，也与本程序的优化设置无关；
+  * 目标板上的结果才随优化设置变化。
+  *
+  * 每行检查 offered = executed + dropped、high_water 不超过队列深度，吞吐上限
+  * 行须存在。CSV 输出到标准输出，说明与比较结果输出到标准错误。参数：
+  *   -d <毫秒>     每项持续时间 (默认 AD9833_STRESS_DURATION_MS)
+  *   -o <文件>     同时写入文件
+  *   -b <文件>     与基线比较: 取基线中同一传输方式的行，按 rate_hz 和 depth
+  *                 对应，dropped 和 late 不得多于基线，achieved_hz 不得低于、
+  *                 lat_max_ns 不得高于基线的 STRESS_TOLERANCE；opt 列不比较。
+  *
+  * 驱动改动有意改变了吞吐时，重新生成基线：
+  *   for t in soft hal; do build-host/ad9833_stress_$t; done > Host/Bench/AD9833_Stress_Baseline.csv
+  *
+  ******************************************************************************
+  */
+
+#include "Mock_HAL.h"
+#include "AD9833_Stress.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(AD9833_STRESS_HAL)
+#include "spi.h"
+#define STRESS_TRANSPORT            "hal"
+#else
+#define STRESS_TRANSPORT            "soft"
+#endif
+
+// 吞吐和最大延迟允许的相对变化
+#define STRESS_TOLERANCE            0.02
+
+// 输出行数上限
+#define STRESS_ROW_MAX              32U
+
+/**
+ * @brief   一行测试结果
+ */
+typedef struct
+{
+    char transport[32];
+    unsigned long rate_hz;
+    unsigned long depth;
+    unsigned long offered;
+    unsigned long executed;
+    unsigned long dropped;
+    unsigned long late;
+    unsigned long high_water;
+    unsigned long achieved_hz;
+    unsigned long lat_max_ns;
+} Stress_Row;
+
+static Stress_Row s_row[STRESS_ROW_MAX];
+static uint32_t s_row_num = 0;
+static uint8_t s_ceiling = 0;
+static FILE* s_out = NULL;
+
+/**
+ * @brief       模拟时钟: 当前虚拟时间
+ * @retval      纳秒
+ */
+static uint64_t Stress_MockNow(void)
+{
+    return Mock_Now();
+}
+
+/**
+ * @brief       模拟时钟: 空闲时推进到下一次更新
+ * @param       until: 下一次更新的时刻 (纳秒)
+ * @retval      无
+ */
+static void Stress_MockIdle(uint64_t until)
+{
+    uint64_t now = Mock_Now();
+
+    if (until > now) Mock_Advance(until - now);
+}
+
+static const AD9833_StressClock s_mock_clock = {
+    Stress_MockNow,
+    1000000000U,
+    Stress_MockIdle,
+};
+
+/**
+ * @brief       解析一行CSV (跳过注释和表头)
+ * @param       line: 一行文本
+ * @param       row: 解析结果
+ * @retval      1: 数据行; 0: 其他
+ */
+static int Stress_Parse(const char* line, Stress_Row* row)
+{
+    char field[12][32];
+    uint32_t n = 0, k = 0;
+
+    if (line[0] == '#' || strncmp(line, "transport,", 10) == 0) return 0;
+
+    memset(field, 0, sizeof(field));
+    for (const char* p = line; *p && *p != '\n' && *p != '\r'; p++)
+    {
+        if (*p == ',')
+        {
+            if (++n >= 12U) return 0;
+            k = 0;
+        }
+        else if (k < sizeof(field[0]) - 1U)
+        {
+            field[n][k++] = *p;
+        }
+    }
+    if (n != 11U) return 0;
+
+    snprintf(row->transport, sizeof(row->transport), "%s", field[0]);
+    row->rate_hz = strtoul(field[2], NULL, 10);
+    row->depth = strtoul(field[3], NULL, 10);
+    row->offered = strtoul(field[4], NULL, 10);
+    row->executed = strtoul(field[5], NULL, 10);
+    row->dropped = strtoul(field[6], NULL, 10);
+    row->late = strtoul(field[7], NULL, 10);
+    row->high_water = strtoul(field[8], NULL, 10);
+    row->achieved_hz = strtoul(field[9], NULL, 10);
+    row->lat_max_ns = strtoul(field[11], NULL, 10);
+    return 1;
+}
+
+/**
+ * @brief       AD9833_Stress 的输出: 写标准输出和文件, 并保存数据行供检查
+ * @param       line: 一行文本
+ * @retval      无
+ */
+static void Stress_Output(const char* line)
+{
+    printf("%s\n", line);
+    if (s_out) fprintf(s_out, "%s\n", line);
+    if (strncmp(line, "# ceiling,", 10) == 0) s_ceiling = 1;
+    if (s_row_num < STRESS_ROW_MAX && Stress_Parse(line, &s_row[s_row_num])) s_row_num++;
+}
+
+/**
+ * @brief       每行的自洽检查
+ * @retval      不符合的行数
+ */
+static uint32_t Stress_Check(void)
+{
+    uint32_t fail = 0;
+
+    for (uint32_t i = 0; i < s_row_num; i++)
+    {
+        const Stress_Row* r = &s_row[i];
+
+        if (r->executed + r->dropped != r->offered || r->high_water > r->depth || !r->executed)
+        {
+            fprintf(stderr, "  INVALID rate %lu depth %lu: offered %lu executed %lu dropped %lu high_water %lu\n",
+                    r->rate_hz, r->depth, r->offered, r->executed, r->dropped, r->high_water);
+            fail++;
+        }
+    }
+    if (!s_ceiling)
+    {
+        fprintf(stderr, "  ceiling line missing\n");
+        fail++;
+    }
+    return fail;
+}
+
+/**
+ * @brief       与基线比较一项
+ * @param       r: 本次结果
+ * @param       base: 基线
+ * @retval      不符合的列数
+ */
+static uint32_t Stress_CompareRow(const Stress_Row* r, const Stress_Row* base)
+{
+    uint32_t fail = 0;
+
+    if (r->dropped > base->dropped || r->late > base->late)
+    {
+        fprintf(stderr, "  REGRESSION rate %lu depth %lu: dropped %lu late %lu, baseline %lu / %lu\n",
+                base->rate_hz, base->depth, r->dropped, r->late, base->dropped, base->late);
+        fail++;
+    }
+    if ((double)r->achieved_hz < (double)base->achieved_hz * (1.0 - STRESS_TOLERANCE))
+    {
+        fprintf(stderr, "  REGRESSION rate %lu depth %lu: achieved_hz %lu < baseline %lu\n",
+                base->rate_hz, base->depth, r->achieved_hz, base->achieved_hz);
+        fail++;
+    }
+    if ((double)r->lat_max_ns > (double)base->lat_max_ns * (1.0 + STRESS_TOLERANCE))
+    {
+        fprintf(stderr, "  REGRESSION rate %lu depth %lu: lat_max_ns %lu > baseline %lu\n",
+                base->rate_hz, base->depth, r->lat_max_ns, base->lat_max_ns);
+        fail++;
+    }
+    return fail;
+}
+
+/**
+ * @brief       与基线文件比较
+ * @param       path: 基线文件
+ * @retval      不符合的项数
+ */
+static uint32_t Stress_Compare(const char* path)
+{
+    FILE* fp = fopen(path, "r");
+    char line[AD9833_STRESS_LINE_MAX * 2U];
+    uint8_t seen[STRESS_ROW_MAX] = {0};
+    uint32_t fail = 0, base_num = 0;
+
+    if (!fp)
+    {
+        fprintf(stderr, "  cannot open baseline %s\n", path);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), fp))
+    {
+        Stress_Row base;
+        uint32_t i;
+
+        if (!Stress_Parse(line, &base) || strcmp(base.transport, STRESS_TRANSPORT) != 0) continue;
+        base_num++;
+
+        for (i = 0; i < s_row_num; i++)
+        {
+            if (s_row[i].rate_hz == base.rate_hz && s_row[i].depth == base.depth) break;
+        }
+        if (i == s_row_num)
+        {
+            fprintf(stderr, "  MISSING rate %lu depth %lu: in baseline but not measured\n", base.rate_hz, base.depth);
+            fail++;
+            continue;
+        }
+        seen[i] = 1;
+        fail += Stress_CompareRow(&s_row[i], &base);
+    }
+    fclose(fp);
+
+    for (uint32_t i = 0; i < s_row_num; i++)
+    {
+        if (!seen[i])
+        {
+            fprintf(stderr, "  NEW rate %lu depth %lu: measured but not in baseline\n", s_row[i].rate_hz, s_row[i].depth);
+            fail++;
+        }
+    }
+    if (base_num == 0)
+    {
+        fprintf(stderr, "  no '%s' rows in baseline %s\n", STRESS_TRANSPORT, path);
+        fail++;
+    }
+    return fail;
+}
+
+/**
+ * @brief       登记当前传输方式的总线引脚并复位模拟层
+ * @retval      无
+ */
+static void Stress_SetBus(void)
+{
+    Mock_Bus bus = {0};
+
+#if defined(AD9833_STRESS_HAL)
+    bus.sclk = (Mock_Pin){ hspi2.sck_port, hspi2.sck_pin };
+    bus.sdata = (Mock_Pin){ hspi2.mosi_port, hspi2.mosi_pin };
+#else
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+#endif
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_Reset();
+    Mock_TraceEnable(0);
+#if defined(AD9833_STRESS_HAL)
+    MX_SPI2_Init();
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    const char* baseline = NULL;
+    const char* out = NULL;
+    uint32_t duration_ms = AD9833_STRESS_DURATION_MS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) duration_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out = argv[++i];
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) baseline = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [-d duration_ms] [-o out.csv] [-b baseline.csv]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (out && !(s_out = fopen(out, "w")))
+    {
+        fprintf(stderr, "cannot write %s\n", out);
+        return 2;
+    }
+
+    Stress_SetBus();
+    AD9833_Stress_Suite(&s_mock_clock, STRESS_TRANSPORT, duration_ms, Stress_Output);
+    if (s_out) fclose(s_out);
+
+    uint32_t fail = Stress_Check();
+    if (baseline) fail += Stress_Compare(baseline);
+    fprintf(stderr, "[%s] stress %s (%u failures)\n", STRESS_TRANSPORT, fail ? "FAILED" : "PASSED", (unsigned)fail);
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,389 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Trigger_CoSim.c
+  * @brief          : 多板卡触发同步的主机协同仿真
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-11
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 在PC上运行真实的 AD9833_Soft 驱动和 AD9833_Trigger 模块，不需要硬件。
+  * 引脚操作、虚拟时钟和 DWT->CYCCNT 由 Host/Mock 的 STM32 模拟层提供，
+  * 模拟层按 AD9833 的时序 (FSYNC 为低期间在 SCLK 下降沿采样，第16个下降
+  * 沿锁存，不足16位时拉高 FSYNC 放弃) 组帧。本文件在引脚变化回调中监视
+  * 公共触发线，触发线出现下降沿且中断未被屏蔽时 (抢占回调)，按中断响应
+  * 时间模型 (固定入口延迟 + 随机抖动) 进入 AD9833_Trigger_IRQHandler()。
+  * DWT->CYCCNT 由纳秒换算，周期数的比较允许1个周期的取整误差。
+  *
+  * 仿真内容：
+  * - 预置写入只产生15个下降沿，触发前芯片不锁存，触发后锁存的控制字正确。
+  * - 主机测得的触发到锁存延迟与仿真中的真实延迟一致。
+  * - 多块板卡 (逐块仿真，共用同一触发时刻) 的锁存时差。
+  * - 寄存器切换、放弃预置、无预置时的误触发。
+  *
+  * 由 Host/CMakeLists.txt 构建为 ad9833_trigger_cosim：
+  *     ad9833_trigger_cosim [板卡数] [抖动周期数]
+  * 全部检查通过时返回0。
+  *
+  ******************************************************************************
+  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "main.h"
+#include "Mock_HAL.h"
+#include "AD9833_Soft.h"
+#include "AD9833_Trigger.h"
+#include "Host_Check.h"
+
+// 中断入口延迟 (压栈 + 取向量), 以及从向量入口到写 SCLK 之前的代码路径 (CPU周期)
+#define COSIM_IRQ_ENTRY_CYCLES      12U
+#define COSIM_IRQ_PATH_CYCLES       14U
+
+// 默认参数
+#define COSIM_BOARD_NUM             8U
+#define COSIM_IRQ_JITTER            6U
+#define COSIM_MEASURE_TIMES         1000U
+
+// 触发线所在的模拟端口
+#define COSIM_TRIG_PORT             Mock_STM32_Port(AD9833_TRIG_OUT_GPIO_Port)
+
+static uint8_t s_irq_pending = 0;
+static uint8_t s_in_irq = 0;
+static uint8_t s_line_ext = 1;      // 外部 (其他板卡) 对触发线的驱动, 1 为释放
+static uint64_t s_line_fall = 0;    // 触发线最近一次下降沿的时刻 (纳秒)
+static uint32_t s_jitter = COSIM_IRQ_JITTER;
+static uint32_t s_rand = 0x12345678U;
+
+/**
+ * @brief       伪随机数 (xorshift32), 保证每次运行结果相同
+ * @retval      随机数
+ */
+static uint32_t CoSim_Rand(void)
+{
+    s_rand ^= s_rand << 13;
+    s_rand ^= s_rand >> 17;
+    s_rand ^= s_rand << 5;
+    return s_rand;
+}
+
+/**
+ * @brief       纳秒换算为CPU周期 (与模拟层刷新 DWT->CYCCNT 的方法相同)
+ * @param       ns: 纳秒
+ * @retval      周期数
+ */
+static uint64_t CoSim_Cycles(uint64_t ns)
+{
+    return ns * SystemCoreClock / 1000000000ULL;
+}
+
+/**
+ * @brief       CPU周期换算为纳秒 (四舍五入)
+ * @param       cycles: 周期数
+ * @retval      纳秒
+ */
+static uint64_t CoSim_Ns(uint64_t cycles)
+{
+    return (cycles * 1000000000ULL + SystemCoreClock / 2U) / SystemCoreClock;
+}
+
+/**
+ * @brief       芯片片选的当前电平
+ * @param       chip: 芯片编号
+ * @retval      0: 选中 (低电平); 1: 未选中
+ */
+static uint8_t CoSim_CsLevel(uint8_t chip)
+{
+    GPIO_TypeDef* port = (chip == 0U) ? AD9833_CS1_GPIO_Port : AD9833_CS2_GPIO_Port;
+    uint16_t pin = (chip == 0U) ? AD9833_CS1_Pin : AD9833_CS2_Pin;
+    return Mock_PinLevel(Mock_STM32_Port(port), pin) ? 1U : 0U;
+}
+
+/**
+ * @brief       取记录中的帧事件 (锁存) 和放弃事件
+ * @param       ev: 输出, 最多 max 个
+ * @param       max: 个数上限
+ * @retval      事件数
+ */
+static uint32_t CoSim_Words(const Mock_Event** ev, uint32_t max)
+{
+    uint32_t num, found = 0;
+    const Mock_Event* trace = Mock_GetTrace(&num);
+
+    for (uint32_t i = 0; i < num; i++)
+    {
+        if (trace[i].type != MOCK_EVENT_FRAME && trace[i].type != MOCK_EVENT_ABORT) continue;
+        if (found < max) ev[found] = &trace[i];
+        found++;
+    }
+    return found;
+}
+
+/**
+ * @brief       片选有效时的 SCLK 下降沿计数
+ * @retval      计数
+ */
+static uint32_t CoSim_SclkFalls(void)
+{
+    Mock_Counters cnt;
+
+    Mock_GetCounters(&cnt);
+    return cnt.sclk_falls;
+}
+
+/**
+ * @brief       进入触发中断
+ * @note        入口延迟 = 固定延迟 + [0, 抖动] 的随机周期
+ * @retval      无
+ */
+static void CoSim_Irq(void)
+{
+    s_irq_pending = 0;
+    s_in_irq = 1;
+    Mock_Advance(CoSim_Ns(COSIM_IRQ_ENTRY_CYCLES + (s_jitter ? CoSim_Rand() % (s_jitter + 1U) : 0U)
+                          + COSIM_IRQ_PATH_CYCLES));
+    AD9833_Trigger_IRQHandler();
+    s_in_irq = 0;
+}
+
+/**
+ * @brief       抢占回调: GPIO 操作之后和 PRIMASK 清零时执行挂起的触发中断
+ * @retval      无
+ */
+static void CoSim_Preempt(void)
+{
+    if (s_irq_pending && !s_in_irq) CoSim_Irq();
+}
+
+/**
+ * @brief       触发线出现下降沿, 中断挂起
+ * @param       time_ns: 时刻
+ * @retval      无
+ */
+static void CoSim_LineFall(uint64_t time_ns)
+{
+    s_line_fall = time_ns;
+    s_irq_pending = 1;
+}
+
+/**
+ * @brief       引脚变化回调: 主机的触发输出拉低公共触发线
+ * @note        在模拟层更新电平的过程中调用, 中断留给随后的抢占回调执行
+ * @retval      无
+ */
+static void CoSim_Edge(const Mock_Event* ev, void* ctx)
+{
+    (void)ctx;
+    if (ev->port == COSIM_TRIG_PORT && ev->pin == AD9833_TRIG_OUT_Pin && !ev->level && s_line_ext)
+    {
+        CoSim_LineFall(ev->time_ns);
+    }
+}
+
+/**
+ * @brief       外部板卡驱动触发线 (仿真从机收到的触发)
+ * @param       level: 0 拉低; 1 释放
+ * @retval      无
+ */
+static void CoSim_DriveLine(uint8_t level)
+{
+    uint8_t was = s_line_ext && Mock_PinLevel(COSIM_TRIG_PORT, AD9833_TRIG_OUT_Pin);
+
+    s_line_ext = level;
+    if (was && !level)
+    {
+        CoSim_LineFall(Mock_Now());
+        if (!__get_PRIMASK()) CoSim_Preempt();
+    }
+}
+
+/**
+ * @brief       复位一块板卡: 引脚恢复上电状态, 驱动重新初始化, 芯片保持复位并写好参数
+ * @note        模拟层的虚拟时钟同时归零
+ * @param       role: 板卡角色
+ * @retval      无
+ */
+static void CoSim_BoardReset(AD9833_TriggerRole role)
+{
+    Mock_Reset();
+    Mock_PortIdle(COSIM_TRIG_PORT, AD9833_TRIG_OUT_Pin | AD9833_TRIG_Pin, 1);
+    s_line_ext = 1;
+    s_irq_pending = 0;
+
+    AD9833_Init(CS1_CS2_DOUBLE);
+    AD9833_FreqSet(CS_BOTH, 0, 1000.0);
+    AD9833_FreqSet(CS_BOTH, 1, 2000.0);
+    AD9833_PhaseSet(CS_BOTH, 0, 0.0);
+    AD9833_PhaseSet(CS_BOTH, 1, 90.0);
+    AD9833_Trigger_Init(role);
+    Mock_ClearTrace();
+}
+
+/**
+ * @brief       检查记录中是否只有两片芯片在同一个边沿锁存 word
+ * @note        模拟层把同一边沿上各片相同的帧合并为一个事件
+ * @param       word: 期望的控制字
+ * @param       time_ns: 输出锁存时刻
+ * @retval      无
+ */
+static void CoSim_ExpectLatch(uint16_t word, uint64_t* time_ns)
+{
+    const Mock_Event* ev[2];
+    uint32_t num = CoSim_Words(ev, 2);
+
+    CHECK(num == 1U, "expected one latch edge, got %u events", (unsigned)num);
+    if (num != 1U) return;
+
+    CHECK(ev[0]->type == MOCK_EVENT_FRAME && ev[0]->pin == CS_BOTH && ev[0]->word == word,
+          "chips 0x%X: %s word 0x%04X, expected 0x%04X", (unsigned)ev[0]->pin,
+          ev[0]->type == MOCK_EVENT_FRAME ? "latched" : "aborted", ev[0]->word, word);
+    *time_ns = ev[0]->time_ns;
+}
+
+/**
+ * @brief       主机: 预置启动、触发、延迟校验和重复测量
+ * @retval      无
+ */
+static void CoSim_Master(void)
+{
+    AD9833_TriggerStat stat;
+    const Mock_Event* ev[2];
+    uint64_t latch = 0;
+
+    CoSim_BoardReset(AD9833_TRIGGER_MASTER);
+
+    uint32_t falls = CoSim_SclkFalls();
+    CHECK(AD9833_Trigger_ArmStart(CS_BOTH, SINE_WAVE) == HAL_OK, "arm start");
+    CHECK(CoSim_SclkFalls() - falls == 15U, "staging clocked %u edges", (unsigned)(CoSim_SclkFalls() - falls));
+    CHECK(CoSim_Words(ev, 2) == 0U, "chip latched before trigger");
+    CHECK(AD9833_Trigger_ArmStart(CS_BOTH, SINE_WAVE) == HAL_BUSY, "second arm not rejected");
+
+    // 预置期间其他写入不应出现在总线上
+    AD9833_FreqSet(CS1, 0, 5000.0);
+    CHECK(CoSim_Words(ev, 2) == 0U, "write went through while staged");
+
+    CHECK(AD9833_Trigger_Fire() == HAL_OK, "fire");
+    CoSim_ExpectLatch(AD9833_CMD_CTRLREG | AD9833_CTRL_B28, &latch);
+    CHECK(CoSim_CsLevel(0) && CoSim_CsLevel(1), "chip select not released");
+
+    // 主机从写触发输出之前开始计时, 比真实延迟多一次寄存器写入
+    AD9833_Trigger_GetStat(&stat);
+    uint64_t truth = CoSim_Cycles(latch) - CoSim_Cycles(s_line_fall);
+    CHECK(stat.samples == 1U && stat.last >= truth &&
+          stat.last - truth <= CoSim_Cycles(Mock_GetTiming()->reg_write_ns) + 1U,
+          "measured latency %u, simulated %u", (unsigned)stat.last, (unsigned)truth);
+    printf("start: latched 0x%04X, trigger-to-latch %u cycles (simulated %u)\n",
+           AD9833_CMD_CTRLREG | AD9833_CTRL_B28, (unsigned)stat.last, (unsigned)truth);
+
+    // 同步跳频: FREQ1/PHASE1 已写好
+    Mock_ClearTrace();
+    CHECK(AD9833_Trigger_ArmHop(CS_BOTH, 1, 1) == HAL_OK, "arm hop");
+    CHECK(AD9833_Trigger_Fire() == HAL_OK, "fire hop");
+    CoSim_ExpectLatch(AD9833_CMD_CTRLREG | AD9833_CTRL_B28 | AD9833_CTRL_FSELECT | AD9833_CTRL_PSELECT, &latch);
+
+    // 放弃预置: 芯片只收到15位, 不写入
+    Mock_ClearTrace();
+    CHECK(AD9833_Trigger_ArmHop(CS_BOTH, 0, 0) == HAL_OK, "arm hop back");
+    AD9833_Trigger_Disarm();
+    // 两片的片选在不同端口上, 依次拉高, 各记一次放弃
+    CHECK(CoSim_Words(ev, 2) == 2U && ev[0]->type == MOCK_EVENT_ABORT && ev[1]->type == MOCK_EVENT_ABORT &&
+          (ev[0]->pin | ev[1]->pin) == CS_BOTH && ev[0]->level == 15U && ev[1]->level == 15U,
+          "disarm did not abort the frame");
+    Mock_ClearTrace();
+    CHECK(AD9833_Trigger_Fire() == HAL_ERROR, "fire without arm not rejected");
+
+    // 没有预置时的触发
+    AD9833_Trigger_GetStat(&stat);
+    uint32_t spurious = stat.spurious;
+    CoSim_DriveLine(0);
+    CoSim_DriveLine(1);
+    AD9833_Trigger_GetStat(&stat);
+    CHECK(stat.spurious == spurious + 1U && CoSim_Words(ev, 2) == 0U, "spurious trigger");
+
+    // 重复触发统计延迟和抖动, 不记录引脚事件
+    AD9833_Trigger_ResetStat();
+    Mock_TraceEnable(0);
+    CHECK(AD9833_Trigger_Measure(CS_BOTH, COSIM_MEASURE_TIMES) == HAL_OK, "measure");
+    Mock_TraceEnable(1);
+    AD9833_Trigger_GetStat(&stat);
+    CHECK(stat.samples == COSIM_MEASURE_TIMES, "measure samples %u", (unsigned)stat.samples);
+    CHECK(stat.max - stat.min <= s_jitter + 1U, "latency spread %u exceeds jitter %u",
+          (unsigned)(stat.max - stat.min), (unsigned)s_jitter);
+    printf("measure: %u triggers, latency min %u max %u mean %.2f std %.2f cycles (%.1f ns mean)\n",
+           (unsigned)stat.samples, (unsigned)stat.min, (unsigned)stat.max, stat.mean, stat.std,
+           stat.mean * 1e9 / SystemCoreClock);
+}
+
+/**
+ * @brief       所有板卡预置启动命令, 在同一时刻触发, 统计锁存时差
+ * @param       boards: 板卡数 (0号为主机)
+ * @retval      无
+ */
+static void CoSim_Boards(uint32_t boards)
+{
+    const uint64_t t_trigger = CoSim_Ns(1000000U);
+    uint64_t first = UINT64_MAX, last = 0;
+
+    printf("boards: %u, irq jitter %u cycles\n", (unsigned)boards, (unsigned)s_jitter);
+    for (uint32_t b = 0; b < boards; b++)
+    {
+        uint64_t latch = 0;
+
+        CoSim_BoardReset(b == 0U ? AD9833_TRIGGER_MASTER : AD9833_TRIGGER_SLAVE);
+        Mock_Advance(CoSim_Ns(CoSim_Rand() % 1000U));   // 各板卡上电时刻不同
+        CHECK(AD9833_Trigger_ArmStart(CS_BOTH, SQUARE_WAVE) == HAL_OK, "board %u arm", (unsigned)b);
+        CHECK(Mock_Now() < t_trigger, "board %u armed too late", (unsigned)b);
+
+        if (b == 0U)
+        {
+            // 写入完成时触发线正好在 t_trigger 变低
+            Mock_Advance(t_trigger - Mock_Now() - Mock_GetTiming()->reg_write_ns);
+            CHECK(AD9833_Trigger_Fire() == HAL_OK, "board 0 fire");
+        }
+        else
+        {
+            Mock_Advance(t_trigger - Mock_Now());
+            CoSim_DriveLine(0);
+            CHECK(AD9833_Trigger_Wait(1U) == HAL_OK, "board %u wait", (unsigned)b);
+            CoSim_DriveLine(1);
+        }
+        CHECK(s_line_fall == t_trigger, "board %u trigger at %llu ns", (unsigned)b,
+              (unsigned long long)s_line_fall);
+
+        CoSim_ExpectLatch(AD9833_CMD_CTRLREG | AD9833_CTRL_B28 | AD9833_CTRL_OPBITEN | AD9833_CTRL_DIV2, &latch);
+        printf("  board %u: latched %llu cycles after trigger\n", (unsigned)b,
+               (unsigned long long)CoSim_Cycles(latch - t_trigger));
+        if (latch < first) first = latch;
+        if (latch > last) last = latch;
+    }
+
+    CHECK(CoSim_Cycles(last - first) <= s_jitter, "board skew %llu cycles exceeds jitter",
+          (unsigned long long)CoSim_Cycles(last - first));
+    printf("board-to-board skew: %llu cycles (%.1f ns)\n", (unsigned long long)CoSim_Cycles(last - first),
+           (double)(last - first));
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t boards = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : COSIM_BOARD_NUM;
+    s_jitter = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : COSIM_IRQ_JITTER;
+    if (boards == 0U) boards = 1U;
+
+    Mock_Bus bus = {0};
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_SetEdgeHook(CoSim_Edge, NULL);
+    Mock_STM32_SetPreemptHook(CoSim_Preempt);
+
+    CoSim_Master();
+    CoSim_Boards(boards);
+
+    printf("%s (%u failures)\n", s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,448 @@
+/**
+******************************************************************************
+  * @file           : AD9833_DspTest.c
+  * @brief          : 主机编译的 CMSIS-DSP 与固件逐位一致的测试
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * cmsis_dsp_host 与固件使用相同的源文件、相同的配置宏和相同的 SIMD 分支，
+  * 剩下唯一的差别是 DSP 指令由C实现。本测试检查：
+  * - 每条用到的 DSP 指令的C实现与 ARMv7-M 架构手册的定义逐位一致
+  *   (随机输入和全部边界值，包括 0x8000 x 0x8000 的溢出)；
+  * - 固件用到的定点函数 (单频点DFT的均值/偏置/点积、乘加、复数运算) 与
+  *   按 CMSIS-DSP 文档写出的整数参考逐位一致，单频点DFT的结果与浮点一致；
+  * - 一组定点变换、滤波和插值函数的输出摘要 (CRC32) 与记录值相同，配置宏
+  *   或分支变化时失败。有意更新 CMSIS-DSP 后用 -p 打印新的摘要。
+  * 浮点函数关闭了乘加合并 (-ffp-contract=off)，与固件只保证在舍入误差内一致。
+  *
+  ******************************************************************************
+  */
+
+#include "arm_math.h"
+#include "arm_const_structs.h"
+#include <stdio.h>
+#include <string.h>
+#include "Host_Check.h"
+
+#ifndef ARM_MATH_DSP
+#error "cmsis_dsp_host must take the Cortex-M4 ARM_MATH_DSP paths"
+#endif
+
+#define DSP_TEST_RANDOM             1000000U    // 每条指令的随机输入组数
+#define DSP_TEST_N                  256U
+
+static uint8_t s_print = 0;
+
+/* 工具 ---------------------------------------------------------------------*/
+
+static uint32_t s_rand = 0x12345678U;
+
+/**
+ * @brief       伪随机数 (xorshift32), 每次运行相同
+ */
+static uint32_t Test_Rand(void)
+{
+    s_rand ^= s_rand << 13;
+    s_rand ^= s_rand >> 17;
+    s_rand ^= s_rand << 5;
+    return s_rand;
+}
+
+/**
+ * @brief       CRC32 (IEEE), 用于输出摘要
+ */
+static uint32_t Test_Crc32(uint32_t crc, const void* data, uint32_t len)
+{
+    const uint8_t* p = data;
+
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *p++;
+        for (uint8_t k = 0; k < 8U; k++) crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+    }
+    return ~crc;
+}
+
+/* ARMv7-M 定义的参考实现 (64位运算, 不依赖有符号溢出) ---------------------*/
+
+static int64_t Ref_Sat(int64_t v, uint32_t bits)
+{
+    int64_t max = ((int64_t)1 << (bits - 1U)) - 1, min = -max - 1;
+    return v > max ? max : (v < min ? min : v);
+}
+
+static int64_t Ref_Lo(uint32_t x) { return (int16_t)(x & 0xFFFFU); }
+static int64_t Ref_Hi(uint32_t x) { return (int16_t)(x >> 16); }
+static int64_t Ref_Byte(uint32_t x, uint32_t i) { return (int8_t)(x >> (8U * i)); }
+
+static uint32_t Ref_Pack(int64_t lo, int64_t hi)
+{
+    return ((uint32_t)(uint16_t)hi << 16) | (uint16_t)lo;
+}
+
+/* 半字运算: op 0 加 1 减; cross 为交叉 (ASX/SAX) 时的方式, halve 为减半 */
+static uint32_t Ref_Dual(uint32_t x, uint32_t y, int lo_sign, int hi_sign, uint8_t cross, uint8_t halve)
+{
+    int64_t ylo = cross ? Ref_Hi(y) : Ref_Lo(y), yhi = cross ? Ref_Lo(y) : Ref_Hi(y);
+    int64_t lo = Ref_Lo(x) + lo_sign * ylo, hi = Ref_Hi(x) + hi_sign * yhi;
+
+    if (halve) return Ref_Pack(lo >> 1, hi >> 1);
+    return Ref_Pack(Ref_Sat(lo, 16), Ref_Sat(hi, 16));
+}
+
+static uint32_t Ref_Quad8(uint32_t x, uint32_t y, int sign)
+{
+    uint32_t r = 0;
+    for (uint32_t i = 0; i < 4U; i++)
+    {
+        r |= (uint32_t)(uint8_t)Ref_Sat(Ref_Byte(x, i) + sign * Ref_Byte(y, i), 8) << (8U * i);
+    }
+    return r;
+}
+
+/* 双乘: 下半 x.lo*y.lo (或交叉时 x.lo*y.hi) 与上半相加或相减 */
+static int64_t Ref_DualMul(uint32_t x, uint32_t y, uint8_t cross, int sign)
+{
+    int64_t a = Ref_Lo(x) * (cross ? Ref_Hi(y) : Ref_Lo(y));
+    int64_t b = Ref_Hi(x) * (cross ? Ref_Lo(y) : Ref_Hi(y));
+    return a + sign * b;
+}
+
+/**
+ * @brief       比较一组输入下全部指令的C实现与参考
+ * @retval      不一致的指令数
+ */
+static uint32_t Test_IntrinsicsOnce(uint32_t x, uint32_t y, uint32_t z, uint64_t acc)
+{
+    uint32_t bad = 0;
+    int32_t sx = (int32_t)x, sy = (int32_t)y;
+
+#define EXPECT(name, got, want)                                                     \
+    do {                                                                            \
+        if ((uint64_t)(got) != (uint64_t)(want))                                    \
+        {                                                                           \
+            if (bad++ < 4U) printf("  %s(0x%08X, 0x%08X): 0x%llX != 0x%llX\n", name, \
+                                  (unsigned)x, (unsigned)y, (unsigned long long)(uint64_t)(got), \
+                                  (unsigned long long)(uint64_t)(want));          \
+        }                                                                           \
+    } while (0)
+
+    EXPECT("QADD16", __QADD16(x, y), Ref_Dual(x, y, 1, 1, 0, 0));
+    EXPECT("QSUB16", __QSUB16(x, y), Ref_Dual(x, y, -1, -1, 0, 0));
+    EXPECT("SHADD16", __SHADD16(x, y), Ref_Dual(x, y, 1, 1, 0, 1));
+    EXPECT("SHSUB16", __SHSUB16(x, y), Ref_Dual(x, y, -1, -1, 0, 1));
+    EXPECT("QASX", __QASX(x, y), Ref_Dual(x, y, -1, 1, 1, 0));
+    EXPECT("QSAX", __QSAX(x, y), Ref_Dual(x, y, 1, -1, 1, 0));
+    EXPECT("SHASX", __SHASX(x, y), Ref_Dual(x, y, -1, 1, 1, 1));
+    EXPECT("SHSAX", __SHSAX(x, y), Ref_Dual(x, y, 1, -1, 1, 1));
+    EXPECT("QADD8", __QADD8(x, y), Ref_Quad8(x, y, 1));
+    EXPECT("QSUB8", __QSUB8(x, y), Ref_Quad8(x, y, -1));
+    EXPECT("QADD", (uint32_t)__QADD(sx, sy), (uint32_t)Ref_Sat((int64_t)sx + sy, 32));
+    EXPECT("QSUB", (uint32_t)__QSUB(sx, sy), (uint32_t)Ref_Sat((int64_t)sx - sy, 32));
+
+    EXPECT("SMUAD", __SMUAD(x, y), (uint32_t)Ref_DualMul(x, y, 0, 1));
+    EXPECT("SMUADX", __SMUADX(x, y), (uint32_t)Ref_DualMul(x, y, 1, 1));
+    EXPECT("SMUSD", __SMUSD(x, y), (uint32_t)Ref_DualMul(x, y, 0, -1));
+    EXPECT("SMUSDX", __SMUSDX(x, y), (uint32_t)Ref_DualMul(x, y, 1, -1));
+    EXPECT("SMLAD", __SMLAD(x, y, z), (uint32_t)(Ref_DualMul(x, y, 0, 1) + (int64_t)z));
+    EXPECT("SMLADX", __SMLADX(x, y, z), (uint32_t)(Ref_DualMul(x, y, 1, 1) + (int64_t)z));
+    EXPECT("SMLSDX", __SMLSDX(x, y, z), (uint32_t)(Ref_DualMul(x, y, 1, -1) + (int64_t)z));
+    EXPECT("SMLALD", __SMLALD(x, y, acc), acc + (uint64_t)Ref_DualMul(x, y, 0, 1));
+    EXPECT("SMLALDX", __SMLALDX(x, y, acc), acc + (uint64_t)Ref_DualMul(x, y, 1, 1));
+    EXPECT("SMMLA", (uint32_t)__SMMLA(sx, sy, (int32_t)z),
+           (uint32_t)((((uint64_t)z << 32) + (uint64_t)((int64_t)sx * sy)) >> 32));
+
+    EXPECT("SXTB16", __SXTB16(x), Ref_Pack(Ref_Byte(x, 0), Ref_Byte(x, 2)));
+    EXPECT("PKHBT", (uint32_t)__PKHBT(x, y, 16), (x & 0xFFFFU) | (y << 16));
+    EXPECT("PKHTB", (uint32_t)__PKHTB(x, y, 16), (x & 0xFFFF0000U) | (y >> 16));
+    EXPECT("CLZ", __CLZ(x), x ? (uint32_t)__builtin_clz(x) : 32U);
+
+    uint32_t n = (z & 31U) + 1U;
+    EXPECT("SSAT", (uint32_t)__SSAT(sx, n), (uint32_t)Ref_Sat(sx, n));
+    EXPECT("USAT", __USAT(sx, n - 1U),
+           (uint32_t)(sx < 0 ? 0 : ((uint64_t)sx > (1ULL << (n - 1U)) - 1U ? (1ULL << (n - 1U)) - 1U : (uint64_t)sx)));
+
+#undef EXPECT
+    return bad;
+}
+
+/**
+ * @brief       DSP 指令: 边界值两两组合和随机输入
+ */
+static void Test_Intrinsics(void)
+{
+    static const uint32_t edge[] = {
+        0x00000000U, 0x00000001U, 0xFFFFFFFFU, 0x7FFF7FFFU, 0x80008000U, 0x80007FFFU, 0x7FFF8000U,
+        0x7FFFFFFFU, 0x80000000U, 0x00008000U, 0x80000001U, 0x7F7F7F7FU, 0x80808080U, 0x0000FFFFU,
+    };
+    uint32_t bad = 0;
+
+    for (uint32_t i = 0; i < sizeof(edge) / sizeof(edge[0]); i++)
+    {
+        for (uint32_t j = 0; j < sizeof(edge) / sizeof(edge[0]); j++)
+        {
+            bad += Test_IntrinsicsOnce(edge[i], edge[j], edge[(i + j) % 14U], 0x7FFFFFFFFFFFFFFFULL);
+            bad += Test_IntrinsicsOnce(edge[i], edge[j], Test_Rand(), 0);
+        }
+    }
+    for (uint32_t i = 0; i < DSP_TEST_RANDOM; i++)
+    {
+        uint32_t x = Test_Rand(), y = Test_Rand(), z = Test_Rand();
+        bad += Test_IntrinsicsOnce(x, y, z, ((uint64_t)Test_Rand() << 32) | z);
+    }
+    CHECK(bad == 0, "%u intrinsic results differ from the ARMv7-M definition", (unsigned)bad);
+}
+
+/* 定点函数与整数参考 -------------------------------------------------------*/
+
+/**
+ * @brief       固件单频点DFT (AD9833_DualAdc) 的计算链: 去均值、正交参考、点积
+ */
+static void Test_SingleBin(void)
+{
+    q15_t x[DSP_TEST_N], y[DSP_TEST_N], c[DSP_TEST_N], s[DSP_TEST_N];
+    const uint32_t bin = 13U;
+    int64_t sum = 0;
+
+    // 满幅正弦 + 直流 + 量化噪声, 含 -32768 (点积溢出32位的情况)
+    for (uint32_t n = 0; n < DSP_TEST_N; n++)
+    {
+        int32_t v = (int32_t)lround(30000.0 * cos(2.0 * PI * bin * n / DSP_TEST_N + 0.7)) + 2000 +
+                    (int32_t)(Test_Rand() % 512U) - 256;
+        x[n] = (q15_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+    }
+    for (uint32_t n = 0; n < DSP_TEST_N; n++) sum += x[n];
+
+    q15_t mean;
+    arm_mean_q15(x, DSP_TEST_N, &mean);
+    CHECK(mean == (q15_t)(sum / (int64_t)DSP_TEST_N), "arm_mean_q15 %d != %d", mean, (int)(sum / DSP_TEST_N));
+
+    arm_offset_q15(x, (q15_t)-mean, y, DSP_TEST_N);
+    uint32_t bad = 0;
+    for (uint32_t n = 0; n < DSP_TEST_N; n++) bad += (y[n] != (q15_t)Ref_Sat((int64_t)x[n] - mean, 16));
+    CHECK(bad == 0, "arm_offset_q15: %u samples differ", (unsigned)bad);
+
+    // 与固件相同: 32位相位累加器的高15位作为角度
+    uint32_t phase = 0, step = (uint32_t)(4294967296.0 * bin / DSP_TEST_N);
+    for (uint32_t n = 0; n < DSP_TEST_N; n++, phase += step)
+    {
+        q15_t angle = (q15_t)(phase >> 17);
+        c[n] = arm_cos_q15(angle);
+        s[n] = arm_sin_q15(angle);
+    }
+    // 第二遍把一个字的两对乘积都设为 (-32768)^2, 两者之和超过 int32
+    for (uint32_t pass = 0; pass < 2U; pass++)
+    {
+        q63_t re, im;
+        int64_t ref_re = 0, ref_im = 0;
+        if (pass) c[4] = c[5] = y[4] = y[5] = -32768;
+        arm_dot_prod_q15(y, c, DSP_TEST_N, &re);
+        arm_dot_prod_q15(y, s, DSP_TEST_N, &im);
+        for (uint32_t n = 0; n < DSP_TEST_N; n++)
+        {
+            ref_re += (int64_t)y[n] * c[n];
+            ref_im += (int64_t)y[n] * s[n];
+        }
+        CHECK(re == ref_re && im == ref_im, "arm_dot_prod_q15 (%lld, %lld) != (%lld, %lld)", (long long)re,
+              (long long)im, (long long)ref_re, (long long)ref_im);
+        if (pass) break;
+
+        // 与浮点单点DFT比较 (参考序列的量化误差之内)
+        double fre = 0.0, fim = 0.0;
+        for (uint32_t n = 0; n < DSP_TEST_N; n++)
+        {
+            fre += y[n] * 32768.0 * cos(2.0 * PI * bin * n / DSP_TEST_N);
+            fim += y[n] * 32768.0 * sin(2.0 * PI * bin * n / DSP_TEST_N);
+        }
+        CHECK(fabs(atan2(-(double)im, (double)re) - atan2(-fim, fre)) < 1e-3, "single-bin phase %.5f vs %.5f",
+              atan2(-(double)im, (double)re), atan2(-fim, fre));
+    }
+}
+
+/**
+ * @brief       逐元素的定点运算与整数参考
+ */
+static void Test_Elementwise(void)
+{
+    q15_t a[DSP_TEST_N], b[DSP_TEST_N], r[DSP_TEST_N];
+    q31_t a31[DSP_TEST_N], b31[DSP_TEST_N], r31[DSP_TEST_N];
+    uint32_t bad_mult = 0, bad_add = 0, bad_sub = 0, bad_conj = 0;
+
+    for (uint32_t n = 0; n < DSP_TEST_N; n++)
+    {
+        a[n] = (q15_t)Test_Rand();
+        b[n] = (q15_t)Test_Rand();
+        a31[n] = (q31_t)Test_Rand();
+        b31[n] = (q31_t)Test_Rand();
+    }
+    a[0] = b[0] = -32768;
+    a31[0] = b31[0] = INT32_MIN;
+    a31[1] = INT32_MAX;
+    b31[1] = INT32_MIN;
+
+    arm_mult_q15(a, b, r, DSP_TEST_N);
+    for (uint32_t n = 0; n < DSP_TEST_N; n++) bad_mult += (r[n] != (q15_t)Ref_Sat(((int64_t)a[n] * b[n]) >> 15, 16));
+    arm_add_q15(a, b, r, DSP_TEST_N);
+    for (uint32_t n = 0; n < DSP_TEST_N; n++) bad_add += (r[n] != (q15_t)Ref_Sat((int64_t)a[n] + b[n], 16));
+    arm_sub_q31(a31, b31, r31, DSP_TEST_N);
+    for (uint32_t n = 0; n < DSP_TEST_N; n++) bad_sub += (r31[n] != (q31_t)Ref_Sat((int64_t)a31[n] - b31[n], 32));
+    arm_cmplx_conj_q31(a31, r31, DSP_TEST_N / 2U);
+    for (uint32_t n = 0; n < DSP_TEST_N; n++)
+    {
+        q31_t want = (n & 1U) ? (q31_t)Ref_Sat(-(int64_t)a31[n], 32) : a31[n];
+        bad_conj += (r31[n] != want);
+    }
+    CHECK(bad_mult == 0, "arm_mult_q15: %u differ", (unsigned)bad_mult);
+    CHECK(bad_add == 0, "arm_add_q15: %u differ", (unsigned)bad_add);
+    CHECK(bad_sub == 0, "arm_sub_q31: %u differ", (unsigned)bad_sub);
+    CHECK(bad_conj == 0, "arm_cmplx_conj_q31: %u differ", (unsigned)bad_conj);
+}
+
+/* 输出摘要 -----------------------------------------------------------------*/
+
+/**
+ * @brief   一项摘要
+ */
+typedef struct
+{
+    const char* name;
+    uint32_t crc;
+} Test_Digest;
+
+// 以固件的配置 (ARM_MATH_DSP, ARM_MATH_ROUNDING, ARM_MATH_MATRIX_CHECK) 记录
+static const Test_Digest s_golden[] = {
+    { "cfft_q15", 0xDB71F2ADU },
+    { "rfft_q31", 0x38CD042AU },
+    { "fir_q15", 0x7DA1BFD7U },
+    { "biquad_q31", 0x38711240U },
+    { "cmplx_mag_q31", 0x6693E573U },
+    { "cmplx_mult_q31", 0xB8C6AD11U },
+    { "atan2_q31", 0x305DDBF1U },
+    { "divide_q31", 0x7774CAEAU },
+    { "sin_cos_q31", 0x76049234U },
+    { "float_to_q15", 0x926D7563U },
+    { "linear_interp_q15", 0xCEF4D5FEU },
+};
+
+/**
+ * @brief       核对一项摘要
+ */
+static void Test_Digest_Check(const char* name, const void* data, uint32_t len)
+{
+    uint32_t crc = Test_Crc32(0, data, len);
+
+    for (uint32_t i = 0; i < sizeof(s_golden) / sizeof(s_golden[0]); i++)
+    {
+        if (strcmp(s_golden[i].name, name)) continue;
+        if (s_print) printf("    { \"%s\", 0x%08XU },\n", name, (unsigned)crc);
+        else CHECK(crc == s_golden[i].crc, "%s digest 0x%08X != 0x%08X", name, (unsigned)crc,
+                   (unsigned)s_golden[i].crc);
+        return;
+    }
+    CHECK(0, "no golden digest for %s", name);
+}
+
+/**
+ * @brief       变换、滤波、复数和插值函数的输出摘要
+ */
+static void Test_Digests(void)
+{
+    static q15_t x15[2U * DSP_TEST_N], y15[2U * DSP_TEST_N];
+    static q31_t x31[2U * DSP_TEST_N], y31[2U * DSP_TEST_N], z31[2U * DSP_TEST_N];
+
+    s_rand = 0xC0FFEE01U;
+    for (uint32_t n = 0; n < 2U * DSP_TEST_N; n++)
+    {
+        double v = 0.6 * sin(2.0 * PI * 7.0 * n / DSP_TEST_N) + 0.3 * cos(2.0 * PI * 31.0 * n / DSP_TEST_N);
+        x15[n] = (q15_t)(v * 32767.0) + (q15_t)(Test_Rand() & 0x3FU);
+        x31[n] = (q31_t)(v * 2147483647.0) + (q31_t)(Test_Rand() & 0xFFFFU);
+    }
+
+    memcpy(y15, x15, sizeof(y15));
+    arm_cfft_q15(&arm_cfft_sR_q15_len256, y15, 0, 1);
+    Test_Digest_Check("cfft_q15", y15, sizeof(y15));
+
+    arm_rfft_instance_q31 rfft;
+    memcpy(z31, x31, sizeof(z31));
+    arm_rfft_init_q31(&rfft, DSP_TEST_N, 0, 1);
+    arm_rfft_q31(&rfft, z31, y31);
+    Test_Digest_Check("rfft_q31", y31, (DSP_TEST_N + 2U) * sizeof(q31_t));
+
+    // 16抽头低通 FIR (系数和为1)
+    static const q15_t fir_coeff[16] = { 120, 410, 980, 1820, 2790, 3650, 4200, 4414,
+                                         4414, 4200, 3650, 2790, 1820, 980, 410, 120 };
+    q15_t fir_state[16 + DSP_TEST_N];
+    arm_fir_instance_q15 fir;
+    arm_fir_init_q15(&fir, 16, fir_coeff, fir_state, DSP_TEST_N);
+    arm_fir_q15(&fir, x15, y15, DSP_TEST_N);
+    Test_Digest_Check("fir_q15", y15, DSP_TEST_N * sizeof(q15_t));
+
+    // 两级二阶节 (Q31, postShift=1 即系数按 Q30)
+    static const q31_t bq_coeff[10] = { 0x0400C4B0, 0x0801896B, 0x0400C4B0, 0x5A3D9C15, -0x24F32F05,
+                                        0x0800E1C1, 0x1001C382, 0x0800E1C1, 0x6B31E09D, -0x2E09E4C3 };
+    q31_t bq_state[8];
+    arm_biquad_casd_df1_inst_q31 bq;
+    arm_biquad_cascade_df1_init_q31(&bq, 2, bq_coeff, bq_state, 1);
+    arm_biquad_cascade_df1_q31(&bq, x31, y31, DSP_TEST_N);
+    Test_Digest_Check("biquad_q31", y31, DSP_TEST_N * sizeof(q31_t));
+
+    // 固件阻抗测量 (AD9833_Impedance) 用到的复数运算
+    arm_cmplx_mag_q31(x31, y31, DSP_TEST_N);
+    Test_Digest_Check("cmplx_mag_q31", y31, DSP_TEST_N * sizeof(q31_t));
+    arm_cmplx_mult_cmplx_q31(x31, &x31[DSP_TEST_N], y31, DSP_TEST_N / 2U);
+    Test_Digest_Check("cmplx_mult_q31", y31, DSP_TEST_N * sizeof(q31_t));
+
+    for (uint32_t n = 0; n < DSP_TEST_N; n++) arm_atan2_q31(x31[2U * n + 1U], x31[2U * n], &y31[n]);
+    Test_Digest_Check("atan2_q31", y31, DSP_TEST_N * sizeof(q31_t));
+
+    for (uint32_t n = 0; n < DSP_TEST_N; n++)
+    {
+        int16_t shift;
+        q31_t den = x31[2U * n] ? x31[2U * n] : 1;
+        arm_divide_q31(x31[2U * n + 1U] / 2, den, &y31[n], &shift);
+        z31[n] = shift;
+    }
+    memcpy(&y31[DSP_TEST_N], z31, DSP_TEST_N * sizeof(q31_t));
+    Test_Digest_Check("divide_q31", y31, 2U * DSP_TEST_N * sizeof(q31_t));
+
+    for (uint32_t n = 0; n < DSP_TEST_N; n++) arm_sin_cos_q31(x31[n], &y31[2U * n], &y31[2U * n + 1U]);
+    Test_Digest_Check("sin_cos_q31", y31, 2U * DSP_TEST_N * sizeof(q31_t));
+
+    // 浮点转定点 (ARM_MATH_ROUNDING 决定舍入还是截断)
+    static float32_t xf[DSP_TEST_N];
+    for (uint32_t n = 0; n < DSP_TEST_N; n++) xf[n] = (float32_t)x31[n] / 2147483648.0f;
+    arm_float_to_q15(xf, y15, DSP_TEST_N);
+    Test_Digest_Check("float_to_q15", y15, DSP_TEST_N * sizeof(q15_t));
+
+    // 头文件中的内联函数 (在使用者的编译单元中展开)
+    static q15_t table[DSP_TEST_N];
+    for (uint32_t n = 0; n < DSP_TEST_N; n++) table[n] = (q15_t)(x15[n] / 2);
+    for (uint32_t n = 0; n < DSP_TEST_N; n++)
+    {
+        q31_t pos = (q31_t)(Test_Rand() & ((DSP_TEST_N << 20) - 1U));
+        y15[n] = arm_linear_interp_q15(table, pos, DSP_TEST_N);
+    }
+    Test_Digest_Check("linear_interp_q15", y15, DSP_TEST_N * sizeof(q15_t));
+}
+
+int main(int argc, char* argv[])
+{
+    s_print = (argc > 1 && strcmp(argv[1], "-p") == 0);
+
+    if (!s_print)
+    {
+        Test_Intrinsics();
+        Test_SingleBin();
+        Test_Elementwise();
+    }
+    Test_Digests();
+    if (s_print) return 0;
+
+    printf("cmsis-dsp host %s (%u failures)\n", s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
@@ -0,0 +1,98 @@
+/**
+******************************************************************************
+  * @file           : arm_math_host.h
+  * @brief          : 主机编译 CMSIS-DSP 时强制包含: 用C实现 Cortex-M4 的 DSP 指令
+  ******************************************************************************
+  * @attention
+  *
+  * 固件在 Cortex-M4 上编译时 ARM_MATH_DSP 为1，定点函数走 SIMD 分支
+  * (__SMLAD、__QADD16 等)；CMSIS-DSP 的可移植C模式 (__GNUC_PYTHON__) 默认
+  * 不定义它，走的是另一套分支，舍入和饱和的位置不同，结果不能逐位比较。
+  *
+  * cmsis_dsp_host 因此同样定义 ARM_MATH_DSP，并用 -include 在每个源文件
+  * 最前面包含本文件：先在未定义 ARM_MATH_DSP 的情况下引用 dsp/none.h，
+  * 得到这些指令 (以及 __PKHBT/__PKHTB) 的C实现，再恢复 ARM_MATH_DSP，让库和
+  * 头文件中的内联函数编译出与固件相同的分支。none.h 的 __SMLALD/__SMLALDX
+  * 先在32位中把两个乘积相加，(-32768)^2 x 2 时与指令结果差 2^32，双乘类
+  * 指令还依赖有符号溢出，这几条在这里按64位重新实现。C实现与指令逐位
+  * 一致由 ad9833_dsp_test 按 ARMv7-M 的定义检查。
+  *
+  ******************************************************************************
+  */
+
+#ifndef _ARM_MATH_HOST_H
+#define _ARM_MATH_HOST_H
+
+#if defined(__GNUC_PYTHON__) && defined(ARM_MATH_DSP)
+#undef ARM_MATH_DSP
+
+// 下面几条在 none.h 中的实现与指令不一致 (两个乘积在32位中相加) 或依赖
+// 有符号溢出, 改名后由本文件重新实现
+#define __SMUAD                     __SMUAD_none
+#define __SMUADX                    __SMUADX_none
+#define __SMLAD                     __SMLAD_none
+#define __SMLADX                    __SMLADX_none
+#define __SMLSDX                    __SMLSDX_none
+#define __SMLALD                    __SMLALD_none
+#define __SMLALDX                   __SMLALDX_none
+#define __SMMLA                     __SMMLA_none
+#include "arm_math_types.h"
+#include "dsp/none.h"
+#undef __SMUAD
+#undef __SMUADX
+#undef __SMLAD
+#undef __SMLADX
+#undef __SMLSDX
+#undef __SMLALD
+#undef __SMLALDX
+#undef __SMMLA
+
+#define ARM_MATH_DSP                1
+
+/**
+ * @brief       x、y 的下半字之积与上半字之积 (交叉时 x.lo*y.hi 与 x.hi*y.lo), 64位
+ */
+__STATIC_FORCEINLINE int64_t Host_DualMul(uint32_t x, uint32_t y, uint8_t cross, int8_t sign)
+{
+    int64_t a = (int64_t)(int16_t)x * (int16_t)(cross ? (y >> 16) : y);
+    int64_t b = (int64_t)(int16_t)(x >> 16) * (int16_t)(cross ? y : (y >> 16));
+    return a + sign * b;
+}
+
+// 32位结果按模 2^32 回绕 (与指令相同, 溢出只置位Q标志)
+__STATIC_FORCEINLINE uint32_t __SMUAD(uint32_t x, uint32_t y) { return (uint32_t)Host_DualMul(x, y, 0, 1); }
+__STATIC_FORCEINLINE uint32_t __SMUADX(uint32_t x, uint32_t y) { return (uint32_t)Host_DualMul(x, y, 1, 1); }
+
+__STATIC_FORCEINLINE uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t sum)
+{
+    return (uint32_t)Host_DualMul(x, y, 0, 1) + sum;
+}
+
+__STATIC_FORCEINLINE uint32_t __SMLADX(uint32_t x, uint32_t y, uint32_t sum)
+{
+    return (uint32_t)Host_DualMul(x, y, 1, 1) + sum;
+}
+
+__STATIC_FORCEINLINE uint32_t __SMLSDX(uint32_t x, uint32_t y, uint32_t sum)
+{
+    return (uint32_t)Host_DualMul(x, y, 1, -1) + sum;
+}
+
+// 64位累加, 两个乘积之和 (最大 2^31) 不截断到32位
+__STATIC_FORCEINLINE uint64_t __SMLALD(uint32_t x, uint32_t y, uint64_t sum)
+{
+    return sum + (uint64_t)Host_DualMul(x, y, 0, 1);
+}
+
+__STATIC_FORCEINLINE uint64_t __SMLALDX(uint32_t x, uint32_t y, uint64_t sum)
+{
+    return sum + (uint64_t)Host_DualMul(x, y, 1, 1);
+}
+
+__STATIC_FORCEINLINE int32_t __SMMLA(int32_t x, int32_t y, int32_t sum)
+{
+    return (int32_t)((uint32_t)sum + (uint32_t)(((int64_t)x * y) >> 32));
+}
+#endif
+
+#endif /* _ARM_MATH_HOST_H */
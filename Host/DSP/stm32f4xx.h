@@ -0,0 +1,12 @@
+/**
+******************************************************************************
+  * @file           : stm32f4xx.h
+  * @brief          : 主机编译 CMSIS-DSP 用的空头文件
+  ******************************************************************************
+  * @attention
+  *
+  * CMSIS/DSP/Inc/arm_math.h 引用了 stm32f4xx.h 和 stm32f4xx_hal.h，主机编译
+  * 时 (定义 __GNUC_PYTHON__) DSP 库不需要其中的任何内容。
+  *
+  ******************************************************************************
+  */
@@ -0,0 +1,6 @@
+/**
+******************************************************************************
+  * @file           : stm32f4xx_hal.h
+  * @brief          : 主机编译 CMSIS-DSP 用的空头文件, 见 stm32f4xx.h
+  ******************************************************************************
+  */
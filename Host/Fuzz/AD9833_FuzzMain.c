@@ -0,0 +1,392 @@
+/**
+******************************************************************************
+  * @file           : AD9833_FuzzMain.c
+  * @brief          : 没有 libFuzzer 时运行模糊测试目标的独立程序
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-17
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 用法: ad9833_proto_fuzz [-n 次数] [-s 种子] [-t 超时ms] [-a 输出目录] 语料...
+  *
+  * 语料为文件或目录 (目录下的每个文件是一个输入)。先把每个语料输入运行
+  * 一遍，再做 -n 次变异：位翻转、改写/插入/删除字节、重复片段、与另一个
+  * 输入拼接、插入帧头、按声明的长度修正 CRC、插入随机的合法帧。产生新
+  * 应答特征 (命令字 x 执行结果) 的输入加入语料。
+  *
+  * - 崩溃 (abort、段错误等)：当前输入写入 <输出目录>/crash-input，退出码1。
+  * - 超时：单个输入的耗时超过 -t，写入 <输出目录>/timeout-<序号>，计数，
+  *   最后退出码1。
+  * - 结束时输出输入数、命令帧数及每秒的吞吐量。
+  *
+  * 用 clang 编译时 CMake 改为链接 libFuzzer (-fsanitize=fuzzer)，不使用本文件。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_ProtoFuzz.h"
+#include "AD9833_Proto.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FUZZ_CORPUS_MAX             4096U
+#define FUZZ_INPUT_MAX              1024U
+
+/**
+ * @brief   一个输入
+ */
+typedef struct
+{
+    uint8_t* data;
+    uint32_t size;
+} Fuzz_Input;
+
+static Fuzz_Input s_corpus[FUZZ_CORPUS_MAX];
+static uint32_t s_corpus_num = 0;
+static uint32_t s_rng = 1;
+
+// 崩溃时由信号处理函数写出的当前输入
+static const uint8_t* volatile s_cur_data = NULL;
+static volatile uint32_t s_cur_size = 0;
+static char s_crash_path[512];
+
+/**
+ * @brief       伪随机数 (xorshift32)
+ * @retval      随机数
+ */
+static uint32_t Fuzz_Rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+/**
+ * @brief       当前时刻 (秒)
+ * @retval      秒
+ */
+static double Fuzz_Now(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief       崩溃时写出当前输入 (只使用异步信号安全的调用)
+ * @param       sig: 信号
+ * @retval      无
+ */
+static void Fuzz_Crash(int sig)
+{
+    static const char msg[] = "ad9833_proto_fuzz: crash, input saved to ";
+    int fd = open(s_crash_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd >= 0)
+    {
+        if (s_cur_data) (void)!write(fd, s_cur_data, s_cur_size);
+        close(fd);
+    }
+    (void)!write(STDERR_FILENO, msg, sizeof(msg) - 1U);
+    (void)!write(STDERR_FILENO, s_crash_path, strlen(s_crash_path));
+    (void)!write(STDERR_FILENO, "\n", 1);
+    (void)sig;
+    _exit(1);
+}
+
+/**
+ * @brief       加入语料 (复制数据)
+ * @param       data: 数据
+ * @param       size: 字节数
+ * @retval      无
+ */
+static void Fuzz_Add(const uint8_t* data, uint32_t size)
+{
+    if (s_corpus_num >= FUZZ_CORPUS_MAX) return;
+
+    uint8_t* copy = malloc(size ? size : 1U);
+    if (!copy) return;
+    memcpy(copy, data, size);
+    s_corpus[s_corpus_num].data = copy;
+    s_corpus[s_corpus_num].size = size;
+    s_corpus_num++;
+}
+
+/**
+ * @brief       读入一个语料文件
+ * @param       path: 路径
+ * @retval      无
+ */
+static void Fuzz_LoadFile(const char* path)
+{
+    static uint8_t buf[FUZZ_INPUT_MAX];
+    FILE* fp = fopen(path, "rb");
+
+    if (!fp)
+    {
+        fprintf(stderr, "cannot read %s\n", path);
+        return;
+    }
+    size_t n = fread(buf, 1, sizeof(buf), fp);
+    fclose(fp);
+    Fuzz_Add(buf, (uint32_t)n);
+}
+
+/**
+ * @brief       读入语料文件或目录
+ * @param       path: 路径
+ * @retval      无
+ */
+static void Fuzz_Load(const char* path)
+{
+    struct stat st;
+    char file[1024];
+
+    if (stat(path, &st) != 0)
+    {
+        fprintf(stderr, "cannot read %s\n", path);
+        return;
+    }
+    if (!S_ISDIR(st.st_mode))
+    {
+        Fuzz_LoadFile(path);
+        return;
+    }
+
+    DIR* dir = opendir(path);
+    if (!dir) return;
+    for (struct dirent* e = readdir(dir); e; e = readdir(dir))
+    {
+        if (e->d_name[0] == '.') continue;
+        snprintf(file, sizeof(file), "%s/%s", path, e->d_name);
+        Fuzz_LoadFile(file);
+    }
+    closedir(dir);
+}
+
+/**
+ * @brief       在 pos 处插入字节
+ * @param       buf: 缓冲区 (容量 FUZZ_INPUT_MAX)
+ * @param       size: 字节数, 更新
+ * @param       pos: 位置
+ * @param       data: 插入的数据
+ * @param       len: 插入的字节数
+ * @retval      无
+ */
+static void Fuzz_Insert(uint8_t* buf, uint32_t* size, uint32_t pos, const uint8_t* data, uint32_t len)
+{
+    if (*size + len > FUZZ_INPUT_MAX) len = FUZZ_INPUT_MAX - *size;
+    memmove(&buf[pos + len], &buf[pos], *size - pos);
+    memmove(&buf[pos], data, len);
+    *size += len;
+}
+
+/**
+ * @brief       变异一次
+ * @param       buf: 缓冲区 (容量 FUZZ_INPUT_MAX)
+ * @param       size: 字节数, 更新
+ * @retval      无
+ */
+static void Fuzz_Mutate(uint8_t* buf, uint32_t* size)
+{
+    static const uint8_t s_cmd[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x10, 0x11, 0x12, 0x13 };
+    uint8_t tmp[AD9833_PROTO_FRAME_MAX];
+    uint32_t n = *size;
+    uint32_t pos = n ? Fuzz_Rand() % n : 0U;
+
+    switch (Fuzz_Rand() % 10U)
+    {
+    case 0:     // 位翻转
+        if (n) buf[pos] ^= (uint8_t)(1U << (Fuzz_Rand() % 8U));
+        break;
+    case 1:     // 改写一个字节
+        if (n) buf[pos] = (uint8_t)Fuzz_Rand();
+        break;
+    case 2:     // 插入一个字节
+        tmp[0] = (uint8_t)Fuzz_Rand();
+        Fuzz_Insert(buf, size, pos, tmp, 1);
+        break;
+    case 3:     // 删除一段
+    {
+        uint32_t len = 1U + Fuzz_Rand() % 8U;
+        if (pos + len > n) len = n - pos;
+        memmove(&buf[pos], &buf[pos + len], n - pos - len);
+        *size = n - len;
+        break;
+    }
+    case 4:     // 重复一段
+    {
+        uint32_t len = 1U + Fuzz_Rand() % 32U;
+        if (pos + len > n) len = n - pos;
+        memcpy(tmp, &buf[pos], len < sizeof(tmp) ? len : sizeof(tmp));
+        Fuzz_Insert(buf, size, pos + len, tmp, len < sizeof(tmp) ? len : sizeof(tmp));
+        break;
+    }
+    case 5:     // 接上另一个输入的后半段
+    {
+        const Fuzz_Input* other = &s_corpus[Fuzz_Rand() % s_corpus_num];
+        uint32_t from = other->size ? Fuzz_Rand() % other->size : 0U;
+        *size = pos;
+        Fuzz_Insert(buf, size, pos, &other->data[from], other->size - from);
+        break;
+    }
+    case 6:     // 插入帧头
+        tmp[0] = AD9833_PROTO_SOF;
+        Fuzz_Insert(buf, size, pos, tmp, 1);
+        break;
+    case 7:     // 按声明的长度修正一帧的 CRC
+        for (uint32_t i = pos; i + 3U < n; i++)
+        {
+            if (buf[i] == AD9833_PROTO_SOF && buf[i + 1U] <= AD9833_PROTO_PAYLOAD_MAX && i + 3U + buf[i + 1U] < n)
+            {
+                buf[i + 3U + buf[i + 1U]] = AD9833_Proto_Crc8(&buf[i + 1U], buf[i + 1U] + 2U);
+                break;
+            }
+        }
+        break;
+    case 8:     // 插入随机的合法帧
+    {
+        uint8_t payload[AD9833_PROTO_PAYLOAD_MAX];
+        uint8_t len = (uint8_t)(Fuzz_Rand() % 10U);
+        if (Fuzz_Rand() & 1U) len = (uint8_t)(1U + 8U * (1U + Fuzz_Rand() % 7U));   // 序列表装入的长度
+        for (uint8_t i = 0; i < len; i++) payload[i] = (uint8_t)((Fuzz_Rand() & 1U) ? Fuzz_Rand() % 4U : Fuzz_Rand());
+        uint16_t flen = AD9833_Proto_Encode(s_cmd[Fuzz_Rand() % sizeof(s_cmd)], payload, len, tmp);
+        Fuzz_Insert(buf, size, pos, tmp, flen);
+        break;
+    }
+    default:    // 改写长度字节
+        if (n) buf[pos] = (uint8_t)(Fuzz_Rand() % (AD9833_PROTO_PAYLOAD_MAX + 8U));
+        break;
+    }
+}
+
+/**
+ * @brief       运行一个输入
+ * @param       data: 数据
+ * @param       size: 字节数
+ * @retval      耗时 (秒)
+ */
+static double Fuzz_Run(const uint8_t* data, uint32_t size)
+{
+    double t0 = Fuzz_Now();
+
+    s_cur_data = data;
+    s_cur_size = size;
+    LLVMFuzzerTestOneInput(data, size);
+    s_cur_data = NULL;
+
+    return Fuzz_Now() - t0;
+}
+
+/**
+ * @brief       保存超时的输入
+ * @param       dir: 输出目录
+ * @param       index: 序号
+ * @param       data: 数据
+ * @param       size: 字节数
+ * @retval      无
+ */
+static void Fuzz_SaveTimeout(const char* dir, uint32_t index, const uint8_t* data, uint32_t size)
+{
+    char path[600];
+    snprintf(path, sizeof(path), "%s/timeout-%u", dir, (unsigned)index);
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp) return;
+    fwrite(data, 1, size, fp);
+    fclose(fp);
+    fprintf(stderr, "ad9833_proto_fuzz: slow input saved to %s\n", path);
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t runs = 10000;
+    uint32_t timeout_ms = 100;
+    const char* dir = ".";
+    uint32_t timeouts = 0;
+    double slowest = 0.0;
+    int i;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (i + 1 >= argc) break;
+        if (strcmp(argv[i], "-n") == 0) runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "-s") == 0) s_rng = 0x9E3779B9U ^ (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "-t") == 0) timeout_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "-a") == 0) dir = argv[++i];
+        else break;
+    }
+    if (i >= argc)
+    {
+        fprintf(stderr, "usage: %s [-n runs] [-s seed] [-t timeout_ms] [-a artifact_dir] corpus...\n", argv[0]);
+        return 2;
+    }
+    for (; i < argc; i++) Fuzz_Load(argv[i]);
+    if (!s_corpus_num)
+    {
+        fprintf(stderr, "empty corpus\n");
+        return 2;
+    }
+
+    if (!s_rng) s_rng = 1;      // xorshift 的状态不能为0
+    snprintf(s_crash_path, sizeof(s_crash_path), "%s/crash-input", dir);
+    signal(SIGABRT, Fuzz_Crash);
+    signal(SIGSEGV, Fuzz_Crash);
+    signal(SIGFPE, Fuzz_Crash);
+    signal(SIGILL, Fuzz_Crash);
+    signal(SIGBUS, Fuzz_Crash);
+
+    LLVMFuzzerInitialize(&argc, &argv);
+
+    uint32_t seeds = s_corpus_num;
+    uint32_t inputs = 0;
+    double t_start = Fuzz_Now();
+    static uint8_t buf[FUZZ_INPUT_MAX];
+
+    for (uint32_t k = 0; k < seeds + runs; k++)
+    {
+        uint32_t size;
+
+        if (k < seeds)
+        {
+            size = s_corpus[k].size;
+            memcpy(buf, s_corpus[k].data, size);
+        }
+        else
+        {
+            const Fuzz_Input* base = &s_corpus[Fuzz_Rand() % s_corpus_num];
+            size = base->size;
+            memcpy(buf, base->data, size);
+            for (uint32_t m = 1U + Fuzz_Rand() % 4U; m; m--) Fuzz_Mutate(buf, &size);
+        }
+
+        double dt = Fuzz_Run(buf, size);
+        inputs++;
+        if (dt > slowest) slowest = dt;
+        if (dt * 1000.0 > timeout_ms)
+        {
+            Fuzz_SaveTimeout(dir, timeouts++, buf, size);
+        }
+        if (k >= seeds && ProtoFuzz_NewFeatures()) Fuzz_Add(buf, size);
+    }
+
+    double sec = Fuzz_Now() - t_start;
+    if (sec <= 0.0) sec = 1e-9;
+    printf("ad9833_proto_fuzz: %u inputs (%u seeds), %.0f inputs/s, %llu commands, %.0f cmd/s\n",
+           (unsigned)inputs, (unsigned)seeds, inputs / sec, (unsigned long long)ProtoFuzz_Commands(),
+           (double)ProtoFuzz_Commands() / sec);
+    printf("ad9833_proto_fuzz: corpus %u, crashes 0, timeouts %u (> %u ms), slowest %.2f ms\n",
+           (unsigned)s_corpus_num, (unsigned)timeouts, (unsigned)timeout_ms, slowest * 1000.0);
+
+    return timeouts ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+/**
+******************************************************************************
+  * @file           : AD9833_ProtoFuzz.c
+  * @brief          : 串口协议解析与序列表装入的模糊测试目标
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-17
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 输入为串口收到的任意字节流，在模拟层上经 AD9833_Proto 解析并驱动
+  * AD9833_Soft (软件SPI)：
+  * - 字节流按 1~16 字节的片段依次输入，片段之间推进 1ms 虚拟时间，每个片段
+  *   之后调用一次 AD9833_Seq_Poll() 和 AD9833_Table_Tick()；
+  * - 输入结束后继续播放序列 (每次推进 1s，最多128步) 再停止，数据字表
+  *   直接停止；
+  * - 最后等待超过帧内超时并发送一个 PING，解析器必须回复。
+  *
+  * 以下情况调用 abort()，由 libFuzzer (或 AD9833_FuzzMain.c) 记为崩溃：
+  * - 应答帧的帧头、长度或 CRC 不正确，或应答数与校验通过的帧数不等；
+  * - 总线上出现不完整的数据字 (片选在第16个下降沿之前拉高)；
+  * - 垃圾数据之后的 PING 没有得到正确应答。
+  *
+  * 每个输入都从相同的状态开始 (模拟层、驱动、解析器和序列表都重新初始化)。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_ProtoFuzz.h"
+#include "Mock_HAL.h"
+#include "AD9833_Soft.h"
+#include "AD9833_Proto.h"
+#include "AD9833_Seq.h"
+#include "AD9833_Table.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(PROTO_FUZZ_LIBFUZZER)
+#include <time.h>
+#endif
+
+#define FUZZ_CHUNK_MAX              16U
+#define FUZZ_DRAIN_STEPS            128U
+
+static uint64_t s_commands = 0;
+static uint32_t s_replies = 0;
+static uint8_t s_ping_ok = 0;
+static uint8_t s_feature[PROTO_FUZZ_FEATURE_NUM / 8U];
+static uint32_t s_new_features = 0;
+
+/**
+ * @brief       检查并登记一个应答帧
+ * @param       data: 帧
+ * @param       len: 字节数
+ * @retval      无
+ */
+static void Fuzz_Send(const uint8_t* data, uint16_t len)
+{
+    if (len < 5U || data[0] != AD9833_PROTO_SOF || data[1] + 4U != len ||
+        AD9833_Proto_Crc8(&data[1], len - 2U) != data[len - 1U] || !(data[2] & AD9833_PROTO_REPLY) ||
+        data[3] > AD9833_PROTO_ERR_BUSY)
+    {
+        fprintf(stderr, "malformed reply (%u bytes)\n", (unsigned)len);
+        abort();
+    }
+    s_replies++;
+
+    uint32_t f = (uint32_t)(data[2] & 0x7FU) * 8U + data[3];
+    if (!(s_feature[f / 8U] & (1U << (f % 8U))))
+    {
+        s_feature[f / 8U] |= (uint8_t)(1U << (f % 8U));
+        s_new_features++;
+    }
+    if (data[2] == (AD9833_PROTO_PING | AD9833_PROTO_REPLY) && data[3] == AD9833_PROTO_OK) s_ping_ok = 1;
+}
+
+#if defined(PROTO_FUZZ_LIBFUZZER)
+static struct timespec s_t0;
+
+/**
+ * @brief       退出时输出命令吞吐量 (libFuzzer 只给出每秒输入数)
+ * @retval      无
+ */
+static void Fuzz_Report(void)
+{
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double sec = (double)(t1.tv_sec - s_t0.tv_sec) + (t1.tv_nsec - s_t0.tv_nsec) * 1e-9;
+    fprintf(stderr, "ad9833_proto_fuzz: %llu commands, %.0f cmd/s\n", (unsigned long long)s_commands,
+            sec > 0.0 ? (double)s_commands / sec : 0.0);
+}
+#endif
+
+int LLVMFuzzerInitialize(int* argc, char*** argv)
+{
+    static Mock_Bus bus;
+
+    (void)argc;
+    (void)argv;
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_TraceEnable(0);        // 不保留轨迹, 内存不随输入增长
+#if defined(PROTO_FUZZ_LIBFUZZER)
+    clock_gettime(CLOCK_MONOTONIC, &s_t0);
+    atexit(Fuzz_Report);
+#endif
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    uint8_t ping[4];
+    AD9833_ProtoStat stat;
+    AD9833_SeqState seq;
+    Mock_Counters cnt;
+    uint32_t chunk = 0;
+
+    Mock_Reset();
+    AD9833_Init(CS1_CS2_DOUBLE);
+    AD9833_Seq_Init();
+    AD9833_Proto_Init(Fuzz_Send, NULL);
+    s_replies = 0;
+    s_ping_ok = 0;
+    s_new_features = 0;
+
+    for (size_t pos = 0; pos < size; chunk++)
+    {
+        size_t n = 1U + (chunk * 7U) % FUZZ_CHUNK_MAX;
+        if (n > size - pos) n = size - pos;
+
+        AD9833_Proto_Input(&data[pos], (uint32_t)n);
+        AD9833_Seq_Poll();
+        AD9833_Table_Tick();
+        Mock_Advance(1000000ULL);
+        pos += n;
+    }
+
+    for (uint32_t i = 0; i < FUZZ_DRAIN_STEPS; i++)
+    {
+        AD9833_Seq_GetState(&seq);
+        if (!seq.running) break;
+        Mock_Advance(1000000000ULL);
+        AD9833_Seq_Poll();
+    }
+    AD9833_Seq_Stop();
+    AD9833_Table_Stop();
+
+    AD9833_Proto_GetStat(&stat);
+    s_commands += stat.frames;
+
+    // 超时后解析器必须回到空闲, 响应新的帧
+    Mock_Advance((AD9833_PROTO_TIMEOUT_MS + 1U) * 1000000ULL);
+    s_ping_ok = 0;
+    AD9833_Proto_Input(ping, AD9833_Proto_Encode(AD9833_PROTO_PING, NULL, 0, ping));
+    if (!s_ping_ok)
+    {
+        fprintf(stderr, "parser did not answer PING after the input\n");
+        abort();
+    }
+    if (s_replies != stat.frames + 1U)
+    {
+        fprintf(stderr, "%u replies for %u frames\n", (unsigned)s_replies, (unsigned)stat.frames + 1U);
+        abort();
+    }
+
+    Mock_GetCounters(&cnt);
+    if (cnt.aborts)
+    {
+        fprintf(stderr, "%u partial words on the bus\n", (unsigned)cnt.aborts);
+        abort();
+    }
+    return 0;
+}
+
+/**
+ * @brief       累计校验通过的命令帧数 (不含每个输入最后的 PING)
+ * @retval      帧数
+ */
+uint64_t ProtoFuzz_Commands(void)
+{
+    return s_commands;
+}
+
+/**
+ * @brief       上一个输入首次出现的应答特征数 (命令字 x 执行结果)
+ * @retval      个数
+ */
+uint32_t ProtoFuzz_NewFeatures(void)
+{
+    return s_new_features;
+}
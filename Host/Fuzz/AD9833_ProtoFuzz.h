@@ -0,0 +1,27 @@
+/**
+******************************************************************************
+  * @file           : AD9833_ProtoFuzz.h
+  * @brief          : 串口协议模糊测试目标的接口 (libFuzzer 约定)
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-17
+  *
+  ******************************************************************************
+  */
+
+#ifndef _AD9833_PROTO_FUZZ_H
+#define _AD9833_PROTO_FUZZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 应答特征的个数: 命令字 (低7位) x 执行结果
+#define PROTO_FUZZ_FEATURE_NUM      (128U * 8U)
+
+/* 函数声明 */
+int LLVMFuzzerInitialize(int* argc, char*** argv);
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+uint64_t ProtoFuzz_Commands(void);
+uint32_t ProtoFuzz_NewFeatures(void);
+
+#endif /* _AD9833_PROTO_FUZZ_H */
@@ -0,0 +1,694 @@
+/**
+******************************************************************************
+  * @file           : AD9833_ProtoTest.c
+  * @brief          : 串口协议与序列表的主机测试, 并生成模糊测试的初始语料
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-17
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 每个会话是上位机发出的一串帧 (可夹杂帧外字节和损坏的帧)，连同每帧
+  * 应得到的应答结果。测试把会话整段输入和逐字节输入各一遍，检查：
+  * - 应答的命令字和结果与预期一致，统计 (帧数、CRC错误、超长、帧外字节) 正确；
+  * - 写入芯片的数据字 (模拟层组帧的结果) 与驱动直接调用一致；
+  * - 序列表按停留时间播放，遍数和步数正确，播放期间拒绝直接写入；
+  * - 分段写入的数据字表按节拍播放，与序列互斥，播放期间拒绝改写和直接写入；
+  * - 停在 B28=0 半字模式的数据字表结束后，直接写入前先按影子寄存器重写控制字；
+  * - 帧内间隔超时后丢弃半帧，之后的帧正常处理。
+  *
+  * 用 -w <目录> 运行时，把各会话写成 <目录>/<名称>.bin，作为
+  * ad9833_proto_fuzz 的语料 (Host/Fuzz/Corpus)。
+  *
+  ******************************************************************************
+  */
+
+#include "Mock_HAL.h"
+#include "AD9833_Soft.h"
+#include "AD9833_Proto.h"
+#include "AD9833_Seq.h"
+#include "AD9833_Table.h"
+#include <stdio.h>
+#include <string.h>
+#include "Host_Check.h"
+
+#define SESSION_SIZE                1024U
+#define SESSION_REPLY_MAX           32U
+
+/**
+ * @brief   一个会话: 上位机发出的字节流和预期的应答
+ */
+typedef struct
+{
+    const char* name;
+    uint8_t data[SESSION_SIZE];
+    uint32_t size;
+    uint8_t cmd[SESSION_REPLY_MAX];
+    uint8_t status[SESSION_REPLY_MAX];
+    uint32_t replies;
+} Session;
+
+/**
+ * @brief   收到的应答
+ */
+typedef struct
+{
+    uint8_t cmd[SESSION_REPLY_MAX];
+    uint8_t status[SESSION_REPLY_MAX];
+    uint8_t data[SESSION_REPLY_MAX][16];
+    uint32_t num;
+    char other[32];
+    uint32_t other_num;
+} Replies;
+
+static Replies s_rx;
+
+static void Test_Send(const uint8_t* data, uint16_t len)
+{
+    if (s_rx.num >= SESSION_REPLY_MAX) return;
+    CHECK(len >= 5U && data[0] == AD9833_PROTO_SOF && data[1] + 4U == len &&
+          AD9833_Proto_Crc8(&data[1], len - 2U) == data[len - 1U], "malformed reply");
+    s_rx.cmd[s_rx.num] = data[2];
+    s_rx.status[s_rx.num] = data[3];
+    memcpy(s_rx.data[s_rx.num], &data[4], (len - 5U < 16U) ? len - 5U : 16U);
+    s_rx.num++;
+}
+
+static void Test_Other(uint8_t byte)
+{
+    if (s_rx.other_num + 1U < sizeof(s_rx.other)) s_rx.other[s_rx.other_num++] = (char)byte;
+}
+
+/**
+ * @brief       在会话中追加一帧及其预期结果
+ * @param       s: 会话
+ * @param       cmd: 命令字
+ * @param       payload: 数据
+ * @param       len: 数据字节数
+ * @param       status: 预期结果
+ * @retval      无
+ */
+static void Put(Session* s, uint8_t cmd, const uint8_t* payload, uint8_t len, AD9833_ProtoStatus status)
+{
+    s->size += AD9833_Proto_Encode(cmd, payload, len, &s->data[s->size]);
+    s->cmd[s->replies] = cmd | AD9833_PROTO_REPLY;
+    s->status[s->replies] = (uint8_t)status;
+    s->replies++;
+}
+
+/**
+ * @brief       在会话中追加原始字节 (帧外字节或损坏的帧)
+ * @param       s: 会话
+ * @param       data: 数据
+ * @param       len: 字节数
+ * @retval      无
+ */
+static void PutRaw(Session* s, const uint8_t* data, uint32_t len)
+{
+    memcpy(&s->data[s->size], data, len);
+    s->size += len;
+}
+
+/**
+ * @brief       编码序列表的一步
+ * @param       p: 输出, 8字节
+ * @param       op: 操作
+ * @param       arg: 参数
+ * @param       mask: 芯片掩码
+ * @param       dwell_ms: 停留时间
+ * @param       value: 频率或相位
+ * @retval      无
+ */
+static void Step(uint8_t* p, AD9833_SeqOp op, uint8_t arg, uint8_t mask, uint16_t dwell_ms, uint32_t value)
+{
+    p[0] = (uint8_t)((op << 4) | arg);
+    p[1] = mask;
+    p[2] = (uint8_t)dwell_ms;
+    p[3] = (uint8_t)(dwell_ms >> 8);
+    for (uint8_t i = 0; i < 4U; i++) p[4U + i] = (uint8_t)(value >> (8U * i));
+}
+
+static void U32(uint8_t* p, uint32_t v)
+{
+    for (uint8_t i = 0; i < 4U; i++) p[i] = (uint8_t)(v >> (8U * i));
+}
+
+/* 会话 -------------------------------------------------------------------*/
+
+static void Build_Ping(Session* s)
+{
+    s->name = "ping";
+    Put(s, AD9833_PROTO_PING, NULL, 0, AD9833_PROTO_OK);
+}
+
+static void Build_SetBoth(Session* s)
+{
+    uint8_t p[8];
+
+    s->name = "set_both";
+    p[0] = CS_BOTH; p[1] = 0; U32(&p[2], 100000U);            // 1kHz
+    Put(s, AD9833_PROTO_FREQ, p, 6, AD9833_PROTO_OK);
+    p[0] = CS2; p[1] = 0; p[2] = 9000U & 0xFFU; p[3] = 9000U >> 8;   // 90°
+    Put(s, AD9833_PROTO_PHASE, p, 4, AD9833_PROTO_OK);
+    p[0] = CS1; p[1] = TRIANGLE_WAVE;
+    Put(s, AD9833_PROTO_WAVE, p, 2, AD9833_PROTO_OK);
+    p[0] = CS_BOTH; p[1] = 0; p[2] = 0;
+    Put(s, AD9833_PROTO_SELECT, p, 3, AD9833_PROTO_OK);
+    p[0] = CS_BOTH; p[1] = 1;
+    Put(s, AD9833_PROTO_RESET, p, 2, AD9833_PROTO_OK);
+    p[1] = 0;
+    Put(s, AD9833_PROTO_RESET, p, 2, AD9833_PROTO_OK);
+    p[0] = CS1; p[1] = 1; U32(&p[2], 163UL << 16);             // 杂散规划给出的频率字
+    Put(s, AD9833_PROTO_FREQ_RAW, p, 6, AD9833_PROTO_OK);
+}
+
+static void Build_Hop(Session* s)
+{
+    uint8_t p[8];
+
+    s->name = "hop";
+    p[0] = CS_BOTH; p[1] = 1; U32(&p[2], 200000U);
+    Put(s, AD9833_PROTO_FREQ, p, 6, AD9833_PROTO_OK);
+    p[0] = CS_BOTH; p[1] = 1; p[2] = 0;
+    Put(s, AD9833_PROTO_SELECT, p, 3, AD9833_PROTO_OK);
+    p[0] = CS_BOTH; p[1] = 0; U32(&p[2], 300000U);
+    Put(s, AD9833_PROTO_FREQ, p, 6, AD9833_PROTO_OK);
+    p[0] = CS_BOTH; p[1] = 0; p[2] = 0;
+    Put(s, AD9833_PROTO_SELECT, p, 3, AD9833_PROTO_OK);
+}
+
+// 9步: 7步扫频 (每步10ms) + 选择寄存器 + 切换波形, 播放2遍
+static void Build_SeqSweep(Session* s)
+{
+    uint8_t p[1U + 7U * AD9833_SEQ_STEP_SIZE];
+
+    s->name = "seq_sweep";
+    p[0] = 0;
+    for (uint8_t i = 0; i < 7U; i++) Step(&p[1U + i * 8U], AD9833_SEQ_FREQ, 0, CS_BOTH, 10, 100000U * (i + 1U));
+    Put(s, AD9833_PROTO_SEQ_LOAD, p, sizeof(p), AD9833_PROTO_OK);
+    p[0] = 7;
+    Step(&p[1], AD9833_SEQ_SELECT, 0, CS_BOTH, 5, 0);
+    Step(&p[9], AD9833_SEQ_WAVE, SQUARE_WAVE, CS2, 5, 0);
+    Put(s, AD9833_PROTO_SEQ_LOAD, p, 17, AD9833_PROTO_OK);
+    p[0] = 0; p[1] = 9; p[2] = 2;
+    Put(s, AD9833_PROTO_SEQ_RUN, p, 3, AD9833_PROTO_OK);
+    Put(s, AD9833_PROTO_SEQ_STATUS, NULL, 0, AD9833_PROTO_OK);
+}
+
+// 无限循环, 播放期间直接写入和装入被拒绝, 停止后恢复
+static void Build_SeqStop(Session* s)
+{
+    uint8_t p[1U + 2U * AD9833_SEQ_STEP_SIZE];
+
+    s->name = "seq_stop";
+    p[0] = 20;
+    Step(&p[1], AD9833_SEQ_PHASE, 1, CS1, 100, 4500U);
+    Step(&p[9], AD9833_SEQ_PHASE, 1, CS1, 100, 13500U);
+    Put(s, AD9833_PROTO_SEQ_LOAD, p, sizeof(p), AD9833_PROTO_OK);
+    p[0] = 20; p[1] = 2; p[2] = 0;
+    Put(s, AD9833_PROTO_SEQ_RUN, p, 3, AD9833_PROTO_OK);
+    Put(s, AD9833_PROTO_SEQ_RUN, p, 3, AD9833_PROTO_ERR_BUSY);
+    p[0] = CS1; p[1] = SINE_WAVE;
+    Put(s, AD9833_PROTO_WAVE, p, 2, AD9833_PROTO_ERR_BUSY);
+    p[0] = 0;
+    Step(&p[1], AD9833_SEQ_PHASE, 0, CS1, 0, 0);
+    Put(s, AD9833_PROTO_SEQ_LOAD, p, 9, AD9833_PROTO_ERR_BUSY);
+    Put(s, AD9833_PROTO_SEQ_STATUS, NULL, 0, AD9833_PROTO_OK);
+    Put(s, AD9833_PROTO_SEQ_STOP, NULL, 0, AD9833_PROTO_OK);
+    p[0] = CS1; p[1] = SINE_WAVE;
+    Put(s, AD9833_PROTO_WAVE, p, 2, AD9833_PROTO_OK);
+}
+
+// 切换到定时播放, 播放期间不能切回, 停止后可以
+static void Build_SeqTimed(Session* s)
+{
+    uint8_t p[1U + 2U * AD9833_SEQ_STEP_SIZE];
+
+    s->name = "seq_timed";
+    p[0] = 2;
+    Put(s, AD9833_PROTO_SEQ_MODE, p, 1, AD9833_PROTO_ERR_ARG);
+    Put(s, AD9833_PROTO_SEQ_MODE, NULL, 0, AD9833_PROTO_ERR_LEN);
+    p[0] = 1;
+    Put(s, AD9833_PROTO_SEQ_MODE, p, 1, AD9833_PROTO_OK);
+    p[0] = 30;
+    Step(&p[1], AD9833_SEQ_FREQ, 1, CS2, 3, 200000U);
+    Step(&p[9], AD9833_SEQ_FREQ, 1, CS2, 7, 300000U);
+    Put(s, AD9833_PROTO_SEQ_LOAD, p, sizeof(p), AD9833_PROTO_OK);
+    p[0] = 30; p[1] = 2; p[2] = 2;
+    Put(s, AD9833_PROTO_SEQ_RUN, p, 3, AD9833_PROTO_OK);
+    p[0] = 0;
+    Put(s, AD9833_PROTO_SEQ_MODE, p, 1, AD9833_PROTO_ERR_BUSY);
+}
+
+// 2步的数据字表 (CS2): 第0步2个字停留2拍, 第1步1个字停留3拍, 从第1步循环
+static const uint8_t s_table[] = {
+    0x41, 0x44, 0x39, 0x54, AD9833_TABLE_VERSION, CS2, AD9833_TABLE_TICK_HZ & 0xFFU, AD9833_TABLE_TICK_HZ >> 8,
+    2, 0, 1, 0, 3, 0, 0, 0,
+    2, 0, 2, 0, 0x00, 0x21, 0x23, 0x41,
+    3, 0, 1, 0, 0x56, 0x44
+};
+
+// 分段写入并播放数据字表, 播放期间改写、序列和直接写入被拒绝
+static void Build_Table(Session* s)
+{
+    uint8_t p[2U + 20U];
+
+    s->name = "table";
+    p[0] = 0; p[1] = 0;
+    memcpy(&p[2], s_table, 20);
+    Put(s, AD9833_PROTO_TABLE_WRITE, p, 22, AD9833_PROTO_OK);
+    p[0] = 20;
+    memcpy(&p[2], &s_table[20], sizeof(s_table) - 20U);
+    Put(s, AD9833_PROTO_TABLE_WRITE, p, (uint8_t)(2U + sizeof(s_table) - 20U), AD9833_PROTO_OK);
+    p[0] = (AD9833_PROTO_TABLE_SIZE - 1U) & 0xFFU; p[1] = (AD9833_PROTO_TABLE_SIZE - 1U) >> 8;
+    Put(s, AD9833_PROTO_TABLE_WRITE, p, 4, AD9833_PROTO_ERR_ARG);    // 超出缓冲区
+    Put(s, AD9833_PROTO_TABLE_WRITE, p, 2, AD9833_PROTO_ERR_LEN);
+    p[0] = sizeof(s_table) - 1U; p[1] = 0; p[2] = 2;
+    Put(s, AD9833_PROTO_TABLE_RUN, p, 3, AD9833_PROTO_ERR_ARG);      // 长度与表不符
+    p[0] = sizeof(s_table);
+    Put(s, AD9833_PROTO_TABLE_RUN, p, 3, AD9833_PROTO_OK);
+    Put(s, AD9833_PROTO_TABLE_RUN, p, 3, AD9833_PROTO_ERR_BUSY);
+    p[0] = 0; p[1] = 0; p[2] = 0xAA;
+    Put(s, AD9833_PROTO_TABLE_WRITE, p, 3, AD9833_PROTO_ERR_BUSY);
+    p[0] = 0; p[1] = 1; p[2] = 1;
+    Put(s, AD9833_PROTO_SEQ_RUN, p, 3, AD9833_PROTO_ERR_BUSY);
+    p[0] = CS1; p[1] = 0; U32(&p[2], 100000U);
+    Put(s, AD9833_PROTO_FREQ, p, 6, AD9833_PROTO_ERR_BUSY);
+    Put(s, AD9833_PROTO_TABLE_STATUS, NULL, 0, AD9833_PROTO_OK);
+}
+
+static void Build_Errors(Session* s)
+{
+    uint8_t p[1U + AD9833_SEQ_STEP_SIZE];
+
+    s->name = "errors";
+    Put(s, 0x7F, NULL, 0, AD9833_PROTO_ERR_CMD);
+    p[0] = CS1; p[1] = 0;
+    Put(s, AD9833_PROTO_FREQ, p, 2, AD9833_PROTO_ERR_LEN);
+    Put(s, AD9833_PROTO_PING, p, 1, AD9833_PROTO_ERR_LEN);
+    p[0] = 0; p[1] = 0; U32(&p[2], 1000U);
+    Put(s, AD9833_PROTO_FREQ, p, 6, AD9833_PROTO_ERR_ARG);          // 掩码为0
+    p[0] = 0x80; p[1] = 0; U32(&p[2], 1000U);
+    Put(s, AD9833_PROTO_FREQ, p, 6, AD9833_PROTO_ERR_ARG);          // 不存在的芯片
+    p[0] = CS1; p[1] = 0; U32(&p[2], AD9833_SEQ_FREQ_MAX + 1U);
+    Put(s, AD9833_PROTO_FREQ, p, 6, AD9833_PROTO_ERR_ARG);
+    p[0] = CS1; p[1] = 0; U32(&p[2], AD9833_SEQ_WORD_MAX + 1U);
+    Put(s, AD9833_PROTO_FREQ_RAW, p, 6, AD9833_PROTO_ERR_ARG);
+    p[0] = CS1; p[1] = 2; p[2] = 0; p[3] = 0;
+    Put(s, AD9833_PROTO_PHASE, p, 4, AD9833_PROTO_ERR_ARG);
+    p[0] = CS1; p[1] = 0; p[2] = 36000U & 0xFFU; p[3] = 36000U >> 8;
+    Put(s, AD9833_PROTO_PHASE, p, 4, AD9833_PROTO_ERR_ARG);
+    p[0] = CS1; p[1] = 4;
+    Put(s, AD9833_PROTO_WAVE, p, 2, AD9833_PROTO_ERR_ARG);
+    p[0] = 40; p[1] = 2; p[2] = 1;
+    Put(s, AD9833_PROTO_SEQ_RUN, p, 3, AD9833_PROTO_ERR_ARG);       // 未装入
+    p[0] = 60; p[1] = 10; p[2] = 1;
+    Put(s, AD9833_PROTO_SEQ_RUN, p, 3, AD9833_PROTO_ERR_ARG);       // 越界
+    p[0] = AD9833_SEQ_LEN;
+    Step(&p[1], AD9833_SEQ_FREQ, 0, CS1, 0, 0);
+    Put(s, AD9833_PROTO_SEQ_LOAD, p, 9, AD9833_PROTO_ERR_ARG);
+    p[0] = 0;
+    Step(&p[1], AD9833_SEQ_FREQ_RAW, 0, CS1, 0, AD9833_SEQ_WORD_MAX + 1U);
+    Put(s, AD9833_PROTO_SEQ_LOAD, p, 9, AD9833_PROTO_ERR_ARG);
+    p[0] = 0;
+    Step(&p[1], AD9833_SEQ_WAVE, SINE_WAVE, CS1, 0, 5);
+    Put(s, AD9833_PROTO_SEQ_LOAD, p, 9, AD9833_PROTO_ERR_ARG);
+    Put(s, AD9833_PROTO_SEQ_LOAD, p, 5, AD9833_PROTO_ERR_LEN);
+}
+
+// 帧外字节、CRC错误、帧头重复、超长, 之后的有效帧照常处理
+static void Build_Noise(Session* s)
+{
+    static const uint8_t s_debug[] = { 'p', 'l', '\r', '\n' };
+    static const uint8_t s_double_sof[] = { AD9833_PROTO_SOF };
+    static const uint8_t s_overrun[] = { AD9833_PROTO_SOF, 0xFF, 0x01 };
+    uint8_t bad[8];
+    uint8_t p[8];
+
+    s->name = "noise";
+    PutRaw(s, s_debug, sizeof(s_debug));
+    uint16_t n = AD9833_Proto_Encode(AD9833_PROTO_PING, NULL, 0, bad);
+    bad[n - 1U] ^= 0x5AU;
+    PutRaw(s, bad, n);
+    PutRaw(s, s_double_sof, sizeof(s_double_sof));
+    Put(s, AD9833_PROTO_PING, NULL, 0, AD9833_PROTO_OK);
+    PutRaw(s, s_overrun, sizeof(s_overrun));
+    p[0] = CS2; p[1] = 1; U32(&p[2], 12345678U);
+    Put(s, AD9833_PROTO_FREQ, p, 6, AD9833_PROTO_OK);
+}
+
+/* 测试 -------------------------------------------------------------------*/
+
+/**
+ * @brief       复位模拟层、驱动和协议
+ * @retval      无
+ */
+static void Fresh(void)
+{
+    Mock_Reset();
+    AD9833_Init(CS1_CS2_DOUBLE);
+    AD9833_Seq_Init();
+    AD9833_Proto_Init(Test_Send, Test_Other);
+    memset(&s_rx, 0, sizeof(s_rx));
+    Mock_ClearTrace();
+}
+
+/**
+ * @brief       输入会话并比较应答
+ * @param       s: 会话
+ * @param       chunk: 每次输入的字节数
+ * @retval      无
+ */
+static void Feed(const Session* s, uint32_t chunk)
+{
+    Fresh();
+    for (uint32_t pos = 0; pos < s->size; pos += chunk)
+    {
+        AD9833_Proto_Input(&s->data[pos], (s->size - pos < chunk) ? s->size - pos : chunk);
+    }
+
+    CHECK(s_rx.num == s->replies, "%s/%u: %u replies, expected %u", s->name, (unsigned)chunk,
+          (unsigned)s_rx.num, (unsigned)s->replies);
+    for (uint32_t i = 0; i < s->replies && i < s_rx.num; i++)
+    {
+        CHECK(s_rx.cmd[i] == s->cmd[i] && s_rx.status[i] == s->status[i],
+              "%s/%u reply %u: cmd 0x%02X status %u, expected 0x%02X %u", s->name, (unsigned)chunk, (unsigned)i,
+              s_rx.cmd[i], s_rx.status[i], s->cmd[i], s->status[i]);
+    }
+}
+
+/**
+ * @brief       在模拟层的组帧结果中查找数据字
+ * @param       mask: 片选掩码
+ * @param       word: 数据字
+ * @retval      出现次数
+ */
+static uint32_t BusCount(uint32_t mask, uint16_t word)
+{
+    uint32_t num;
+    uint32_t hits = 0;
+    const Mock_Event* ev = Mock_GetTrace(&num);
+
+    for (uint32_t i = 0; i < num; i++)
+    {
+        if (ev[i].type == MOCK_EVENT_FRAME && ev[i].pin == mask && ev[i].word == word) hits++;
+    }
+    return hits;
+}
+
+/**
+ * @brief       取模拟层组帧结果中写给一组芯片的最后几个数据字
+ * @param       mask: 片选掩码
+ * @param       words: 输出, 按写入顺序
+ * @param       n: 个数
+ * @retval      找到的个数
+ */
+static uint32_t BusLast(uint32_t mask, uint16_t* words, uint32_t n)
+{
+    uint32_t num;
+    uint32_t found = 0;
+    const Mock_Event* ev = Mock_GetTrace(&num);
+
+    for (uint32_t i = num; i-- > 0U && found < n;)
+    {
+        if (ev[i].type == MOCK_EVENT_FRAME && ev[i].pin == mask) words[n - 1U - found++] = ev[i].word;
+    }
+    return found;
+}
+
+/**
+ * @brief       推进虚拟时间并播放, 直到序列停止
+ * @param       max_ms: 最长时间
+ * @retval      用时 (毫秒)
+ */
+static uint32_t PlayUntilIdle(uint32_t max_ms)
+{
+    AD9833_SeqState seq;
+    uint32_t ms = 0;
+
+    for (; ms < max_ms; ms++)
+    {
+        AD9833_Seq_Poll();
+        AD9833_Seq_GetState(&seq);
+        if (!seq.running) break;
+        Mock_Advance(1000000ULL);
+    }
+    return ms;
+}
+
+static void Test_Sessions(Session* list, uint32_t num)
+{
+    for (uint32_t i = 0; i < num; i++)
+    {
+        Feed(&list[i], list[i].size);
+        Feed(&list[i], 1);
+        Feed(&list[i], 5);
+    }
+}
+
+static void Test_Words(Session* set_both)
+{
+    Feed(set_both, set_both->size);
+
+    uint32_t w = AD9833_FreqToWord(CS1, 1000.0);
+    CHECK(BusCount(CS_BOTH, (uint16_t)(0x4000U | (w & 0x3FFFU))) == 1U &&
+          BusCount(CS_BOTH, (uint16_t)(0x4000U | (w >> 14))) == 1U, "FREQ0 words for 1kHz not broadcast");
+    CHECK(BusCount(CS2, (uint16_t)(0xC000U | 1024U)) == 1U, "PHASE0 word for 90 deg missing");
+    CHECK(BusCount(CS1, (uint16_t)(0x8000U | ((163UL << 16) & 0x3FFFU))) == 1U &&
+          BusCount(CS1, (uint16_t)(0x8000U | ((163UL << 16) >> 14))) == 1U, "FREQ1 raw word halves missing");
+}
+
+static void Test_Seq(Session* sweep)
+{
+    AD9833_SeqState seq;
+
+    Feed(sweep, sweep->size);
+    CHECK(s_rx.num == 4U && s_rx.data[3][0] == 1U && s_rx.data[3][2] == 2U, "status after run: running %u loops %u",
+          s_rx.data[3][0], s_rx.data[3][2]);
+
+    uint32_t ms = PlayUntilIdle(10000);
+    AD9833_Seq_GetState(&seq);
+    CHECK(seq.steps == 18U && !seq.running && seq.index == 0U, "steps %u running %u index %u",
+          (unsigned)seq.steps, seq.running, seq.index);
+    // 每遍 7x10ms + 5ms + 5ms, 第二遍最后一步之后不再等待
+    CHECK(ms >= 80U + 75U && ms <= 80U + 75U + 2U, "played in %u ms", (unsigned)ms);
+
+    for (uint32_t i = 1; i <= 7U; i++)
+    {
+        uint32_t w = AD9833_FreqToWord(CS1, 1000.0 * i);
+        CHECK(BusCount(CS_BOTH, (uint16_t)(0x4000U | (w & 0x3FFFU))) == 2U, "step %u LSB not written twice", (unsigned)i);
+    }
+}
+
+static void Test_Timed(Session* timed)
+{
+    AD9833_SeqState seq;
+    uint8_t p[1] = { 0 };
+    uint32_t ticks = 0;
+
+    Feed(timed, timed->size);
+    // 主循环播放不执行
+    PlayUntilIdle(50);
+    AD9833_Seq_GetState(&seq);
+    CHECK(seq.timed && seq.running && seq.steps == 0U, "timed %u running %u steps %u after Poll",
+          seq.timed, seq.running, (unsigned)seq.steps);
+
+    for (; ticks < 100U && seq.running; ticks++)
+    {
+        AD9833_Seq_Tick();
+        AD9833_Seq_GetState(&seq);
+    }
+    // 每遍 3 + 7 个节拍, 第二遍最后一步之后不再等待
+    CHECK(seq.steps == 4U && ticks == 14U, "steps %u in %u ticks", (unsigned)seq.steps, (unsigned)ticks);
+    uint32_t w = AD9833_FreqToWord(CS2, 3000.0);
+    CHECK(BusCount(CS2, (uint16_t)(0x8000U | (w & 0x3FFFU))) == 2U, "FREQ1 LSB for 3kHz not written twice");
+
+    uint8_t frame[8];
+    AD9833_Proto_Input(frame, AD9833_Proto_Encode(AD9833_PROTO_SEQ_MODE, p, 1, frame));
+    AD9833_Seq_GetState(&seq);
+    CHECK(s_rx.status[s_rx.num - 1U] == AD9833_PROTO_OK && !seq.timed, "SEQ_MODE 0 after stop: status %u timed %u",
+          s_rx.status[s_rx.num - 1U], seq.timed);
+}
+
+static void Test_Table(Session* table)
+{
+    AD9833_TableState st;
+    uint8_t frame[8];
+    uint32_t ticks = 0;
+
+    Feed(table, table->size);
+    CHECK(s_rx.data[s_rx.num - 1U][0] == 1U && s_rx.data[s_rx.num - 1U][1] == 2U, "status after run: running %u loops %u",
+          s_rx.data[s_rx.num - 1U][0], s_rx.data[s_rx.num - 1U][1]);
+    CHECK(BusCount(CS2, 0x2100U) == 0U, "table written before the first tick");
+
+    AD9833_Table_GetState(&st);
+    for (; ticks < 100U && st.running; ticks++)
+    {
+        AD9833_Table_Tick();
+        AD9833_Table_GetState(&st);
+    }
+    // 第0步 + 第1步播放2遍: 2 + 3 个节拍后执行最后一步
+    CHECK(st.steps == 3U && st.words == 4U && ticks == 6U, "steps %u words %u in %u ticks",
+          (unsigned)st.steps, (unsigned)st.words, (unsigned)ticks);
+    CHECK(BusCount(CS2, 0x2100U) == 1U && BusCount(CS2, 0x4123U) == 1U && BusCount(CS2, 0x4456U) == 2U,
+          "table words on CS2 wrong");
+    CHECK(BusCount(CS1, 0x4456U) == 0U, "table word reached CS1");
+
+    AD9833_Proto_Input(frame, AD9833_Proto_Encode(AD9833_PROTO_TABLE_STATUS, NULL, 0, frame));
+    const uint8_t* d = s_rx.data[s_rx.num - 1U];
+    CHECK(s_rx.status[s_rx.num - 1U] == AD9833_PROTO_OK && d[0] == 0U && d[4] == 3U && d[8] == 4U,
+          "status after play: running %u steps %u words %u", d[0], d[4], d[8]);
+
+    // 结束后可再次写入, 无限循环时由 TABLE_STOP 停止
+    uint8_t p[3] = { sizeof(s_table), 0, 0 };
+    AD9833_Proto_Input(frame, AD9833_Proto_Encode(AD9833_PROTO_TABLE_RUN, p, 3, frame));
+    for (uint32_t i = 0; i < 50U; i++) AD9833_Table_Tick();
+    AD9833_Proto_Input(frame, AD9833_Proto_Encode(AD9833_PROTO_TABLE_STOP, NULL, 0, frame));
+    AD9833_Table_GetState(&st);
+    CHECK(s_rx.status[s_rx.num - 1U] == AD9833_PROTO_OK && !st.running && st.steps > 10U, "stop: running %u steps %u",
+          st.running, (unsigned)st.steps);
+}
+
+// 1步的数据字表 (CS2): 半字模式 (B28=0, HLB=1) 写 FREQ0 高14位, 结束时 B28 仍为0
+static const uint8_t s_table_hlb[] = {
+    0x41, 0x44, 0x39, 0x54, AD9833_TABLE_VERSION, CS2, AD9833_TABLE_TICK_HZ & 0xFFU, AD9833_TABLE_TICK_HZ >> 8,
+    1, 0, 0, 0, 2, 0, 0, 0,
+    1, 0, 2, 0, 0x00, 0x10, 0x23, 0x41
+};
+
+static void Test_TableRestore(void)
+{
+    uint8_t p[2U + sizeof(s_table_hlb)];
+    uint8_t frame[AD9833_PROTO_FRAME_MAX];
+    uint16_t w[3];
+    const uint32_t word = 0x0ABCDEFU;
+
+    Fresh();
+    p[0] = 0; p[1] = 0;
+    memcpy(&p[2], s_table_hlb, sizeof(s_table_hlb));
+    AD9833_Proto_Input(frame, AD9833_Proto_Encode(AD9833_PROTO_TABLE_WRITE, p, sizeof(p), frame));
+    p[0] = sizeof(s_table_hlb); p[1] = 0; p[2] = 1;
+    AD9833_Proto_Input(frame, AD9833_Proto_Encode(AD9833_PROTO_TABLE_RUN, p, 3, frame));
+    AD9833_Table_Tick();
+    CHECK(BusLast(CS2, w, 2) == 2U && w[0] == 0x1000U && w[1] == 0x4123U, "HLB table words %04X %04X", w[0], w[1]);
+
+    // 表已结束, FREQ_RAW 之前先重写影子控制字 (B28=1, RESET=1), 两个半字才分别落在低、高14位
+    p[0] = CS2; p[1] = 0; U32(&p[2], word);
+    AD9833_Proto_Input(frame, AD9833_Proto_Encode(AD9833_PROTO_FREQ_RAW, p, 6, frame));
+    CHECK(s_rx.status[s_rx.num - 1U] == AD9833_PROTO_OK, "FREQ_RAW after the table: status %u",
+          s_rx.status[s_rx.num - 1U]);
+    CHECK(BusLast(CS2, w, 3) == 3U && w[0] == 0x2100U && w[1] == (uint16_t)(0x4000U | (word & 0x3FFFU)) &&
+          w[2] == (uint16_t)(0x4000U | (word >> 14)), "FREQ_RAW after the HLB table: %04X %04X %04X", w[0], w[1], w[2]);
+
+    // 只重写一次
+    AD9833_Proto_Input(frame, AD9833_Proto_Encode(AD9833_PROTO_FREQ_RAW, p, 6, frame));
+    CHECK(BusCount(CS2, 0x2100U) == 1U, "control word rewritten %u times", (unsigned)BusCount(CS2, 0x2100U));
+
+    // TABLE_STOP 停止后立即重写
+    p[0] = sizeof(s_table_hlb); p[1] = 0; p[2] = 0;
+    AD9833_Proto_Input(frame, AD9833_Proto_Encode(AD9833_PROTO_TABLE_RUN, p, 3, frame));
+    AD9833_Table_Tick();
+    AD9833_Proto_Input(frame, AD9833_Proto_Encode(AD9833_PROTO_TABLE_STOP, NULL, 0, frame));
+    CHECK(BusLast(CS2, w, 1) == 1U && w[0] == 0x2100U, "after TABLE_STOP the last CS2 word is %04X", w[0]);
+}
+
+static void Test_Noise(Session* noise)
+{
+    AD9833_ProtoStat stat;
+
+    Feed(noise, noise->size);
+    AD9833_Proto_GetStat(&stat);
+    CHECK(stat.frames == 2U && stat.crc_errors == 1U && stat.overruns == 2U, "frames %u crc %u overruns %u",
+          (unsigned)stat.frames, (unsigned)stat.crc_errors, (unsigned)stat.overruns);
+    // 超长帧头被丢弃后, 其后到达的 0x01 也在帧外
+    CHECK(strcmp(s_rx.other, "pl\r\n\x01") == 0, "%u bytes outside frames", (unsigned)s_rx.other_num);
+}
+
+static void Test_Timeout(void)
+{
+    uint8_t ping[4];
+    AD9833_ProtoStat stat;
+
+    Fresh();
+    AD9833_Proto_Encode(AD9833_PROTO_PING, NULL, 0, ping);
+    AD9833_Proto_Input(ping, 2);                                // 半帧
+    Mock_Advance((AD9833_PROTO_TIMEOUT_MS - 1U) * 1000000ULL);
+    AD9833_Proto_Input(&ping[2], 2);                            // 未超时, 拼成整帧
+    Mock_Advance((AD9833_PROTO_TIMEOUT_MS + 5U) * 1000000ULL);
+    AD9833_Proto_Input(ping, 3);
+    Mock_Advance((AD9833_PROTO_TIMEOUT_MS + 5U) * 1000000ULL);
+    AD9833_Proto_Input(ping, 4);                                // 超时丢弃前面的半帧
+
+    AD9833_Proto_GetStat(&stat);
+    CHECK(s_rx.num == 2U && stat.timeouts == 1U && stat.frames == 2U, "replies %u timeouts %u frames %u",
+          (unsigned)s_rx.num, (unsigned)stat.timeouts, (unsigned)stat.frames);
+}
+
+/**
+ * @brief       写出语料
+ * @param       dir: 目录
+ * @param       list: 会话
+ * @param       num: 会话数
+ * @retval      0: 成功
+ */
+static int WriteCorpus(const char* dir, const Session* list, uint32_t num)
+{
+    char path[512];
+
+    for (uint32_t i = 0; i < num; i++)
+    {
+        snprintf(path, sizeof(path), "%s/%s.bin", dir, list[i].name);
+        FILE* fp = fopen(path, "wb");
+        if (!fp)
+        {
+            fprintf(stderr, "cannot write %s\n", path);
+            return 2;
+        }
+        fwrite(list[i].data, 1, list[i].size, fp);
+        fclose(fp);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    static Session s_session[9];
+    Mock_Bus bus = {0};
+
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+
+    Build_Ping(&s_session[0]);
+    Build_SetBoth(&s_session[1]);
+    Build_Hop(&s_session[2]);
+    Build_SeqSweep(&s_session[3]);
+    Build_SeqStop(&s_session[4]);
+    Build_Errors(&s_session[5]);
+    Build_Noise(&s_session[6]);
+    Build_SeqTimed(&s_session[7]);
+    Build_Table(&s_session[8]);
+
+    if (argc == 3 && strcmp(argv[1], "-w") == 0) return WriteCorpus(argv[2], s_session, 9);
+    if (argc != 1)
+    {
+        fprintf(stderr, "usage: %s [-w corpus_dir]\n", argv[0]);
+        return 2;
+    }
+
+    Test_Sessions(s_session, 9);
+    Test_Words(&s_session[1]);
+    Test_Seq(&s_session[3]);
+    Test_Noise(&s_session[6]);
+    Test_Timed(&s_session[7]);
+    Test_Table(&s_session[8]);
+    Test_TableRestore();
+    Test_Timeout();
+
+    printf("proto %s (%u failures)\n", s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
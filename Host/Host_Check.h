@@ -0,0 +1,40 @@
+/**
+******************************************************************************
+  * @file           : Host_Check.h
+  * @brief          : 主机测试共用的检查宏
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 使用方法:
+  *    1. 测试主文件包含本头文件 (每个测试程序只在一个源文件中包含)
+  *    2. 用 CHECK(条件, 格式, ...) 检查结果, 失败时打印位置和说明并计数
+  *    3. 结束时按 s_fail 打印 PASSED/FAILED, 并作为进程返回值
+  *
+  ******************************************************************************
+  */
+
+#ifndef _HOST_CHECK_H
+#define _HOST_CHECK_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// 本测试程序的失败计数
+static uint32_t s_fail = 0;
+
+#define CHECK(cond, ...)                                        \
+    do {                                                        \
+        if (!(cond))                                            \
+        {                                                       \
+            s_fail++;                                           \
+            printf("  FAIL %s:%d: ", __FILE__, __LINE__);       \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+        }                                                       \
+    } while (0)
+
+#endif /* _HOST_CHECK_H */
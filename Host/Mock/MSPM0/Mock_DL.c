@@ -0,0 +1,71 @@
+/**
+******************************************************************************
+  * @file           : Mock_DL.c
+  * @brief          : 主机构建用的 MSPM0 DriverLib 模拟函数
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * DL_GPIO_setPins()/DL_GPIO_clearPins() 各计一次GPIO操作，耗时取时间模型的
+  * dl_write_ns (单次写 DOUTSET/DOUTCLR 寄存器)。
+  *
+  ******************************************************************************
+  */
+
+#include "ti_msp_dl_config.h"
+#include "Mock_HAL.h"
+
+GPIO_Regs Mock_DL_GPIO[MOCK_DL_PORT_NUM] = {0};
+
+static uint32_t s_primask = 0;
+
+/**
+ * @brief       模拟端口在 Mock_HAL 中的编号
+ * @param       gpio: 端口
+ * @retval      编号
+ */
+uint8_t Mock_DL_Port(const GPIO_Regs* gpio)
+{
+    return (uint8_t)(gpio - Mock_DL_GPIO);
+}
+
+void DL_GPIO_setPins(GPIO_Regs* gpio, uint32_t pins)
+{
+    uint8_t port = Mock_DL_Port(gpio);
+
+    gpio->DOUTSET31_0 = pins;
+    Mock_PortWrite(port, pins, 0, Mock_GetTiming()->dl_write_ns);
+    gpio->DOUT31_0 = Mock_PinLevel(port, 0xFFFFFFFFU);
+}
+
+void DL_GPIO_clearPins(GPIO_Regs* gpio, uint32_t pins)
+{
+    uint8_t port = Mock_DL_Port(gpio);
+
+    gpio->DOUTCLR31_0 = pins;
+    Mock_PortWrite(port, 0, pins, Mock_GetTiming()->dl_write_ns);
+    gpio->DOUT31_0 = Mock_PinLevel(port, 0xFFFFFFFFU);
+}
+
+void __disable_irq(void)
+{
+    s_primask = 1;
+}
+
+void __enable_irq(void)
+{
+    s_primask = 0;
+}
+
+uint32_t __get_PRIMASK(void)
+{
+    return s_primask;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    s_primask = priMask & 1U;
+}
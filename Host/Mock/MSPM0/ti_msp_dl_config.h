@@ -0,0 +1,80 @@
+/**
+******************************************************************************
+  * @file           : ti_msp_dl_config.h
+  * @brief          : 主机构建用的 SysConfig 头文件, 由记录型模拟层提供 DriverLib 接口
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 代替 SysConfig 生成的 ti_msp_dl_config.h 编译 AD9833_Soft_MSPM0，
+  * 只提供驱动用到的 DriverLib 接口。DL_GPIO_setPins()/DL_GPIO_clearPins()
+  * 经由 Mock_DL.c 记录到 Mock_HAL (GPIOA 为0号端口, GPIOB 为1号端口)。
+  *
+  ******************************************************************************
+  */
+
+#ifndef ti_msp_dl_config_h
+#define ti_msp_dl_config_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct
+{
+    volatile uint32_t DOUT31_0;
+    volatile uint32_t DOUTSET31_0;
+    volatile uint32_t DOUTCLR31_0;
+} GPIO_Regs;
+
+#define MOCK_DL_PORT_NUM            2U
+extern GPIO_Regs Mock_DL_GPIO[MOCK_DL_PORT_NUM];
+
+#define GPIOA                       (&Mock_DL_GPIO[0])
+#define GPIOB                       (&Mock_DL_GPIO[1])
+
+#define DL_GPIO_PIN_0               (0x00000001U)
+#define DL_GPIO_PIN_1               (0x00000002U)
+#define DL_GPIO_PIN_2               (0x00000004U)
+#define DL_GPIO_PIN_3               (0x00000008U)
+#define DL_GPIO_PIN_4               (0x00000010U)
+#define DL_GPIO_PIN_5               (0x00000020U)
+#define DL_GPIO_PIN_6               (0x00000040U)
+#define DL_GPIO_PIN_7               (0x00000080U)
+#define DL_GPIO_PIN_8               (0x00000100U)
+#define DL_GPIO_PIN_9               (0x00000200U)
+#define DL_GPIO_PIN_10              (0x00000400U)
+#define DL_GPIO_PIN_11              (0x00000800U)
+#define DL_GPIO_PIN_12              (0x00001000U)
+#define DL_GPIO_PIN_13              (0x00002000U)
+#define DL_GPIO_PIN_14              (0x00004000U)
+#define DL_GPIO_PIN_15              (0x00008000U)
+#define DL_GPIO_PIN_16              (0x00010000U)
+#define DL_GPIO_PIN_17              (0x00020000U)
+#define DL_GPIO_PIN_18              (0x00040000U)
+#define DL_GPIO_PIN_19              (0x00080000U)
+#define DL_GPIO_PIN_20              (0x00100000U)
+#define DL_GPIO_PIN_21              (0x00200000U)
+#define DL_GPIO_PIN_22              (0x00400000U)
+#define DL_GPIO_PIN_23              (0x00800000U)
+#define DL_GPIO_PIN_24              (0x01000000U)
+#define DL_GPIO_PIN_25              (0x02000000U)
+#define DL_GPIO_PIN_26              (0x04000000U)
+#define DL_GPIO_PIN_27              (0x08000000U)
+#define DL_GPIO_PIN_28              (0x10000000U)
+#define DL_GPIO_PIN_29              (0x20000000U)
+#define DL_GPIO_PIN_30              (0x40000000U)
+#define DL_GPIO_PIN_31              (0x80000000U)
+
+/* 模拟函数 (Mock_DL.c) */
+uint8_t Mock_DL_Port(const GPIO_Regs* gpio);
+void DL_GPIO_setPins(GPIO_Regs* gpio, uint32_t pins);
+void DL_GPIO_clearPins(GPIO_Regs* gpio, uint32_t pins);
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+
+#endif /* ti_msp_dl_config_h */
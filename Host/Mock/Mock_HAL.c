@@ -0,0 +1,419 @@
+/**
+******************************************************************************
+  * @file           : Mock_HAL.c
+  * @brief          : 主机构建用的记录型HAL模拟层 (公共部分)
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 引脚电平按端口保存为位图。每次写操作先推进虚拟时钟，再逐位比较新旧
+  * 电平，记录变化的引脚并交给组帧逻辑：
+  * - 片选拉高: 该片未满16位的数据作废 (AD9833 在 FSYNC 拉高时放弃写入)。
+  * - SCLK下降沿: 片选为低的各片移入 SDATA 的当前电平，满16位得到一个数据字。
+  * - 片选拉低: 该片从头开始计数。
+  * 同一个SCLK边沿上完成的相同数据字合并为一个帧事件 (广播写入)。
+  *
+  ******************************************************************************
+  */
+
+#include "Mock_HAL.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief   单片的组帧状态
+ */
+typedef struct
+{
+    uint16_t shift;
+    uint8_t bits;
+} Mock_ChipRx;
+
+static const Mock_Timing s_default_timing = {
+    .gpio_call_ns = MOCK_DEFAULT_GPIO_CALL_NS,
+    .reg_write_ns = MOCK_DEFAULT_REG_WRITE_NS,
+    .dl_write_ns = MOCK_DEFAULT_DL_WRITE_NS,
+    .spi_call_ns = MOCK_DEFAULT_SPI_CALL_NS,
+    .spi_bit_ns = MOCK_DEFAULT_SPI_BIT_NS,
+};
+
+static Mock_Timing s_timing = {0};
+static Mock_Bus s_bus = {0};
+static Mock_ChipRx s_rx[MOCK_CS_MAX] = {0};
+static Mock_Counters s_cnt = {0};
+static uint32_t s_level[MOCK_PORT_NUM] = {0};
+static uint64_t s_now = 0;
+static uint8_t s_timing_set = 0;
+
+static Mock_Event* s_trace = NULL;
+static uint32_t s_trace_num = 0;
+static uint32_t s_trace_cap = 0;
+static uint8_t s_trace_on = 1;
+
+static Mock_EdgeHook s_hook = NULL;
+static void* s_hook_ctx = NULL;
+
+/**
+ * @brief       追加一条事件
+ * @param       ev: 事件
+ * @retval      无
+ */
+static void Mock_Record(const Mock_Event* ev)
+{
+    if (!s_trace_on) return;
+
+    if (s_trace_num == s_trace_cap)
+    {
+        uint32_t cap = s_trace_cap ? s_trace_cap * 2U : 4096U;
+        Mock_Event* grown = realloc(s_trace, cap * sizeof(Mock_Event));
+        if (!grown) return;
+        s_trace = grown;
+        s_trace_cap = cap;
+    }
+    s_trace[s_trace_num++] = *ev;
+}
+
+/**
+ * @brief       记录一个帧事件或放弃事件, 与本次写入中已记录的相同事件合并
+ * @param       type: MOCK_EVENT_FRAME 或 MOCK_EVENT_ABORT
+ * @param       chip: 芯片编号
+ * @param       first: 本次写入中第一条帧事件的序号
+ * @retval      无
+ */
+static void Mock_RecordWord(uint8_t type, uint8_t chip, uint32_t first)
+{
+    const Mock_ChipRx* rx = &s_rx[chip];
+
+    if (type == MOCK_EVENT_FRAME) s_cnt.frames++;
+    else s_cnt.aborts++;
+
+    for (uint32_t i = first; s_trace_on && i < s_trace_num; i++)
+    {
+        Mock_Event* ev = &s_trace[i];
+        if (ev->type == type && ev->word == rx->shift && (type == MOCK_EVENT_FRAME || ev->level == rx->bits))
+        {
+            ev->pin |= 1UL << chip;
+            return;
+        }
+    }
+
+    Mock_Event ev = { s_now, type, 0, rx->bits, 1UL << chip, rx->shift };
+    Mock_Record(&ev);
+}
+
+/**
+ * @brief       读取登记引脚的电平
+ * @param       pin: 引脚
+ * @retval      0 或 1
+ */
+static uint8_t Mock_Get(const Mock_Pin* pin)
+{
+    return (s_level[pin->port] & pin->pin) ? 1U : 0U;
+}
+
+/**
+ * @brief       改变一个端口的引脚电平, 记录变化并组帧
+ * @param       port: 端口编号
+ * @param       set: 置高的引脚
+ * @param       clear: 置低的引脚
+ * @retval      无
+ */
+static void Mock_Apply(uint8_t port, uint32_t set, uint32_t clear)
+{
+    if (port >= MOCK_PORT_NUM) return;
+
+    uint32_t old = s_level[port];
+    uint32_t now = (old | set) & ~clear;
+    uint32_t changed = old ^ now;
+    if (!changed) return;
+
+    for (uint32_t m = changed; m; m &= m - 1U)
+    {
+        uint32_t bit = m & (~m + 1U);
+        Mock_Event ev = { s_now, MOCK_EVENT_PIN, port, (now & bit) ? 1U : 0U, bit, 0 };
+        s_cnt.pin_edges++;
+        Mock_Record(&ev);
+    }
+
+    uint8_t sclk_was = Mock_Get(&s_bus.sclk);
+    s_level[port] = now;
+
+    // 回调按引脚逐个给出, 同一次写入中的多个引脚时间相同
+    for (uint32_t m = changed; s_hook && m; m &= m - 1U)
+    {
+        uint32_t bit = m & (~m + 1U);
+        Mock_Event ev = { s_now, MOCK_EVENT_PIN, port, (now & bit) ? 1U : 0U, bit, 0 };
+        s_hook(&ev, s_hook_ctx);
+    }
+    uint32_t first = s_trace_num;
+
+    // 片选拉高: 未完成的数据作废
+    for (uint8_t i = 0; i < s_bus.cs_num; i++)
+    {
+        const Mock_Pin* cs = &s_bus.cs[i];
+        if (cs->port != port || !(changed & cs->pin) || !(now & cs->pin)) continue;
+        s_cnt.cs_rises++;
+        if (s_rx[i].bits) Mock_RecordWord(MOCK_EVENT_ABORT, i, first);
+        s_rx[i].bits = 0;
+        s_rx[i].shift = 0;
+    }
+
+    // SCLK下降沿: 片选为低的各片移入一位
+    if (s_bus.sclk.port == port && sclk_was && !Mock_Get(&s_bus.sclk))
+    {
+        uint8_t bit = Mock_Get(&s_bus.sdata);
+        uint8_t any = 0, done = 0;
+
+        for (uint8_t i = 0; i < s_bus.cs_num; i++)
+        {
+            if (Mock_Get(&s_bus.cs[i])) continue;
+            // 本次写入同时拉低的片选不接收这个边沿
+            if (s_bus.cs[i].port == port && (changed & s_bus.cs[i].pin)) continue;
+
+            any = 1;
+            s_rx[i].shift = (uint16_t)((s_rx[i].shift << 1) | bit);
+            if (++s_rx[i].bits == 16U)
+            {
+                Mock_RecordWord(MOCK_EVENT_FRAME, i, first);
+                done = 1;
+                s_rx[i].bits = 0;
+                s_rx[i].shift = 0;
+            }
+        }
+        if (any) s_cnt.sclk_falls++;
+        if (done) s_cnt.bus_words++;
+    }
+
+    // 片选拉低: 从头计数
+    for (uint8_t i = 0; i < s_bus.cs_num; i++)
+    {
+        const Mock_Pin* cs = &s_bus.cs[i];
+        if (cs->port != port || !(changed & cs->pin) || (now & cs->pin)) continue;
+        s_cnt.cs_falls++;
+        s_rx[i].bits = 0;
+        s_rx[i].shift = 0;
+    }
+}
+
+/**
+ * @brief       复位虚拟时钟、引脚电平、计数和记录, 时间模型恢复默认
+ * @note        总线登记保留, 登记的片选和SCLK恢复为高电平
+ * @retval      无
+ */
+void Mock_Reset(void)
+{
+    (void)Mock_GetTiming();
+
+    s_now = 0;
+    memset(s_level, 0, sizeof(s_level));
+    memset(s_rx, 0, sizeof(s_rx));
+    memset(&s_cnt, 0, sizeof(s_cnt));
+    s_trace_num = 0;
+
+    if (s_bus.cs_num)
+    {
+        s_level[s_bus.sclk.port] |= s_bus.sclk.pin;
+        for (uint8_t i = 0; i < s_bus.cs_num; i++) s_level[s_bus.cs[i].port] |= s_bus.cs[i].pin;
+    }
+}
+
+/**
+ * @brief       设置时间模型
+ * @param       timing: 时间模型, NULL 恢复默认
+ * @retval      无
+ */
+void Mock_SetTiming(const Mock_Timing* timing)
+{
+    s_timing = timing ? *timing : s_default_timing;
+    s_timing_set = 1;
+}
+
+/**
+ * @brief       获取当前时间模型
+ * @retval      时间模型
+ */
+const Mock_Timing* Mock_GetTiming(void)
+{
+    if (!s_timing_set)
+    {
+        s_timing = s_default_timing;
+        s_timing_set = 1;
+    }
+    return &s_timing;
+}
+
+/**
+ * @brief       登记总线引脚并复位
+ * @param       bus: 总线引脚
+ * @retval      无
+ */
+void Mock_SetBus(const Mock_Bus* bus)
+{
+    s_bus = *bus;
+    if (s_bus.cs_num > MOCK_CS_MAX) s_bus.cs_num = MOCK_CS_MAX;
+    Mock_Reset();
+}
+
+/**
+ * @brief       打开或关闭事件记录, 计数不受影响
+ * @param       enable: 1 记录; 0 不记录
+ * @retval      无
+ */
+void Mock_TraceEnable(uint8_t enable)
+{
+    s_trace_on = enable ? 1U : 0U;
+}
+
+/**
+ * @brief       设置引脚变化回调
+ * @note        回调在电平更新之后调用, 可用 Mock_PinLevel() 读取其他引脚的当前电平
+ * @param       hook: 回调, NULL 取消
+ * @param       ctx: 传给回调的参数
+ * @retval      无
+ */
+void Mock_SetEdgeHook(Mock_EdgeHook hook, void* ctx)
+{
+    s_hook = hook;
+    s_hook_ctx = ctx;
+}
+
+/**
+ * @brief       获取虚拟时间
+ * @retval      纳秒
+ */
+uint64_t Mock_Now(void)
+{
+    return s_now;
+}
+
+/**
+ * @brief       推进虚拟时间
+ * @param       ns: 纳秒
+ * @retval      无
+ */
+void Mock_Advance(uint64_t ns)
+{
+    s_now += ns;
+}
+
+/**
+ * @brief       读取引脚电平
+ * @param       port: 端口编号
+ * @param       pin: 引脚掩码
+ * @retval      各引脚的电平位图
+ */
+uint32_t Mock_PinLevel(uint8_t port, uint32_t pin)
+{
+    return (port < MOCK_PORT_NUM) ? (s_level[port] & pin) : 0U;
+}
+
+/**
+ * @brief       获取统计计数
+ * @param       counters: 输出
+ * @retval      无
+ */
+void Mock_GetCounters(Mock_Counters* counters)
+{
+    *counters = s_cnt;
+}
+
+/**
+ * @brief       获取事件记录
+ * @param       count: 输出事件数
+ * @retval      事件数组, 下次写操作后可能失效
+ */
+const Mock_Event* Mock_GetTrace(uint32_t* count)
+{
+    *count = s_trace_num;
+    return s_trace;
+}
+
+/**
+ * @brief       清空事件记录, 虚拟时钟和计数不变
+ * @retval      无
+ */
+void Mock_ClearTrace(void)
+{
+    s_trace_num = 0;
+}
+
+/**
+ * @brief       一次GPIO写操作
+ * @param       port: 端口编号
+ * @param       set: 置高的引脚
+ * @param       clear: 置低的引脚 (与 set 重叠时置高优先, 与 BSRR 相同)
+ * @param       cost_ns: 本次操作的耗时
+ * @retval      无
+ */
+void Mock_PortWrite(uint8_t port, uint32_t set, uint32_t clear, uint32_t cost_ns)
+{
+    s_now += cost_ns;
+    s_cnt.gpio_calls++;
+    Mock_Apply(port, set, clear & ~set);
+}
+
+/**
+ * @brief       设置引脚电平而不计入GPIO操作, 用于外设初始化时的空闲电平
+ * @param       port: 端口编号
+ * @param       pin: 引脚
+ * @param       level: 电平
+ * @retval      无
+ */
+void Mock_PortIdle(uint8_t port, uint32_t pin, uint8_t level)
+{
+    Mock_Apply(port, level ? pin : 0U, level ? 0U : pin);
+}
+
+/**
+ * @brief       一次硬件SPI发送调用的固定开销
+ * @param       cost_ns: 耗时
+ * @retval      无
+ */
+void Mock_SpiCall(uint32_t cost_ns)
+{
+    s_now += cost_ns;
+    s_cnt.spi_calls++;
+}
+
+/**
+ * @brief       硬件SPI发送一个数据单元, 在SCK/MOSI引脚上展开为边沿
+ * @note        高位在前; 每位占 spi_bit_ns, 两个边沿各在半位处。CPHA=0 时在第一个
+ *              边沿之前给出数据, CPHA=1 时在第一个边沿给出数据。SCK 须已处于
+ *              CPOL 对应的空闲电平 (由 Mock_PortIdle() 设置)
+ * @param       sck_port: SCK 端口编号
+ * @param       sck_pin: SCK 引脚
+ * @param       mosi_port: MOSI 端口编号
+ * @param       mosi_pin: MOSI 引脚
+ * @param       word: 数据
+ * @param       bits: 位数 (8 或 16)
+ * @param       cpol: 时钟空闲电平
+ * @param       cpha: 0: 第一个边沿采样; 1: 第二个边沿采样
+ * @retval      无
+ */
+void Mock_SpiWord(uint8_t sck_port, uint32_t sck_pin, uint8_t mosi_port, uint32_t mosi_pin,
+                  uint16_t word, uint8_t bits, uint8_t cpol, uint8_t cpha)
+{
+    uint32_t bit_ns = Mock_GetTiming()->spi_bit_ns;
+    uint32_t half = bit_ns / 2U;
+    Mock_Event ev = { s_now, MOCK_EVENT_SPI, 0, bits, 0, word };
+
+    s_cnt.spi_units++;
+    Mock_Record(&ev);
+
+    for (int8_t b = (int8_t)(bits - 1U); b >= 0; b--)
+    {
+        uint32_t data = (word >> b) & 1U;
+
+        if (!cpha) Mock_Apply(mosi_port, data ? mosi_pin : 0, data ? 0 : mosi_pin);
+        s_now += half;
+        if (cpol) Mock_Apply(sck_port, 0, sck_pin);
+        else Mock_Apply(sck_port, sck_pin, 0);
+        if (cpha) Mock_Apply(mosi_port, data ? mosi_pin : 0, data ? 0 : mosi_pin);
+        s_now += bit_ns - half;
+        if (cpol) Mock_Apply(sck_port, sck_pin, 0);
+        else Mock_Apply(sck_port, 0, sck_pin);
+    }
+}
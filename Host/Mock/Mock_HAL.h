@@ -0,0 +1,171 @@
+/**
+******************************************************************************
+  * @file           : Mock_HAL.h
+  * @brief          : 主机构建用的记录型HAL模拟层 (公共部分)
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 驱动源文件在主机上编译时，HAL_GPIO_WritePin / WRITE_REG /
+  * HAL_SPI_Transmit (STM32) 和 DL_GPIO_setPins / DL_GPIO_clearPins
+  * (MSPM0) 都落到本层：每次调用按时间模型推进虚拟时钟，记录引脚电平
+  * 变化和SPI数据字，并统计调用次数。硬件SPI发送的数据字同时展开为
+  * SCK/MOSI 引脚上的边沿，与软件SPI使用同一种轨迹格式。
+  *
+  * 登记总线引脚 (Mock_SetBus) 后，本层还按 AD9833 的规则 (片选为低时
+  * 在SCLK下降沿采样，第16个下降沿得到一个数据字) 组帧，记录每个数据字
+  * 及其片选掩码，用于统计和检查。
+  *
+  ******************************************************************************
+  */
+
+#ifndef _MOCK_HAL_H
+#define _MOCK_HAL_H
+
+#include <stdint.h>
+
+// 端口数上限 (STM32 GPIOA~GPIOE, MSPM0 GPIOA/GPIOB)
+#define MOCK_PORT_NUM               8U
+
+// 登记的片选引脚数上限
+#define MOCK_CS_MAX                 32U
+
+// 默认时间模型 (纳秒): STM32F407 168MHz, SPI2 21MHz; MSPM0G3507 32MHz
+#define MOCK_DEFAULT_GPIO_CALL_NS   60U     // HAL_GPIO_WritePin() 一次调用
+#define MOCK_DEFAULT_REG_WRITE_NS   12U     // WRITE_REG() 直接写 BSRR
+#define MOCK_DEFAULT_DL_WRITE_NS    62U     // DL_GPIO_setPins/clearPins
+#define MOCK_DEFAULT_SPI_CALL_NS    1200U   // HAL_SPI_Transmit() 轮询发送的固定开销
+#define MOCK_DEFAULT_SPI_BIT_NS     48U     // SPI 每位时间
+
+/**
+  * @brief 事件类型
+  *     @arg MOCK_EVENT_PIN: 引脚电平变化
+  *     @arg MOCK_EVENT_SPI: HAL_SPI_Transmit() 发送的数据单元
+  *     @arg MOCK_EVENT_FRAME: 在登记的总线上组帧得到的16位数据字
+  *     @arg MOCK_EVENT_ABORT: 片选在第16个下降沿之前拉高, 放弃的不完整帧
+  */
+typedef enum
+{
+    MOCK_EVENT_PIN = 0,
+    MOCK_EVENT_SPI,
+    MOCK_EVENT_FRAME,
+    MOCK_EVENT_ABORT
+} Mock_EventType;
+
+/**
+  * @brief 记录的事件
+  *     @arg time_ns: 发生时刻 (虚拟时间, 纳秒)
+  *     @arg type: 事件类型 (Mock_EventType)
+  *     @arg port: 端口编号 (PIN)
+  *     @arg level: 新电平 (PIN); 已收到的位数 (ABORT)
+  *     @arg pin: 引脚掩码 (PIN); 片选掩码, 按登记顺序 (FRAME/ABORT)
+  *     @arg word: 数据 (SPI/FRAME/ABORT)
+  */
+typedef struct
+{
+    uint64_t time_ns;
+    uint8_t type;
+    uint8_t port;
+    uint8_t level;
+    uint32_t pin;
+    uint16_t word;
+} Mock_Event;
+
+/**
+  * @brief 时间模型 (纳秒)
+  *     @arg gpio_call_ns: HAL_GPIO_WritePin() 一次调用
+  *     @arg reg_write_ns: WRITE_REG() 一次写入
+  *     @arg dl_write_ns: DL_GPIO_setPins/clearPins 一次调用
+  *     @arg spi_call_ns: HAL_SPI_Transmit() 一次调用的固定开销
+  *     @arg spi_bit_ns: SPI 每位时间
+  */
+typedef struct
+{
+    uint32_t gpio_call_ns;
+    uint32_t reg_write_ns;
+    uint32_t dl_write_ns;
+    uint32_t spi_call_ns;
+    uint32_t spi_bit_ns;
+} Mock_Timing;
+
+/**
+  * @brief 统计计数
+  *     @arg gpio_calls: GPIO写操作次数 (HAL_GPIO_WritePin/WRITE_REG/DL_GPIO_*)
+  *     @arg pin_edges: 引脚电平变化次数
+  *     @arg spi_calls: HAL_SPI_Transmit() 调用次数
+  *     @arg spi_units: HAL_SPI_Transmit() 发送的数据单元数
+  *     @arg frames: 组帧得到的数据字数 (按芯片计, 广播写入两片计2)
+  *     @arg aborts: 放弃的不完整帧数 (按芯片计)
+  *     @arg cs_falls: 登记的片选引脚的下降沿数
+  *     @arg cs_rises: 登记的片选引脚的上升沿数
+  *     @arg sclk_falls: 片选有效时的SCLK下降沿数
+  *     @arg bus_words: 总线上完成的数据字数 (广播写入计1)
+  */
+typedef struct
+{
+    uint32_t gpio_calls;
+    uint32_t pin_edges;
+    uint32_t spi_calls;
+    uint32_t spi_units;
+    uint32_t frames;
+    uint32_t aborts;
+    uint32_t cs_falls;
+    uint32_t cs_rises;
+    uint32_t sclk_falls;
+    uint32_t bus_words;
+} Mock_Counters;
+
+/**
+  * @brief 引脚编号 (端口编号 + 引脚掩码)
+  */
+typedef struct
+{
+    uint8_t port;
+    uint32_t pin;
+} Mock_Pin;
+
+/**
+  * @brief 总线引脚
+  *     @arg sclk: 时钟
+  *     @arg sdata: 数据
+  *     @arg cs: 各片的片选, 按芯片编号排列
+  *     @arg cs_num: 片选数
+  */
+typedef struct
+{
+    Mock_Pin sclk;
+    Mock_Pin sdata;
+    Mock_Pin cs[MOCK_CS_MAX];
+    uint8_t cs_num;
+} Mock_Bus;
+
+/**
+ * @brief   引脚变化回调, 每个引脚电平变化时调用一次 (与记录开关无关)
+ */
+typedef void (*Mock_EdgeHook)(const Mock_Event* ev, void* ctx);
+
+/* 公共接口 */
+void Mock_Reset(void);
+void Mock_SetTiming(const Mock_Timing* timing);
+const Mock_Timing* Mock_GetTiming(void);
+void Mock_SetBus(const Mock_Bus* bus);
+void Mock_TraceEnable(uint8_t enable);
+void Mock_SetEdgeHook(Mock_EdgeHook hook, void* ctx);
+uint64_t Mock_Now(void);
+void Mock_Advance(uint64_t ns);
+uint32_t Mock_PinLevel(uint8_t port, uint32_t pin);
+void Mock_GetCounters(Mock_Counters* counters);
+const Mock_Event* Mock_GetTrace(uint32_t* count);
+void Mock_ClearTrace(void);
+
+/* 供各平台的模拟函数调用 */
+void Mock_PortIdle(uint8_t port, uint32_t pin, uint8_t level);
+void Mock_PortWrite(uint8_t port, uint32_t set, uint32_t clear, uint32_t cost_ns);
+void Mock_SpiCall(uint32_t cost_ns);
+void Mock_SpiWord(uint8_t sck_port, uint32_t sck_pin, uint8_t mosi_port, uint32_t mosi_pin,
+                  uint16_t word, uint8_t bits, uint8_t cpol, uint8_t cpha);
+
+#endif /* _MOCK_HAL_H */
@@ -0,0 +1,227 @@
+/**
+******************************************************************************
+  * @file           : Mock_STM32.c
+  * @brief          : 主机构建用的 STM32 HAL 模拟函数
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * - HAL_GPIO_WritePin() 和 WRITE_REG() 写 BSRR 各计一次GPIO操作，耗时分别
+  *   取时间模型的 gpio_call_ns 和 reg_write_ns。
+  * - HAL_SPI_Transmit() 按句柄的 DataSize/CPOL/CPHA 把每个数据单元展开为
+  *   SCK/MOSI 上的边沿，固定开销取 spi_call_ns。
+  * - hspi2 的引脚与 Core/Src/spi.c 相同 (SCK PB10, MOSI PC3)，配置为
+  *   AD9833 要求的16位、CPOL=1、CPHA=0 (模式2)。
+  * - HAL_GetTick() 和 DWT->CYCCNT 由虚拟时间换算 (SystemCoreClock)。
+  * - HAL_UART_Transmit() 不占用虚拟时间，数据写入句柄的缓冲区或标准输出。
+  * - __STREXW() 默认总是成功，Mock_STM32_StrexFail() 可让接下来的几次失败，
+  *   用于检查 LDREX/STREX 重试。
+  * - Mock_STM32_SetPreemptHook() 登记的抢占回调在每次 GPIO 操作之后和
+  *   PRIMASK 清零时调用 (PRIMASK 置位期间不调用)，由中断调度层 (AD9833_Sim)
+  *   在这些点执行已挂起的中断，模拟中断在主循环任意两次 GPIO 操作之间抢占。
+  *
+  ******************************************************************************
+  */
+
+#include "main.h"
+#include "spi.h"
+#include "Mock_HAL.h"
+#include <stdio.h>
+#include <string.h>
+
+GPIO_TypeDef Mock_GPIO[MOCK_STM32_PORT_NUM] = {0};
+DWT_Type Mock_DWT = {0};
+CoreDebug_Type Mock_CoreDebug = {0};
+uint32_t SystemCoreClock = 168000000UL;
+
+SPI_HandleTypeDef hspi2 = {
+    .Init = {
+        .DataSize = SPI_DATASIZE_16BIT,
+        .CLKPolarity = SPI_POLARITY_HIGH,
+        .CLKPhase = SPI_PHASE_1EDGE,
+        .FirstBit = SPI_FIRSTBIT_MSB,
+    },
+    .sck_port = 1,              // PB10
+    .sck_pin = GPIO_PIN_10,
+    .mosi_port = 2,             // PC3
+    .mosi_pin = GPIO_PIN_3,
+};
+
+static uint32_t s_primask = 0;
+static uint32_t s_strex_fail = 0;
+static void (*s_preempt)(void) = NULL;
+
+/**
+ * @brief       由虚拟时间刷新 ODR 和 CYCCNT
+ * @retval      无
+ */
+static void Mock_STM32_Sync(void)
+{
+    for (uint8_t i = 0; i < MOCK_STM32_PORT_NUM; i++)
+    {
+        Mock_GPIO[i].ODR = Mock_PinLevel(i, 0xFFFFU);
+    }
+    Mock_DWT.CYCCNT = (uint32_t)(Mock_Now() * SystemCoreClock / 1000000000ULL);
+    if (s_preempt && !s_primask) s_preempt();
+}
+
+/**
+ * @brief       模拟端口在 Mock_HAL 中的编号
+ * @param       GPIOx: 端口
+ * @retval      编号
+ */
+uint8_t Mock_STM32_Port(const GPIO_TypeDef* GPIOx)
+{
+    return (uint8_t)(GPIOx - Mock_GPIO);
+}
+
+void Mock_STM32_WriteReg(volatile uint32_t* reg, uint32_t value)
+{
+    for (uint8_t i = 0; i < MOCK_STM32_PORT_NUM; i++)
+    {
+        if (reg == &Mock_GPIO[i].BSRR)
+        {
+            Mock_PortWrite(i, value & 0xFFFFU, value >> 16, Mock_GetTiming()->reg_write_ns);
+            Mock_STM32_Sync();
+            return;
+        }
+    }
+    *reg = value;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    uint8_t port = Mock_STM32_Port(GPIOx);
+
+    if (PinState != GPIO_PIN_RESET) Mock_PortWrite(port, GPIO_Pin, 0, Mock_GetTiming()->gpio_call_ns);
+    else Mock_PortWrite(port, 0, GPIO_Pin, Mock_GetTiming()->gpio_call_ns);
+    Mock_STM32_Sync();
+}
+
+/**
+ * @brief       使SCK处于CPOL对应的空闲电平, 不计入GPIO操作
+ * @param       hspi: 句柄
+ * @retval      HAL_OK
+ */
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi)
+{
+    Mock_PortIdle(hspi->sck_port, hspi->sck_pin, hspi->Init.CLKPolarity == SPI_POLARITY_HIGH);
+    Mock_STM32_Sync();
+    return HAL_OK;
+}
+
+void MX_SPI2_Init(void)
+{
+    HAL_SPI_Init(&hspi2);
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    if (!hspi || !pData || Size == 0U) return HAL_ERROR;
+
+    uint8_t wide = (hspi->Init.DataSize == SPI_DATASIZE_16BIT) ? 1U : 0U;
+    uint8_t cpol = (hspi->Init.CLKPolarity == SPI_POLARITY_HIGH) ? 1U : 0U;
+    uint8_t cpha = (hspi->Init.CLKPhase == SPI_PHASE_2EDGE) ? 1U : 0U;
+
+    Mock_SpiCall(Mock_GetTiming()->spi_call_ns);
+    for (uint16_t i = 0; i < Size; i++)
+    {
+        // 16位模式下 Size 为半字数, pData 按小端半字读取, 与 HAL 相同
+        uint16_t word = wide ? (uint16_t)(pData[2U * i] | (pData[2U * i + 1U] << 8)) : pData[i];
+        Mock_SpiWord(hspi->sck_port, hspi->sck_pin, hspi->mosi_port, hspi->mosi_pin,
+                     word, wide ? 16U : 8U, cpol, cpha);
+    }
+    Mock_STM32_Sync();
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+    (void)Timeout;
+    if (!huart || !pData) return HAL_ERROR;
+
+    if (!huart->buf)
+    {
+        fwrite(pData, 1, Size, stdout);
+        return HAL_OK;
+    }
+    if (huart->len + Size + 1U > huart->size) return HAL_ERROR;
+
+    memcpy(huart->buf + huart->len, pData, Size);
+    huart->len += Size;
+    huart->buf[huart->len] = '\0';
+    return HAL_OK;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return (uint32_t)(Mock_Now() / 1000000ULL);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    Mock_Advance((uint64_t)Delay * 1000000ULL);
+    Mock_STM32_Sync();
+}
+
+void __disable_irq(void)
+{
+    s_primask = 1;
+}
+
+void __enable_irq(void)
+{
+    s_primask = 0;
+    if (s_preempt) s_preempt();
+}
+
+uint32_t __get_PRIMASK(void)
+{
+    return s_primask;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    s_primask = priMask & 1U;
+    if (s_preempt && !s_primask) s_preempt();
+}
+
+uint32_t __LDREXW(volatile uint32_t* addr)
+{
+    return *addr;
+}
+
+uint32_t __STREXW(uint32_t value, volatile uint32_t* addr)
+{
+    if (s_strex_fail)
+    {
+        s_strex_fail--;
+        return 1U;
+    }
+    *addr = value;
+    return 0U;
+}
+
+/**
+ * @brief       让接下来的若干次 __STREXW() 失败 (模拟独占访问被中断打断)
+ * @param       count: 失败次数
+ * @retval      无
+ */
+void Mock_STM32_StrexFail(uint32_t count)
+{
+    s_strex_fail = count;
+}
+
+/**
+ * @brief       登记抢占回调: 每次 GPIO 操作之后和 PRIMASK 清零时调用
+ * @param       hook: 回调, NULL 为取消
+ * @retval      无
+ */
+void Mock_STM32_SetPreemptHook(void (*hook)(void))
+{
+    s_preempt = hook;
+}
@@ -0,0 +1,175 @@
+/**
+******************************************************************************
+  * @file           : main.h
+  * @brief          : 主机构建用的 main.h, 由记录型模拟层提供 STM32 HAL 接口
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 代替 Core/Inc/main.h 编译 AD9833_Soft 和 AD9833_HAL，只提供驱动用到的
+  * HAL 接口。GPIO 端口为模拟寄存器，WRITE_REG() 写 BSRR 和
+  * HAL_GPIO_WritePin() 都经由 Mock_STM32.c 记录到 Mock_HAL。引脚定义与
+  * Core/Inc/main.h 相同。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __MAIN_H
+#define __MAIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum
+{
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0U,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+// 模拟端口 GPIOA~GPIOE, 下标即 Mock_HAL 中的端口编号
+#define MOCK_STM32_PORT_NUM         5U
+extern GPIO_TypeDef Mock_GPIO[MOCK_STM32_PORT_NUM];
+extern DWT_Type Mock_DWT;
+extern CoreDebug_Type Mock_CoreDebug;
+extern uint32_t SystemCoreClock;
+
+#define GPIOA                       (&Mock_GPIO[0])
+#define GPIOB                       (&Mock_GPIO[1])
+#define GPIOC                       (&Mock_GPIO[2])
+#define GPIOD                       (&Mock_GPIO[3])
+#define GPIOE                       (&Mock_GPIO[4])
+#define DWT                         (&Mock_DWT)
+#define CoreDebug                   (&Mock_CoreDebug)
+
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+
+#define GPIO_PIN_0                  ((uint16_t)0x0001)
+#define GPIO_PIN_1                  ((uint16_t)0x0002)
+#define GPIO_PIN_2                  ((uint16_t)0x0004)
+#define GPIO_PIN_3                  ((uint16_t)0x0008)
+#define GPIO_PIN_4                  ((uint16_t)0x0010)
+#define GPIO_PIN_5                  ((uint16_t)0x0020)
+#define GPIO_PIN_6                  ((uint16_t)0x0040)
+#define GPIO_PIN_7                  ((uint16_t)0x0080)
+#define GPIO_PIN_8                  ((uint16_t)0x0100)
+#define GPIO_PIN_9                  ((uint16_t)0x0200)
+#define GPIO_PIN_10                 ((uint16_t)0x0400)
+#define GPIO_PIN_11                 ((uint16_t)0x0800)
+#define GPIO_PIN_12                 ((uint16_t)0x1000)
+#define GPIO_PIN_13                 ((uint16_t)0x2000)
+#define GPIO_PIN_14                 ((uint16_t)0x4000)
+#define GPIO_PIN_15                 ((uint16_t)0x8000)
+
+/* SPI (只保留模拟发送用到的配置项) */
+#define SPI_DATASIZE_8BIT           0x00000000U
+#define SPI_DATASIZE_16BIT          0x00000800U
+#define SPI_POLARITY_LOW            0x00000000U
+#define SPI_POLARITY_HIGH           0x00000002U
+#define SPI_PHASE_1EDGE             0x00000000U
+#define SPI_PHASE_2EDGE             0x00000001U
+#define SPI_FIRSTBIT_MSB            0x00000000U
+
+typedef struct
+{
+    uint32_t DataSize;
+    uint32_t CLKPolarity;
+    uint32_t CLKPhase;
+    uint32_t FirstBit;
+} SPI_InitTypeDef;
+
+/**
+ * @brief   模拟SPI句柄
+ *      @arg Init: 配置
+ *      @arg sck_port/sck_pin: SCK 引脚 (端口编号与引脚掩码)
+ *      @arg mosi_port/mosi_pin: MOSI 引脚
+ */
+typedef struct
+{
+    SPI_InitTypeDef Init;
+    uint8_t sck_port;
+    uint16_t sck_pin;
+    uint8_t mosi_port;
+    uint16_t mosi_pin;
+} SPI_HandleTypeDef;
+
+#define HAL_MAX_DELAY               0xFFFFFFFFU
+
+/**
+ * @brief   模拟串口句柄, 发送的数据追加到缓冲区, 缓冲区为NULL时写标准输出
+ *      @arg buf: 缓冲区
+ *      @arg size: 缓冲区容量 (保留1字节给结尾的 '\0')
+ *      @arg len: 已写入的字节数
+ */
+typedef struct
+{
+    char* buf;
+    uint32_t size;
+    uint32_t len;
+} UART_HandleTypeDef;
+
+/* 模拟函数 (Mock_STM32.c) */
+void Mock_STM32_WriteReg(volatile uint32_t* reg, uint32_t value);
+uint8_t Mock_STM32_Port(const GPIO_TypeDef* GPIOx);
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, const uint8_t* pData, uint16_t Size, uint32_t Timeout);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+uint32_t __LDREXW(volatile uint32_t* addr);
+uint32_t __STREXW(uint32_t value, volatile uint32_t* addr);
+void Mock_STM32_StrexFail(uint32_t count);
+void Mock_STM32_SetPreemptHook(void (*hook)(void));
+
+#define WRITE_REG(REG, VAL)         Mock_STM32_WriteReg(&(REG), (uint32_t)(VAL))
+#define __DMB()                     __sync_synchronize()
+#define __HAL_GPIO_EXTI_CLEAR_IT(__EXTI_LINE__)  ((void)(__EXTI_LINE__))
+
+/* Private defines -----------------------------------------------------------*/
+#define AD9833_SCLK_Pin GPIO_PIN_5
+#define AD9833_SCLK_GPIO_Port GPIOA
+#define AD9833_CS1_Pin GPIO_PIN_6
+#define AD9833_CS1_GPIO_Port GPIOA
+#define AD9833_MOSI_Pin GPIO_PIN_7
+#define AD9833_MOSI_GPIO_Port GPIOA
+#define AD9833_CS2_Pin GPIO_PIN_4
+#define AD9833_CS2_GPIO_Port GPIOC
+#define AD9833_TRIG_OUT_Pin GPIO_PIN_0
+#define AD9833_TRIG_OUT_GPIO_Port GPIOB
+#define AD9833_TRIG_Pin GPIO_PIN_1
+#define AD9833_TRIG_GPIO_Port GPIOB
+
+#endif /* __MAIN_H */
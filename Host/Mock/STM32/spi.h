@@ -0,0 +1,17 @@
+/**
+******************************************************************************
+  * @file           : spi.h
+  * @brief          : 主机构建用的 spi.h, 句柄由 Mock_STM32.c 提供
+  ******************************************************************************
+  */
+
+#ifndef __SPI_H__
+#define __SPI_H__
+
+#include "main.h"
+
+extern SPI_HandleTypeDef hspi2;
+
+void MX_SPI2_Init(void);
+
+#endif /* __SPI_H__ */
@@ -0,0 +1,369 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Model.c
+  * @brief          : AD9833 行为模型, 由 FSYNC/SCLK/SDATA 引脚边沿解码写入
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 时序检查只在 FSYNC 为低的写入期间进行，FSYNC 为高时 SCLK 和 SDATA 可以
+  * 任意变化。同一时刻的多个引脚变化按 FSYNC 上升、SDATA、SCLK、FSYNC 下降的
+  * 顺序处理。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Model.h"
+#include <string.h>
+
+static const AD9833_ModelTiming s_default_timing = AD9833_MODEL_TIMING_DEFAULT;
+
+static const char* const s_check_name[AD9833_MODEL_CHECK_NUM] = {
+    "t1 SCLK period",
+    "t2 SCLK high",
+    "t3 SCLK low",
+    "t4 FSYNC setup",
+    "t5 FSYNC hold",
+    "t6 data setup",
+    "t7 data hold",
+    "t8 SCLK high to FSYNC",
+    "B28 pair",
+    "reserved bit",
+};
+
+/**
+ * @brief       记录一次违反
+ * @param       model: 模型
+ * @param       check: 检查项
+ * @param       time_ns: 时刻
+ * @retval      无
+ */
+static void AD9833_Model_Violate(AD9833_Model* model, AD9833_ModelCheck check, uint64_t time_ns)
+{
+    model->violation[check]++;
+    if (model->first_time == UINT64_MAX)
+    {
+        model->first_time = time_ns;
+        model->first_check = (uint8_t)check;
+    }
+}
+
+/**
+ * @brief       初始化模型为上电状态
+ * @note        寄存器清零, 控制寄存器为 AD9833_MODEL_CTRL_POWERUP; 引脚假定为
+ *              FSYNC 高、SCLK 高、SDATA 低; 时序参数取默认值
+ * @param       model: 模型
+ * @retval      无
+ */
+void AD9833_Model_Init(AD9833_Model* model)
+{
+    memset(model, 0, sizeof(*model));
+    model->ctrl = AD9833_MODEL_CTRL_POWERUP;
+    model->timing = s_default_timing;
+    model->first_time = UINT64_MAX;
+    model->period_min = UINT32_MAX;
+    model->fsync = 1;
+    model->sclk = 1;
+}
+
+/**
+ * @brief       按数据字写入寄存器
+ * @note        违反 B28 写入顺序或保留位时以最后一个数据字的时刻记录
+ * @param       model: 模型
+ * @param       word: 16位数据字
+ * @retval      无
+ */
+void AD9833_Model_Word(AD9833_Model* model, uint16_t word)
+{
+    uint16_t data = word & 0x3FFFU;
+
+    model->words++;
+
+    switch (word >> 14)
+    {
+    case 0:     // 控制寄存器
+        if (word & AD9833_MODEL_RESERVED)
+        {
+            AD9833_Model_Violate(model, AD9833_MODEL_RESERVED_BIT, model->t_word_end);
+        }
+        if (model->pair_pending && !(word & AD9833_MODEL_B28))
+        {
+            AD9833_Model_Violate(model, AD9833_MODEL_B28_PAIR, model->t_word_end);
+            model->pair_pending = 0;
+        }
+        model->ctrl = word;
+        break;
+
+    case 1:     // FREQ0
+    case 2:     // FREQ1
+    {
+        uint8_t reg = (uint8_t)((word >> 14) - 1U);
+
+        if (model->ctrl & AD9833_MODEL_B28)
+        {
+            if (model->pair_pending && model->pair_reg == reg)
+            {
+                model->freq[reg] = ((uint32_t)data << 14) | model->pair_lsb;
+                model->pair_pending = 0;
+                break;
+            }
+            // 另一寄存器的写入打断了上一对, 本次作为新的一对的低14位
+            if (model->pair_pending)
+            {
+                AD9833_Model_Violate(model, AD9833_MODEL_B28_PAIR, model->t_word_end);
+            }
+            model->pair_pending = 1;
+            model->pair_reg = reg;
+            model->pair_lsb = data;
+        }
+        else if (model->ctrl & AD9833_MODEL_HLB)
+        {
+            model->freq[reg] = (model->freq[reg] & 0x3FFFU) | ((uint32_t)data << 14);
+        }
+        else
+        {
+            model->freq[reg] = (model->freq[reg] & ~0x3FFFUL) | data;
+        }
+        break;
+    }
+
+    default:    // PHASE0/PHASE1, D12 不关心
+        model->phase[(word >> 13) & 1U] = word & 0x0FFFU;
+        break;
+    }
+}
+
+/**
+ * @brief       给出三根线的当前电平, 模型按变化解码并检查时序
+ * @param       model: 模型
+ * @param       time_ns: 时刻 (不减)
+ * @param       fsync: FSYNC 电平
+ * @param       sclk: SCLK 电平
+ * @param       sdata: SDATA 电平
+ * @retval      无
+ */
+void AD9833_Model_Pins(AD9833_Model* model, uint64_t time_ns, uint8_t fsync, uint8_t sclk, uint8_t sdata)
+{
+    const AD9833_ModelTiming* t = &model->timing;
+
+    fsync = fsync ? 1U : 0U;
+    sclk = sclk ? 1U : 0U;
+    sdata = sdata ? 1U : 0U;
+
+    // FSYNC 上升: 未满16位的数据作废
+    if (fsync && !model->fsync)
+    {
+        if (model->bits)
+        {
+            model->aborts++;
+            model->bits = 0;
+            model->shift = 0;
+        }
+        else if (model->t_word_end > model->t_fsync_fall && time_ns - model->t_word_end < t->t5)
+        {
+            AD9833_Model_Violate(model, AD9833_MODEL_T5, time_ns);
+        }
+        model->fsync = 1;
+    }
+
+    uint8_t framing = (!model->fsync && model->t_sclk_fall > model->t_fsync_fall) ? 1U : 0U;
+
+    if (sdata != model->sdata)
+    {
+        if (framing && time_ns - model->t_sclk_fall < t->t7)
+        {
+            AD9833_Model_Violate(model, AD9833_MODEL_T7, time_ns);
+        }
+        model->sdata = sdata;
+        model->t_sdata = time_ns;
+    }
+
+    if (sclk != model->sclk)
+    {
+        if (!sclk)
+        {
+            if (!model->fsync)
+            {
+                if (framing)
+                {
+                    uint64_t period = time_ns - model->t_sclk_fall;
+                    if (period < model->period_min) model->period_min = (uint32_t)period;
+                    if (period < t->t1) AD9833_Model_Violate(model, AD9833_MODEL_T1, time_ns);
+                    if (time_ns - model->t_sclk_rise < t->t2) AD9833_Model_Violate(model, AD9833_MODEL_T2, time_ns);
+                }
+                else if (time_ns - model->t_fsync_fall < t->t4)
+                {
+                    AD9833_Model_Violate(model, AD9833_MODEL_T4, time_ns);
+                }
+                if (time_ns - model->t_sdata < t->t6) AD9833_Model_Violate(model, AD9833_MODEL_T6, time_ns);
+
+                model->shift = (uint16_t)((model->shift << 1) | model->sdata);
+                if (++model->bits == 16U)
+                {
+                    model->t_word_end = time_ns;
+                    if (model->word_hook) model->word_hook(model, time_ns, model->shift, model->word_ctx);
+                    AD9833_Model_Word(model, model->shift);
+                    model->bits = 0;
+                    model->shift = 0;
+                }
+            }
+            model->t_sclk_fall = time_ns;
+        }
+        else
+        {
+            if (framing && time_ns - model->t_sclk_fall < t->t3)
+            {
+                AD9833_Model_Violate(model, AD9833_MODEL_T3, time_ns);
+            }
+            model->t_sclk_rise = time_ns;
+        }
+        model->sclk = sclk;
+    }
+
+    // FSYNC 下降: SCLK 须已为高
+    if (!fsync && model->fsync)
+    {
+        if (!model->sclk || time_ns - model->t_sclk_rise < t->t8)
+        {
+            AD9833_Model_Violate(model, AD9833_MODEL_T8, time_ns);
+        }
+        model->fsync = 0;
+        model->t_fsync_fall = time_ns;
+        model->bits = 0;
+        model->shift = 0;
+    }
+}
+
+/**
+ * @brief       各检查项违反次数之和
+ * @param       model: 模型
+ * @retval      次数
+ */
+uint32_t AD9833_Model_Violations(const AD9833_Model* model)
+{
+    uint32_t sum = 0;
+
+    for (uint8_t i = 0; i < AD9833_MODEL_CHECK_NUM; i++) sum += model->violation[i];
+    return sum;
+}
+
+/**
+ * @brief       检查项名称
+ * @param       check: 检查项
+ * @retval      名称
+ */
+const char* AD9833_Model_CheckName(AD9833_ModelCheck check)
+{
+    return (check < AD9833_MODEL_CHECK_NUM) ? s_check_name[check] : "?";
+}
+
+/**
+ * @brief       初始化挂在模拟总线上的多片模型, 各片引脚电平取模拟层的当前电平
+ * @note        不初始化各片的寄存器, 需要时先调用 AD9833_Model_Init()
+ * @param       mb: 总线模型
+ * @param       chip: 各片模型, 按 bus 中片选的顺序
+ * @param       num: 片数 (不超过 bus->cs_num)
+ * @param       bus: 总线引脚
+ * @retval      无
+ */
+void AD9833_ModelBus_Init(AD9833_ModelBus* mb, AD9833_Model* chip, uint8_t num, const Mock_Bus* bus)
+{
+    mb->chip = chip;
+    mb->num = (num < bus->cs_num) ? num : bus->cs_num;
+    mb->bus = *bus;
+    mb->sclk = Mock_PinLevel(bus->sclk.port, bus->sclk.pin) ? 1U : 0U;
+    mb->sdata = Mock_PinLevel(bus->sdata.port, bus->sdata.pin) ? 1U : 0U;
+    mb->fsync = 0;
+
+    for (uint8_t i = 0; i < mb->num; i++)
+    {
+        uint8_t fsync = Mock_PinLevel(bus->cs[i].port, bus->cs[i].pin) ? 1U : 0U;
+        if (fsync) mb->fsync |= 1UL << i;
+        chip[i].fsync = fsync;
+        chip[i].sclk = mb->sclk;
+        chip[i].sdata = mb->sdata;
+    }
+}
+
+/**
+ * @brief       模拟层的引脚变化回调
+ */
+static void AD9833_ModelBus_Hook(const Mock_Event* ev, void* ctx)
+{
+    AD9833_ModelBus_Edge((AD9833_ModelBus*)ctx, ev);
+}
+
+/**
+ * @brief       挂到模拟层上实时解码, 同一时间只能挂一条总线
+ * @param       mb: 总线模型
+ * @retval      无
+ */
+void AD9833_ModelBus_Attach(AD9833_ModelBus* mb)
+{
+    Mock_SetEdgeHook(AD9833_ModelBus_Hook, mb);
+}
+
+/**
+ * @brief       取消实时解码
+ * @retval      无
+ */
+void AD9833_ModelBus_Detach(void)
+{
+    Mock_SetEdgeHook(NULL, NULL);
+}
+
+/**
+ * @brief       处理一个引脚事件
+ * @param       mb: 总线模型
+ * @param       ev: 事件, 非引脚事件和无关引脚忽略
+ * @retval      无
+ */
+void AD9833_ModelBus_Edge(AD9833_ModelBus* mb, const Mock_Event* ev)
+{
+    if (ev->type != MOCK_EVENT_PIN) return;
+
+    uint8_t level = ev->level ? 1U : 0U;
+    uint8_t shared = 0;
+
+    if (ev->port == mb->bus.sclk.port && (ev->pin & mb->bus.sclk.pin))
+    {
+        mb->sclk = level;
+        shared = 1;
+    }
+    if (ev->port == mb->bus.sdata.port && (ev->pin & mb->bus.sdata.pin))
+    {
+        mb->sdata = level;
+        shared = 1;
+    }
+
+    for (uint8_t i = 0; i < mb->num; i++)
+    {
+        const Mock_Pin* cs = &mb->bus.cs[i];
+        uint8_t mine = (ev->port == cs->port && (ev->pin & cs->pin)) ? 1U : 0U;
+
+        if (mine)
+        {
+            if (level) mb->fsync |= 1UL << i;
+            else mb->fsync &= ~(1UL << i);
+        }
+        if (mine || shared)
+        {
+            AD9833_Model_Pins(&mb->chip[i], ev->time_ns, (mb->fsync >> i) & 1U, mb->sclk, mb->sdata);
+        }
+    }
+}
+
+/**
+ * @brief       解码一段记录
+ * @param       mb: 总线模型, 引脚电平须为记录开始时的电平
+ * @param       ev: 事件数组
+ * @param       count: 事件数
+ * @retval      无
+ */
+void AD9833_ModelBus_Replay(AD9833_ModelBus* mb, const Mock_Event* ev, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++) AD9833_ModelBus_Edge(mb, &ev[i]);
+}
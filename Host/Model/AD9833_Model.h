@@ -0,0 +1,179 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Model.h
+  * @brief          : AD9833 行为模型, 由 FSYNC/SCLK/SDATA 引脚边沿解码写入
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 按数据手册的串口规则逐位解码，维护完整的寄存器组，并检查时序：
+  * - FSYNC 为低时在 SCLK 下降沿采样 SDATA，高位在前，满16位得到一个数据字；
+  *   FSYNC 保持低电平时可连续写入多个数据字。
+  * - FSYNC 在第16个下降沿之前拉高时，已收到的位作废 (计入 aborts)。
+  * - B28=1 时对同一频率寄存器连续两次写入，先低14位后高14位，第二次写入后
+  *   寄存器才更新；B28=0 时按 HLB 单独写入高14位或低14位。
+  * - PHASE 写入取低12位，D12 不关心。
+  * - 时序参数 t1~t8 取数据手册的最小值，可按需修改，违反时计数并记录第一次
+  *   违反的时刻。
+  *
+  * 使用方法：
+  * 1. 调用 `AD9833_Model_Init()` 初始化模型 (上电状态)。
+  * 2. 每次引脚电平变化后调用 `AD9833_Model_Pins()` 给出三根线的当前电平，
+  *    或直接调用 `AD9833_Model_Word()` 按数据字写入。
+  * 3. 与主机模拟层配合时，调用 `AD9833_ModelBus_Attach()` 把多片模型挂到
+  *    Mock_HAL 的总线上实时解码，或用 `AD9833_ModelBus_Replay()` 解码记录。
+  *
+  ******************************************************************************
+  */
+
+#ifndef _AD9833_MODEL_H
+#define _AD9833_MODEL_H
+
+#include <stdint.h>
+#include "Mock_HAL.h"
+
+// 控制寄存器位 (与驱动头文件相同)
+#define AD9833_MODEL_B28            (1U << 13)
+#define AD9833_MODEL_HLB            (1U << 12)
+#define AD9833_MODEL_FSELECT        (1U << 11)
+#define AD9833_MODEL_PSELECT        (1U << 10)
+#define AD9833_MODEL_RESET          (1U << 8)
+#define AD9833_MODEL_SLEEP1         (1U << 7)
+#define AD9833_MODEL_SLEEP12        (1U << 6)
+#define AD9833_MODEL_OPBITEN        (1U << 5)
+#define AD9833_MODEL_DIV2           (1U << 3)
+#define AD9833_MODEL_MODE           (1U << 1)
+#define AD9833_MODEL_RESERVED       ((1U << 9) | (1U << 4) | (1U << 2) | (1U << 0))
+
+// 上电时控制寄存器的状态 (数据手册建议上电后先置位RESET)
+#define AD9833_MODEL_CTRL_POWERUP   AD9833_MODEL_RESET
+
+/**
+ * @brief   时序参数 (纳秒, 数据手册最小值)
+ *      @arg t1: SCLK 周期 (下降沿到下降沿)
+ *      @arg t2: SCLK 高电平时间
+ *      @arg t3: SCLK 低电平时间
+ *      @arg t4: FSYNC 下降沿到第一个 SCLK 下降沿
+ *      @arg t5: 第16个 SCLK 下降沿到 FSYNC 上升沿
+ *      @arg t6: SDATA 建立时间
+ *      @arg t7: SDATA 保持时间
+ *      @arg t8: SCLK 上升沿到 FSYNC 下降沿 (FSYNC 下降时 SCLK 须为高)
+ */
+typedef struct
+{
+    uint32_t t1;
+    uint32_t t2;
+    uint32_t t3;
+    uint32_t t4;
+    uint32_t t5;
+    uint32_t t6;
+    uint32_t t7;
+    uint32_t t8;
+} AD9833_ModelTiming;
+
+#define AD9833_MODEL_TIMING_DEFAULT { 25U, 10U, 10U, 5U, 10U, 5U, 3U, 5U }
+
+/**
+ * @brief   检查项
+ *      @arg AD9833_MODEL_T1 ~ AD9833_MODEL_T8: 违反对应的时序参数
+ *      @arg AD9833_MODEL_B28_PAIR: B28=1 时两次写入不是同一频率寄存器, 或 B28 在两次写入之间被清零
+ *      @arg AD9833_MODEL_RESERVED_BIT: 控制字的保留位不为0
+ */
+typedef enum
+{
+    AD9833_MODEL_T1 = 0,
+    AD9833_MODEL_T2,
+    AD9833_MODEL_T3,
+    AD9833_MODEL_T4,
+    AD9833_MODEL_T5,
+    AD9833_MODEL_T6,
+    AD9833_MODEL_T7,
+    AD9833_MODEL_T8,
+    AD9833_MODEL_B28_PAIR,
+    AD9833_MODEL_RESERVED_BIT,
+    AD9833_MODEL_CHECK_NUM
+} AD9833_ModelCheck;
+
+struct AD9833_Model;
+
+/**
+ * @brief   数据字回调, 模型在每个数据字写入寄存器之前调用
+ */
+typedef void (*AD9833_ModelWordHook)(struct AD9833_Model* model, uint64_t time_ns, uint16_t word, void* ctx);
+
+/**
+ * @brief   单片模型
+ *      @arg ctrl/freq/phase: 寄存器组 (频率28位, 相位12位)
+ *      @arg words: 收到的数据字数
+ *      @arg aborts: 作废的不完整数据字数
+ *      @arg violation: 各检查项的违反次数
+ *      @arg first_time/first_check: 第一次违反的时刻和检查项 (first_time 为 UINT64_MAX 时无违反)
+ *      @arg period_min: 写入期间最短的 SCLK 周期 (纳秒, UINT32_MAX 表示尚无)
+ *      @arg word_hook/word_ctx: 数据字回调及其参数, 可为 NULL
+ *      其余为解码状态
+ */
+typedef struct AD9833_Model
+{
+    uint16_t ctrl;
+    uint32_t freq[2];
+    uint16_t phase[2];
+
+    uint32_t words;
+    uint32_t aborts;
+    uint32_t violation[AD9833_MODEL_CHECK_NUM];
+    uint64_t first_time;
+    uint8_t first_check;
+    uint32_t period_min;
+    AD9833_ModelWordHook word_hook;
+    void* word_ctx;
+
+    AD9833_ModelTiming timing;
+    uint16_t shift;
+    uint8_t bits;
+    uint8_t fsync;
+    uint8_t sclk;
+    uint8_t sdata;
+    uint8_t pair_pending;
+    uint8_t pair_reg;
+    uint16_t pair_lsb;
+    uint64_t t_fsync_fall;
+    uint64_t t_sclk_rise;
+    uint64_t t_sclk_fall;
+    uint64_t t_sdata;
+    uint64_t t_word_end;
+} AD9833_Model;
+
+/**
+ * @brief   挂在模拟总线上的多片模型
+ *      @arg chip: 各片模型, 按 Mock_Bus 中片选的顺序
+ *      @arg num: 片数
+ *      @arg bus: 总线引脚
+ *      其余为三根线的当前电平
+ */
+typedef struct
+{
+    AD9833_Model* chip;
+    uint8_t num;
+    Mock_Bus bus;
+    uint8_t sclk;
+    uint8_t sdata;
+    uint32_t fsync;
+} AD9833_ModelBus;
+
+/* 函数声明 */
+void AD9833_Model_Init(AD9833_Model* model);
+void AD9833_Model_Pins(AD9833_Model* model, uint64_t time_ns, uint8_t fsync, uint8_t sclk, uint8_t sdata);
+void AD9833_Model_Word(AD9833_Model* model, uint16_t word);
+uint32_t AD9833_Model_Violations(const AD9833_Model* model);
+const char* AD9833_Model_CheckName(AD9833_ModelCheck check);
+
+void AD9833_ModelBus_Init(AD9833_ModelBus* mb, AD9833_Model* chip, uint8_t num, const Mock_Bus* bus);
+void AD9833_ModelBus_Attach(AD9833_ModelBus* mb);
+void AD9833_ModelBus_Detach(void);
+void AD9833_ModelBus_Edge(AD9833_ModelBus* mb, const Mock_Event* ev);
+void AD9833_ModelBus_Replay(AD9833_ModelBus* mb, const Mock_Event* ev, uint32_t count);
+
+#endif /* _AD9833_MODEL_H */
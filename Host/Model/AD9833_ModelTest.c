@@ -0,0 +1,221 @@
+/**
+******************************************************************************
+  * @file           : AD9833_ModelTest.c
+  * @brief          : AD9833 行为模型的解码与时序检查测试
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-12
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 直接按引脚电平驱动模型，覆盖控制字、B28 两次写入、HLB 单独写入、
+  * 相位写入、FSYNC 中止、同一 FSYNC 下连续写入以及时序违反。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Model.h"
+#include <stdio.h>
+#include "Host_Check.h"
+
+/**
+ * @brief   测试用的引脚驱动: 当前时间和三根线的电平
+ */
+typedef struct
+{
+    AD9833_Model* m;
+    uint64_t t;
+    uint8_t fsync;
+    uint8_t sclk;
+    uint8_t sdata;
+} Drive;
+
+static void Drive_Set(Drive* d, uint32_t delay, int fsync, int sclk, int sdata)
+{
+    d->t += delay;
+    if (fsync >= 0) d->fsync = (uint8_t)fsync;
+    if (sclk >= 0) d->sclk = (uint8_t)sclk;
+    if (sdata >= 0) d->sdata = (uint8_t)sdata;
+    AD9833_Model_Pins(d->m, d->t, d->fsync, d->sclk, d->sdata);
+}
+
+/**
+ * @brief       移出若干位, 每位: 给数据, 半周期后下降沿, 再半周期后上升沿
+ * @param       d: 引脚驱动
+ * @param       word: 数据 (高位在前)
+ * @param       bits: 位数
+ * @param       half: 半周期 (纳秒)
+ * @retval      无
+ */
+static void Drive_Bits(Drive* d, uint16_t word, uint8_t bits, uint32_t half)
+{
+    for (int8_t b = 15; b > 15 - (int8_t)bits; b--)
+    {
+        Drive_Set(d, 0, -1, -1, (word >> b) & 1U);
+        Drive_Set(d, half, -1, 0, -1);
+        Drive_Set(d, half, -1, 1, -1);
+    }
+}
+
+static void Drive_Word(Drive* d, uint16_t word)
+{
+    Drive_Set(d, 100, 0, -1, -1);
+    Drive_Bits(d, word, 16, 50);
+    Drive_Set(d, 50, 1, -1, -1);
+}
+
+static void Test_Ctrl(void)
+{
+    AD9833_Model m;
+    AD9833_Model_Init(&m);
+    Drive d = { &m, 0, 1, 1, 0 };
+
+    CHECK(m.ctrl == AD9833_MODEL_RESET, "power-up ctrl 0x%04X", m.ctrl);
+    Drive_Word(&d, 0x2028);
+    CHECK(m.ctrl == 0x2028 && m.words == 1, "ctrl 0x%04X words %u", m.ctrl, (unsigned)m.words);
+    CHECK(AD9833_Model_Violations(&m) == 0, "unexpected violation");
+}
+
+static void Test_B28(void)
+{
+    AD9833_Model m;
+    AD9833_Model_Init(&m);
+    Drive d = { &m, 0, 1, 1, 0 };
+
+    Drive_Word(&d, 0x2100);                 // B28 | RESET
+    Drive_Word(&d, 0x8000 | 0x1234);        // FREQ1 低14位
+    CHECK(m.freq[1] == 0 && m.pair_pending, "FREQ1 updated before the second word");
+    Drive_Word(&d, 0xC000 | 0x0AB);         // 两次写入之间的相位写入不影响
+    Drive_Word(&d, 0x8000 | 0x0567);        // FREQ1 高14位
+    CHECK(m.freq[1] == ((0x0567UL << 14) | 0x1234), "FREQ1 0x%07X", (unsigned)m.freq[1]);
+    CHECK(m.phase[0] == 0x0AB, "PHASE0 0x%03X", m.phase[0]);
+
+    // 对另一寄存器的写入打断上一对
+    Drive_Word(&d, 0x4000 | 0x0001);
+    Drive_Word(&d, 0x8000 | 0x0002);
+    CHECK(m.violation[AD9833_MODEL_B28_PAIR] == 1, "broken pair not flagged");
+    CHECK(m.freq[0] == 0, "FREQ0 written by a broken pair");
+}
+
+static void Test_HLB(void)
+{
+    AD9833_Model m;
+    AD9833_Model_Init(&m);
+    Drive d = { &m, 0, 1, 1, 0 };
+
+    Drive_Word(&d, 0x2000);
+    Drive_Word(&d, 0x4000 | 0x3FFF);
+    Drive_Word(&d, 0x4000 | 0x3FFF);
+    Drive_Word(&d, 0x1000);                 // B28=0, HLB=1: 只写高14位
+    Drive_Word(&d, 0x4000 | 0x0001);
+    CHECK(m.freq[0] == ((1UL << 14) | 0x3FFF), "HLB=1: FREQ0 0x%07X", (unsigned)m.freq[0]);
+    Drive_Word(&d, 0x0000);                 // B28=0, HLB=0: 只写低14位
+    Drive_Word(&d, 0x4000 | 0x0002);
+    CHECK(m.freq[0] == ((1UL << 14) | 0x0002), "HLB=0: FREQ0 0x%07X", (unsigned)m.freq[0]);
+}
+
+static void Test_Phase(void)
+{
+    AD9833_Model m;
+    AD9833_Model_Init(&m);
+    Drive d = { &m, 0, 1, 1, 0 };
+
+    Drive_Word(&d, 0xC000 | 0x1123);        // D12 不关心
+    Drive_Word(&d, 0xE000 | 0x0FFF);
+    CHECK(m.phase[0] == 0x123 && m.phase[1] == 0xFFF, "PHASE 0x%03X 0x%03X", m.phase[0], m.phase[1]);
+}
+
+static void Test_Abort(void)
+{
+    AD9833_Model m;
+    AD9833_Model_Init(&m);
+    Drive d = { &m, 0, 1, 1, 0 };
+
+    Drive_Set(&d, 100, 0, -1, -1);
+    Drive_Bits(&d, 0x2000, 15, 50);
+    Drive_Set(&d, 50, 1, -1, -1);
+    CHECK(m.aborts == 1 && m.words == 0 && m.ctrl == AD9833_MODEL_RESET, "15-bit write not aborted");
+
+    // 中止后的下一次写入从头开始
+    Drive_Word(&d, 0x2000);
+    CHECK(m.words == 1 && m.ctrl == 0x2000, "write after abort: ctrl 0x%04X", m.ctrl);
+
+    // FSYNC 保持低电平连续写入两个数据字
+    Drive_Set(&d, 100, 0, -1, -1);
+    Drive_Bits(&d, 0xC000 | 0x011, 16, 50);
+    Drive_Bits(&d, 0xE000 | 0x022, 16, 50);
+    Drive_Set(&d, 50, 1, -1, -1);
+    CHECK(m.phase[0] == 0x011 && m.phase[1] == 0x022 && m.aborts == 1, "back-to-back words");
+}
+
+static void Test_Timing(void)
+{
+    AD9833_Model m;
+    Drive d;
+
+    // 20ns 周期: t1 违反, 半周期 10ns 不违反 t2/t3
+    AD9833_Model_Init(&m);
+    d = (Drive){ &m, 0, 1, 1, 0 };
+    Drive_Set(&d, 100, 0, -1, -1);
+    Drive_Bits(&d, 0x2000, 16, 10);
+    Drive_Set(&d, 50, 1, -1, -1);
+    CHECK(m.violation[AD9833_MODEL_T1] == 15 && m.violation[AD9833_MODEL_T2] == 0 &&
+          m.violation[AD9833_MODEL_T3] == 0, "t1: %u", (unsigned)m.violation[AD9833_MODEL_T1]);
+    CHECK(m.period_min == 20, "period_min %u", (unsigned)m.period_min);
+    CHECK(m.words == 1, "word lost on timing violation");
+
+    // SCLK 空闲为低 (CPOL=0) 时拉低 FSYNC: t8
+    AD9833_Model_Init(&m);
+    d = (Drive){ &m, 0, 1, 0, 0 };
+    m.sclk = 0;
+    Drive_Set(&d, 100, 0, -1, -1);
+    CHECK(m.violation[AD9833_MODEL_T8] == 1, "FSYNC fall with SCLK low not flagged");
+
+    // FSYNC 下降后立即给出下降沿: t4; 最后一个下降沿后立即拉高 FSYNC: t5
+    AD9833_Model_Init(&m);
+    d = (Drive){ &m, 0, 1, 1, 0 };
+    Drive_Set(&d, 100, 0, -1, -1);
+    Drive_Set(&d, 0, -1, -1, 1);
+    Drive_Set(&d, 2, -1, 0, -1);
+    CHECK(m.violation[AD9833_MODEL_T4] == 1, "t4 not flagged");
+    Drive_Set(&d, 50, -1, 1, -1);
+    Drive_Bits(&d, 0xFFFF, 14, 50);
+    Drive_Set(&d, 50, -1, 0, -1);
+    Drive_Set(&d, 2, 1, -1, -1);
+    CHECK(m.violation[AD9833_MODEL_T5] == 1, "t5 not flagged");
+
+    // 数据在下降沿前 2ns 才变化: t6; 下降沿后 1ns 就变化: t7
+    AD9833_Model_Init(&m);
+    d = (Drive){ &m, 0, 1, 1, 0 };
+    Drive_Set(&d, 100, 0, -1, -1);
+    Drive_Set(&d, 48, -1, -1, 1);
+    Drive_Set(&d, 2, -1, 0, -1);
+    Drive_Set(&d, 1, -1, -1, 0);
+    CHECK(m.violation[AD9833_MODEL_T6] == 1 && m.violation[AD9833_MODEL_T7] == 1, "t6/t7 not flagged");
+    CHECK(m.first_check == AD9833_MODEL_T6, "first violation %s", AD9833_Model_CheckName(m.first_check));
+}
+
+static void Test_Reserved(void)
+{
+    AD9833_Model m;
+    AD9833_Model_Init(&m);
+    Drive d = { &m, 0, 1, 1, 0 };
+
+    Drive_Word(&d, 0x2001);
+    CHECK(m.violation[AD9833_MODEL_RESERVED_BIT] == 1, "reserved D0 not flagged");
+}
+
+int main(void)
+{
+    Test_Ctrl();
+    Test_B28();
+    Test_HLB();
+    Test_Phase();
+    Test_Abort();
+    Test_Timing();
+    Test_Reserved();
+
+    printf("[model] %s (%u failures)\n", s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
@@ -0,0 +1,621 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Plan.c
+  * @brief          : 把扫频/跳频计划编译成固件可直接播放的数据字表
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 编译按芯片寄存器的影子状态逐步生成数据字。第0步的目标状态由反复编译
+  * 一遍求得：从任意初始状态编译一遍得到结束状态，以它为起点再编译，直到
+  * 结束状态与起点相同 (或隔一遍相同，此时展开为两遍)。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Plan.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 控制字和寄存器地址, 与 AD9833_Soft.h 相同
+#define PLAN_CTRL_B28               (1U << 13)
+#define PLAN_CTRL_HLB               (1U << 12)
+#define PLAN_CTRL_FSELECT           (1U << 11)
+#define PLAN_CTRL_RESET             (1U << 8)
+#define PLAN_CTRL_OPBITEN           (1U << 5)
+#define PLAN_CTRL_DIV2              (1U << 3)
+#define PLAN_CTRL_MODE              (1U << 1)
+#define PLAN_CTRL_WAVE              (PLAN_CTRL_OPBITEN | PLAN_CTRL_DIV2 | PLAN_CTRL_MODE)
+#define PLAN_CMD_FREQ0              0x4000U
+#define PLAN_CMD_FREQ1              0x8000U
+#define PLAN_CMD_PHASE0             0xC000U
+#define PLAN_CMD_PHASE1             0xE000U
+
+#define PLAN_TABLE_MAGIC            0x54394441U     // "AD9T", 与 AD9833_Table.h 相同
+#define PLAN_TABLE_VERSION          1U
+#define PLAN_TABLE_HEADER_SIZE      16U
+#define PLAN_TABLE_STEP_SIZE        4U
+#define PLAN_STEP_WORDS_MAX         8U              // 一步最多的数据字数
+#define PLAN_LINE_MAX               1024U
+#define PLAN_TOKEN_MAX              64U
+#define PLAN_FIXPOINT_PASSES        8U
+
+/**
+ * @brief   芯片寄存器的影子状态
+ */
+typedef struct
+{
+    uint16_t ctrl;
+    uint32_t freq[2];
+    uint16_t phase[2];
+} AD9833_PlanChip;
+
+/**
+ * @brief   表的输出
+ */
+typedef struct
+{
+    uint8_t* out;
+    uint32_t cap;
+    uint32_t pos;
+} AD9833_PlanWriter;
+
+/**
+ * @brief       初始化空计划 (默认设置)
+ * @param       plan: 计划
+ * @retval      无
+ */
+void AD9833_Plan_Init(AD9833_Plan* plan)
+{
+    memset(plan, 0, sizeof(*plan));
+    plan->mclk = AD9833_PLAN_MCLK;
+    plan->tick_hz = AD9833_PLAN_TICK_HZ;
+    plan->chips = 3;
+    plan->hop = AD9833_PLAN_ACTIVE;
+    plan->wave = AD9833_PLAN_SINE;
+}
+
+/**
+ * @brief       释放计划的步
+ * @param       plan: 计划
+ * @retval      无
+ */
+void AD9833_Plan_Free(AD9833_Plan* plan)
+{
+    free(plan->step);
+    plan->step = NULL;
+    plan->num = plan->cap = 0;
+}
+
+/**
+ * @brief       频率换算为28位频率字
+ * @param       plan: 计划 (主时钟)
+ * @param       freq: 频率 (Hz)
+ * @retval      频率字
+ */
+uint32_t AD9833_Plan_FreqWord(const AD9833_Plan* plan, double freq)
+{
+    long long word = llround(freq * (double)(1UL << 28) / plan->mclk);
+    return (uint32_t)(word < 0 ? 0 : (word > 0x0FFFFFFFLL ? 0x0FFFFFFFLL : word));
+}
+
+/**
+ * @brief       相位换算为12位相位字
+ * @param       phase: 相位 (度)
+ * @retval      相位字
+ */
+uint16_t AD9833_Plan_PhaseWord(double phase)
+{
+    long long word = llround(phase / 360.0 * 4096.0) % 4096;
+    return (uint16_t)(word < 0 ? word + 4096 : word);
+}
+
+/* 解析 ---------------------------------------------------------------------*/
+
+/**
+ * @brief       记录错误信息
+ */
+static int AD9833_Plan_Error(char* err, size_t err_len, uint32_t line, const char* fmt, ...)
+{
+    if (err && err_len)
+    {
+        va_list ap;
+        int n = snprintf(err, err_len, "line %u: ", (unsigned)line);
+        va_start(ap, fmt);
+        if (n >= 0 && (size_t)n < err_len) vsnprintf(err + n, err_len - (size_t)n, fmt, ap);
+        va_end(ap);
+    }
+    return (int)line;
+}
+
+/**
+ * @brief       解析频率 (可带 k/M 后缀和 Hz)
+ * @retval      1: 成功
+ */
+static uint8_t AD9833_Plan_ParseFreq(const char* tok, double* freq)
+{
+    char* end;
+    double v = strtod(tok, &end);
+
+    if (end == tok) return 0;
+    if (*end == 'k' || *end == 'K') { v *= 1e3; end++; }
+    else if (*end == 'M') { v *= 1e6; end++; }
+    if (strcmp(end, "Hz") == 0 || strcmp(end, "hz") == 0) end += 2;
+    if (*end) return 0;
+
+    *freq = v;
+    return 1;
+}
+
+/**
+ * @brief       解析时间为节拍数 (s/ms/us 或以 t 结尾的节拍数)
+ * @retval      1: 成功
+ */
+static uint8_t AD9833_Plan_ParseTicks(const char* tok, uint16_t tick_hz, uint32_t* ticks)
+{
+    char* end;
+    double v = strtod(tok, &end);
+
+    if (end == tok || v <= 0.0) return 0;
+    if (strcmp(end, "t") == 0) ;
+    else if (strcmp(end, "s") == 0) v *= tick_hz;
+    else if (strcmp(end, "ms") == 0) v *= tick_hz / 1e3;
+    else if (strcmp(end, "us") == 0) v *= tick_hz / 1e6;
+    else return 0;
+
+    long long n = llround(v);
+    if (n < 1 || n > 0xFFFF || fabs(v - (double)n) > 1e-6 * v) return 0;
+    *ticks = (uint32_t)n;
+    return 1;
+}
+
+/**
+ * @brief       解析波形名
+ * @retval      波形, 0 为无效
+ */
+static uint8_t AD9833_Plan_ParseWave(const char* tok)
+{
+    if (strcmp(tok, "sine") == 0) return AD9833_PLAN_SINE;
+    if (strcmp(tok, "triangle") == 0) return AD9833_PLAN_TRIANGLE;
+    if (strcmp(tok, "square") == 0) return AD9833_PLAN_SQUARE;
+    return 0;
+}
+
+/**
+ * @brief       段的选项
+ */
+typedef struct
+{
+    uint8_t wave;
+    double phase;
+    double phase_step;
+} AD9833_PlanOpts;
+
+/**
+ * @brief       追加一步
+ * @retval      1: 成功; 0: 超过步数上限或内存不足
+ */
+static uint8_t AD9833_Plan_Add(AD9833_Plan* plan, double freq, uint32_t dwell, const AD9833_PlanOpts* opts,
+                               uint32_t index)
+{
+    if (plan->num >= AD9833_PLAN_STEPS_MAX) return 0;
+    if (plan->num == plan->cap)
+    {
+        uint32_t cap = plan->cap ? plan->cap * 2U : 64U;
+        AD9833_PlanStep* grown = realloc(plan->step, cap * sizeof(AD9833_PlanStep));
+        if (!grown) return 0;
+        plan->step = grown;
+        plan->cap = cap;
+    }
+
+    AD9833_PlanStep* s = &plan->step[plan->num++];
+    s->freq = freq;
+    s->phase = opts->phase + opts->phase_step * index;
+    s->wave = opts->wave;
+    s->dwell = (uint16_t)dwell;
+    return 1;
+}
+
+/**
+ * @brief       解析一段计划文本并追加到计划中
+ * @param       plan: 计划 (先调用 AD9833_Plan_Init())
+ * @param       text: 文本
+ * @param       err: 错误信息的输出, 可为 NULL
+ * @param       err_len: err 的容量
+ * @retval      0: 成功; 否则为出错的行号
+ */
+int AD9833_Plan_Parse(AD9833_Plan* plan, const char* text, char* err, size_t err_len)
+{
+    char line[PLAN_LINE_MAX];
+    char* tok[PLAN_TOKEN_MAX];
+    uint32_t line_no = 0;
+
+    while (*text)
+    {
+        size_t len = strcspn(text, "\n");
+        line_no++;
+        if (len >= sizeof(line)) return AD9833_Plan_Error(err, err_len, line_no, "line too long");
+        memcpy(line, text, len);
+        line[len] = '\0';
+        text += len + (text[len] == '\n' ? 1U : 0U);
+
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        uint32_t n = 0, args = 0;
+        char* save = NULL;
+        for (char* t = strtok_r(line, " \t\r", &save); t; t = strtok_r(NULL, " \t\r", &save))
+        {
+            if (n == PLAN_TOKEN_MAX) return AD9833_Plan_Error(err, err_len, line_no, "too many fields");
+            tok[n++] = t;
+        }
+        if (!n) continue;
+
+        // 段的选项在行尾, 其余为参数
+        AD9833_PlanOpts opts = { plan->wave, plan->phase, 0.0 };
+        for (args = n; args > 1U && strchr(tok[args - 1U], '='); args--)
+        {
+            char* key = tok[args - 1U];
+            char* val = strchr(key, '=') + 1;
+            char* end;
+            if (strncmp(key, "wave=", 5) == 0)
+            {
+                if (!(opts.wave = AD9833_Plan_ParseWave(val)))
+                {
+                    return AD9833_Plan_Error(err, err_len, line_no, "unknown wave '%s'", val);
+                }
+            }
+            else if (strncmp(key, "phase=", 6) == 0)
+            {
+                opts.phase = strtod(val, &end);
+                if (end == val) return AD9833_Plan_Error(err, err_len, line_no, "bad phase '%s'", val);
+                if (*end)
+                {
+                    char* inc = end;
+                    opts.phase_step = strtod(inc, &end);
+                    if (end == inc || *end || (*inc != '+' && *inc != '-'))
+                    {
+                        return AD9833_Plan_Error(err, err_len, line_no, "bad phase '%s'", val);
+                    }
+                }
+            }
+            else
+            {
+                return AD9833_Plan_Error(err, err_len, line_no, "unknown option '%s'", key);
+            }
+        }
+
+        const char* cmd = tok[0];
+        double f1, f2, v;
+        uint32_t dwell, count;
+        char* end;
+
+        if (strcmp(cmd, "mclk") == 0 && args == 2U)
+        {
+            if (!AD9833_Plan_ParseFreq(tok[1], &v) || v <= 0.0)
+            {
+                return AD9833_Plan_Error(err, err_len, line_no, "bad clock '%s'", tok[1]);
+            }
+            plan->mclk = v;
+        }
+        else if (strcmp(cmd, "tick") == 0 && args == 2U)
+        {
+            v = strtod(tok[1], &end);
+            if (end == tok[1] || *end || v < 1.0 || v > 65535.0 || v != floor(v))
+            {
+                return AD9833_Plan_Error(err, err_len, line_no, "bad tick rate '%s'", tok[1]);
+            }
+            if (plan->num) return AD9833_Plan_Error(err, err_len, line_no, "tick must be set before the first step");
+            plan->tick_hz = (uint16_t)v;
+        }
+        else if (strcmp(cmd, "chips") == 0 && args == 2U)
+        {
+            if (strcmp(tok[1], "cs1") == 0) plan->chips = 1;
+            else if (strcmp(tok[1], "cs2") == 0) plan->chips = 2;
+            else if (strcmp(tok[1], "both") == 0) plan->chips = 3;
+            else return AD9833_Plan_Error(err, err_len, line_no, "unknown chips '%s'", tok[1]);
+        }
+        else if (strcmp(cmd, "hop") == 0 && args == 2U)
+        {
+            if (strcmp(tok[1], "active") == 0) plan->hop = AD9833_PLAN_ACTIVE;
+            else if (strcmp(tok[1], "pingpong") == 0) plan->hop = AD9833_PLAN_PINGPONG;
+            else return AD9833_Plan_Error(err, err_len, line_no, "unknown hop mode '%s'", tok[1]);
+        }
+        else if (strcmp(cmd, "wave") == 0 && args == 2U)
+        {
+            if (!(plan->wave = AD9833_Plan_ParseWave(tok[1])))
+            {
+                return AD9833_Plan_Error(err, err_len, line_no, "unknown wave '%s'", tok[1]);
+            }
+        }
+        else if (strcmp(cmd, "phase") == 0 && args == 2U)
+        {
+            plan->phase = strtod(tok[1], &end);
+            if (end == tok[1] || *end) return AD9833_Plan_Error(err, err_len, line_no, "bad phase '%s'", tok[1]);
+        }
+        else if (strcmp(cmd, "step") == 0 && args == 3U)
+        {
+            if (!AD9833_Plan_ParseFreq(tok[1], &f1)) return AD9833_Plan_Error(err, err_len, line_no, "bad frequency");
+            if (!AD9833_Plan_ParseTicks(tok[2], plan->tick_hz, &dwell))
+            {
+                return AD9833_Plan_Error(err, err_len, line_no, "bad dwell '%s'", tok[2]);
+            }
+            if (!AD9833_Plan_Add(plan, f1, dwell, &opts, 0)) return AD9833_Plan_Error(err, err_len, line_no, "too many steps");
+        }
+        else if ((strcmp(cmd, "linear") == 0 || strcmp(cmd, "log") == 0) && args == 5U)
+        {
+            uint8_t log_sweep = (cmd[1] == 'o');
+            count = (uint32_t)strtoul(tok[3], &end, 10);
+            if (!AD9833_Plan_ParseFreq(tok[1], &f1) || !AD9833_Plan_ParseFreq(tok[2], &f2) ||
+                (log_sweep && (f1 <= 0.0 || f2 <= 0.0)))
+            {
+                return AD9833_Plan_Error(err, err_len, line_no, "bad frequency");
+            }
+            if (*end || !count) return AD9833_Plan_Error(err, err_len, line_no, "bad step count '%s'", tok[3]);
+            if (!AD9833_Plan_ParseTicks(tok[4], plan->tick_hz, &dwell))
+            {
+                return AD9833_Plan_Error(err, err_len, line_no, "bad dwell '%s'", tok[4]);
+            }
+            for (uint32_t k = 0; k < count; k++)
+            {
+                double x = (count > 1U) ? (double)k / (count - 1U) : 0.0;
+                double f = log_sweep ? f1 * pow(f2 / f1, x) : f1 + (f2 - f1) * x;
+                if (!AD9833_Plan_Add(plan, f, dwell, &opts, k)) return AD9833_Plan_Error(err, err_len, line_no, "too many steps");
+            }
+        }
+        else if (strcmp(cmd, "list") == 0 && args >= 3U)
+        {
+            if (!AD9833_Plan_ParseTicks(tok[1], plan->tick_hz, &dwell))
+            {
+                return AD9833_Plan_Error(err, err_len, line_no, "bad dwell '%s'", tok[1]);
+            }
+            for (uint32_t k = 2; k < args; k++)
+            {
+                if (!AD9833_Plan_ParseFreq(tok[k], &f1))
+                {
+                    return AD9833_Plan_Error(err, err_len, line_no, "bad frequency '%s'", tok[k]);
+                }
+                if (!AD9833_Plan_Add(plan, f1, dwell, &opts, k - 2U)) return AD9833_Plan_Error(err, err_len, line_no, "too many steps");
+            }
+        }
+        else if (strcmp(cmd, "chirp") == 0 && args == 4U)
+        {
+            if (!AD9833_Plan_ParseFreq(tok[1], &f1) || !AD9833_Plan_ParseFreq(tok[2], &f2))
+            {
+                return AD9833_Plan_Error(err, err_len, line_no, "bad frequency");
+            }
+            if (!AD9833_Plan_ParseTicks(tok[3], plan->tick_hz, &count) || count < 2U)
+            {
+                return AD9833_Plan_Error(err, err_len, line_no, "bad duration '%s'", tok[3]);
+            }
+            for (uint32_t k = 0; k < count; k++)
+            {
+                double f = f1 + (f2 - f1) * k / (count - 1U);
+                if (!AD9833_Plan_Add(plan, f, 1, &opts, k)) return AD9833_Plan_Error(err, err_len, line_no, "too many steps");
+            }
+        }
+        else
+        {
+            return AD9833_Plan_Error(err, err_len, line_no, "unknown or malformed '%s'", cmd);
+        }
+    }
+
+    for (uint32_t i = 0; i < plan->num; i++)
+    {
+        if (plan->step[i].freq < 0.0 || plan->step[i].freq > plan->mclk / 2.0)
+        {
+            return AD9833_Plan_Error(err, err_len, line_no, "step %u: %.3f Hz outside 0..mclk/2", (unsigned)i,
+                                     plan->step[i].freq);
+        }
+    }
+    return 0;
+}
+
+/* 编译 ---------------------------------------------------------------------*/
+
+/**
+ * @brief       波形对应的控制位
+ */
+static uint16_t AD9833_Plan_WaveBits(uint8_t wave)
+{
+    if (wave == AD9833_PLAN_TRIANGLE) return PLAN_CTRL_MODE;
+    if (wave == AD9833_PLAN_SQUARE) return PLAN_CTRL_OPBITEN | PLAN_CTRL_DIV2;
+    return 0;
+}
+
+/**
+ * @brief       生成一步的数据字并更新影子状态
+ * @param       plan: 计划
+ * @param       s: 影子状态
+ * @param       step: 步
+ * @param       w: 输出, 至多 PLAN_STEP_WORDS_MAX 个
+ * @param       stat: 统计, 可为 NULL
+ * @retval      数据字数
+ */
+static uint32_t AD9833_Plan_StepWords(const AD9833_Plan* plan, AD9833_PlanChip* s, const AD9833_PlanStep* step,
+                                      uint16_t* w, AD9833_PlanStat* stat)
+{
+    uint32_t n = 0;
+    uint32_t word = AD9833_Plan_FreqWord(plan, step->freq);
+    uint16_t phase = AD9833_Plan_PhaseWord(step->phase);
+    uint16_t wave = AD9833_Plan_WaveBits(step->wave);
+    uint8_t fsel = (s->ctrl & PLAN_CTRL_FSELECT) ? 1U : 0U;
+    uint8_t reg = fsel;
+
+    // pingpong: 频率变化时写另一个寄存器 (它可能已经是目标值), 之后切换
+    if (plan->hop == AD9833_PLAN_PINGPONG && word != s->freq[fsel]) reg = fsel ^ 1U;
+
+    uint32_t diff = s->freq[reg] ^ word;
+    uint16_t mode = s->ctrl & (PLAN_CTRL_B28 | PLAN_CTRL_HLB);
+    uint16_t want = mode;
+    if ((diff & 0x3FFFU) && (diff >> 14)) want = PLAN_CTRL_B28;
+    else if (diff & 0x3FFFU) want = 0;
+    else if (diff >> 14) want = PLAN_CTRL_HLB;
+
+    uint16_t select = reg ? PLAN_CTRL_FSELECT : 0U;
+    uint16_t cur = s->ctrl;
+    uint16_t cmd = reg ? PLAN_CMD_FREQ1 : PLAN_CMD_FREQ0;
+
+    // 改变模式的控制字带上新波形, 但不提前切换 FSELECT
+    if (want != mode)
+    {
+        cur = (uint16_t)(want | (s->ctrl & PLAN_CTRL_FSELECT) | wave);
+        w[n++] = cur;
+        if (stat) stat->ctrl_words++;
+    }
+    if (want == PLAN_CTRL_B28 && diff)
+    {
+        w[n++] = (uint16_t)(cmd | (word & 0x3FFFU));
+        w[n++] = (uint16_t)(cmd | (word >> 14));
+    }
+    else if (diff)
+    {
+        w[n++] = (uint16_t)(cmd | ((want & PLAN_CTRL_HLB) ? (word >> 14) : (word & 0x3FFFU)));
+        if (stat) stat->half_words++;
+    }
+    if (phase != s->phase[0]) w[n++] = (uint16_t)(PLAN_CMD_PHASE0 | phase);
+
+    uint16_t final = (uint16_t)(want | select | wave);
+    if (final != cur)
+    {
+        w[n++] = final;
+        if (stat) stat->ctrl_words++;
+    }
+
+    s->ctrl = final;
+    s->freq[reg] = word;
+    s->phase[0] = phase;
+    if (stat) stat->driver_words += (plan->hop == AD9833_PLAN_PINGPONG) ? 5U : 4U;
+    return n;
+}
+
+/**
+ * @brief       写出一步
+ * @retval      1: 成功; 0: 空间不足
+ */
+static uint8_t AD9833_Plan_Put(AD9833_PlanWriter* wr, uint16_t dwell, const uint16_t* w, uint32_t n)
+{
+    uint32_t size = PLAN_TABLE_STEP_SIZE + 2U * n;
+
+    if (wr->out)
+    {
+        if (wr->cap - wr->pos < size) return 0;
+        uint8_t* p = &wr->out[wr->pos];
+        p[0] = (uint8_t)dwell;
+        p[1] = (uint8_t)(dwell >> 8);
+        p[2] = (uint8_t)n;
+        p[3] = (uint8_t)(n >> 8);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            p[4U + 2U * i] = (uint8_t)w[i];
+            p[5U + 2U * i] = (uint8_t)(w[i] >> 8);
+        }
+    }
+    wr->pos += size;
+    return 1;
+}
+
+/**
+ * @brief       编译一遍计划, 只更新影子状态
+ */
+static void AD9833_Plan_Pass(const AD9833_Plan* plan, AD9833_PlanChip* s)
+{
+    uint16_t w[PLAN_STEP_WORDS_MAX];
+
+    for (uint32_t i = 0; i < plan->num; i++) AD9833_Plan_StepWords(plan, s, &plan->step[i], w, NULL);
+}
+
+/**
+ * @brief       把计划编译成数据字表
+ * @param       plan: 计划
+ * @param       out: 输出, 为 NULL 时只计算大小
+ * @param       cap: out 的容量
+ * @param       stat: 统计, 可为 NULL
+ * @retval      表的字节数, 0 为计划为空、容量不足或无法构成循环
+ */
+uint32_t AD9833_Plan_Compile(const AD9833_Plan* plan, uint8_t* out, uint32_t cap, AD9833_PlanStat* stat)
+{
+    AD9833_PlanStat st;
+    AD9833_PlanWriter wr = { out, cap, PLAN_TABLE_HEADER_SIZE };
+    uint16_t w[PLAN_STEP_WORDS_MAX];
+
+    memset(&st, 0, sizeof(st));
+    if (!plan->num || (out && cap < PLAN_TABLE_HEADER_SIZE)) return 0;
+
+    // 第0步的状态: 编译一遍后的结束状态, 到它再编译一遍 (或两遍) 后不变为止
+    const AD9833_PlanStep* last = &plan->step[plan->num - 1U];
+    AD9833_PlanChip start = { (uint16_t)(PLAN_CTRL_B28 | AD9833_Plan_WaveBits(last->wave)), { 0, 0 }, { 0, 0 } };
+    start.freq[0] = start.freq[1] = AD9833_Plan_FreqWord(plan, last->freq);
+    start.phase[0] = AD9833_Plan_PhaseWord(last->phase);
+
+    AD9833_PlanChip one, two;
+    uint32_t passes = 0;
+    AD9833_Plan_Pass(plan, &start);
+    for (uint32_t i = 0; i < PLAN_FIXPOINT_PASSES && !passes; i++)
+    {
+        one = start;
+        AD9833_Plan_Pass(plan, &one);
+        two = one;
+        AD9833_Plan_Pass(plan, &two);
+        if (memcmp(&one, &start, sizeof(one)) == 0) passes = 1;
+        else if (memcmp(&two, &start, sizeof(two)) == 0) passes = 2;
+        else start = two;
+    }
+    if (!passes) return 0;
+
+    // 第0步: 复位, 写全部寄存器, 释放复位并设定模式、选择和波形
+    uint32_t n = 0;
+    w[n++] = PLAN_CTRL_RESET | PLAN_CTRL_B28;
+    for (uint8_t r = 0; r < 2U; r++)
+    {
+        uint16_t cmd = r ? PLAN_CMD_FREQ1 : PLAN_CMD_FREQ0;
+        w[n++] = (uint16_t)(cmd | (start.freq[r] & 0x3FFFU));
+        w[n++] = (uint16_t)(cmd | (start.freq[r] >> 14));
+    }
+    w[n++] = (uint16_t)(PLAN_CMD_PHASE0 | start.phase[0]);
+    w[n++] = (uint16_t)(PLAN_CMD_PHASE1 | start.phase[1]);
+    w[n++] = start.ctrl;
+    if (!AD9833_Plan_Put(&wr, 1, w, n)) return 0;
+    st.setup_words = st.words = n;
+
+    AD9833_PlanChip s = start;
+    for (uint32_t p = 0; p < passes; p++)
+    {
+        for (uint32_t i = 0; i < plan->num; i++)
+        {
+            n = AD9833_Plan_StepWords(plan, &s, &plan->step[i], w, &st);
+            if (!AD9833_Plan_Put(&wr, plan->step[i].dwell, w, n)) return 0;
+            st.words += n;
+        }
+    }
+
+    st.steps = 1U + passes * plan->num;
+    st.passes = passes;
+    st.bytes = wr.pos;
+    if (out)
+    {
+        uint8_t* h = out;
+        h[0] = (uint8_t)PLAN_TABLE_MAGIC;
+        h[1] = (uint8_t)(PLAN_TABLE_MAGIC >> 8);
+        h[2] = (uint8_t)(PLAN_TABLE_MAGIC >> 16);
+        h[3] = (uint8_t)(PLAN_TABLE_MAGIC >> 24);
+        h[4] = PLAN_TABLE_VERSION;
+        h[5] = plan->chips;
+        h[6] = (uint8_t)plan->tick_hz;
+        h[7] = (uint8_t)(plan->tick_hz >> 8);
+        h[8] = (uint8_t)st.steps;
+        h[9] = (uint8_t)(st.steps >> 8);
+        h[10] = 1;      // 循环从第1步开始
+        h[11] = 0;
+        for (uint8_t i = 0; i < 4U; i++) h[12U + i] = (uint8_t)(st.words >> (8U * i));
+    }
+    if (stat) *stat = st;
+    return wr.pos;
+}
@@ -0,0 +1,138 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Plan.h
+  * @brief          : 把扫频/跳频计划编译成固件可直接播放的数据字表
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 计划是逐行的文本 (# 之后为注释)：
+  *
+  *     mclk 25M                    主时钟 (Hz), 默认 25MHz
+  *     tick 1000                   播放节拍 (Hz), 须与固件的 AD9833_TABLE_TICK_HZ 相同
+  *     chips both                  cs1 | cs2 | both (广播写入)
+  *     hop active                  active: 改写正在使用的频率寄存器
+  *                                 pingpong: 写另一个寄存器后切换 FSELECT
+  *     wave sine                   之后各段的默认波形 (sine | triangle | square)
+  *     phase 0                     之后各段的默认相位 (度)
+  *     step   <f> <dwell> [选项]
+  *     linear <f1> <f2> <n> <dwell> [选项]     n 点线性扫频
+  *     log    <f1> <f2> <n> <dwell> [选项]     n 点对数扫频
+  *     list   <dwell> <f>... [选项]            依次跳到各频率
+  *     chirp  <f1> <f2> <time> [选项]          每个节拍一步的线性调频
+  *
+  * 频率可带 k/M 后缀；时间可带 s/ms/us 后缀或以 t 结尾表示节拍数。选项为
+  * wave=<波形> 和 phase=<度> 或 phase=<起始>+<步进> (每步增加)，只作用于本段。
+  *
+  * 编译时逐步比较芯片的寄存器，只写出变化的部分：
+  * - 频率字只有低14位或只有高14位变化时，切换到 B28=0 并用 HLB 选择一半，
+  *   只写一个数据字 (模式保持到需要改变为止)；两半都变化时用 B28=1 连续
+  *   写两个字，避免输出中间频率。
+  * - 相位和波形不变时不写；改变模式的控制字同时带上新波形。
+  * - pingpong 方式的 FSELECT 切换放在数据字之后，目标寄存器写完才切换。
+  * 第0步把芯片设为最后一步之后的状态，循环播放时每一步的增量仍然成立；
+  * pingpong 方式下一遍结束时 FSELECT 与开始时相反的计划展开为两遍。
+  *
+  * 表的格式见 Drivers/AD9833_Table。
+  *
+  * 使用方法：
+  * 1. 调用 `AD9833_Plan_Parse()` 解析计划 (可多次调用追加)。
+  * 2. 调用 `AD9833_Plan_Compile()` 编译成表 (out 为 NULL 时只计算大小)。
+  * 3. 调用 `AD9833_Plan_Free()` 释放。
+  *
+  ******************************************************************************
+  */
+
+#ifndef _AD9833_PLAN_H
+#define _AD9833_PLAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define AD9833_PLAN_MCLK            25000000.0  // 默认主时钟 (Hz)
+#define AD9833_PLAN_TICK_HZ         1000U       // 默认节拍 (Hz)
+#define AD9833_PLAN_STEPS_MAX       30000U      // 一遍的步数上限 (展开为两遍后仍在表的范围内)
+
+// 波形, 与驱动的 waveType 相同
+#define AD9833_PLAN_SINE            1U
+#define AD9833_PLAN_TRIANGLE        2U
+#define AD9833_PLAN_SQUARE          3U
+
+/**
+ * @brief   频率的更新方式
+ */
+typedef enum
+{
+    AD9833_PLAN_ACTIVE = 0,
+    AD9833_PLAN_PINGPONG
+} AD9833_PlanHop;
+
+/**
+ * @brief   计划的一步
+ *      @arg freq: 频率 (Hz)
+ *      @arg phase: 相位 (度)
+ *      @arg wave: 波形
+ *      @arg dwell: 停留节拍数
+ */
+typedef struct
+{
+    double freq;
+    double phase;
+    uint8_t wave;
+    uint16_t dwell;
+} AD9833_PlanStep;
+
+/**
+ * @brief   计划
+ *      @arg mclk/tick_hz/chips/hop: 设置
+ *      @arg wave/phase: 当前的默认波形和相位
+ *      @arg step/num/cap: 步
+ */
+typedef struct
+{
+    double mclk;
+    uint16_t tick_hz;
+    uint8_t chips;
+    uint8_t hop;
+    uint8_t wave;
+    double phase;
+    AD9833_PlanStep* step;
+    uint32_t num;
+    uint32_t cap;
+} AD9833_Plan;
+
+/**
+ * @brief   编译统计
+ *      @arg steps: 表中的步数 (含第0步)
+ *      @arg passes: 一遍计划在表中展开的遍数 (1 或 2)
+ *      @arg words: 数据字总数
+ *      @arg bytes: 表的字节数
+ *      @arg setup_words: 第0步的数据字数
+ *      @arg half_words: 只写一半频率字的次数
+ *      @arg ctrl_words: 控制字数 (不含第0步)
+ *      @arg driver_words: 逐步调用驱动接口 (FreqSet/PhaseSet/SetWaveformAndStart/SelectFreqReg) 要写的字数
+ */
+typedef struct
+{
+    uint32_t steps;
+    uint32_t passes;
+    uint32_t words;
+    uint32_t bytes;
+    uint32_t setup_words;
+    uint32_t half_words;
+    uint32_t ctrl_words;
+    uint32_t driver_words;
+} AD9833_PlanStat;
+
+/* 函数声明 */
+void AD9833_Plan_Init(AD9833_Plan* plan);
+void AD9833_Plan_Free(AD9833_Plan* plan);
+int AD9833_Plan_Parse(AD9833_Plan* plan, const char* text, char* err, size_t err_len);
+uint32_t AD9833_Plan_FreqWord(const AD9833_Plan* plan, double freq);
+uint16_t AD9833_Plan_PhaseWord(double phase);
+uint32_t AD9833_Plan_Compile(const AD9833_Plan* plan, uint8_t* out, uint32_t cap, AD9833_PlanStat* stat);
+
+#endif /* _AD9833_PLAN_H */
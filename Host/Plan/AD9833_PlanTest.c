@@ -0,0 +1,317 @@
+/**
+******************************************************************************
+  * @file           : AD9833_PlanTest.c
+  * @brief          : 计划编译与固件播放的主机测试
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 把几份计划编译成表，由真实的 AD9833_Table 在 Mock_HAL + 行为模型上播放：
+  * - 每一步执行后正在使用的频率寄存器、PHASE0 和波形与计划一致，执行的
+  *   节拍与上一步的停留节拍一致，循环播放多遍仍然成立；
+  * - 任意两个数据字之间，输出频率和波形只能是上一步或这一步的值
+  *   (没有半个频率字或提前切换寄存器造成的中间状态)；
+  * - 写出的数据字少于逐步调用驱动接口，小步进扫频用到半字更新；
+  * - 格式错误的表和计划被拒绝，并给出出错的行号。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Plan.h"
+#include "AD9833_Table.h"
+#include "AD9833_Model.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Host_Check.h"
+
+#define PLAN_TEST_TICK_NS           (1000000000ULL / AD9833_TABLE_TICK_HZ)
+#define PLAN_TEST_LOOPS             3U
+
+static AD9833_InitTypedef s_cfg = {
+    .status = CS1_CS2_DOUBLE,
+    .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+    .AD_CS2 = { SINE_WAVE, 1000.0, 90.0, 0, 0 },
+};
+
+static AD9833_Model s_chip[AD9833_CHIP_NUM];
+static AD9833_ModelBus s_mb;
+
+/**
+ * @brief   一步前后允许的输出 (由数据字回调检查)
+ *      @arg armed: 已过第0步
+ *      @arg freq/wave: 上一步和这一步的频率字和波形控制位
+ */
+static struct
+{
+    uint8_t armed;
+    uint32_t freq[2];
+    uint16_t wave[2];
+    uint32_t glitches;
+} s_watch;
+
+/**
+ * @brief       芯片正在输出的频率字
+ */
+static uint32_t Test_ActiveFreq(const AD9833_Model* m)
+{
+    return m->freq[(m->ctrl & AD9833_MODEL_FSELECT) ? 1U : 0U];
+}
+
+/**
+ * @brief       芯片的波形控制位
+ */
+static uint16_t Test_WaveBits(const AD9833_Model* m)
+{
+    return m->ctrl & (AD9833_MODEL_OPBITEN | AD9833_MODEL_DIV2 | AD9833_MODEL_MODE);
+}
+
+/**
+ * @brief       计划波形对应的控制位
+ */
+static uint16_t Test_PlanWave(uint8_t wave)
+{
+    if (wave == AD9833_PLAN_TRIANGLE) return AD9833_MODEL_MODE;
+    if (wave == AD9833_PLAN_SQUARE) return AD9833_MODEL_OPBITEN | AD9833_MODEL_DIV2;
+    return 0;
+}
+
+/**
+ * @brief       数据字回调: 写入前的输出必须是上一步或这一步的值
+ */
+static void Test_Word(AD9833_Model* model, uint64_t time_ns, uint16_t word, void* ctx)
+{
+    (void)time_ns;
+    (void)word;
+    (void)ctx;
+    if (!s_watch.armed) return;
+
+    uint32_t f = Test_ActiveFreq(model);
+    uint16_t w = Test_WaveBits(model);
+    if ((f != s_watch.freq[0] && f != s_watch.freq[1]) || (w != s_watch.wave[0] && w != s_watch.wave[1]) ||
+        (model->ctrl & AD9833_MODEL_RESET))
+    {
+        s_watch.glitches++;
+    }
+}
+
+/**
+ * @brief       初始化模拟总线、模型和驱动
+ */
+static void Test_Setup(void)
+{
+    Mock_Bus bus = {0};
+
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_Reset();
+    Mock_TraceEnable(0);
+
+    for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+    {
+        AD9833_Model_Init(&s_chip[i]);
+        s_chip[i].word_hook = Test_Word;
+    }
+    AD9833_ModelBus_Init(&s_mb, s_chip, AD9833_CHIP_NUM, &bus);
+    AD9833_ModelBus_Attach(&s_mb);
+    AD9833_Cmd(&s_cfg);
+    memset(&s_watch, 0, sizeof(s_watch));
+}
+
+/**
+ * @brief       编译并播放一份计划, 逐步检查
+ * @param       name: 名称
+ * @param       text: 计划
+ * @param       stat: 编译统计的输出
+ * @retval      无
+ */
+static void Test_Play(const char* name, const char* text, AD9833_PlanStat* stat)
+{
+    AD9833_Plan plan;
+    char err[128];
+
+    AD9833_Plan_Init(&plan);
+    int line = AD9833_Plan_Parse(&plan, text, err, sizeof(err));
+    CHECK(line == 0, "%s: %s", name, err);
+    if (line) return;
+
+    uint32_t size = AD9833_Plan_Compile(&plan, NULL, 0, stat);
+    uint8_t* table = malloc(size ? size : 1U);
+    CHECK(size && AD9833_Plan_Compile(&plan, table, size, NULL) == size, "%s: compile", name);
+
+    Test_Setup();
+    CHECK(AD9833_Table_Load(table, size) == HAL_OK, "%s: load", name);
+    CHECK(AD9833_Table_Run(PLAN_TEST_LOOPS) == HAL_OK, "%s: run", name);
+    CHECK(AD9833_Table_Run(1) == HAL_BUSY, "%s: run while running", name);
+    CHECK(AD9833_Table_Load(table, size) == HAL_BUSY, "%s: load while running", name);
+
+    uint8_t chips = table[5];
+    uint32_t expect_steps = 1U + PLAN_TEST_LOOPS * stat->passes * plan.num;
+    uint32_t reg_errors = 0, tick_errors = 0, done = 0, tick = 0, due = 0;
+    AD9833_TableState st;
+    const AD9833_PlanStep* prev = &plan.step[plan.num - 1U];
+
+    for (; tick < 1000000U; tick++)
+    {
+        AD9833_Table_GetState(&st);
+        if (!st.running) break;
+
+        const AD9833_PlanStep* next = &plan.step[(done ? done - 1U : 0U) % plan.num];
+        s_watch.armed = (done > 0);
+        s_watch.freq[0] = AD9833_Plan_FreqWord(&plan, prev->freq);
+        s_watch.freq[1] = AD9833_Plan_FreqWord(&plan, next->freq);
+        s_watch.wave[0] = Test_PlanWave(prev->wave);
+        s_watch.wave[1] = Test_PlanWave(next->wave);
+
+        AD9833_Table_Tick();
+        Mock_Advance(PLAN_TEST_TICK_NS);
+        AD9833_Table_GetState(&st);
+        if (st.steps == done) continue;
+
+        // 第0步之后芯片处于最后一步的状态, 第k步对应计划的第 (k-1)%num 步
+        const AD9833_PlanStep* now = done ? next : prev;
+        if (tick != due) tick_errors++;
+        due = tick + (done ? now->dwell : 1U);
+        for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+        {
+            const AD9833_Model* m = &s_chip[i];
+            if (!(chips & (1U << i))) continue;
+            if (Test_ActiveFreq(m) != AD9833_Plan_FreqWord(&plan, now->freq) ||
+                m->phase[0] != AD9833_Plan_PhaseWord(now->phase) || (m->ctrl & AD9833_MODEL_PSELECT) ||
+                Test_WaveBits(m) != Test_PlanWave(now->wave) ||
+                (m->ctrl & (AD9833_MODEL_RESET | AD9833_MODEL_SLEEP1 | AD9833_MODEL_SLEEP12)))
+            {
+                if (!reg_errors) printf("  %s: step %u chip %u ctrl 0x%04X\n", name, (unsigned)done, (unsigned)i, m->ctrl);
+                reg_errors++;
+            }
+        }
+        prev = now;
+        done++;
+    }
+
+    CHECK(!st.running && st.steps == expect_steps, "%s: %u of %u steps", name, (unsigned)st.steps,
+          (unsigned)expect_steps);
+    CHECK(reg_errors == 0, "%s: %u steps with wrong registers", name, (unsigned)reg_errors);
+    CHECK(tick_errors == 0, "%s: %u steps off their tick", name, (unsigned)tick_errors);
+    CHECK(s_watch.glitches == 0, "%s: %u intermediate outputs", name, (unsigned)s_watch.glitches);
+    CHECK(st.words == stat->setup_words + PLAN_TEST_LOOPS * (stat->words - stat->setup_words), "%s: %u words",
+          name, (unsigned)st.words);
+    CHECK(AD9833_Model_Violations(&s_chip[0]) == 0 && AD9833_Model_Violations(&s_chip[1]) == 0,
+          "%s: bus timing violations", name);
+
+    printf("%-8s %5u steps x %u pass, %6u words (driver %6u), %4u half, %6u bytes\n", name, (unsigned)plan.num,
+           (unsigned)stat->passes, (unsigned)(stat->words - stat->setup_words), (unsigned)stat->driver_words,
+           (unsigned)stat->half_words, (unsigned)stat->bytes);
+
+    AD9833_ModelBus_Detach();
+    free(table);
+    AD9833_Plan_Free(&plan);
+}
+
+/**
+ * @brief       各种计划的播放
+ */
+static void Test_Plans(void)
+{
+    AD9833_PlanStat st;
+
+    // 小步进线性扫频: 大多只需半字更新
+    Test_Play("linear",
+              "# 1k..2k, 100Hz steps\n"
+              "chips both\n"
+              "linear 1k 2k 11 5ms\n"
+              "step 500 2t wave=square\n",
+              &st);
+    CHECK(st.passes == 1 && st.half_words >= 10U, "linear: %u passes, %u half words", (unsigned)st.passes,
+          (unsigned)st.half_words);
+    CHECK(st.words - st.setup_words < st.driver_words / 2U, "linear: %u words", (unsigned)st.words);
+
+    // pingpong 跳频, 每段各自的波形和相位; 另一个寄存器差得不多时也用半字更新
+    Test_Play("pingpong",
+              "hop pingpong\n"
+              "chips cs1\n"
+              "list 3t 1M 2M 1M 3M wave=triangle phase=0+45\n"
+              "step 2M 1ms wave=sine phase=-90\n"
+              "step 2M 2ms\n"
+              "linear 100k 101k 5 2t\n",
+              &st);
+    CHECK(st.words - st.setup_words < st.driver_words && st.half_words, "pingpong: %u words", (unsigned)st.words);
+
+    // 一遍切换奇数次 FSELECT, 展开为两遍
+    Test_Play("odd",
+              "hop pingpong\n"
+              "list 1t 1k 2k 3k\n",
+              &st);
+    CHECK(st.passes == 2U, "odd: %u passes", (unsigned)st.passes);
+
+    // 对数扫频和调频 (每个节拍一步)
+    Test_Play("chirp",
+              "mclk 25M\n"
+              "chips cs2\n"
+              "wave triangle\n"
+              "log 100 10k 20 2ms phase=10+5\n"
+              "chirp 10k 10.5k 50ms\n",
+              &st);
+    CHECK(st.steps == 1U + st.passes * 70U, "chirp: %u steps", (unsigned)st.steps);
+}
+
+/**
+ * @brief       格式错误的表和计划
+ */
+static void Test_Errors(void)
+{
+    AD9833_Plan plan;
+    char err[128];
+    uint8_t table[256];
+
+    AD9833_Plan_Init(&plan);
+    CHECK(AD9833_Plan_Parse(&plan, "step 1k 1ms\n\nlinear 1k 2k 0 1ms\n", err, sizeof(err)) == 3, "count 0");
+    AD9833_Plan_Free(&plan);
+    AD9833_Plan_Init(&plan);
+    CHECK(AD9833_Plan_Parse(&plan, "# x\nstep 1k 1.5t\n", err, sizeof(err)) == 2, "fractional ticks");
+    CHECK(AD9833_Plan_Parse(&plan, "step 20M 1ms\n", err, sizeof(err)) == 1, "above mclk/2");
+    AD9833_Plan_Free(&plan);
+    AD9833_Plan_Init(&plan);
+    CHECK(AD9833_Plan_Parse(&plan, "step 1k 1ms wave=saw\n", err, sizeof(err)) == 1, "unknown wave");
+    CHECK(AD9833_Plan_Parse(&plan, "step 1k 1ms\ntick 500\n", err, sizeof(err)) == 2, "tick after step");
+    CHECK(AD9833_Plan_Parse(&plan, "sweep 1k\n", err, sizeof(err)) == 1 && strstr(err, "sweep"), "unknown: %s",
+          err);
+    AD9833_Plan_Free(&plan);
+
+    AD9833_Plan_Init(&plan);
+    CHECK(AD9833_Plan_Compile(&plan, NULL, 0, NULL) == 0, "empty plan");
+    CHECK(AD9833_Plan_Parse(&plan, "list 1ms 1k 2k 3k\n", err, sizeof(err)) == 0, "%s", err);
+    uint32_t size = AD9833_Plan_Compile(&plan, table, sizeof(table), NULL);
+    CHECK(size > 0 && AD9833_Plan_Compile(&plan, table, size - 1U, NULL) == 0, "short buffer");
+
+    Test_Setup();
+    CHECK(AD9833_Table_Load(table, size) == HAL_OK, "valid table");
+    CHECK(AD9833_Table_Load(table, size - 2U) == HAL_ERROR, "truncated");
+    CHECK(AD9833_Table_Load(table, size + 2U) == HAL_ERROR, "trailing bytes");
+    table[6] ^= 1U;
+    CHECK(AD9833_Table_Load(table, size) == HAL_ERROR, "tick rate");
+    table[6] ^= 1U;
+    table[0] ^= 1U;
+    CHECK(AD9833_Table_Load(table, size) == HAL_ERROR, "magic");
+    table[0] ^= 1U;
+    table[16] = table[17] = 0;
+    CHECK(AD9833_Table_Load(table, size) == HAL_ERROR, "zero dwell");
+    AD9833_ModelBus_Detach();
+    AD9833_Plan_Free(&plan);
+}
+
+int main(void)
+{
+    Test_Plans();
+    Test_Errors();
+
+    printf("[soft] plan %s (%u failures)\n", s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
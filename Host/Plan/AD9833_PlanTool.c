@@ -0,0 +1,168 @@
+/**
+******************************************************************************
+  * @file           : AD9833_PlanTool.c
+  * @brief          : 计划编译命令行工具
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 用法：
+  *
+  *     ad9833_plan [-o table.bin] [-c table.c] [-n name] plan.txt
+  *
+  * 打印编译统计 (与逐步调用驱动接口相比节省的数据字)。-o 写出二进制表，
+  * 可在运行时读入RAM后交给 `AD9833_Table_Load()`；-c 写出 C 源文件，
+  * 表为 `const uint8_t name[]` (默认 ad9833_table) 和 `name_len`，直接链接
+  * 进Flash播放。plan.txt 为 - 时从标准输入读取。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Plan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief       打印用法
+ */
+static int Usage(const char* prog)
+{
+    fprintf(stderr, "usage: %s [-o table.bin] [-c table.c] [-n name] plan.txt\n", prog);
+    return 2;
+}
+
+/**
+ * @brief       读入整个文件
+ * @param       path: 文件名, - 为标准输入
+ * @retval      以0结尾的内容, NULL 为失败
+ */
+static char* ReadText(const char* path)
+{
+    FILE* fp = strcmp(path, "-") ? fopen(path, "rb") : stdin;
+    size_t len = 0, cap = 4096;
+    char* text = malloc(cap);
+
+    if (!fp || !text)
+    {
+        free(text);
+        return NULL;
+    }
+    for (size_t n; (n = fread(&text[len], 1, cap - len - 1U, fp)) > 0;)
+    {
+        len += n;
+        if (cap - len > 1U) continue;
+        char* grown = realloc(text, cap * 2U);
+        if (!grown) break;
+        text = grown;
+        cap *= 2U;
+    }
+    text[len] = '\0';
+    if (fp != stdin) fclose(fp);
+    return text;
+}
+
+/**
+ * @brief       写出 C 源文件
+ * @param       path: 文件名
+ * @param       name: 数组名
+ * @param       table: 表
+ * @param       size: 字节数
+ * @retval      0: 成功
+ */
+static int WriteSource(const char* path, const char* name, const uint8_t* table, uint32_t size)
+{
+    FILE* fp = fopen(path, "w");
+    if (!fp)
+    {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 2;
+    }
+
+    fprintf(fp, "/* Generated by ad9833_plan, play with AD9833_Table_Load(%s, %s_len) */\n\n", name, name);
+    fprintf(fp, "#include <stdint.h>\n\n");
+    fprintf(fp, "const uint32_t %s_len = %uU;\n\n", name, (unsigned)size);
+    fprintf(fp, "__attribute__((aligned(4))) const uint8_t %s[%u] = {", name, (unsigned)size);
+    for (uint32_t i = 0; i < size; i++)
+    {
+        fprintf(fp, "%s0x%02X,", (i % 12U) ? " " : "\n    ", table[i]);
+    }
+    fprintf(fp, "\n};\n");
+    fclose(fp);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* bin = NULL;
+    const char* src = NULL;
+    const char* name = "ad9833_table";
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:c:n:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'o': bin = optarg; break;
+        case 'c': src = optarg; break;
+        case 'n': name = optarg; break;
+        default: return Usage(argv[0]);
+        }
+    }
+    if (optind != argc - 1) return Usage(argv[0]);
+
+    char* text = ReadText(argv[optind]);
+    if (!text)
+    {
+        fprintf(stderr, "cannot read %s\n", argv[optind]);
+        return 2;
+    }
+
+    AD9833_Plan plan;
+    AD9833_PlanStat st;
+    char err[160];
+    AD9833_Plan_Init(&plan);
+    if (AD9833_Plan_Parse(&plan, text, err, sizeof(err)))
+    {
+        fprintf(stderr, "%s: %s\n", argv[optind], err);
+        return 1;
+    }
+    free(text);
+
+    uint32_t size = AD9833_Plan_Compile(&plan, NULL, 0, &st);
+    uint8_t* table = size ? malloc(size) : NULL;
+    if (!table || AD9833_Plan_Compile(&plan, table, size, NULL) != size)
+    {
+        fprintf(stderr, "%s: cannot compile (empty plan or no repeating start state)\n", argv[optind]);
+        return 1;
+    }
+
+    uint32_t words = st.words - st.setup_words;
+    printf("%u plan steps, %u table steps (%u pass%s), %u bytes, tick %u Hz\n", (unsigned)plan.num,
+           (unsigned)st.steps, (unsigned)st.passes, st.passes > 1U ? "es" : "", (unsigned)size,
+           (unsigned)plan.tick_hz);
+    printf("%u words per loop (%u half-word, %u control) + %u setup; driver calls would write %u (%.1f%% saved)\n",
+           (unsigned)words, (unsigned)st.half_words, (unsigned)st.ctrl_words, (unsigned)st.setup_words,
+           (unsigned)st.driver_words, 100.0 * (1.0 - (double)words / st.driver_words));
+
+    int ret = 0;
+    if (bin)
+    {
+        FILE* fp = fopen(bin, "wb");
+        if (!fp || fwrite(table, 1, size, fp) != size)
+        {
+            fprintf(stderr, "cannot write %s\n", bin);
+            ret = 2;
+        }
+        if (fp) fclose(fp);
+    }
+    if (src && !ret) ret = WriteSource(src, name, table, size);
+
+    free(table);
+    AD9833_Plan_Free(&plan);
+    return ret;
+}
@@ -0,0 +1,582 @@
+/**
+******************************************************************************
+  * @file           : AD9833_ProtoDmaTest.c
+  * @brief          : 串口循环 DMA 接收与原地帧解析的主机协同仿真
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 按固件的接法运行 AD9833_Proto：USART1 接收 DMA 以 115200bps 写入 144 字节
+  * 的循环缓冲区，HT / TC / IDLE 中断调用 AD9833_Proto_RxEvent()，主循环调用
+  * AD9833_Proto_RxPoll() 在缓冲区中原地解析：
+  * - 约 8KB 的随机字节流 (各种命令、最长的帧、帧外字节、校验错误、长度
+  *   超限、帧内超时) 分成若干段送入，应答、帧外字节、总线上的数据字和统计
+  *   必须与在中断中把同一字节流交给 AD9833_Proto_Input() 的结果完全相同；
+  *   其中有数据段跨过缓冲区末尾的帧，中断次数远少于字节数；
+  * - 主循环长时间不解析、DMA 覆盖了尚未解析的数据时，丢弃的字节数计入
+  *   lost，之后的帧照常执行；
+  * - 帧中间出现接收错误时，错误中断只重新启动 DMA (从缓冲区起点写入)，
+  *   主循环丢弃窗口和出错前未解析的字节 (计入 lost) 后继续解析，不重放
+  *   缓冲区中的旧数据；主循环停顿期间连续两次出错也是如此；
+  * - 缓冲区短于两帧时 AD9833_Proto_RxStart() 拒绝。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Sim.h"
+#include "AD9833_Model.h"
+#include "AD9833_Seq.h"
+#include "AD9833_Proto.h"
+#include <stdio.h>
+#include <string.h>
+#include "Host_Check.h"
+
+#define SIM_BYTE_NS                 86806U      // 115200bps 8N1
+#define SIM_RING_SIZE               144U
+#define SIM_STREAM_MAX              12288U
+#define SIM_BURST_MAX               128U
+#define SIM_LOG_MAX                 4096U
+
+static AD9833_InitTypedef s_cfg = {
+    .status = CS1_CS2_DOUBLE,
+    .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+    .AD_CS2 = { SINE_WAVE, 1000.0, 90.0, 0, 0 },
+};
+
+static AD9833_Model s_chip[AD9833_CHIP_NUM];
+static AD9833_ModelBus s_mb;
+static AD9833_SimDma s_rx;
+static uint8_t s_ring[SIM_RING_SIZE];
+static uint16_t s_rx_read = 0;
+static uint8_t s_polling = 1;
+
+/**
+ * @brief   字节流: 分段送入, 段与段之间空闲 gap_ns
+ */
+static struct
+{
+    uint8_t data[SIM_STREAM_MAX];
+    uint32_t size;
+    uint32_t burst_end[SIM_BURST_MAX];
+    uint64_t burst_gap[SIM_BURST_MAX];
+    uint32_t bursts;
+    uint32_t frames;
+    uint32_t wrapped;
+    uint32_t timeouts;
+} s_stream;
+
+/**
+ * @brief   一次运行的结果
+ *      @arg reply/other: 应答帧和帧外字节 (依次拼接)
+ *      @arg words/word_hash: 总线数据字的个数和 (芯片, 数据字) 序列的散列
+ */
+typedef struct
+{
+    uint8_t reply[SIM_LOG_MAX * 2U];
+    uint32_t reply_len;
+    uint8_t other[SIM_LOG_MAX];
+    uint32_t other_len;
+    uint32_t words;
+    uint32_t word_hash;
+    AD9833_ProtoStat stat;
+} Result;
+
+static Result s_result[2];
+static Result* s_cur;
+
+/**
+ * @brief       线性同余随机数 (可重复)
+ */
+static uint32_t Rand(void)
+{
+    static uint32_t s_seed = 20250818U;
+    s_seed = s_seed * 1664525U + 1013904223U;
+    return s_seed >> 8;
+}
+
+/**
+ * @brief       模型的数据字回调: 散列 (芯片, 数据字)
+ */
+static void Sim_Word(AD9833_Model* model, uint64_t time_ns, uint16_t word, void* ctx)
+{
+    uint32_t v = ((uint32_t)(model - s_chip) << 16) | word;
+
+    (void)time_ns;
+    (void)ctx;
+    for (uint8_t b = 0; b < 3U; b++)
+    {
+        s_cur->word_hash = (s_cur->word_hash ^ ((v >> (8U * b)) & 0xFFU)) * 16777619U;
+    }
+    s_cur->words++;
+}
+
+/**
+ * @brief       协议应答: 记下帧
+ */
+static void Sim_Send(const uint8_t* data, uint16_t len)
+{
+    if (s_cur->reply_len + len > sizeof(s_cur->reply)) return;
+    memcpy(&s_cur->reply[s_cur->reply_len], data, len);
+    s_cur->reply_len += len;
+}
+
+/**
+ * @brief       帧外字节: 记下
+ */
+static void Sim_Other(uint8_t byte)
+{
+    if (s_cur->other_len < sizeof(s_cur->other)) s_cur->other[s_cur->other_len++] = byte;
+}
+
+/**
+ * @brief       USART1 接收中断 (参考): 把新到的字节片段交给 AD9833_Proto_Input()
+ */
+static void Sim_InputIsr(AD9833_SimIrq* irq, void* ctx)
+{
+    AD9833_SimDma* dma = irq->dma;
+
+    (void)ctx;
+    while (s_rx_read != dma->pos)
+    {
+        uint16_t end = (dma->pos > s_rx_read) ? dma->pos : SIM_RING_SIZE;
+        AD9833_Proto_Input(&s_ring[s_rx_read], (uint32_t)(end - s_rx_read));
+        s_rx_read = (end == SIM_RING_SIZE) ? 0U : end;
+    }
+}
+
+/**
+ * @brief       USART1 接收中断 (固件的接法): 上报写入位置, 写满时与 HAL 相同上报 size
+ */
+static void Sim_EventIsr(AD9833_SimIrq* irq, void* ctx)
+{
+    AD9833_SimDma* dma = irq->dma;
+
+    (void)ctx;
+    AD9833_Proto_RxEvent((dma->pos || !(dma->event & AD9833_SIM_DMA_TC)) ? dma->pos : dma->size);
+}
+
+/**
+ * @brief       USART1 接收中断 (固件的接法, 含接收错误): 出错时记下位置并重新启动接收
+ */
+static void Sim_ErrorIsr(AD9833_SimIrq* irq, void* ctx)
+{
+    AD9833_SimDma* dma = irq->dma;
+    uint16_t head = (dma->pos || !(dma->event & AD9833_SIM_DMA_TC)) ? dma->pos : dma->size;
+
+    (void)ctx;
+    if (dma->event & AD9833_SIM_DMA_ERR)
+    {
+        // HAL_UART_ErrorCallback: 只置标志, 重新启动 DMA
+        AD9833_Proto_RxRestart(head);
+        AD9833_SimDma_Restart(dma);
+        return;
+    }
+    AD9833_Proto_RxEvent(head);
+}
+
+/**
+ * @brief       主循环: 原地解析
+ */
+static void Sim_MainLoop(void)
+{
+    if (s_polling) AD9833_Proto_RxPoll();
+}
+
+/**
+ * @brief       复位模拟层和模型, 初始化驱动、序列和解析器
+ * @param       result: 本次运行的结果
+ * @retval      无
+ */
+static void Sim_Setup(Result* result)
+{
+    Mock_Bus bus = {0};
+
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_Reset();
+    Mock_TraceEnable(0);
+
+    for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+    {
+        AD9833_Model_Init(&s_chip[i]);
+    }
+    AD9833_ModelBus_Init(&s_mb, s_chip, AD9833_CHIP_NUM, &bus);
+    AD9833_ModelBus_Attach(&s_mb);
+    AD9833_Cmd(&s_cfg);
+    for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+    {
+        s_chip[i].word_hook = Sim_Word;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->word_hash = 2166136261U;
+    s_cur = result;
+    s_rx_read = 0;
+    s_polling = 1;
+    memset(s_ring, 0, sizeof(s_ring));
+    AD9833_Seq_Init();
+    AD9833_Proto_Init(Sim_Send, Sim_Other);
+}
+
+/**
+ * @brief       在字节流中追加一帧
+ * @param       cmd: 命令字
+ * @param       payload: 数据
+ * @param       len: 数据字节数
+ * @param       corrupt: 非0时破坏 CRC
+ * @retval      无
+ */
+static void Stream_Frame(uint8_t cmd, const uint8_t* payload, uint8_t len, uint8_t corrupt)
+{
+    uint32_t at = s_stream.size;
+    uint16_t n = AD9833_Proto_Encode(cmd, payload, len, &s_stream.data[at]);
+
+    s_stream.size += n;
+    if (corrupt)
+    {
+        s_stream.data[s_stream.size - 1U] ^= 0x5AU;
+        return;
+    }
+    s_stream.frames++;
+    // DMA 从 ring[0] 起连续写入整个字节流, 数据段的位置由流中的偏移决定
+    if ((at + 3U) % SIM_RING_SIZE + len > SIM_RING_SIZE) s_stream.wrapped++;
+}
+
+/**
+ * @brief       结束当前段
+ * @param       gap_ns: 到下一段的空闲时间
+ * @retval      无
+ */
+static void Stream_EndBurst(uint64_t gap_ns)
+{
+    s_stream.burst_end[s_stream.bursts] = s_stream.size;
+    s_stream.burst_gap[s_stream.bursts] = gap_ns;
+    s_stream.bursts++;
+}
+
+/**
+ * @brief       生成随机字节流
+ * @retval      无
+ */
+static void Stream_Build(void)
+{
+    uint8_t p[AD9833_PROTO_PAYLOAD_MAX];
+
+    memset(&s_stream, 0, sizeof(s_stream));
+    while (s_stream.size + 2U * AD9833_PROTO_FRAME_MAX < SIM_STREAM_MAX && s_stream.bursts + 1U < SIM_BURST_MAX)
+    {
+        uint32_t r = Rand() % 16U;
+        uint32_t v = Rand();
+
+        p[0] = (uint8_t)(1U + v % 3U);
+        p[1] = (uint8_t)((v >> 2) & 1U);
+        switch (r)
+        {
+        case 0:
+            Stream_Frame(AD9833_PROTO_PING, NULL, 0, 0);
+            break;
+        case 1:
+        case 2:
+            v = Rand() & 0x0FFFFFFFU;
+            p[2] = (uint8_t)v; p[3] = (uint8_t)(v >> 8); p[4] = (uint8_t)(v >> 16); p[5] = (uint8_t)(v >> 24);
+            Stream_Frame(AD9833_PROTO_FREQ_RAW, p, 6, 0);
+            break;
+        case 3:
+            v = Rand() % 36000U;
+            p[2] = (uint8_t)v; p[3] = (uint8_t)(v >> 8);
+            Stream_Frame(AD9833_PROTO_PHASE, p, 4, 0);
+            break;
+        case 4:
+            p[1] = (uint8_t)(Rand() % 5U);
+            Stream_Frame(AD9833_PROTO_WAVE, p, 2, 0);
+            break;
+        case 5:
+            p[2] = (uint8_t)((v >> 3) & 1U);
+            Stream_Frame(AD9833_PROTO_SELECT, p, 3, 0);
+            break;
+        case 6:
+        {
+            uint8_t steps = (uint8_t)(1U + Rand() % 7U);
+            p[0] = (uint8_t)(Rand() % AD9833_SEQ_LEN);
+            for (uint32_t i = 1; i <= steps * AD9833_SEQ_STEP_SIZE; i++) p[i] = (uint8_t)Rand();
+            Stream_Frame(AD9833_PROTO_SEQ_LOAD, p, (uint8_t)(1U + steps * AD9833_SEQ_STEP_SIZE), 0);
+            break;
+        }
+        case 7:
+            Stream_Frame(AD9833_PROTO_SEQ_STATUS, NULL, 0, 0);
+            break;
+        case 8:     // 最长的帧 (未知命令)
+            for (uint32_t i = 0; i < AD9833_PROTO_PAYLOAD_MAX; i++) p[i] = (uint8_t)Rand();
+            Stream_Frame(0x7E, p, AD9833_PROTO_PAYLOAD_MAX, 0);
+            break;
+        case 9:     // 校验错误
+            v = Rand() & 0x0FFFFFFFU;
+            p[2] = (uint8_t)v; p[3] = (uint8_t)(v >> 8); p[4] = (uint8_t)(v >> 16); p[5] = (uint8_t)(v >> 24);
+            Stream_Frame(AD9833_PROTO_FREQ_RAW, p, 6, 1);
+            break;
+        case 10:    // 长度超限
+            s_stream.data[s_stream.size++] = AD9833_PROTO_SOF;
+            s_stream.data[s_stream.size++] = (uint8_t)(AD9833_PROTO_PAYLOAD_MAX + 1U + v % 64U);
+            break;
+        case 11:
+        case 12:    // 帧外字节
+            for (uint32_t i = 1U + v % 12U; i; i--) s_stream.data[s_stream.size++] = (uint8_t)('a' + Rand() % 26U);
+            break;
+        case 13:    // 半帧后长时间空闲
+            s_stream.size += AD9833_Proto_Encode(AD9833_PROTO_PING, NULL, 0, &s_stream.data[s_stream.size]) - 2U;
+            Stream_EndBurst(40000000ULL);
+            s_stream.timeouts++;
+            break;
+        default:
+            if (s_stream.size > (s_stream.bursts ? s_stream.burst_end[s_stream.bursts - 1U] : 0U))
+            {
+                Stream_EndBurst(1000000ULL + (v % 5U) * 1000000ULL);
+            }
+            break;
+        }
+    }
+    Stream_Frame(AD9833_PROTO_PING, NULL, 0, 0);     // 最后一段半帧的超时在收到新数据时才计入
+    Stream_EndBurst(5000000ULL);
+}
+
+/**
+ * @brief       分段送入字节流
+ * @param       isr: 接收中断服务函数
+ * @param       main_loop: 主循环
+ * @retval      无
+ */
+static void Stream_Run(AD9833_SimIsr isr, void (*main_loop)(void))
+{
+    uint32_t start = 0;
+
+    AD9833_Sim_Init(AD9833_SIM_ENTRY_NS);
+    AD9833_Sim_AddDma(&s_rx, "USART1_RX", 1, s_ring, SIM_RING_SIZE, isr, NULL);
+    for (uint32_t b = 0; b < s_stream.bursts; b++)
+    {
+        uint32_t len = s_stream.burst_end[b] - start;
+        uint64_t t0 = Mock_Now();
+
+        CHECK(AD9833_SimDma_Feed(&s_rx, t0 + 100000ULL, SIM_BYTE_NS, &s_stream.data[start], len) == len,
+              "burst %u not queued", (unsigned)b);
+        AD9833_Sim_Run(t0 + 100000ULL + (uint64_t)len * SIM_BYTE_NS + s_stream.burst_gap[b], main_loop);
+        start = s_stream.burst_end[b];
+    }
+    AD9833_Proto_GetStat(&s_cur->stat);
+}
+
+/**
+ * @brief       原地解析与 Input 的结果逐项相同
+ * @retval      无
+ */
+static void Test_Differential(void)
+{
+    Stream_Build();
+
+    Sim_Setup(&s_result[0]);
+    Stream_Run(Sim_InputIsr, NULL);
+
+    Sim_Setup(&s_result[1]);
+    CHECK(AD9833_Proto_RxStart(s_ring, SIM_RING_SIZE) == HAL_OK, "RxStart refused");
+    Stream_Run(Sim_EventIsr, Sim_MainLoop);
+
+    const Result* ref = &s_result[0];
+    const Result* got = &s_result[1];
+    CHECK(ref->stat.frames == s_stream.frames, "reference parsed %u of %u frames", (unsigned)ref->stat.frames,
+          (unsigned)s_stream.frames);
+    CHECK(ref->stat.timeouts == s_stream.timeouts, "reference timeouts %u, expected %u",
+          (unsigned)ref->stat.timeouts, (unsigned)s_stream.timeouts);
+    CHECK(!memcmp(&got->stat, &ref->stat, sizeof(got->stat)),
+          "stat frames %u/%u rejected %u/%u crc %u/%u over %u/%u timeouts %u/%u junk %u/%u lost %u/%u",
+          (unsigned)got->stat.frames, (unsigned)ref->stat.frames, (unsigned)got->stat.rejected,
+          (unsigned)ref->stat.rejected, (unsigned)got->stat.crc_errors, (unsigned)ref->stat.crc_errors,
+          (unsigned)got->stat.overruns, (unsigned)ref->stat.overruns, (unsigned)got->stat.timeouts,
+          (unsigned)ref->stat.timeouts, (unsigned)got->stat.junk, (unsigned)ref->stat.junk,
+          (unsigned)got->stat.lost, (unsigned)ref->stat.lost);
+    CHECK(got->reply_len == ref->reply_len && !memcmp(got->reply, ref->reply, ref->reply_len),
+          "replies differ (%u / %u bytes)", (unsigned)got->reply_len, (unsigned)ref->reply_len);
+    CHECK(got->other_len == ref->other_len && !memcmp(got->other, ref->other, ref->other_len),
+          "other bytes differ (%u / %u)", (unsigned)got->other_len, (unsigned)ref->other_len);
+    CHECK(got->words == ref->words && got->word_hash == ref->word_hash, "bus words differ (%u / %u)",
+          (unsigned)got->words, (unsigned)ref->words);
+    CHECK(s_stream.wrapped > 0U, "no frame payload crosses the ring end");
+    CHECK(s_rx.irq.fires * 16U < s_stream.size, "%u receive interrupts for %u bytes", (unsigned)s_rx.irq.fires,
+          (unsigned)s_stream.size);
+
+    printf("  %u bytes in %u bursts: %u frames (%u wrapped), %u reply bytes, %u bus words, %u interrupts\n",
+           (unsigned)s_stream.size, (unsigned)s_stream.bursts, (unsigned)got->stat.frames,
+           (unsigned)s_stream.wrapped, (unsigned)got->reply_len, (unsigned)got->words, (unsigned)s_rx.irq.fires);
+}
+
+/**
+ * @brief       主循环停顿时 DMA 覆盖未解析的数据
+ * @retval      无
+ */
+static void Test_Lost(void)
+{
+    uint8_t stall[300];
+    uint8_t frame[AD9833_PROTO_FRAME_MAX];
+    uint16_t len = AD9833_Proto_Encode(AD9833_PROTO_PING, NULL, 0, frame);
+    uint32_t stall_len = 0;
+
+    while (stall_len + len <= sizeof(stall))
+    {
+        memcpy(&stall[stall_len], frame, len);
+        stall_len += len;
+    }
+
+    Sim_Setup(&s_result[0]);
+    CHECK(AD9833_Proto_RxStart(s_ring, SIM_RING_SIZE) == HAL_OK, "RxStart refused");
+    AD9833_Sim_Init(AD9833_SIM_ENTRY_NS);
+    AD9833_Sim_AddDma(&s_rx, "USART1_RX", 1, s_ring, SIM_RING_SIZE, Sim_EventIsr, NULL);
+
+    // 停顿期间收到 stall_len 字节, 超过缓冲区
+    uint64_t t0 = Mock_Now();
+    s_polling = 0;
+    AD9833_SimDma_Feed(&s_rx, t0 + 100000ULL, SIM_BYTE_NS, stall, stall_len);
+    AD9833_Sim_Run(t0 + 100000ULL + (uint64_t)(stall_len + 2U) * SIM_BYTE_NS, Sim_MainLoop);
+    s_polling = 1;
+    AD9833_Sim_Run(Mock_Now() + 1000000ULL, Sim_MainLoop);
+
+    AD9833_ProtoStat st;
+    AD9833_Proto_GetStat(&st);
+    CHECK(st.lost == stall_len && st.frames == 0U, "lost %u of %u bytes, %u frames", (unsigned)st.lost,
+          (unsigned)stall_len, (unsigned)st.frames);
+
+    // 重新同步后照常执行
+    t0 = Mock_Now();
+    AD9833_SimDma_Feed(&s_rx, t0 + 100000ULL, SIM_BYTE_NS, stall, 10U * len);
+    AD9833_Sim_Run(t0 + 100000ULL + (uint64_t)(10U * len + 2U) * SIM_BYTE_NS, Sim_MainLoop);
+    AD9833_Proto_GetStat(&st);
+    CHECK(st.frames == 10U && s_cur->reply_len == 10U * 7U, "%u frames, %u reply bytes after the overrun",
+          (unsigned)st.frames, (unsigned)s_cur->reply_len);
+
+    uint8_t small[AD9833_PROTO_RX_MIN - 1U];
+    CHECK(AD9833_Proto_RxStart(small, sizeof(small)) == HAL_ERROR, "ring shorter than two frames accepted");
+    CHECK(AD9833_Proto_RxStart(NULL, SIM_RING_SIZE) == HAL_ERROR, "NULL ring accepted");
+}
+
+/**
+ * @brief       安排 count 个 PING 帧, 每帧之后空闲 1ms
+ * @param       at_ns: 第一帧的时刻
+ * @param       count: 帧数
+ * @retval      最后一帧之后空闲结束的时刻
+ */
+static uint64_t Feed_Pings(uint64_t at_ns, uint32_t count)
+{
+    uint8_t ping[4];
+    uint16_t len = AD9833_Proto_Encode(AD9833_PROTO_PING, NULL, 0, ping);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        AD9833_SimDma_Feed(&s_rx, at_ns, SIM_BYTE_NS, ping, len);
+        at_ns += (uint64_t)len * SIM_BYTE_NS + 1000000ULL;
+    }
+    return at_ns;
+}
+
+/**
+ * @brief       帧中间的接收错误: 错误中断只重新启动 DMA, 主循环重新同步
+ * @retval      无
+ */
+static void Test_RxError(void)
+{
+    uint8_t ping[4];
+    uint16_t len = AD9833_Proto_Encode(AD9833_PROTO_PING, NULL, 0, ping);
+    AD9833_ProtoStat st;
+
+    Sim_Setup(&s_result[0]);
+    CHECK(AD9833_Proto_RxStart(s_ring, SIM_RING_SIZE) == HAL_OK, "RxStart refused");
+    AD9833_Sim_Init(AD9833_SIM_ENTRY_NS);
+    AD9833_Sim_AddDma(&s_rx, "USART1_RX", 1, s_ring, SIM_RING_SIZE, Sim_ErrorIsr, NULL);
+
+    // 已解析出半帧 (窗口中2字节) 时出错
+    uint64_t t = Feed_Pings(Mock_Now() + 100000ULL, 5);
+    AD9833_SimDma_Feed(&s_rx, t, SIM_BYTE_NS, ping, 2);
+    t += 2U * SIM_BYTE_NS + 1000000ULL;
+    AD9833_SimDma_Error(&s_rx, t);
+    t = Feed_Pings(t + 1000000ULL, 5);
+    AD9833_Sim_Run(t, Sim_MainLoop);
+
+    AD9833_Proto_GetStat(&st);
+    CHECK(st.frames == 10U && st.lost == 2U && st.junk == 0U && s_cur->reply_len == 10U * 7U,
+          "half frame: frames %u lost %u junk %u reply bytes %u", (unsigned)st.frames, (unsigned)st.lost,
+          (unsigned)st.junk, (unsigned)s_cur->reply_len);
+    CHECK(s_rx.pos == 5U * len, "DMA not restarted at the ring start (pos %u)", (unsigned)s_rx.pos);
+
+    // 主循环停顿: 3帧未解析, 第4帧第1字节后出错, 再收到2帧, 第7帧第2字节后再次出错
+    Sim_Setup(&s_result[0]);
+    CHECK(AD9833_Proto_RxStart(s_ring, SIM_RING_SIZE) == HAL_OK, "RxStart refused");
+    AD9833_Sim_Init(AD9833_SIM_ENTRY_NS);
+    AD9833_Sim_AddDma(&s_rx, "USART1_RX", 1, s_ring, SIM_RING_SIZE, Sim_ErrorIsr, NULL);
+    s_polling = 0;
+
+    t = Feed_Pings(Mock_Now() + 100000ULL, 3);
+    AD9833_SimDma_Error(&s_rx, t + SIM_BYTE_NS + SIM_BYTE_NS / 2U);
+    t = Feed_Pings(t, 3);
+    AD9833_SimDma_Error(&s_rx, t + 2U * SIM_BYTE_NS + SIM_BYTE_NS / 2U);
+    uint64_t t_resume = Feed_Pings(t, 1);
+    AD9833_Sim_Run(t_resume, Sim_MainLoop);
+    s_polling = 1;
+    t = Feed_Pings(t_resume, 3);
+    AD9833_Sim_Run(t, Sim_MainLoop);
+
+    // 第二次出错前的 3*4 + 1 + 3 + 2*4 + 2 字节丢弃; 第7帧剩下的2字节在帧外
+    AD9833_Proto_GetStat(&st);
+    CHECK(st.frames == 3U && st.lost == 26U && st.junk == 2U && s_cur->reply_len == 3U * 7U,
+          "stalled: frames %u lost %u junk %u reply bytes %u", (unsigned)st.frames, (unsigned)st.lost,
+          (unsigned)st.junk, (unsigned)s_cur->reply_len);
+    CHECK(s_rx.irq.fires >= 2U && s_rx.dropped == 0U, "rx ISR fired %u times, %u bytes dropped by the halted DMA",
+          (unsigned)s_rx.irq.fires, (unsigned)s_rx.dropped);
+    printf("  receive errors mid-frame: %u bytes lost, %u frames parsed after the restarts\n", (unsigned)st.lost,
+           (unsigned)st.frames);
+
+    // 错误中断抢占正在执行 FREQ 帧的主循环: 该帧照常完成, 之后的帧不重放也不丢
+    Sim_Setup(&s_result[0]);
+    CHECK(AD9833_Proto_RxStart(s_ring, SIM_RING_SIZE) == HAL_OK, "RxStart refused");
+    AD9833_Sim_Init(AD9833_SIM_ENTRY_NS);
+    AD9833_Sim_AddDma(&s_rx, "USART1_RX", 1, s_ring, SIM_RING_SIZE, Sim_ErrorIsr, NULL);
+    Mock_STM32_SetPreemptHook(AD9833_Sim_Preempt);
+
+    uint8_t p[6] = { CS1, 0 };
+    uint8_t frame[AD9833_PROTO_FRAME_MAX];
+    t = Mock_Now() + 100000ULL;
+    for (uint32_t i = 0; i < 4U; i++)
+    {
+        uint32_t freq = 100000U * (i + 1U);
+        for (uint8_t b = 0; b < 4U; b++) p[2U + b] = (uint8_t)(freq >> (8U * b));
+        len = AD9833_Proto_Encode(AD9833_PROTO_FREQ, p, 6, frame);
+        AD9833_SimDma_Feed(&s_rx, t, SIM_BYTE_NS, frame, len);
+        t += (uint64_t)len * SIM_BYTE_NS;
+        // 第2帧的 IDLE 之后主循环开始执行该帧, 此时出错
+        if (i == 1U) AD9833_SimDma_Error(&s_rx, t + SIM_BYTE_NS + 1000U);
+        t += 1000000ULL;
+    }
+    AD9833_Sim_Run(t, Sim_MainLoop);
+    Mock_STM32_SetPreemptHook(NULL);
+
+    AD9833_Proto_GetStat(&st);
+    CHECK(st.frames == 4U && st.lost == 0U && st.junk == 0U && s_cur->reply_len == 4U * 5U,
+          "preempted: frames %u lost %u junk %u reply bytes %u", (unsigned)st.frames, (unsigned)st.lost,
+          (unsigned)st.junk, (unsigned)s_cur->reply_len);
+    CHECK(s_rx.irq.preempts > 0U && s_rx.pos == 2U * len, "error ISR preempted %u times, DMA pos %u",
+          (unsigned)s_rx.irq.preempts, (unsigned)s_rx.pos);
+    CHECK(s_chip[0].freq[0] == AD9833_FreqToWord(CS1, 4000.0), "CS1 FREQ0 %07X after the restart",
+          (unsigned)s_chip[0].freq[0]);
+}
+
+int main(void)
+{
+    Test_Differential();
+    Test_Lost();
+    Test_RxError();
+
+    printf("[soft] proto dma %s (%u failures)\n", s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
@@ -0,0 +1,553 @@
+/**
+******************************************************************************
+  * @file           : AD9833_SeqSimTest.c
+  * @brief          : 定时器中断中播放序列的主机协同仿真
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 真实的 AD9833_Seq (定时播放)、AD9833_Proto 和 AD9833_Soft 在 AD9833_Sim 的
+  * 虚拟中断下运行，总线由行为模型实时解码：
+  * - 1kHz 定时器中断调用 AD9833_Seq_Tick()，播放 64 步 x 50 遍 (约10秒
+  *   模拟时间)，每一步的执行节拍与停留时间之和严格一致，每一步第一个数据字
+  *   相对定时器更新的偏移逐遍相同 (不漂移)，中断耗时不超过预算；
+  * - 每一步只写入掩码中的芯片，写入后寄存器与该步一致，步序不乱；
+  * - USART1 接收 DMA (优先级高于定时器) 在播放中送来 SEQ_STATUS 和 SEQ_STOP，
+  *   与固件相同，接收中断只上报写入位置，主循环解析；主循环执行停止命令
+  *   之后不再有任何总线写入；
+  * - 主循环停顿期间 DMA 写过整个缓冲区，解析器丢弃被覆盖的字节 (lost)
+  *   后重新同步，定时播放不受停顿影响；
+  * - 把预算和周期调到中断放不下时，超预算和合并丢失的更新都被检测到；
+  * - 中断可在主循环的任意 GPIO 操作之间抢占时，主循环连续改写 CS1 的频率，
+  *   定时器中断播放 CS2 的序列，两片的寄存器都与各自写入的一致，总线无违例。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Sim.h"
+#include "AD9833_Model.h"
+#include "AD9833_Seq.h"
+#include "AD9833_Proto.h"
+#include <stdio.h>
+#include <string.h>
+#include "Host_Check.h"
+
+#define SIM_TICK_NS                 (1000000000ULL / AD9833_SEQ_TICK_HZ)
+#define SIM_TIMER_BUDGET_NS         50000U
+#define SIM_LOOPS                   50U
+#define SIM_STEPS                   (AD9833_SEQ_LEN * SIM_LOOPS)
+#define SIM_BYTE_NS                 86806U      // 115200bps 8N1
+#define SIM_RX_SIZE                 256U        // 与固件的 PROTO_RX_SIZE 相同
+
+static AD9833_InitTypedef s_cfg = {
+    .status = CS1_CS2_DOUBLE,
+    .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+    .AD_CS2 = { SINE_WAVE, 1000.0, 90.0, 0, 0 },
+};
+
+static AD9833_Model s_chip[AD9833_CHIP_NUM];
+static AD9833_ModelBus s_mb;
+static AD9833_SimIrq s_timer;
+static AD9833_SimDma s_rx;
+static uint8_t s_rx_buf[SIM_RX_SIZE];
+
+static AD9833_SeqStep s_steps[AD9833_SEQ_LEN];
+
+/**
+ * @brief   播放记录
+ *      @arg step_tick: 第k步执行时的节拍序号 (相对第一次定时器更新)
+ *      @arg offset_ns: 第k步第一个数据字相对该节拍定时器更新的时刻
+ */
+static struct
+{
+    uint32_t tick;
+    uint32_t executed;
+    uint32_t order_errors;
+    uint32_t mask_errors;
+    uint32_t reg_errors;
+    uint64_t t_first_update;
+    uint64_t offset[AD9833_SEQ_LEN];
+    uint64_t offset_min;
+    uint64_t offset_max;
+    uint32_t drift_errors;
+    uint32_t last_tick;
+    uint32_t words_in_isr[AD9833_CHIP_NUM];
+    uint64_t first_word_ns;
+    uint32_t expect_tick;
+    uint32_t tick_errors;
+    uint64_t last_word_ns;
+    uint32_t words;
+} s_rec;
+
+static uint8_t s_reply[8][AD9833_PROTO_FRAME_MAX];
+static uint16_t s_reply_len[8];
+static uint32_t s_reply_num = 0;
+static uint64_t s_stop_ns = 0;
+static uint32_t s_stop_steps = 0;
+static uint8_t s_polling = 1;
+
+/**
+ * @brief       模型的数据字回调: 记下时刻和所属芯片
+ */
+static void Sim_Word(AD9833_Model* model, uint64_t time_ns, uint16_t word, void* ctx)
+{
+    (void)word;
+    (void)ctx;
+    uint32_t i = (uint32_t)(model - s_chip);
+
+    if (!s_rec.first_word_ns) s_rec.first_word_ns = time_ns;
+    s_rec.words_in_isr[i]++;
+    s_rec.last_word_ns = time_ns;
+    s_rec.words++;
+}
+
+/**
+ * @brief       由第k步检查芯片的寄存器
+ * @param       step: 步
+ * @retval      1: 一致
+ */
+static uint8_t Sim_RegsMatch(const AD9833_SeqStep* step)
+{
+    for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+    {
+        const AD9833_Model* m = &s_chip[i];
+
+        if (!(step->mask & (1U << i))) continue;
+        switch (step->op)
+        {
+        case AD9833_SEQ_FREQ:
+        {
+            uint32_t expect = (uint32_t)(step->value / 100.0 * 268435456.0 / AD9833_MCLK_NOMINAL + 0.5);
+            uint32_t got = m->freq[step->arg];
+            if (got + 1U < expect || got > expect + 1U) return 0;
+            break;
+        }
+        case AD9833_SEQ_FREQ_RAW:
+            if (m->freq[step->arg] != step->value) return 0;
+            break;
+        case AD9833_SEQ_SELECT:
+            if (((m->ctrl & AD9833_MODEL_FSELECT) ? 1U : 0U) != (step->arg & 1U)) return 0;
+            if (((m->ctrl & AD9833_MODEL_PSELECT) ? 1U : 0U) != ((step->arg >> 1) & 1U)) return 0;
+            break;
+        default:
+            break;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief       定时器更新中断: 调用 AD9833_Seq_Tick() 并检查执行的步
+ */
+static void Sim_TimerIsr(AD9833_SimIrq* irq, void* ctx)
+{
+    AD9833_SeqState before, after;
+    uint64_t update_ns = irq->request_ns - irq->period_ns;     // 本次服务的更新时刻
+
+    (void)ctx;
+    if (!s_rec.t_first_update) s_rec.t_first_update = update_ns;
+
+    memset(s_rec.words_in_isr, 0, sizeof(s_rec.words_in_isr));
+    s_rec.first_word_ns = 0;
+
+    AD9833_Seq_GetState(&before);
+    AD9833_Seq_Tick();
+    AD9833_Seq_GetState(&after);
+
+    uint32_t tick = (uint32_t)((update_ns - s_rec.t_first_update) / irq->period_ns);
+    if (after.steps == before.steps)
+    {
+        for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+        {
+            if (s_rec.words_in_isr[i]) s_rec.mask_errors++;
+        }
+        return;
+    }
+
+    const AD9833_SeqStep* step = &s_steps[before.index];
+    uint32_t k = s_rec.executed++;
+
+    if (before.index != k % AD9833_SEQ_LEN) s_rec.order_errors++;
+    if (tick != s_rec.expect_tick) s_rec.tick_errors++;
+    s_rec.last_tick = tick;
+    s_rec.expect_tick = tick + (step->dwell_ms ? step->dwell_ms : 1U) * (AD9833_SEQ_TICK_HZ / 1000U);
+
+    for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+    {
+        uint8_t selected = (step->mask & (1U << i)) ? 1U : 0U;
+        if (selected != (s_rec.words_in_isr[i] ? 1U : 0U)) s_rec.mask_errors++;
+    }
+    if (!Sim_RegsMatch(step)) s_rec.reg_errors++;
+
+    if (s_rec.first_word_ns)
+    {
+        uint64_t off = s_rec.first_word_ns - update_ns;
+        // 第一遍从 AD9833_Cmd() 的状态开始, 从第二遍起每遍的写入完全相同
+        if (k >= 2U * AD9833_SEQ_LEN && off != s_rec.offset[before.index]) s_rec.drift_errors++;
+        s_rec.offset[before.index] = off;
+        if (off < s_rec.offset_min) s_rec.offset_min = off;
+        if (off > s_rec.offset_max) s_rec.offset_max = off;
+    }
+}
+
+/**
+ * @brief       协议应答: 记下帧
+ */
+static void Sim_Send(const uint8_t* data, uint16_t len)
+{
+    if (s_reply_num < 8U)
+    {
+        memcpy(s_reply[s_reply_num], data, len);
+        s_reply_len[s_reply_num] = len;
+    }
+    s_reply_num++;
+}
+
+/**
+ * @brief       USART1 接收 DMA 中断 (固件的接法): 只上报写入位置, 写满时与 HAL 相同上报 size
+ */
+static void Sim_RxIsr(AD9833_SimIrq* irq, void* ctx)
+{
+    AD9833_SimDma* dma = irq->dma;
+
+    (void)ctx;
+    AD9833_Proto_RxEvent((dma->pos || !(dma->event & AD9833_SIM_DMA_TC)) ? dma->pos : dma->size);
+}
+
+/**
+ * @brief       主循环 (固件的接法): 原地解析, 记下序列停止的时刻
+ */
+static void Sim_MainLoop(void)
+{
+    AD9833_SeqState st;
+
+    if (s_polling) AD9833_Proto_RxPoll();
+    AD9833_Seq_Poll();
+
+    AD9833_Seq_GetState(&st);
+    if (!st.running && !s_stop_ns)
+    {
+        s_stop_steps = st.steps;
+        s_stop_ns = Mock_Now();
+    }
+}
+
+/**
+ * @brief       生成序列表: 改频 (频率或频率字)、改相、寄存器选择, 掩码和停留时间 (0~5ms) 轮换
+ * @param       mask: 各步的芯片掩码, 0 为轮换 CS1 / CS2 / 两片
+ * @retval      无
+ */
+static void Sim_LoadTable(uint8_t mask)
+{
+    uint8_t data[AD9833_SEQ_LEN * AD9833_SEQ_STEP_SIZE];
+
+    for (uint32_t k = 0; k < AD9833_SEQ_LEN; k++)
+    {
+        AD9833_SeqStep* s = &s_steps[k];
+        uint8_t* d = &data[k * AD9833_SEQ_STEP_SIZE];
+
+        s->mask = mask ? mask : (uint8_t)(1U + k % 3U);
+        s->dwell_ms = (uint16_t)((k * 7U) % 6U);
+        switch (k % 5U)
+        {
+        case 0:
+        case 2:  s->op = AD9833_SEQ_FREQ;   s->arg = (uint8_t)((k >> 2) & 1U); s->value = 100000U + k * 12345U; break;
+        case 1:  s->op = AD9833_SEQ_PHASE;  s->arg = 0; s->value = (k * 250U) % 36000U; break;
+        case 3:  s->op = AD9833_SEQ_SELECT; s->arg = (uint8_t)((k >> 2) & 3U); s->value = 0; break;
+        default: s->op = AD9833_SEQ_FREQ_RAW; s->arg = (uint8_t)((k >> 2) & 1U); s->value = (2U * k + 1U) << 16; break;
+        }
+
+        d[0] = (uint8_t)(s->op << 4 | s->arg);
+        d[1] = s->mask;
+        d[2] = (uint8_t)s->dwell_ms;
+        d[3] = (uint8_t)(s->dwell_ms >> 8);
+        d[4] = (uint8_t)s->value;
+        d[5] = (uint8_t)(s->value >> 8);
+        d[6] = (uint8_t)(s->value >> 16);
+        d[7] = (uint8_t)(s->value >> 24);
+    }
+    CHECK(AD9833_Seq_Load(0, data, AD9833_SEQ_LEN) == HAL_OK, "table not loaded");
+}
+
+/**
+ * @brief       登记总线和模型, 初始化两路输出
+ * @retval      无
+ */
+static void Sim_Setup(void)
+{
+    Mock_Bus bus = {0};
+
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_Reset();
+    Mock_TraceEnable(0);
+
+    for (uint32_t i = 0; i < AD9833_CHIP_NUM; i++)
+    {
+        AD9833_Model_Init(&s_chip[i]);
+        s_chip[i].word_hook = Sim_Word;
+    }
+    AD9833_ModelBus_Init(&s_mb, s_chip, AD9833_CHIP_NUM, &bus);
+    AD9833_ModelBus_Attach(&s_mb);
+    AD9833_Cmd(&s_cfg);
+
+    memset(&s_rec, 0, sizeof(s_rec));
+    s_rec.offset_min = UINT64_MAX;
+}
+
+/**
+ * @brief       长序列: 节拍、步序、掩码、寄存器和中断耗时
+ * @retval      无
+ */
+static void Test_LongRun(void)
+{
+    Sim_Setup();
+    AD9833_Seq_Init();
+    Sim_LoadTable(0);
+    CHECK(AD9833_Seq_SetTimed(1) == HAL_OK, "SetTimed refused");
+
+    AD9833_Sim_Init(AD9833_SIM_ENTRY_NS);
+    AD9833_Sim_AddTimer(&s_timer, "TIM6", 2, SIM_TICK_NS, Sim_TimerIsr, NULL);
+    s_timer.budget_ns = SIM_TIMER_BUDGET_NS;
+    CHECK(AD9833_Seq_Run(0, AD9833_SEQ_LEN, SIM_LOOPS) == HAL_OK, "Run refused");
+
+    AD9833_Sim_Run(Mock_Now() + 20ULL * 1000000000ULL, AD9833_Seq_Poll);
+
+    AD9833_SeqState st;
+    AD9833_Seq_GetState(&st);
+    CHECK(!st.running && st.steps == SIM_STEPS, "running %u steps %u", (unsigned)st.running, (unsigned)st.steps);
+    CHECK(s_rec.executed == SIM_STEPS, "%u steps executed in the timer ISR", (unsigned)s_rec.executed);
+    CHECK(s_rec.tick_errors == 0, "%u steps on the wrong tick", (unsigned)s_rec.tick_errors);
+    CHECK(s_rec.order_errors == 0, "%u steps out of order", (unsigned)s_rec.order_errors);
+    CHECK(s_rec.mask_errors == 0, "%u writes to the wrong chip", (unsigned)s_rec.mask_errors);
+    CHECK(s_rec.reg_errors == 0, "%u steps left the wrong registers", (unsigned)s_rec.reg_errors);
+    CHECK(s_timer.overruns == 0 && s_timer.missed == 0, "timer overruns %u missed %u",
+          (unsigned)s_timer.overruns, (unsigned)s_timer.missed);
+    CHECK(AD9833_Model_Violations(&s_chip[0]) == 0 && AD9833_Model_Violations(&s_chip[1]) == 0,
+          "bus timing violations");
+
+    CHECK(s_rec.drift_errors == 0, "%u steps wrote at a different offset from the previous loop",
+          (unsigned)s_rec.drift_errors);
+    CHECK(s_rec.offset_max < SIM_TIMER_BUDGET_NS, "first word %llu ns after the update",
+          (unsigned long long)s_rec.offset_max);
+    printf("  first word %llu..%llu ns after the timer update\n", (unsigned long long)s_rec.offset_min,
+           (unsigned long long)s_rec.offset_max);
+    printf("  %u steps over %u ticks, timer ISR max %llu ns (budget %u), latency max %llu ns\n",
+           (unsigned)s_rec.executed, (unsigned)s_rec.last_tick,
+           (unsigned long long)s_timer.duration_max_ns, (unsigned)SIM_TIMER_BUDGET_NS,
+           (unsigned long long)s_timer.latency_max_ns);
+}
+
+/**
+ * @brief       播放中经 DMA 收到 SEQ_STATUS 和 SEQ_STOP
+ * @retval      无
+ */
+static void Test_DmaStop(void)
+{
+    uint8_t frame[AD9833_PROTO_FRAME_MAX];
+    uint16_t len;
+
+    Sim_Setup();
+    AD9833_Seq_Init();
+    Sim_LoadTable(0);
+    AD9833_Seq_SetTimed(1);
+    AD9833_Proto_Init(Sim_Send, NULL);
+    CHECK(AD9833_Proto_RxStart(s_rx_buf, SIM_RX_SIZE) == HAL_OK, "RxStart refused");
+    s_reply_num = 0;
+    s_stop_ns = 0;
+    s_polling = 1;
+
+    AD9833_Sim_Init(AD9833_SIM_ENTRY_NS);
+    AD9833_Sim_AddTimer(&s_timer, "TIM6", 2, SIM_TICK_NS, Sim_TimerIsr, NULL);
+    AD9833_Sim_AddDma(&s_rx, "USART1_RX", 1, s_rx_buf, SIM_RX_SIZE, Sim_RxIsr, NULL);
+    CHECK(AD9833_Seq_Run(0, AD9833_SEQ_LEN, 0) == HAL_OK, "Run refused");
+
+    uint64_t t0 = Mock_Now();
+    len = AD9833_Proto_Encode(AD9833_PROTO_SEQ_STATUS, NULL, 0, frame);
+    AD9833_SimDma_Feed(&s_rx, t0 + 30000000ULL, SIM_BYTE_NS, frame, len);
+    len = AD9833_Proto_Encode(AD9833_PROTO_SEQ_STOP, NULL, 0, frame);
+    AD9833_SimDma_Feed(&s_rx, t0 + 50000000ULL, SIM_BYTE_NS, frame, len);
+
+    AD9833_Sim_Run(t0 + 200000000ULL, Sim_MainLoop);
+
+    AD9833_SeqState st;
+    AD9833_Seq_GetState(&st);
+    CHECK(!st.running, "sequence still running");
+    CHECK(s_stop_ns != 0U, "stop never executed by the main loop");
+    CHECK(st.steps == s_stop_steps && s_rec.executed == s_stop_steps, "%u steps after the stop",
+          (unsigned)(st.steps - s_stop_steps));
+    CHECK(s_rec.last_word_ns < s_stop_ns, "bus word at %llu ns after the main loop stopped the sequence at %llu ns",
+          (unsigned long long)s_rec.last_word_ns, (unsigned long long)s_stop_ns);
+    CHECK(s_reply_num == 2U, "%u replies", (unsigned)s_reply_num);
+    CHECK(s_reply[0][2] == (AD9833_PROTO_SEQ_STATUS | AD9833_PROTO_REPLY) && s_reply[0][3] == AD9833_PROTO_OK &&
+          s_reply[0][4] == 1U, "status reply %02X %02X running %u", s_reply[0][2], s_reply[0][3], s_reply[0][4]);
+    CHECK(s_reply[1][2] == (AD9833_PROTO_SEQ_STOP | AD9833_PROTO_REPLY) && s_reply[1][3] == AD9833_PROTO_OK,
+          "stop reply %02X %02X", s_reply[1][2], s_reply[1][3]);
+    CHECK(s_rx.event == AD9833_SIM_DMA_IDLE && s_rx.bytes == 2U * len, "rx event %02X bytes %u",
+          (unsigned)s_rx.event, (unsigned)s_rx.bytes);
+    CHECK(s_rx.irq.fires == 2U, "rx ISR fired %u times", (unsigned)s_rx.irq.fires);
+    printf("  stopped after %u steps, %.3f ms after the frame was queued\n",
+           (unsigned)s_stop_steps, (double)(s_stop_ns - (t0 + 50000000ULL)) / 1e6);
+}
+
+/**
+ * @brief       主循环停顿时 DMA 写过整个缓冲区: 丢弃后重新同步, 定时播放照常
+ * @retval      无
+ */
+static void Test_DmaLap(void)
+{
+    uint8_t stall[SIM_RX_SIZE + 2U * AD9833_PROTO_FRAME_MAX];
+    uint8_t frame[AD9833_PROTO_FRAME_MAX];
+    uint16_t len = AD9833_Proto_Encode(AD9833_PROTO_SEQ_STATUS, NULL, 0, frame);
+    uint32_t stall_len = 0;
+    AD9833_ProtoStat stat;
+    AD9833_SeqState st;
+
+    while (stall_len + len <= sizeof(stall))
+    {
+        memcpy(&stall[stall_len], frame, len);
+        stall_len += len;
+    }
+
+    Sim_Setup();
+    AD9833_Seq_Init();
+    Sim_LoadTable(0);
+    AD9833_Seq_SetTimed(1);
+    AD9833_Proto_Init(Sim_Send, NULL);
+    CHECK(AD9833_Proto_RxStart(s_rx_buf, SIM_RX_SIZE) == HAL_OK, "RxStart refused");
+    s_reply_num = 0;
+    s_stop_ns = 0;
+
+    AD9833_Sim_Init(AD9833_SIM_ENTRY_NS);
+    AD9833_Sim_AddTimer(&s_timer, "TIM6", 2, SIM_TICK_NS, Sim_TimerIsr, NULL);
+    AD9833_Sim_AddDma(&s_rx, "USART1_RX", 1, s_rx_buf, SIM_RX_SIZE, Sim_RxIsr, NULL);
+    CHECK(AD9833_Seq_Run(0, AD9833_SEQ_LEN, 0) == HAL_OK, "Run refused");
+
+    // 停顿期间收到 stall_len 字节, 超过缓冲区
+    uint64_t t0 = Mock_Now();
+    s_polling = 0;
+    AD9833_SimDma_Feed(&s_rx, t0 + 1000000ULL, SIM_BYTE_NS, stall, stall_len);
+    AD9833_Sim_Run(t0 + 1000000ULL + (uint64_t)(stall_len + 2U) * SIM_BYTE_NS, Sim_MainLoop);
+    uint32_t stalled_steps = s_rec.executed;
+    s_polling = 1;
+    AD9833_Sim_Run(Mock_Now() + 1000000ULL, Sim_MainLoop);
+
+    AD9833_Proto_GetStat(&stat);
+    CHECK(stat.lost > 0U && stat.lost <= stall_len, "lost %u of %u bytes", (unsigned)stat.lost, (unsigned)stall_len);
+    CHECK(stat.frames == s_reply_num && stat.lost + stat.frames * len == stall_len,
+          "%u frames, %u replies, %u lost of %u bytes", (unsigned)stat.frames, (unsigned)s_reply_num,
+          (unsigned)stat.lost, (unsigned)stall_len);
+    CHECK(stalled_steps > 0U, "no steps played while the main loop stalled");
+
+    // 重新同步后停止命令照常执行
+    t0 = Mock_Now();
+    len = AD9833_Proto_Encode(AD9833_PROTO_SEQ_STOP, NULL, 0, frame);
+    AD9833_SimDma_Feed(&s_rx, t0 + 1000000ULL, SIM_BYTE_NS, frame, len);
+    AD9833_Sim_Run(t0 + 20000000ULL, Sim_MainLoop);
+
+    AD9833_Seq_GetState(&st);
+    CHECK(!st.running && s_stop_ns != 0U, "sequence still running after the resync");
+    CHECK(s_reply_num == stat.frames + 1U && s_reply[stat.frames][2] == (AD9833_PROTO_SEQ_STOP | AD9833_PROTO_REPLY),
+          "%u replies after the resync", (unsigned)s_reply_num);
+    CHECK(s_rec.tick_errors == 0 && s_rec.order_errors == 0 && s_rec.mask_errors == 0,
+          "ticks %u order %u mask %u errors", (unsigned)s_rec.tick_errors, (unsigned)s_rec.order_errors,
+          (unsigned)s_rec.mask_errors);
+    printf("  main loop stalled for %u bytes: %u lost, %u frames parsed, %u steps played meanwhile\n",
+           (unsigned)stall_len, (unsigned)stat.lost, (unsigned)stat.frames, (unsigned)stalled_steps);
+}
+
+/**
+ * @brief       中断放不下时的检测: 缩短周期和预算
+ * @retval      无
+ */
+static void Test_Overrun(void)
+{
+    Sim_Setup();
+    AD9833_Seq_Init();
+    Sim_LoadTable(0);
+    AD9833_Seq_SetTimed(1);
+
+    AD9833_Sim_Init(AD9833_SIM_ENTRY_NS);
+    AD9833_Sim_AddTimer(&s_timer, "TIM6", 2, 4000U, Sim_TimerIsr, NULL);
+    s_timer.budget_ns = 2000U;
+    CHECK(AD9833_Seq_Run(0, AD9833_SEQ_LEN, 1) == HAL_OK, "Run refused");
+
+    AD9833_Sim_Run(Mock_Now() + 5000000ULL, NULL);
+
+    CHECK(s_rec.executed == AD9833_SEQ_LEN, "%u steps", (unsigned)s_rec.executed);
+    CHECK(s_timer.overruns == s_rec.executed, "overruns %u for %u executing ticks",
+          (unsigned)s_timer.overruns, (unsigned)s_rec.executed);
+    CHECK(s_timer.missed > 0U, "no missed updates with a %u ns ISR in a 4000 ns period",
+          (unsigned)s_timer.duration_max_ns);
+    printf("  4 us tick: %u overruns, %u updates merged, ISR max %llu ns\n", (unsigned)s_timer.overruns,
+           (unsigned)s_timer.missed, (unsigned long long)s_timer.duration_max_ns);
+}
+
+static uint32_t s_main_writes = 0;
+static uint32_t s_main_word[2];
+
+/**
+ * @brief       主循环: 交替改写 CS1 两个频率寄存器的频率字
+ */
+static void Sim_MainFreq(void)
+{
+    uint32_t reg = s_main_writes & 1U;
+    uint32_t word = (s_main_writes * 2654435761UL) & 0x0FFFFFFFUL;
+
+    AD9833_FreqSetRaw(CS1, (uint8_t)reg, word);
+    s_main_word[reg] = word;
+    s_main_writes++;
+}
+
+/**
+ * @brief       主循环写 CS1 的同时, 抢占主循环的定时器中断播放 CS2 的序列
+ * @retval      无
+ */
+static void Test_Interleave(void)
+{
+    Sim_Setup();
+    AD9833_Seq_Init();
+    Sim_LoadTable(0x02U);
+    AD9833_Seq_SetTimed(1);
+    s_main_writes = 0;
+
+    AD9833_Sim_Init(AD9833_SIM_ENTRY_NS);
+    AD9833_Sim_AddTimer(&s_timer, "TIM6", 2, SIM_TICK_NS, Sim_TimerIsr, NULL);
+    Mock_STM32_SetPreemptHook(AD9833_Sim_Preempt);
+    CHECK(AD9833_Seq_Run(0, AD9833_SEQ_LEN, 2) == HAL_OK, "Run refused");
+
+    AD9833_Sim_Run(Mock_Now() + 500000000ULL, Sim_MainFreq);
+    Mock_STM32_SetPreemptHook(NULL);
+
+    CHECK(s_rec.executed == 2U * AD9833_SEQ_LEN, "%u steps", (unsigned)s_rec.executed);
+    CHECK(s_timer.preempts > 0U, "%u of %u timer ISRs preempted the main loop",
+          (unsigned)s_timer.preempts, (unsigned)s_timer.fires);
+    CHECK(s_rec.mask_errors == 0, "%u writes to the wrong chip", (unsigned)s_rec.mask_errors);
+    CHECK(s_rec.reg_errors == 0, "%u steps left the wrong CS2 registers", (unsigned)s_rec.reg_errors);
+    CHECK(s_chip[0].freq[0] == s_main_word[0] && s_chip[0].freq[1] == s_main_word[1],
+          "CS1 FREQ0 %07X FREQ1 %07X, main loop wrote %07X %07X", (unsigned)s_chip[0].freq[0],
+          (unsigned)s_chip[0].freq[1], (unsigned)s_main_word[0], (unsigned)s_main_word[1]);
+    CHECK(AD9833_Model_Violations(&s_chip[0]) == 0 && AD9833_Model_Violations(&s_chip[1]) == 0,
+          "bus timing violations");
+    printf("  %u main-loop writes to CS1, %u timer ISRs preempted them, latency max %llu ns\n",
+           (unsigned)s_main_writes, (unsigned)s_timer.preempts, (unsigned long long)s_timer.latency_max_ns);
+}
+
+int main(void)
+{
+    Test_LongRun();
+    Test_DmaStop();
+    Test_DmaLap();
+    Test_Overrun();
+    Test_Interleave();
+
+    printf("[soft] seq sim %s (%u failures)\n", s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
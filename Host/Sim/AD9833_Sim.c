@@ -0,0 +1,373 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Sim.c
+  * @brief          : 主机上的虚拟定时器、DMA 与中断调度
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 调度循环：把 DMA 流中已到达的字节写入缓冲区，执行已挂起的最高优先级
+  * 中断；没有挂起的中断时执行一次主循环，主循环不推进时间时直接跳到下一个
+  * 事件 (定时器到期、字节到达或空闲检测)。服务函数进入时清除挂起标志，
+  * 执行期间发生的请求在返回后再次挂起，与硬件的行为相同。
+  * 主循环执行期间，AD9833_Sim_Preempt() 在模拟层回调它的位置执行已挂起的
+  * 中断 (抢占)；服务函数执行期间不再进入 (不嵌套)。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Sim.h"
+#include <string.h>
+
+static AD9833_SimIrq* s_irq[AD9833_SIM_IRQ_MAX];
+static uint32_t s_irq_num = 0;
+static uint32_t s_entry_ns = AD9833_SIM_ENTRY_NS;
+static AD9833_SimDispatchHook s_hook = NULL;
+static uint8_t s_in_main = 0;
+static uint8_t s_in_isr = 0;
+
+/**
+ * @brief       清除全部中断源
+ * @param       entry_ns: 中断响应时间 (纳秒)
+ * @retval      无
+ */
+void AD9833_Sim_Init(uint32_t entry_ns)
+{
+    s_irq_num = 0;
+    s_entry_ns = entry_ns;
+    s_hook = NULL;
+    s_in_main = 0;
+    s_in_isr = 0;
+}
+
+/**
+ * @brief       设置执行记录回调
+ * @param       hook: 回调, NULL 为取消
+ * @retval      无
+ */
+void AD9833_Sim_SetDispatchHook(AD9833_SimDispatchHook hook)
+{
+    s_hook = hook;
+}
+
+/**
+ * @brief       登记中断源
+ */
+static void AD9833_Sim_Add(AD9833_SimIrq* irq, const char* name, uint8_t priority, AD9833_SimIsr isr, void* ctx)
+{
+    memset(irq, 0, sizeof(*irq));
+    irq->name = name;
+    irq->priority = priority;
+    irq->isr = isr;
+    irq->ctx = ctx;
+    irq->request_ns = UINT64_MAX;
+    if (s_irq_num < AD9833_SIM_IRQ_MAX) s_irq[s_irq_num++] = irq;
+}
+
+/**
+ * @brief       登记定时器, 从当前时刻起每 period_ns 产生一次更新
+ * @note        耗时预算默认取周期, 可在登记后修改 irq->budget_ns
+ * @param       irq: 中断源
+ * @param       name: 名称
+ * @param       priority: 优先级
+ * @param       period_ns: 周期 (纳秒)
+ * @param       isr: 服务函数
+ * @param       ctx: 服务函数的参数
+ * @retval      无
+ */
+void AD9833_Sim_AddTimer(AD9833_SimIrq* irq, const char* name, uint8_t priority, uint64_t period_ns,
+                         AD9833_SimIsr isr, void* ctx)
+{
+    AD9833_Sim_Add(irq, name, priority, isr, ctx);
+    irq->period_ns = period_ns;
+    irq->budget_ns = period_ns;
+    irq->request_ns = Mock_Now() + period_ns;
+}
+
+/**
+ * @brief       登记 DMA 流 (外设到内存, 循环模式)
+ * @param       dma: DMA 流
+ * @param       name: 名称
+ * @param       priority: 优先级
+ * @param       buf: 循环缓冲区
+ * @param       size: 缓冲区字节数 (偶数)
+ * @param       isr: 服务函数, 在其中读取 dma->event 和 dma->pos
+ * @param       ctx: 服务函数的参数
+ * @retval      无
+ */
+void AD9833_Sim_AddDma(AD9833_SimDma* dma, const char* name, uint8_t priority, uint8_t* buf, uint16_t size,
+                       AD9833_SimIsr isr, void* ctx)
+{
+    memset(dma, 0, sizeof(*dma));
+    AD9833_Sim_Add(&dma->irq, name, priority, isr, ctx);
+    dma->irq.dma = dma;
+    dma->buf = buf;
+    dma->size = size;
+    dma->last_ns = Mock_Now();
+    dma->idle_ns = UINT64_MAX;
+    dma->err_ns = UINT64_MAX;
+}
+
+/**
+ * @brief       安排输入数据: 字节依次到达, 接在上一次安排的数据之后
+ * @note        一段数据的最后一个字节之后空闲一个字节时间产生 IDLE; 下一段
+ *              紧接着到达时 (at_ns 不晚于上一段结束) 不产生
+ * @param       dma: DMA 流
+ * @param       at_ns: 第一个字节开始发送的时刻
+ * @param       byte_ns: 每字节时间 (如 115200bps 8N1 为 86806ns)
+ * @param       data: 数据
+ * @param       len: 字节数
+ * @retval      安排的字节数 (FIFO 满时少于 len)
+ */
+uint32_t AD9833_SimDma_Feed(AD9833_SimDma* dma, uint64_t at_ns, uint32_t byte_ns, const uint8_t* data, uint32_t len)
+{
+    uint64_t t = (at_ns > dma->last_ns) ? at_ns : dma->last_ns;
+    uint32_t n = 0;
+
+    while (n < len && dma->fifo_num < AD9833_SIM_DMA_FIFO)
+    {
+        uint32_t k = (dma->fifo_head + dma->fifo_num) % AD9833_SIM_DMA_FIFO;
+
+        t += byte_ns;
+        dma->fifo[k] = data[n];
+        dma->fifo_time[k] = t;
+        dma->fifo_end[k] = (n + 1U == len) ? 1U : 0U;
+        dma->fifo_num++;
+        n++;
+    }
+    if (n)
+    {
+        dma->fifo_end[(dma->fifo_head + dma->fifo_num - 1U) % AD9833_SIM_DMA_FIFO] = 1U;
+        dma->last_ns = t;
+        dma->frame_ns = byte_ns;
+    }
+    return n;
+}
+
+/**
+ * @brief       安排一次接收错误
+ * @note        到时产生 ERR 请求并停止写入, 与 HAL 在错误中断中中止 DMA 相同
+ * @param       dma: DMA 流
+ * @param       at_ns: 出错时刻
+ * @retval      无
+ */
+void AD9833_SimDma_Error(AD9833_SimDma* dma, uint64_t at_ns)
+{
+    dma->err_ns = at_ns;
+}
+
+/**
+ * @brief       接收错误后重新启动, 从缓冲区起点写入
+ * @note        在服务函数中调用, 对应 HAL_UARTEx_ReceiveToIdle_DMA
+ * @param       dma: DMA 流
+ * @retval      无
+ */
+void AD9833_SimDma_Restart(AD9833_SimDma* dma)
+{
+    dma->pos = 0;
+    dma->halted = 0;
+    dma->flags &= (uint8_t)~(AD9833_SIM_DMA_HT | AD9833_SIM_DMA_TC | AD9833_SIM_DMA_IDLE);
+    dma->idle_ns = UINT64_MAX;
+}
+
+/**
+ * @brief       置位 DMA 事件并挂起请求
+ */
+static void AD9833_SimDma_Flag(AD9833_SimDma* dma, uint8_t flag, uint64_t t)
+{
+    dma->flags |= flag;
+    if (t < dma->irq.request_ns) dma->irq.request_ns = t;
+}
+
+/**
+ * @brief       写入到当前时刻为止到达的字节, 产生 HT / TC / IDLE 事件
+ * @note        下一个字节与空闲检测同时到达时按未空闲处理
+ * @param       dma: DMA 流
+ * @param       now: 当前时刻
+ * @retval      无
+ */
+static void AD9833_SimDma_Sync(AD9833_SimDma* dma, uint64_t now)
+{
+    for (;;)
+    {
+        uint64_t t_byte = dma->fifo_num ? dma->fifo_time[dma->fifo_head] : UINT64_MAX;
+
+        if (dma->err_ns <= t_byte && dma->err_ns <= now)
+        {
+            AD9833_SimDma_Flag(dma, AD9833_SIM_DMA_ERR, dma->err_ns);
+            dma->err_ns = UINT64_MAX;
+            dma->halted = 1;
+            dma->idle_ns = UINT64_MAX;
+            continue;
+        }
+        if (dma->idle_ns < t_byte && dma->idle_ns <= now)
+        {
+            AD9833_SimDma_Flag(dma, AD9833_SIM_DMA_IDLE, dma->idle_ns);
+            dma->idle_ns = UINT64_MAX;
+            continue;
+        }
+        if (t_byte > now) break;
+
+        uint32_t k = dma->fifo_head;
+
+        if (dma->halted)
+        {
+            dma->dropped++;
+            dma->fifo_head = (k + 1U) % AD9833_SIM_DMA_FIFO;
+            dma->fifo_num--;
+            continue;
+        }
+        dma->buf[dma->pos++] = dma->fifo[k];
+        dma->bytes++;
+        if (dma->pos == dma->size / 2U) AD9833_SimDma_Flag(dma, AD9833_SIM_DMA_HT, t_byte);
+        if (dma->pos == dma->size)
+        {
+            dma->pos = 0;
+            AD9833_SimDma_Flag(dma, AD9833_SIM_DMA_TC, t_byte);
+        }
+        dma->idle_ns = dma->fifo_end[k] ? t_byte + dma->frame_ns : UINT64_MAX;
+        dma->fifo_head = (k + 1U) % AD9833_SIM_DMA_FIFO;
+        dma->fifo_num--;
+    }
+}
+
+/**
+ * @brief       DMA 流的下一个事件时刻 (字节到达或空闲检测)
+ */
+static uint64_t AD9833_SimDma_Next(const AD9833_SimDma* dma)
+{
+    uint64_t t = dma->fifo_num ? dma->fifo_time[dma->fifo_head] : UINT64_MAX;
+
+    if (dma->err_ns < t) t = dma->err_ns;
+    return (dma->idle_ns < t) ? dma->idle_ns : t;
+}
+
+/**
+ * @brief       执行一个中断
+ * @param       irq: 中断源
+ * @retval      无
+ */
+static void AD9833_Sim_Dispatch(AD9833_SimIrq* irq)
+{
+    uint64_t request = irq->request_ns;
+    uint64_t entry = Mock_Now();
+
+    // 进入时清除挂起标志, 执行期间的新请求在返回后挂起
+    if (irq->period_ns)
+    {
+        uint64_t n = (entry - request) / irq->period_ns + 1U;
+        irq->missed += (uint32_t)(n - 1U);
+        irq->request_ns = request + n * irq->period_ns;
+    }
+    else
+    {
+        irq->request_ns = UINT64_MAX;
+    }
+    if (irq->dma)
+    {
+        irq->dma->event = irq->dma->flags;
+        irq->dma->flags = 0;
+    }
+
+    s_in_isr = 1;
+    Mock_Advance(s_entry_ns);
+    irq->isr(irq, irq->ctx);
+    s_in_isr = 0;
+
+    uint64_t exit = Mock_Now();
+    uint64_t duration = exit - entry;
+
+    irq->fires++;
+    if (entry - request > irq->latency_max_ns) irq->latency_max_ns = entry - request;
+    if (duration > irq->duration_max_ns) irq->duration_max_ns = duration;
+    if (irq->budget_ns && duration > irq->budget_ns) irq->overruns++;
+    if (s_hook) s_hook(irq, entry, exit);
+}
+
+/**
+ * @brief       同步各 DMA 流并取出已挂起的最高优先级中断
+ * @param       now: 当前时刻
+ * @retval      中断源, 没有挂起的中断时为 NULL
+ */
+static AD9833_SimIrq* AD9833_Sim_Pending(uint64_t now)
+{
+    AD9833_SimIrq* pick = NULL;
+
+    for (uint32_t i = 0; i < s_irq_num; i++)
+    {
+        AD9833_SimIrq* irq = s_irq[i];
+
+        if (irq->dma) AD9833_SimDma_Sync(irq->dma, now);
+        if (irq->request_ns <= now && (!pick || irq->priority < pick->priority)) pick = irq;
+    }
+    return pick;
+}
+
+/**
+ * @brief       运行到指定时刻
+ * @note        返回时虚拟时间不早于 until_ns (中断或主循环可能越过)
+ * @param       until_ns: 结束时刻
+ * @param       main_loop: 主循环的一次执行, 可为 NULL
+ * @retval      无
+ */
+void AD9833_Sim_Run(uint64_t until_ns, void (*main_loop)(void))
+{
+    for (;;)
+    {
+        uint64_t now = Mock_Now();
+        AD9833_SimIrq* pick = AD9833_Sim_Pending(now);
+        uint64_t next = UINT64_MAX;
+
+        if (pick)
+        {
+            AD9833_Sim_Dispatch(pick);
+            continue;
+        }
+        if (now >= until_ns) break;
+
+        if (main_loop)
+        {
+            s_in_main = 1;
+            main_loop();
+            s_in_main = 0;
+            if (Mock_Now() != now) continue;
+        }
+
+        for (uint32_t i = 0; i < s_irq_num; i++)
+        {
+            uint64_t t = s_irq[i]->request_ns;
+
+            if (s_irq[i]->dma)
+            {
+                uint64_t t_dma = AD9833_SimDma_Next(s_irq[i]->dma);
+                if (t_dma < t) t = t_dma;
+            }
+            if (t < next) next = t;
+        }
+        if (next > until_ns) next = until_ns;
+        Mock_Advance(next - now);
+    }
+}
+
+/**
+ * @brief       在主循环中执行已挂起的中断 (抢占主循环)
+ * @note        由模拟层在每次 GPIO 操作之后和开中断时调用 (如
+ *              Mock_STM32_SetPreemptHook(AD9833_Sim_Preempt)); 不在主循环中
+ *              或已在服务函数中时直接返回
+ * @retval      无
+ */
+void AD9833_Sim_Preempt(void)
+{
+    AD9833_SimIrq* pick;
+
+    if (!s_in_main || s_in_isr) return;
+
+    while ((pick = AD9833_Sim_Pending(Mock_Now())) != NULL)
+    {
+        pick->preempts++;
+        AD9833_Sim_Dispatch(pick);
+    }
+}
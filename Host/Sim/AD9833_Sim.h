@@ -0,0 +1,155 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Sim.h
+  * @brief          : 主机上的虚拟定时器、DMA 与中断调度, 用于运行中断中的真实代码
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 以 Mock_HAL 的虚拟时钟为时基，模拟中断源并调度中断服务函数：
+  * - 定时器: 按周期产生更新请求，中断未处理时再次到期的更新合并为一个
+  *   (计入 missed)，与硬件的挂起标志相同。
+  * - DMA (外设到内存，循环模式): 按每字节时间把输入数据写入循环缓冲区，
+  *   写到一半、写到末尾 (回绕) 和最后一个字节后空闲一个字节时间时分别
+  *   产生 HT / TC / IDLE 请求，对应 HAL_UARTEx_ReceiveToIdle_DMA 的三种回调。
+  *   `AD9833_SimDma_Error()` 安排一次接收错误 (噪声、帧错误)：产生 ERR 请求
+  *   (对应 HAL_UART_ErrorCallback) 并停止写入，之后到达的字节丢弃，直到服务
+  *   函数调用 `AD9833_SimDma_Restart()` 从缓冲区起点重新接收。
+  * - 调度: 中断不嵌套，同时挂起的请求按优先级 (数值小的先) 依次执行，
+  *   优先级相同时按登记顺序。进入中断先经过 entry_ns 的响应时间，服务
+  *   函数中的驱动调用经模拟层推进时间，因此中断的实际耗时可测。
+  *
+  * 每个中断源统计执行次数、最大响应延迟 (请求到进入)、最大耗时、超出
+  * 预算 (budget_ns) 的次数和合并丢失的更新数；每次执行后调用 on_dispatch
+  * 回调，可用于检查执行顺序。主循环的代码通过 AD9833_Sim_Run() 的 main_loop
+  * 参数执行，中断默认只在主循环两次调用之间发生；把 AD9833_Sim_Preempt()
+  * 登记为模拟层的抢占回调 (Mock_STM32_SetPreemptHook) 后，中断也可在主循环
+  * 的任意两次 GPIO 操作之间执行，PRIMASK 置位期间推迟到开中断时。
+  *
+  * 使用方法：
+  * 1. 复位模拟层后调用 `AD9833_Sim_Init()`。
+  * 2. 用 `AD9833_Sim_AddTimer()` / `AD9833_Sim_AddDma()` 登记中断源。
+  * 3. 调用 `AD9833_SimDma_Feed()` 安排输入数据。
+  * 4. 调用 `AD9833_Sim_Run()` 运行到指定时刻，然后检查统计。
+  *
+  ******************************************************************************
+  */
+
+#ifndef _AD9833_SIM_H
+#define _AD9833_SIM_H
+
+#include <stdint.h>
+#include "Mock_HAL.h"
+
+// 中断源个数上限
+#define AD9833_SIM_IRQ_MAX          8U
+
+// 一个 DMA 流中尚未写入的字节数上限
+#define AD9833_SIM_DMA_FIFO         1024U
+
+// 默认中断响应时间 (纳秒): Cortex-M4 168MHz 下约12个周期
+#define AD9833_SIM_ENTRY_NS         72U
+
+// DMA 事件标志
+#define AD9833_SIM_DMA_HT           0x01U
+#define AD9833_SIM_DMA_TC           0x02U
+#define AD9833_SIM_DMA_IDLE         0x04U
+#define AD9833_SIM_DMA_ERR          0x08U
+
+struct AD9833_SimIrq;
+
+// 中断服务函数
+typedef void (*AD9833_SimIsr)(struct AD9833_SimIrq* irq, void* ctx);
+
+/**
+ * @brief   中断源
+ *      @arg name: 名称
+ *      @arg priority: 优先级, 数值小的先执行
+ *      @arg isr/ctx: 服务函数及其参数
+ *      @arg budget_ns: 耗时预算, 0 为不检查 (定时器默认取周期)
+ *      @arg request_ns: 下一个请求的时刻, UINT64_MAX 为无
+ *      @arg fires: 执行次数
+ *      @arg overruns: 耗时超出预算的次数
+ *      @arg missed: 挂起期间再次到期而合并的更新数 (定时器)
+ *      @arg latency_max_ns: 请求到进入服务函数的最大延迟
+ *      @arg duration_max_ns: 服务函数的最大耗时 (含响应时间)
+ *      @arg preempts: 在主循环执行中途进入的次数 (AD9833_Sim_Preempt)
+ *      其余为内部状态
+ */
+typedef struct AD9833_SimIrq
+{
+    const char* name;
+    uint8_t priority;
+    AD9833_SimIsr isr;
+    void* ctx;
+    uint64_t budget_ns;
+    uint64_t request_ns;
+
+    uint32_t fires;
+    uint32_t overruns;
+    uint32_t missed;
+    uint64_t latency_max_ns;
+    uint64_t duration_max_ns;
+    uint32_t preempts;
+
+    uint64_t period_ns;
+    struct AD9833_SimDma* dma;
+} AD9833_SimIrq;
+
+/**
+ * @brief   DMA 流 (外设到内存, 循环模式)
+ *      @arg irq: 该流的中断源
+ *      @arg buf/size: 循环缓冲区
+ *      @arg pos: 下一个字节写入的位置 (size - NDTR)
+ *      @arg flags: 已发生、尚未交给服务函数的事件 (AD9833_SIM_DMA_*)
+ *      @arg bytes: 已写入的字节数
+ *      @arg halted: 接收错误后停止写入, 等待重新启动
+ *      @arg dropped: 停止期间丢弃的字节数
+ *      @arg err_ns: 下一次接收错误的时刻
+ *      其余为尚未写入的字节及其到达时刻
+ */
+typedef struct AD9833_SimDma
+{
+    AD9833_SimIrq irq;
+    uint8_t* buf;
+    uint16_t size;
+    uint16_t pos;
+    uint8_t flags;
+    uint8_t event;
+    uint32_t bytes;
+    uint8_t halted;
+    uint32_t dropped;
+    uint64_t err_ns;
+
+    uint8_t fifo[AD9833_SIM_DMA_FIFO];
+    uint8_t fifo_end[AD9833_SIM_DMA_FIFO];
+    uint64_t fifo_time[AD9833_SIM_DMA_FIFO];
+    uint32_t fifo_head;
+    uint32_t fifo_num;
+    uint64_t last_ns;
+    uint64_t idle_ns;
+    uint32_t frame_ns;
+} AD9833_SimDma;
+
+/**
+ * @brief   执行记录回调: 每次中断服务函数返回后调用
+ */
+typedef void (*AD9833_SimDispatchHook)(const AD9833_SimIrq* irq, uint64_t entry_ns, uint64_t exit_ns);
+
+/* 函数声明 */
+void AD9833_Sim_Init(uint32_t entry_ns);
+void AD9833_Sim_SetDispatchHook(AD9833_SimDispatchHook hook);
+void AD9833_Sim_AddTimer(AD9833_SimIrq* irq, const char* name, uint8_t priority, uint64_t period_ns,
+                         AD9833_SimIsr isr, void* ctx);
+void AD9833_Sim_AddDma(AD9833_SimDma* dma, const char* name, uint8_t priority, uint8_t* buf, uint16_t size,
+                       AD9833_SimIsr isr, void* ctx);
+uint32_t AD9833_SimDma_Feed(AD9833_SimDma* dma, uint64_t at_ns, uint32_t byte_ns, const uint8_t* data, uint32_t len);
+void AD9833_SimDma_Error(AD9833_SimDma* dma, uint64_t at_ns);
+void AD9833_SimDma_Restart(AD9833_SimDma* dma);
+void AD9833_Sim_Run(uint64_t until_ns, void (*main_loop)(void));
+void AD9833_Sim_Preempt(void);
+
+#endif /* _AD9833_SIM_H */
@@ -0,0 +1,311 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Spur.c
+  * @brief          : 按频率字的结构估计杂散, 在容差内挑选杂散最小的频率字
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 各 L 的杂散在 `AD9833_Spur_Init()` 中算好 (L >= 16 的DFT总共约一千万次
+  * 乘加)，之后的估计和挑选只查表，可在多个线程中同时调用。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Spur.h"
+#include <math.h>
+#include <pthread.h>
+#include <string.h>
+
+#define AD9833_SPUR_LUT_SIZE        (1U << AD9833_SPUR_PHASE_BITS)
+#define AD9833_SPUR_ZEROS_NUM       (AD9833_SPUR_ACC_BITS - 1U)     // 有效频率字的 L 为 0~26
+
+/**
+ * @brief   每种 L 的杂散
+ *      @arg trunc_sfdr/dac_sfdr/sfdr: 同 AD9833_SpurWord
+ *      @arg dac_bin: L >= 16 时, M/2^L = 1 的输出中最大杂散的DFT点
+ */
+typedef struct
+{
+    double trunc_sfdr;
+    double dac_sfdr;
+    double sfdr;
+    uint32_t dac_bin;
+} AD9833_SpurClass;
+
+static AD9833_SpurClass s_class[AD9833_SPUR_ZEROS_NUM];
+static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief       频率折叠到 0~fs/2
+ */
+static double AD9833_Spur_Fold(double f, double fs)
+{
+    f = fmod(f, fs);
+    if (f < 0.0) f += fs;
+    return (f > fs / 2.0) ? fs - f : f;
+}
+
+/**
+ * @brief       末尾0的个数
+ */
+static uint8_t AD9833_Spur_Zeros(uint32_t word)
+{
+    return word ? (uint8_t)__builtin_ctz(word) : (uint8_t)AD9833_SPUR_ACC_BITS;
+}
+
+/**
+ * @brief       T 点一个周期的正弦码表的SFDR
+ * @param       lut: 4096点码表
+ * @param       period: 点数 T (4~4096 的2的幂)
+ * @param       bin: 输出, 最大杂散的DFT点
+ * @retval      SFDR (dBc)
+ */
+static double AD9833_Spur_DacSfdr(const double* lut, uint32_t period, uint32_t* bin)
+{
+    static double s_cos[AD9833_SPUR_LUT_SIZE], s_sin[AD9833_SPUR_LUT_SIZE];
+    double y[AD9833_SPUR_LUT_SIZE];
+    uint32_t stride = AD9833_SPUR_LUT_SIZE / period;
+    double mean = 0.0, carrier = 0.0, spur = 0.0;
+
+    for (uint32_t i = 0; i < AD9833_SPUR_LUT_SIZE; i++)
+    {
+        s_cos[i] = cos(2.0 * M_PI * i / AD9833_SPUR_LUT_SIZE);
+        s_sin[i] = sin(2.0 * M_PI * i / AD9833_SPUR_LUT_SIZE);
+    }
+    for (uint32_t j = 0; j < period; j++) mean += lut[j * stride];
+    mean /= period;
+    for (uint32_t j = 0; j < period; j++) y[j] = lut[j * stride] - mean;
+
+    *bin = 0;
+    for (uint32_t k = 1; k <= period / 2U; k++)
+    {
+        double re = 0.0, im = 0.0;
+        for (uint32_t j = 0; j < period; j++)
+        {
+            uint32_t idx = (k * j * stride) & (AD9833_SPUR_LUT_SIZE - 1U);
+            re += y[j] * s_cos[idx];
+            im -= y[j] * s_sin[idx];
+        }
+        double mag = re * re + im * im;
+        if (k == 1U) carrier = mag;
+        else if (mag > spur)
+        {
+            spur = mag;
+            *bin = k;
+        }
+    }
+    // 谱线低于双精度舍入的量级时视为没有杂散
+    if (spur <= carrier * 1e-20) return AD9833_SPUR_SFDR_NONE;
+    return 10.0 * log10(carrier / spur);
+}
+
+/**
+ * @brief       计算各 L 的杂散表
+ */
+static void AD9833_Spur_Build(void)
+{
+    static double lut[AD9833_SPUR_LUT_SIZE];
+
+    for (uint32_t i = 0; i < AD9833_SPUR_LUT_SIZE; i++)
+    {
+        long code = lround(511.5 + 511.5 * sin(2.0 * M_PI * i / AD9833_SPUR_LUT_SIZE));
+        lut[i] = (double)(code < 0 ? 0 : (code > 1023 ? 1023 : code));
+    }
+
+    for (uint32_t L = AD9833_SPUR_TRUNC_BITS; L < AD9833_SPUR_ZEROS_NUM; L++)
+    {
+        AD9833_SpurClass* c = &s_class[L];
+        c->trunc_sfdr = AD9833_SPUR_SFDR_NONE;
+        c->dac_sfdr = AD9833_Spur_DacSfdr(lut, 1U << (AD9833_SPUR_ACC_BITS - L), &c->dac_bin);
+    }
+    for (uint32_t L = 0; L < AD9833_SPUR_TRUNC_BITS; L++)
+    {
+        AD9833_SpurClass* c = &s_class[L];
+        double x = M_PI / (double)(1U << (AD9833_SPUR_TRUNC_BITS - L));
+        c->trunc_sfdr = 20.0 * AD9833_SPUR_PHASE_BITS * log10(2.0) - 20.0 * log10(x / sin(x));
+        c->dac_sfdr = s_class[AD9833_SPUR_TRUNC_BITS].dac_sfdr;
+        c->dac_bin = 0;
+    }
+    for (uint32_t L = 0; L < AD9833_SPUR_ZEROS_NUM; L++)
+    {
+        s_class[L].sfdr = fmin(s_class[L].trunc_sfdr, s_class[L].dac_sfdr);
+    }
+}
+
+/**
+ * @brief       计算各 L 的杂散表
+ * @note        只在第一次调用时计算, 可重复调用; 估计和挑选时会自动调用
+ * @retval      无
+ */
+void AD9833_Spur_Init(void)
+{
+    pthread_once(&s_once, AD9833_Spur_Build);
+}
+
+/**
+ * @brief       估计一个频率字的杂散
+ * @param       word: 频率字 (1 ~ AD9833_SPUR_WORD_MAX)
+ * @param       mclk: 主时钟 (Hz)
+ * @param       out: 输出
+ * @retval      无
+ */
+void AD9833_Spur_Analyze(uint32_t word, double mclk, AD9833_SpurWord* out)
+{
+    const double scale = mclk / (double)(1UL << AD9833_SPUR_ACC_BITS);
+    uint8_t L = AD9833_Spur_Zeros(word);
+
+    AD9833_Spur_Init();
+    memset(out, 0, sizeof(*out));
+    out->word = word;
+    out->zeros = L;
+    out->freq = word * scale;
+    if (L >= AD9833_SPUR_ZEROS_NUM) return;
+
+    const AD9833_SpurClass* c = &s_class[L];
+    out->trunc_sfdr = c->trunc_sfdr;
+    out->dac_sfdr = c->dac_sfdr;
+    out->sfdr = c->sfdr;
+
+    if (L < AD9833_SPUR_TRUNC_BITS)
+    {
+        // 截断误差锯齿的基波在 fs * (M mod 2^16) / 2^16, 杂散为其与载波的和频
+        uint32_t frac = word & ((1UL << AD9833_SPUR_TRUNC_BITS) - 1UL);
+        out->spur_freq = AD9833_Spur_Fold((word + (double)frac * (1UL << AD9833_SPUR_PHASE_BITS)) * scale, mclk);
+    }
+    else
+    {
+        // 输出是 M/2^L = 1 时序列的置换, 第 j 点的谱线移到 j * (M/2^L) mod T
+        uint32_t period = 1UL << (AD9833_SPUR_ACC_BITS - L);
+        uint32_t k = (uint32_t)(((uint64_t)c->dac_bin * (word >> L)) & (period - 1U));
+        if (k > period / 2U) k = period - k;
+        out->spur_freq = mclk * k / period;
+    }
+}
+
+/**
+ * @brief       在目标频率的容差内挑选估计SFDR最高的频率字
+ * @param       target: 目标频率 (Hz)
+ * @param       tol: 容差 (Hz), 为0或容差内没有频率字时只取最近的频率字
+ * @param       mclk: 主时钟 (Hz)
+ * @param       out: 输出
+ * @retval      0: 成功; -1: 目标频率不在 (0, fs/2) 内
+ */
+int AD9833_Spur_Pick(double target, double tol, double mclk, AD9833_SpurPick* out)
+{
+    const double per_hz = (double)(1UL << AD9833_SPUR_ACC_BITS) / mclk;
+    double t = target * per_hz;
+
+    memset(out, 0, sizeof(*out));
+    out->target = target;
+    if (!(t >= 0.5 && t < AD9833_SPUR_WORD_MAX + 0.5)) return -1;
+
+    AD9833_Spur_Init();
+    uint32_t nearest = (uint32_t)llround(t);
+    double lo = ceil((target - fabs(tol)) * per_hz), hi = floor((target + fabs(tol)) * per_hz);
+    if (lo < 1.0) lo = 1.0;
+    if (hi > (double)AD9833_SPUR_WORD_MAX) hi = (double)AD9833_SPUR_WORD_MAX;
+    if (lo > hi) lo = hi = nearest;
+
+    uint32_t best = nearest;
+    double best_err = fabs(nearest - t);
+    double best_sfdr = s_class[AD9833_Spur_Zeros(nearest)].sfdr;
+
+    for (uint32_t L = 0; L < AD9833_SPUR_ZEROS_NUM; L++)
+    {
+        // 末尾恰有 L 个0的频率字为 (2k+1) * 2^L, 取离目标最近的两个
+        double step = (double)(1UL << L);
+        double k0 = floor((t / step - 1.0) / 2.0);
+
+        for (double k = k0; k <= k0 + 1.0; k += 1.0)
+        {
+            double v = (2.0 * k + 1.0) * step;
+            if (k < 0.0 || v < lo || v > hi) continue;
+
+            double err = fabs(v - t);
+            double sfdr = s_class[L].sfdr;
+            if (sfdr > best_sfdr || (sfdr == best_sfdr && err < best_err))
+            {
+                best = (uint32_t)v;
+                best_err = err;
+                best_sfdr = sfdr;
+            }
+        }
+    }
+
+    AD9833_Spur_Analyze(best, mclk, &out->best);
+    AD9833_Spur_Analyze(nearest, mclk, &out->nearest);
+    return 0;
+}
+
+/**
+ * @brief   一个线程的工作
+ */
+typedef struct
+{
+    const double* target;
+    AD9833_SpurPick* out;
+    uint32_t num;
+    double tol;
+    double mclk;
+    uint32_t failed;
+} AD9833_SpurJob;
+
+static void* AD9833_Spur_Worker(void* arg)
+{
+    AD9833_SpurJob* job = (AD9833_SpurJob*)arg;
+
+    for (uint32_t i = 0; i < job->num; i++)
+    {
+        if (AD9833_Spur_Pick(job->target[i], job->tol, job->mclk, &job->out[i]) != 0) job->failed++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief       为一组目标频率挑选频率字 (扫频计划)
+ * @note        目标频率按连续的段分给各线程, 结果与单线程相同
+ * @param       target: 目标频率 (Hz)
+ * @param       num: 个数
+ * @param       tol: 容差 (Hz)
+ * @param       mclk: 主时钟 (Hz)
+ * @param       out: 输出, num 个; 目标频率无效时 best/nearest 为0
+ * @param       threads: 线程数 (0 或 1 为在调用者线程中计算, 最多 AD9833_SPUR_THREADS_MAX)
+ * @retval      目标频率无效的个数
+ */
+uint32_t AD9833_Spur_Plan(const double* target, uint32_t num, double tol, double mclk,
+                          AD9833_SpurPick* out, uint32_t threads)
+{
+    AD9833_SpurJob job[AD9833_SPUR_THREADS_MAX];
+    pthread_t tid[AD9833_SPUR_THREADS_MAX];
+    uint32_t failed = 0;
+
+    AD9833_Spur_Init();
+    if (threads > AD9833_SPUR_THREADS_MAX) threads = AD9833_SPUR_THREADS_MAX;
+    if (threads > num) threads = num;
+    if (threads < 1U) threads = 1;
+
+    for (uint32_t i = 0, first = 0; i < threads; i++)
+    {
+        uint32_t count = num / threads + (i < num % threads ? 1U : 0U);
+        job[i] = (AD9833_SpurJob){ &target[first], &out[first], count, tol, mclk, 0 };
+        first += count;
+    }
+
+    uint32_t started = 1;
+    for (uint32_t i = 1; i < threads; i++, started++)
+    {
+        if (pthread_create(&tid[i], NULL, AD9833_Spur_Worker, &job[i]) != 0) break;
+    }
+    AD9833_Spur_Worker(&job[0]);
+    for (uint32_t i = 1; i < threads; i++)
+    {
+        if (i < started) pthread_join(tid[i], NULL);
+        else AD9833_Spur_Worker(&job[i]);       // 线程创建失败时在本线程补算
+        failed += job[i].failed;
+    }
+    return failed + job[0].failed;
+}
@@ -0,0 +1,94 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Spur.h
+  * @brief          : 按频率字的结构估计杂散, 在容差内挑选杂散最小的频率字
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * AD9833 的28位相位累加器只取高12位查表 (截去低 B=16 位)，10位DAC输出。
+  * 频率字 M 的杂散只由它末尾0的个数 L (gcd(M, 2^28) = 2^L) 决定：
+  * - L < 16: 截断误差是周期 K = 2^(16-L) 的锯齿，最大杂散 (Nicholas &
+  *   Samueli) 为 2^-12 * (π/K) / sin(π/K)，即 -72.2dBc (M 为奇数) 到
+  *   -68.3dBc (L = 15)；杂散在 fout + fs * (M mod 2^16) / 2^16 (折叠后)。
+  * - L >= 16: 没有截断误差，输出周期为 T = 2^(28-L) 个样点，依次取查找表中
+  *   间隔 4096/T 的 T 个码值 (按 M/2^L 置换顺序)。置换只移动谱线位置、
+  *   不改变幅度，因此杂散等于 "T 点一个周期的正弦码表" 的DFT中除基波以外
+  *   的最大谱线，每个 L 只需算一次。
+  * 10位DAC量化在 L < 16 时分散到 2^(28-L) 点以上的周期中，取 T = 4096 的
+  * 结果作为下限。只计理想的截断与量化，不含DAC的非线性和时钟杂散。
+  *
+  * 正弦码表与 AD9833_Synth 相同 (12位相位 -> 10位码)，可用它合成验证。
+  *
+  * 在容差内挑选频率字时，对每个 L 直接算出离目标最近、末尾恰有 L 个0的
+  * 频率字 (M = (2k+1) * 2^L)，取估计SFDR最高者，相同时取频率误差最小者。
+  * 扫频计划按目标频率分给多个线程独立计算，结果与单线程相同。
+  *
+  * 结果中的频率字可直接交给固件：串口协议的 AD9833_PROTO_FREQ_RAW 命令、
+  * 序列表的 AD9833_SEQ_FREQ_RAW 步或 `AD9833_FreqSetRaw()`。
+  *
+  * 使用方法：
+  * 1. 调用 `AD9833_Spur_Analyze()` 估计一个频率字的杂散。
+  * 2. 调用 `AD9833_Spur_Pick()` 在目标频率的容差内挑选频率字。
+  * 3. 调用 `AD9833_Spur_Plan()` 用多个线程处理一组目标频率。
+  *
+  ******************************************************************************
+  */
+
+#ifndef _AD9833_SPUR_H
+#define _AD9833_SPUR_H
+
+#include <stdint.h>
+
+#define AD9833_SPUR_ACC_BITS        28U         // 相位累加器位数
+#define AD9833_SPUR_PHASE_BITS      12U         // 查表相位位数
+#define AD9833_SPUR_TRUNC_BITS      (AD9833_SPUR_ACC_BITS - AD9833_SPUR_PHASE_BITS)
+#define AD9833_SPUR_WORD_MAX        ((1UL << (AD9833_SPUR_ACC_BITS - 1U)) - 1UL)   // 低于 fs/2
+#define AD9833_SPUR_SFDR_NONE       200.0       // 没有该来源的杂散时的SFDR (dBc)
+#define AD9833_SPUR_THREADS_MAX     64U
+
+/**
+ * @brief   一个频率字的杂散估计
+ *      @arg word: 频率字
+ *      @arg zeros: 末尾0的个数 L
+ *      @arg freq: 输出频率 (Hz)
+ *      @arg trunc_sfdr: 相位截断杂散的SFDR (dBc), 无截断时为 AD9833_SPUR_SFDR_NONE
+ *      @arg dac_sfdr: DAC量化杂散的SFDR (dBc)
+ *      @arg sfdr: 两者中较小的
+ *      @arg spur_freq: 最大杂散的频率 (Hz, 折叠到 0~fs/2)
+ */
+typedef struct
+{
+    uint32_t word;
+    uint8_t zeros;
+    double freq;
+    double trunc_sfdr;
+    double dac_sfdr;
+    double sfdr;
+    double spur_freq;
+} AD9833_SpurWord;
+
+/**
+ * @brief   一个目标频率的挑选结果
+ *      @arg target: 目标频率 (Hz)
+ *      @arg best: 容差内估计SFDR最高的频率字
+ *      @arg nearest: 离目标最近的频率字 (用于比较)
+ */
+typedef struct
+{
+    double target;
+    AD9833_SpurWord best;
+    AD9833_SpurWord nearest;
+} AD9833_SpurPick;
+
+/* 函数声明 */
+void AD9833_Spur_Init(void);
+void AD9833_Spur_Analyze(uint32_t word, double mclk, AD9833_SpurWord* out);
+int AD9833_Spur_Pick(double target, double tol, double mclk, AD9833_SpurPick* out);
+uint32_t AD9833_Spur_Plan(const double* target, uint32_t num, double tol, double mclk,
+                          AD9833_SpurPick* out, uint32_t threads);
+
+#endif /* _AD9833_SPUR_H */
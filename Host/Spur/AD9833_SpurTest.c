@@ -0,0 +1,263 @@
+/**
+******************************************************************************
+  * @file           : AD9833_SpurTest.c
+  * @brief          : AD9833_Spur 的杂散估计与频率字挑选测试
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 按累加器、12位截断和10位码表逐样点生成一个完整周期的输出，与估计比较：
+  * - L >= 16: 整周期DFT的SFDR和最大杂散位置与估计相同 (验证置换关系)；
+  * - L < 16 (周期不超过 2^16 点的字): 估计位置上的谱线与基波之比符合
+  *   Nicholas 公式；
+  * - 挑选的频率字在容差内，且逐个枚举容差内的频率字没有估计更好的；
+  * - 多线程的扫频计划与单线程逐个挑选的结果完全相同。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Spur.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Host_Check.h"
+
+#define SPUR_MCLK                   25000000.0
+#define SPUR_PLAN_NUM               20000U
+
+static double s_lut[4096];
+
+/**
+ * @brief       生成与 AD9833_Synth 相同的正弦码表
+ * @retval      无
+ */
+static void Lut_Init(void)
+{
+    for (uint32_t i = 0; i < 4096U; i++)
+    {
+        long code = lround(511.5 + 511.5 * sin(2.0 * M_PI * i / 4096.0));
+        s_lut[i] = (double)(code < 0 ? 0 : (code > 1023 ? 1023 : code));
+    }
+}
+
+/**
+ * @brief       逐样点生成一个周期的输出 (去直流)
+ * @param       word: 频率字
+ * @param       period: 周期点数
+ * @retval      样点 (调用者释放)
+ */
+static double* Render(uint32_t word, uint32_t period)
+{
+    double* x = malloc(period * sizeof(double));
+    double mean = 0.0;
+    uint32_t acc = 0;
+
+    for (uint32_t n = 0; n < period; n++)
+    {
+        x[n] = s_lut[acc >> AD9833_SPUR_TRUNC_BITS];
+        acc = (acc + word) & ((1UL << AD9833_SPUR_ACC_BITS) - 1UL);
+        mean += x[n];
+    }
+    CHECK(acc == 0, "word 0x%07X: not periodic in %u samples", (unsigned)word, (unsigned)period);
+    for (uint32_t n = 0; n < period; n++) x[n] -= mean / period;
+    return x;
+}
+
+/**
+ * @brief       一个DFT点的功率
+ */
+static double Bin(const double* x, uint32_t period, uint32_t k)
+{
+    double re = 0.0, im = 0.0;
+
+    for (uint32_t n = 0; n < period; n++)
+    {
+        double a = 2.0 * M_PI * (double)(((uint64_t)k * n) % period) / period;
+        re += x[n] * cos(a);
+        im -= x[n] * sin(a);
+    }
+    return re * re + im * im;
+}
+
+/**
+ * @brief       各 L 的估计值与公式
+ * @retval      无
+ */
+static void Test_Classes(void)
+{
+    AD9833_SpurWord w;
+    double prev = 1e9;
+
+    for (uint32_t L = 0; L < AD9833_SPUR_TRUNC_BITS; L++)
+    {
+        AD9833_Spur_Analyze((1UL << L) | (1UL << 26), SPUR_MCLK, &w);
+        CHECK(w.zeros == L && w.trunc_sfdr <= prev + 1e-9, "L %u: truncation SFDR %.2f after %.2f",
+              (unsigned)L, w.trunc_sfdr, prev);
+        prev = w.trunc_sfdr;
+    }
+    AD9833_Spur_Analyze(0x0000001U, SPUR_MCLK, &w);
+    CHECK(fabs(w.trunc_sfdr - 72.25) < 0.01, "odd word: truncation SFDR %.3f", w.trunc_sfdr);
+    AD9833_Spur_Analyze(0x0008000U, SPUR_MCLK, &w);
+    CHECK(fabs(w.trunc_sfdr - 68.33) < 0.01, "L = 15: truncation SFDR %.3f", w.trunc_sfdr);
+    AD9833_Spur_Analyze(0x0010000U, SPUR_MCLK, &w);
+    CHECK(w.trunc_sfdr == AD9833_SPUR_SFDR_NONE && w.sfdr == w.dac_sfdr, "L = 16: truncation spur %.2f",
+          w.trunc_sfdr);
+}
+
+/**
+ * @brief       无截断的字: 整周期DFT
+ * @retval      无
+ */
+static void Test_Exact(void)
+{
+    static const uint32_t s_word[] = { 0x0010000U, 0x0350000U, 0x1FF0000U, 0x00A0000U, 0x0B40000U, 0x3C80000U };
+
+    for (uint32_t i = 0; i < sizeof(s_word) / sizeof(s_word[0]); i++)
+    {
+        AD9833_SpurWord w;
+        AD9833_Spur_Analyze(s_word[i], SPUR_MCLK, &w);
+
+        uint32_t period = 1UL << (AD9833_SPUR_ACC_BITS - w.zeros);
+        uint32_t carrier = (uint32_t)lround(w.freq * period / SPUR_MCLK);
+        double* x = Render(s_word[i], period);
+        double pc = 0.0, ps = 0.0;
+        uint32_t spur = 0;
+
+        for (uint32_t k = 1; k <= period / 2U; k++)
+        {
+            double p = Bin(x, period, k);
+            if (k == carrier) pc = p;
+            else if (p > ps)
+            {
+                ps = p;
+                spur = k;
+            }
+        }
+        free(x);
+
+        double sfdr = 10.0 * log10(pc / ps);
+        double spur_freq = SPUR_MCLK * spur / period;
+        printf("  0x%07X L=%2u: SFDR %.2f (estimate %.2f), spur %.0f Hz (estimate %.0f)\n", (unsigned)s_word[i],
+               (unsigned)w.zeros, sfdr, w.sfdr, spur_freq, w.spur_freq);
+        CHECK(fabs(sfdr - w.sfdr) < 0.01 && fabs(spur_freq - w.spur_freq) < 1e-6,
+              "0x%07X: measured %.2f dBc at %.0f Hz", (unsigned)s_word[i], sfdr, spur_freq);
+    }
+}
+
+/**
+ * @brief       有截断的字: 估计位置上的谱线
+ * @retval      无
+ */
+static void Test_Truncation(void)
+{
+    static const uint32_t s_word[] = { 0x0018000U, 0x0428000U, 0x0054000U, 0x0131000U };
+
+    for (uint32_t i = 0; i < sizeof(s_word) / sizeof(s_word[0]); i++)
+    {
+        AD9833_SpurWord w;
+        AD9833_Spur_Analyze(s_word[i], SPUR_MCLK, &w);
+
+        uint32_t period = 1UL << (AD9833_SPUR_ACC_BITS - w.zeros);
+        uint32_t carrier = (uint32_t)lround(w.freq * period / SPUR_MCLK);
+        uint32_t spur = (uint32_t)lround(w.spur_freq * period / SPUR_MCLK);
+        double* x = Render(s_word[i], period);
+        double sfdr = 10.0 * log10(Bin(x, period, carrier) / Bin(x, period, spur));
+        free(x);
+
+        printf("  0x%07X L=%2u: %.2f dBc at %.0f Hz (estimate %.2f)\n", (unsigned)s_word[i], (unsigned)w.zeros,
+               sfdr, w.spur_freq, w.trunc_sfdr);
+        CHECK(fabs(sfdr - w.trunc_sfdr) < 0.5, "0x%07X: measured %.2f dBc", (unsigned)s_word[i], sfdr);
+    }
+}
+
+/**
+ * @brief       挑选: 容差、与逐个枚举的比较
+ * @retval      无
+ */
+static void Test_Pick(void)
+{
+    AD9833_SpurPick pick;
+    const double per_hz = (double)(1UL << AD9833_SPUR_ACC_BITS) / SPUR_MCLK;
+
+    CHECK(AD9833_Spur_Pick(1e6, 0.0, SPUR_MCLK, &pick) == 0 && pick.best.word == pick.nearest.word &&
+          pick.best.word == 10737418U, "tolerance 0: word %u", (unsigned)pick.best.word);
+    CHECK(AD9833_Spur_Pick(1e6, 6000.0, SPUR_MCLK, &pick) == 0 && pick.best.word == 163U << 16,
+          "1 MHz +-6 kHz: word 0x%07X", (unsigned)pick.best.word);
+    CHECK(AD9833_Spur_Pick(0.0, 1.0, SPUR_MCLK, &pick) != 0 &&
+          AD9833_Spur_Pick(SPUR_MCLK / 2.0, 1.0, SPUR_MCLK, &pick) != 0, "out-of-range targets accepted");
+
+    srand(7);
+    for (uint32_t i = 0; i < 40U; i++)
+    {
+        double target = 100.0 + (SPUR_MCLK / 2.0 - 1000.0) * rand() / RAND_MAX;
+        double tol = (i & 1U) ? 50.0 : 200.0;
+
+        CHECK(AD9833_Spur_Pick(target, tol, SPUR_MCLK, &pick) == 0, "%.3f Hz rejected", target);
+        CHECK(fabs(pick.best.freq - target) <= tol, "%.3f Hz: picked %.3f Hz", target, pick.best.freq);
+        CHECK(pick.best.sfdr >= pick.nearest.sfdr, "%.3f Hz: worse than the nearest word", target);
+
+        uint32_t lo = (uint32_t)ceil((target - tol) * per_hz), hi = (uint32_t)floor((target + tol) * per_hz);
+        double err = fabs(pick.best.word - target * per_hz);
+        for (uint32_t w = lo; w <= hi; w++)
+        {
+            AD9833_SpurWord cand;
+            AD9833_Spur_Analyze(w, SPUR_MCLK, &cand);
+            if (cand.sfdr > pick.best.sfdr ||
+                (cand.sfdr == pick.best.sfdr && fabs(w - target * per_hz) < err))
+            {
+                CHECK(0, "%.3f Hz: 0x%07X (%.2f dBc) beats 0x%07X (%.2f dBc)", target, (unsigned)w, cand.sfdr,
+                      (unsigned)pick.best.word, pick.best.sfdr);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief       多线程扫频计划
+ * @retval      无
+ */
+static void Test_Plan(void)
+{
+    static double target[SPUR_PLAN_NUM];
+    static AD9833_SpurPick one[SPUR_PLAN_NUM], many[SPUR_PLAN_NUM];
+
+    for (uint32_t i = 0; i < SPUR_PLAN_NUM; i++) target[i] = 1000.0 + 611.0 * i;
+    target[17] = -1.0;
+    target[SPUR_PLAN_NUM - 1U] = SPUR_MCLK;
+
+    uint32_t failed_one = AD9833_Spur_Plan(target, SPUR_PLAN_NUM, 100.0, SPUR_MCLK, one, 1);
+    uint32_t failed_many = AD9833_Spur_Plan(target, SPUR_PLAN_NUM, 100.0, SPUR_MCLK, many, 7);
+
+    CHECK(failed_one == 2U && failed_many == 2U, "%u / %u invalid targets", (unsigned)failed_one, (unsigned)failed_many);
+    CHECK(memcmp(one, many, sizeof(one)) == 0, "threaded plan differs from the single-thread plan");
+
+    double gain = 0.0, worst = 1e9;
+    for (uint32_t i = 0; i < SPUR_PLAN_NUM; i++)
+    {
+        if (!one[i].best.word) continue;
+        gain += one[i].best.sfdr - one[i].nearest.sfdr;
+        if (one[i].best.sfdr < worst) worst = one[i].best.sfdr;
+    }
+    printf("  %u-point plan, +-100 Hz: worst %.2f dBc, mean gain over the nearest word %.2f dB\n",
+           (unsigned)SPUR_PLAN_NUM, worst, gain / (SPUR_PLAN_NUM - 2U));
+}
+
+int main(void)
+{
+    Lut_Init();
+    AD9833_Spur_Init();
+
+    Test_Classes();
+    Test_Exact();
+    Test_Truncation();
+    Test_Pick();
+    Test_Plan();
+
+    printf("spur %s (%u failures)\n", s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
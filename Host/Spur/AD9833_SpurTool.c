@@ -0,0 +1,165 @@
+/**
+******************************************************************************
+  * @file           : AD9833_SpurTool.c
+  * @brief          : 杂散规划命令行工具: 为目标频率或扫频计划挑选频率字
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 用法：
+  *
+  *     ad9833_spur [-m mclk] [-t tol] [-j threads] [-o plan.csv] freq...
+  *     ad9833_spur [-m mclk] [-t tol] [-j threads] [-o plan.csv] -s start:stop:step
+  *
+  * -m 主时钟 (Hz, 默认 25MHz)，-t 容差 (Hz, 默认0即只取最近的频率字)，
+  * -j 线程数 (默认为CPU核数)，-s 按步进生成扫频计划。逐个给出频率时打印
+  * 每个目标的结果；扫频计划只打印汇总。-o 写出CSV：
+  *
+  *     target,word,freq,error,zeros,sfdr,spur_freq,nearest_word,nearest_sfdr
+  *
+  * word 为十六进制的28位频率字，可直接用 AD9833_PROTO_FREQ_RAW 命令或
+  * AD9833_SEQ_FREQ_RAW 步写入固件。有无效的目标频率时返回1。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Spur.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SPUR_TOOL_PRINT_MAX         64U     // 逐个打印的目标数上限
+
+/**
+ * @brief       打印用法
+ */
+static int Usage(const char* prog)
+{
+    fprintf(stderr, "usage: %s [-m mclk] [-t tol] [-j threads] [-o plan.csv] (freq... | -s start:stop:step)\n", prog);
+    return 2;
+}
+
+/**
+ * @brief       写出CSV
+ * @param       path: 文件名
+ * @param       pick: 结果
+ * @param       num: 个数
+ * @retval      0: 成功
+ */
+static int WriteCsv(const char* path, const AD9833_SpurPick* pick, uint32_t num)
+{
+    FILE* fp = fopen(path, "w");
+    if (!fp)
+    {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 2;
+    }
+
+    fprintf(fp, "target,word,freq,error,zeros,sfdr,spur_freq,nearest_word,nearest_sfdr\n");
+    for (uint32_t i = 0; i < num; i++)
+    {
+        const AD9833_SpurPick* p = &pick[i];
+        if (!p->best.word) continue;
+        fprintf(fp, "%.3f,0x%07X,%.3f,%.3f,%u,%.2f,%.0f,0x%07X,%.2f\n", p->target, (unsigned)p->best.word,
+                p->best.freq, p->best.freq - p->target, (unsigned)p->best.zeros, p->best.sfdr, p->best.spur_freq,
+                (unsigned)p->nearest.word, p->nearest.sfdr);
+    }
+    fclose(fp);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    double mclk = 25000000.0, tol = 0.0;
+    double start = 0.0, stop = 0.0, step = 0.0;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t threads = (cpus > 0) ? (uint32_t)cpus : 1U;
+    const char* out = NULL;
+    int sweep = 0, opt;
+
+    while ((opt = getopt(argc, argv, "m:t:j:o:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'm': mclk = atof(optarg); break;
+        case 't': tol = atof(optarg); break;
+        case 'j': threads = (uint32_t)atoi(optarg); break;
+        case 'o': out = optarg; break;
+        case 's':
+            if (sscanf(optarg, "%lf:%lf:%lf", &start, &stop, &step) != 3 || step <= 0.0 || stop < start)
+            {
+                return Usage(argv[0]);
+            }
+            sweep = 1;
+            break;
+        default:
+            return Usage(argv[0]);
+        }
+    }
+    if (mclk <= 0.0 || (sweep && optind != argc) || (!sweep && optind == argc)) return Usage(argv[0]);
+
+    uint32_t num = sweep ? (uint32_t)((stop - start) / step + 1.0 + 1e-9) : (uint32_t)(argc - optind);
+    double* target = malloc(num * sizeof(double));
+    AD9833_SpurPick* pick = malloc(num * sizeof(AD9833_SpurPick));
+    if (!target || !pick)
+    {
+        fprintf(stderr, "out of memory for %u targets\n", (unsigned)num);
+        return 2;
+    }
+    for (uint32_t i = 0; i < num; i++) target[i] = sweep ? start + step * i : atof(argv[optind + i]);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    AD9833_Spur_Init();
+    uint32_t failed = AD9833_Spur_Plan(target, num, tol, mclk, pick, threads);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    if (!sweep && num <= SPUR_TOOL_PRINT_MAX)
+    {
+        printf("%14s %10s %16s %10s %3s %8s %12s %10s %8s\n", "target_Hz", "word", "freq_Hz", "error_Hz", "L",
+               "SFDR_dBc", "spur_Hz", "nearest", "SFDR_dBc");
+        for (uint32_t i = 0; i < num; i++)
+        {
+            const AD9833_SpurPick* p = &pick[i];
+            if (!p->best.word)
+            {
+                printf("%14.3f  out of range (0 < f < mclk/2)\n", p->target);
+                continue;
+            }
+            printf("%14.3f  0x%07X %16.3f %10.3f %3u %8.2f %12.0f  0x%07X %8.2f\n", p->target,
+                   (unsigned)p->best.word, p->best.freq, p->best.freq - p->target, (unsigned)p->best.zeros,
+                   p->best.sfdr, p->best.spur_freq, (unsigned)p->nearest.word, p->nearest.sfdr);
+        }
+    }
+    else
+    {
+        double worst = 1e9, worst_nearest = 1e9, gain = 0.0;
+        uint32_t valid = 0;
+        for (uint32_t i = 0; i < num; i++)
+        {
+            if (!pick[i].best.word) continue;
+            if (pick[i].best.sfdr < worst) worst = pick[i].best.sfdr;
+            if (pick[i].nearest.sfdr < worst_nearest) worst_nearest = pick[i].nearest.sfdr;
+            gain += pick[i].best.sfdr - pick[i].nearest.sfdr;
+            valid++;
+        }
+        printf("%u targets, tolerance %.3f Hz, %u threads, %.1f ms\n", (unsigned)num, tol, (unsigned)threads,
+               (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+        if (valid)
+        {
+            printf("worst SFDR %.2f dBc (nearest words %.2f dBc), mean gain %.2f dB\n", worst, worst_nearest,
+                   gain / valid);
+        }
+    }
+    if (failed) printf("%u targets out of range\n", (unsigned)failed);
+
+    int ret = out ? WriteCsv(out, pick, num) : 0;
+    free(target);
+    free(pick);
+    return ret ? ret : (failed ? 1 : 0);
+}
@@ -0,0 +1,337 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Synth.c
+  * @brief          : 由模型记录的写入合成 AD9833 输出波形并做频谱分析
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-13
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 合成时另建一个不接引脚的模型，按生效时刻依次调用 AD9833_Model_Word()
+  * 更新寄存器，寄存器语义 (B28/HLB 等) 与引脚解码完全一致。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Synth.h"
+#include "arm_math.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define AD9833_SYNTH_CTRL_OUTPUT    (AD9833_MODEL_FSELECT | AD9833_MODEL_PSELECT | AD9833_MODEL_RESET | \
+                                     AD9833_MODEL_SLEEP1 | AD9833_MODEL_SLEEP12 | AD9833_MODEL_OPBITEN | \
+                                     AD9833_MODEL_DIV2 | AD9833_MODEL_MODE)
+
+// 正弦查找表: 12位相位 -> 10位DAC码
+static uint16_t s_sine[4096];
+static uint8_t s_sine_ready = 0;
+
+// 频谱分析的工作区
+static float32_t s_buf[AD9833_SYNTH_FFT_MAX];
+static float32_t s_win[AD9833_SYNTH_FFT_MAX];
+static float32_t s_fft[AD9833_SYNTH_FFT_MAX];
+static float32_t s_pow[AD9833_SYNTH_FFT_MAX / 2U + 1U];
+
+/**
+ * @brief       模型的数据字回调, 追加到日志
+ */
+static void AD9833_SynthLog_Hook(AD9833_Model* model, uint64_t time_ns, uint16_t word, void* ctx)
+{
+    AD9833_SynthLog* log = (AD9833_SynthLog*)ctx;
+    (void)model;
+
+    if (log->num == log->cap)
+    {
+        uint32_t cap = log->cap ? log->cap * 2U : 256U;
+        AD9833_SynthWord* grown = realloc(log->word, cap * sizeof(AD9833_SynthWord));
+        if (!grown) return;
+        log->word = grown;
+        log->cap = cap;
+    }
+    log->word[log->num].time_ns = time_ns;
+    log->word[log->num].word = word;
+    log->num++;
+}
+
+/**
+ * @brief       把日志挂到模型上
+ * @param       log: 日志, 须先清零
+ * @param       model: 模型
+ * @retval      无
+ */
+void AD9833_SynthLog_Attach(AD9833_SynthLog* log, AD9833_Model* model)
+{
+    model->word_hook = AD9833_SynthLog_Hook;
+    model->word_ctx = log;
+}
+
+/**
+ * @brief       清空日志, 保留已分配的空间
+ * @param       log: 日志
+ * @retval      无
+ */
+void AD9833_SynthLog_Clear(AD9833_SynthLog* log)
+{
+    log->num = 0;
+}
+
+/**
+ * @brief       释放日志
+ * @param       log: 日志
+ * @retval      无
+ */
+void AD9833_SynthLog_Free(AD9833_SynthLog* log)
+{
+    free(log->word);
+    memset(log, 0, sizeof(*log));
+}
+
+/**
+ * @brief       默认合成参数 (25MHz, 延迟8个周期, t0=0)
+ * @param       cfg: 输出
+ * @retval      无
+ */
+void AD9833_Synth_DefaultConfig(AD9833_SynthConfig* cfg)
+{
+    cfg->mclk = AD9833_SYNTH_MCLK;
+    cfg->latency = AD9833_SYNTH_LATENCY;
+    cfg->t0_ns = 0;
+}
+
+/**
+ * @brief       生成正弦查找表
+ * @retval      无
+ */
+static void AD9833_Synth_SineInit(void)
+{
+    if (s_sine_ready) return;
+    for (uint32_t i = 0; i < 4096U; i++)
+    {
+        long code = lround(511.5 + 511.5 * sin(2.0 * PI * i / 4096.0));
+        s_sine[i] = (uint16_t)(code < 0 ? 0 : (code > 1023 ? 1023 : code));
+    }
+    s_sine_ready = 1;
+}
+
+/**
+ * @brief       写入记录的生效样点
+ * @param       cfg: 合成参数
+ * @param       time_ns: 写入时刻 (不早于 t0)
+ * @retval      样点序号
+ */
+static uint64_t AD9833_Synth_Effective(const AD9833_SynthConfig* cfg, uint64_t time_ns)
+{
+    double cycles = (double)(time_ns - cfg->t0_ns) * cfg->mclk / 1e9;
+    return (uint64_t)ceil(cycles) + cfg->latency;
+}
+
+/**
+ * @brief       按日志合成一段输出
+ * @note        t0 之前的写入直接作为初始状态, 累加器从0开始
+ * @param       log: 写入日志
+ * @param       cfg: 合成参数
+ * @param       out: 输出, 每个 MCLK 周期一个样点, 归一化到 [-1, 1]
+ * @param       samples: 样点数
+ * @param       hop: 输出变化记录, 可为 NULL
+ * @param       hop_max: 记录容量
+ * @retval      输出变化的次数 (可能大于 hop_max)
+ */
+uint32_t AD9833_Synth_Render(const AD9833_SynthLog* log, const AD9833_SynthConfig* cfg,
+                             float* out, uint32_t samples, AD9833_SynthHop* hop, uint32_t hop_max)
+{
+    AD9833_Model reg;
+    uint32_t w = 0, hops = 0;
+    uint32_t acc = 0;
+    uint8_t msb_last = 0, msb_div = 0;
+    float held = 0.0f;
+
+    AD9833_Synth_SineInit();
+    AD9833_Model_Init(&reg);
+
+    while (w < log->num && log->word[w].time_ns < cfg->t0_ns)
+    {
+        AD9833_Model_Word(&reg, log->word[w++].word);
+    }
+
+    for (uint32_t k = 0; k < samples; k++)
+    {
+        // 本周期生效的写入
+        while (w < log->num && AD9833_Synth_Effective(cfg, log->word[w].time_ns) <= k)
+        {
+            uint16_t ctrl = reg.ctrl;
+            uint32_t freq = reg.freq[(ctrl & AD9833_MODEL_FSELECT) ? 1 : 0];
+            uint16_t phase = reg.phase[(ctrl & AD9833_MODEL_PSELECT) ? 1 : 0];
+
+            AD9833_Model_Word(&reg, log->word[w].word);
+
+            uint16_t change = (uint16_t)((ctrl ^ reg.ctrl) & AD9833_SYNTH_CTRL_OUTPUT);
+            uint32_t freq_new = reg.freq[(reg.ctrl & AD9833_MODEL_FSELECT) ? 1 : 0];
+            uint16_t phase_new = reg.phase[(reg.ctrl & AD9833_MODEL_PSELECT) ? 1 : 0];
+
+            if (change || freq_new != freq || phase_new != phase)
+            {
+                uint32_t acc_new = (reg.ctrl & AD9833_MODEL_RESET) ? 0U : acc;
+                int32_t jump = (int32_t)((((acc_new >> 16) + phase_new) - ((acc >> 16) + phase)) & 0xFFFU);
+                if (jump >= 2048) jump -= 4096;
+
+                if (hop && hops < hop_max)
+                {
+                    hop[hops].sample = k;
+                    hop[hops].time_ns = log->word[w].time_ns;
+                    hop[hops].word = log->word[w].word;
+                    hop[hops].freq_word = freq_new;
+                    hop[hops].phase_jump = jump * 360.0 / 4096.0;
+                    hop[hops].ctrl_change = change;
+                }
+                hops++;
+            }
+            w++;
+        }
+
+        uint16_t ctrl = reg.ctrl;
+
+        if (ctrl & AD9833_MODEL_SLEEP1)
+        {
+            out[k] = held;      // MCLK 关闭, 累加器和输出保持
+            continue;
+        }
+        if (ctrl & AD9833_MODEL_RESET) acc = 0;
+
+        uint16_t phase = (uint16_t)(((acc >> 16) + reg.phase[(ctrl & AD9833_MODEL_PSELECT) ? 1 : 0]) & 0xFFFU);
+        float y;
+
+        if (ctrl & AD9833_MODEL_OPBITEN)
+        {
+            uint8_t msb = (uint8_t)(phase >> 11);
+            if (ctrl & AD9833_MODEL_RESET) msb = 0;
+            if (msb && !msb_last) msb_div ^= 1U;
+            msb_last = msb;
+            y = ((ctrl & AD9833_MODEL_DIV2) ? msb : msb_div) ? 1.0f : -1.0f;
+        }
+        else if ((ctrl & AD9833_MODEL_SLEEP12) || (ctrl & AD9833_MODEL_RESET))
+        {
+            y = 0.0f;           // DAC 关闭或复位: 中间电平
+        }
+        else
+        {
+            uint16_t code;
+            if (ctrl & AD9833_MODEL_MODE)
+            {
+                uint16_t p = phase >> 1;
+                code = (p & 0x400U) ? (uint16_t)(0x7FFU - p) : p;
+            }
+            else
+            {
+                code = s_sine[phase];
+            }
+            y = (float)((code - 511.5) / 511.5);
+        }
+
+        out[k] = held = y;
+        if (!(ctrl & AD9833_MODEL_RESET))
+        {
+            acc = (acc + reg.freq[(ctrl & AD9833_MODEL_FSELECT) ? 1 : 0]) & 0x0FFFFFFFUL;
+        }
+    }
+
+    return hops;
+}
+
+/**
+ * @brief       把频点折叠到 0 ~ n/2
+ */
+static uint32_t AD9833_Synth_Fold(uint64_t bin, uint32_t n)
+{
+    bin %= n;
+    return (uint32_t)((bin > n / 2U) ? n - bin : bin);
+}
+
+/**
+ * @brief       计算频谱指标
+ * @note        加 Blackman-Harris 窗后做实数FFT; 基波取直流以外的最大点, 功率按
+ *              主瓣 ±AD9833_SYNTH_LEAK_BINS 点求和; SFDR 取基波与最大杂散的峰值点之比;
+ *              噪声按剩余点的平均功率折算到直流以外的全部频点
+ * @param       x: 样点
+ * @param       n: 点数 (32~4096 的2的幂)
+ * @param       fs: 采样率 (Hz)
+ * @param       result: 输出
+ * @retval      0: 成功; -1: 点数无效或没有信号
+ */
+int AD9833_Synth_Spectrum(const float* x, uint32_t n, double fs, AD9833_SynthSpectrum* result)
+{
+    arm_rfft_fast_instance_f32 fft;
+    const uint32_t half = n / 2U, leak = AD9833_SYNTH_LEAK_BINS;
+
+    if (n < 32U || n > AD9833_SYNTH_FFT_MAX || (n & (n - 1U))) return -1;
+    if (arm_rfft_fast_init_f32(&fft, (uint16_t)n) != ARM_MATH_SUCCESS) return -1;
+
+    arm_blackman_harris_92db_f32(s_win, n);
+    arm_mult_f32(x, s_win, s_buf, n);
+    arm_rfft_fast_f32(&fft, s_buf, s_fft, 0);
+
+    // s_fft[0] 为直流, s_fft[1] 为奈奎斯特频率 (均为实数), 其后为复数
+    s_pow[0] = s_fft[0] * s_fft[0];
+    s_pow[half] = s_fft[1] * s_fft[1];
+    arm_cmplx_mag_squared_f32(&s_fft[2], &s_pow[1], half - 1U);
+
+    // 满幅正弦的峰值点功率
+    float32_t wsum = 0.0f;
+    for (uint32_t i = 0; i < n; i++) wsum += s_win[i];
+    double ref = (double)wsum * wsum / 4.0;
+
+    uint32_t fund = leak + 1U;
+    for (uint32_t i = leak + 1U; i <= half; i++)
+    {
+        if (s_pow[i] > s_pow[fund]) fund = i;
+    }
+    if (s_pow[fund] <= 0.0f) return -1;
+
+    // 标记: 0 噪声, 1 直流, 2 基波, 3 谐波
+    static uint8_t s_mark[AD9833_SYNTH_FFT_MAX / 2U + 1U];
+    memset(s_mark, 0, half + 1U);
+    for (uint32_t i = 0; i <= leak; i++) s_mark[i] = 1;
+    for (uint32_t h = 2; h <= AD9833_SYNTH_HARMONICS; h++)
+    {
+        uint32_t c = AD9833_Synth_Fold((uint64_t)fund * h, n);
+        for (uint32_t i = (c > leak ? c - leak : 0); i <= c + leak && i <= half; i++)
+        {
+            if (!s_mark[i]) s_mark[i] = 3;
+        }
+    }
+    for (uint32_t i = (fund > leak ? fund - leak : 0); i <= fund + leak && i <= half; i++) s_mark[i] = 2;
+
+    double sig = 0.0, harm = 0.0, noise = 0.0, spur = 0.0;
+    uint32_t noise_bins = 0, spur_bin = 0;
+    for (uint32_t i = 0; i <= half; i++)
+    {
+        if (s_mark[i] == 2) sig += s_pow[i];
+        else if (s_mark[i] == 3) harm += s_pow[i];
+        else if (s_mark[i] == 0) { noise += s_pow[i]; noise_bins++; }
+
+        if (s_mark[i] != 1 && s_mark[i] != 2 && s_pow[i] > spur)
+        {
+            spur = s_pow[i];
+            spur_bin = i;
+        }
+    }
+
+    // 按剩余点的平均功率把噪声折算到直流以外的全部频点
+    uint32_t harm_bins = 0;
+    for (uint32_t i = 0; i <= half; i++) harm_bins += (s_mark[i] == 3) ? 1U : 0U;
+    double density = noise_bins ? noise / noise_bins : 0.0;
+    double noise_all = density * (half - leak);
+    double noise_harm = density * (half - leak - harm_bins) + harm;
+
+    result->fund_bin = fund;
+    result->fund_freq = fund * fs / n;
+    result->fund_db = 10.0 * log10(s_pow[fund] / ref);
+    result->spur_bin = spur_bin;
+    result->spur_freq = spur_bin * fs / n;
+    result->sfdr = spur > 0.0 ? 10.0 * log10(s_pow[fund] / spur) : 200.0;
+    result->snr = noise_all > 0.0 ? 10.0 * log10(sig / noise_all) : 200.0;
+    result->sinad = noise_harm > 0.0 ? 10.0 * log10(sig / noise_harm) : 200.0;
+    return 0;
+}
@@ -0,0 +1,128 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Synth.h
+  * @brief          : 由模型记录的写入合成 AD9833 输出波形并做频谱分析
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-13
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 按 AD9833 的数据通路逐个 MCLK 周期合成输出：
+  * - 28位相位累加器每个 MCLK 加上选中的频率字，RESET 时清零，SLEEP1 时停止。
+  * - 累加器高12位加上选中的相位寄存器得到12位相位 (截断)。
+  * - 正弦: 12位相位查表得到10位DAC码；三角波: 相位高11位折叠为10位DAC码；
+  *   OPBITEN=1: 输出相位的最高位 (DIV2=1) 或其二分频 (DIV2=0)。
+  * - RESET 时输出中间电平，SLEEP12 且非 OPBITEN 时DAC关闭输出0，SLEEP1 时
+  *   输出保持。
+  * - 写入在第16个SCLK下降沿之后的第一个 MCLK 上升沿加上 latency 个周期生效
+  *   (数据手册: 7~8个 MCLK 周期)。
+  *
+  * 输出归一化到 [-1, 1]。频谱分析使用 CMSIS-DSP 的 arm_rfft_fast_f32 和
+  * Blackman-Harris 窗 (主机编译)，点数为 32~4096 的2的幂。
+  *
+  * 使用方法：
+  * 1. 调用 `AD9833_SynthLog_Attach()` 把记录挂到模型上，之后模型解码到的
+  *    每个数据字连同时刻记入日志。
+  * 2. 调用 `AD9833_Synth_Render()` 按日志合成一段输出，并得到其中各次
+  *    输出变化 (跳变) 的记录。
+  * 3. 调用 `AD9833_Synth_Spectrum()` 计算 SFDR、SNR 等指标。
+  *
+  ******************************************************************************
+  */
+
+#ifndef _AD9833_SYNTH_H
+#define _AD9833_SYNTH_H
+
+#include <stdint.h>
+#include "AD9833_Model.h"
+
+#define AD9833_SYNTH_MCLK           25000000.0  // 默认主时钟 (Hz)
+#define AD9833_SYNTH_LATENCY        8U          // 默认写入生效延迟 (MCLK周期)
+#define AD9833_SYNTH_FFT_MAX        4096U       // arm_rfft_fast_f32 支持的最大点数
+#define AD9833_SYNTH_HARMONICS      6U          // SNR 扣除的谐波 (2~6次)
+#define AD9833_SYNTH_LEAK_BINS      4U          // 窗函数主瓣半宽 (点)
+
+/**
+ * @brief   一条写入记录
+ */
+typedef struct
+{
+    uint64_t time_ns;
+    uint16_t word;
+} AD9833_SynthWord;
+
+/**
+ * @brief   一片芯片的写入日志
+ */
+typedef struct
+{
+    AD9833_SynthWord* word;
+    uint32_t num;
+    uint32_t cap;
+} AD9833_SynthLog;
+
+/**
+ * @brief   合成参数
+ *      @arg mclk: 主时钟 (Hz)
+ *      @arg latency: 写入生效延迟 (MCLK周期)
+ *      @arg t0_ns: 第0个样点的时刻, 之前的写入作为初始状态
+ */
+typedef struct
+{
+    double mclk;
+    uint32_t latency;
+    uint64_t t0_ns;
+} AD9833_SynthConfig;
+
+/**
+ * @brief   一次输出变化 (生效的写入改变了输出用到的寄存器或控制位)
+ *      @arg sample: 生效的样点
+ *      @arg time_ns: 写入时刻
+ *      @arg word: 数据字
+ *      @arg freq_word: 生效后使用的频率字
+ *      @arg phase_jump: 与按原设置继续相比的相位跳变 (度, -180~180)
+ *      @arg ctrl_change: 改变的控制位 (FSELECT/PSELECT/波形/RESET/SLEEP)
+ */
+typedef struct
+{
+    uint32_t sample;
+    uint64_t time_ns;
+    uint16_t word;
+    uint32_t freq_word;
+    double phase_jump;
+    uint16_t ctrl_change;
+} AD9833_SynthHop;
+
+/**
+ * @brief   频谱指标
+ *      @arg fund_bin/fund_freq: 基波位置
+ *      @arg fund_db: 基波功率 (dBFS, 满幅正弦为0)
+ *      @arg sfdr: 无杂散动态范围 (dBc)
+ *      @arg spur_bin/spur_freq: 最大杂散的位置
+ *      @arg snr: 信噪比, 不计直流和2~6次谐波 (dB)
+ *      @arg sinad: 信纳比, 不计直流 (dB)
+ */
+typedef struct
+{
+    uint32_t fund_bin;
+    double fund_freq;
+    double fund_db;
+    double sfdr;
+    uint32_t spur_bin;
+    double spur_freq;
+    double snr;
+    double sinad;
+} AD9833_SynthSpectrum;
+
+/* 函数声明 */
+void AD9833_SynthLog_Attach(AD9833_SynthLog* log, AD9833_Model* model);
+void AD9833_SynthLog_Clear(AD9833_SynthLog* log);
+void AD9833_SynthLog_Free(AD9833_SynthLog* log);
+void AD9833_Synth_DefaultConfig(AD9833_SynthConfig* cfg);
+uint32_t AD9833_Synth_Render(const AD9833_SynthLog* log, const AD9833_SynthConfig* cfg,
+                             float* out, uint32_t samples, AD9833_SynthHop* hop, uint32_t hop_max);
+int AD9833_Synth_Spectrum(const float* x, uint32_t n, double fs, AD9833_SynthSpectrum* result);
+
+#endif /* _AD9833_SYNTH_H */
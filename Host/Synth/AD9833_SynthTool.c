@@ -0,0 +1,280 @@
+/**
+******************************************************************************
+  * @file           : AD9833_SynthTool.c
+  * @brief          : 比较不同更新方式的输出频谱代价
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-13
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 软件SPI驱动在模拟层上运行，AD9833_Model 按引脚边沿解码，写入日志交给
+  * AD9833_Synth 按 25MHz MCLK 合成输出：
+  * 1. 稳态: 正弦/三角波/方波的 SFDR、SNR、SINAD。
+  * 2. 跳频: 同一次从 f1 到 f2 的跳频用不同方式完成，给出输出变化次数、
+  *    中间状态持续时间、最大相位跳变以及窗口内 f1/f2 主瓣以外的能量。
+  * 3. 相位步进和复位重启的相位跳变。
+  *
+  * 用第一个参数给出文件名时，把各跳频方式的合成波形写成CSV (每列一种方式)。
+  * 结果与预期不符时返回非0，作为测试运行。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Soft.h"
+#include "AD9833_Synth.h"
+#include "Mock_HAL.h"
+#include "arm_math.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "Host_Check.h"
+
+#define SYNTH_N             AD9833_SYNTH_FFT_MAX    // 每段合成的样点数 (163.84us)
+#define SYNTH_F1            (25e6 * 101.0 / 4096.0) // 约 616kHz, 落在频点上
+#define SYNTH_F2            (25e6 * 251.3 / 4096.0) // 约 1.53MHz, 频率字高低14位都与 f1 不同
+#define SYNTH_HOP_AT_NS     40000U                  // 跳频操作在窗口中的起始时刻
+#define SYNTH_HOP_MAX       32U
+
+static AD9833_Model s_chip[2];
+static AD9833_SynthLog s_log[2];
+static AD9833_ModelBus s_mb;
+static Mock_Bus s_bus;
+static float s_wave[SYNTH_N];
+
+/**
+ * @brief   一种更新方式
+ */
+typedef struct
+{
+    const char* name;
+    void (*run)(void);
+} Synth_Strategy;
+
+/**
+ * @brief       复位模拟层、模型和日志, 以 CS1 正弦 f1 启动, 返回 t0
+ * @param       wave: 波形
+ * @retval      窗口起点 (虚拟时间)
+ */
+static uint64_t Synth_Start(waveType wave)
+{
+    AD9833_InitTypedef cfg = {
+        .status = CS1_SINGLE,
+        .AD_CS1 = { wave, SYNTH_F1, 0.0, 0, 0 },
+    };
+
+    Mock_Reset();
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        AD9833_Model_Init(&s_chip[i]);
+        AD9833_SynthLog_Clear(&s_log[i]);
+        AD9833_SynthLog_Attach(&s_log[i], &s_chip[i]);
+    }
+    AD9833_ModelBus_Init(&s_mb, s_chip, 2, &s_bus);
+    AD9833_ModelBus_Attach(&s_mb);
+
+    AD9833_Cmd(&cfg);
+    Mock_Advance(1000);
+    return Mock_Now();
+}
+
+/**
+ * @brief       合成 CS1 从 t0 开始的一段输出
+ */
+static uint32_t Synth_Render(uint64_t t0, AD9833_SynthHop* hop)
+{
+    AD9833_SynthConfig cfg;
+
+    AD9833_Synth_DefaultConfig(&cfg);
+    cfg.t0_ns = t0;
+    return AD9833_Synth_Render(&s_log[0], &cfg, s_wave, SYNTH_N, hop, SYNTH_HOP_MAX);
+}
+
+static void Synth_Steady(void)
+{
+    static const char* const name[] = { "sine", "triangle", "square" };
+    static const waveType wave[] = { SINE_WAVE, TRIANGLE_WAVE, SQUARE_WAVE };
+
+    printf("steady state, f = %.0f Hz, %u samples at 25 MHz\n", SYNTH_F1, (unsigned)SYNTH_N);
+    printf("%-10s %10s %10s %10s %10s %12s\n", "wave", "fund_dBFS", "SFDR_dBc", "SNR_dB", "SINAD_dB", "spur_Hz");
+
+    for (uint8_t w = 0; w < 3; w++)
+    {
+        AD9833_SynthSpectrum sp;
+        uint64_t t0 = Synth_Start(wave[w]);
+
+        Synth_Render(t0, NULL);
+        CHECK(AD9833_Synth_Spectrum(s_wave, SYNTH_N, AD9833_SYNTH_MCLK, &sp) == 0, "%s: no spectrum", name[w]);
+        printf("%-10s %10.2f %10.2f %10.2f %10.2f %12.0f\n", name[w], sp.fund_db, sp.sfdr, sp.snr, sp.sinad, sp.spur_freq);
+
+        CHECK(fabs(sp.fund_freq - SYNTH_F1) < 1.0, "%s: fundamental at %.0f Hz", name[w], sp.fund_freq);
+        if (w == 0)
+        {
+            // 12位相位截断、10位DAC: 数据手册典型 SFDR 约 60~70dBc
+            CHECK(sp.sfdr > 55.0 && sp.snr > 50.0, "sine: SFDR %.1f SNR %.1f", sp.sfdr, sp.snr);
+        }
+    }
+}
+
+/* 跳频方式 */
+static void Hop_B28Active(void)
+{
+    AD9833_FreqSet(CS1, 0, SYNTH_F2);
+}
+
+static void Hop_PingPong(void)
+{
+    AD9833_FreqSet(CS1, 1, SYNTH_F2);
+    AD9833_SelectFreqReg(CS1, 1);
+}
+
+static void Hop_HlbHalves(void)
+{
+    // B28=0, 先写高14位再写低14位, 两次写入之间输出中间频率
+    uint32_t word = AD9833_FreqToWord(CS1, SYNTH_F2);
+    AD9833_Write(CS1, AD9833_CTRL_HLB);
+    AD9833_Write(CS1, AD9833_CMD_FREQ0REG | (uint16_t)((word >> 14) & 0x3FFF));
+    AD9833_Write(CS1, 0x0000);
+    AD9833_Write(CS1, AD9833_CMD_FREQ0REG | (uint16_t)(word & 0x3FFF));
+    AD9833_Write(CS1, AD9833_CTRL_B28);
+}
+
+static void Hop_ResetRestart(void)
+{
+    AD9833_Reset(CS1, 1);
+    AD9833_FreqSet(CS1, 0, SYNTH_F2);
+    AD9833_Reset(CS1, 0);
+}
+
+static const Synth_Strategy s_strategy[] = {
+    { "b28_active",     Hop_B28Active },
+    { "pingpong",       Hop_PingPong },
+    { "hlb_halves",     Hop_HlbHalves },
+    { "reset_restart",  Hop_ResetRestart },
+};
+
+#define SYNTH_STRATEGY_NUM  (sizeof(s_strategy) / sizeof(s_strategy[0]))
+
+/**
+ * @brief       f1/f2 主瓣以外的能量占比 (dBc)
+ */
+static double Synth_Spill(const float* x)
+{
+    static float32_t win[SYNTH_N], buf[SYNTH_N], fft[SYNTH_N], pow[SYNTH_N / 2 + 1];
+    arm_rfft_fast_instance_f32 inst;
+    const uint32_t b1 = 101, b2 = 251, leak = AD9833_SYNTH_LEAK_BINS;
+
+    arm_rfft_fast_init_f32(&inst, SYNTH_N);
+    arm_blackman_harris_92db_f32(win, SYNTH_N);
+    arm_mult_f32(x, win, buf, SYNTH_N);
+    arm_rfft_fast_f32(&inst, buf, fft, 0);
+    arm_cmplx_mag_squared_f32(&fft[2], &pow[1], SYNTH_N / 2 - 1);
+
+    double tone = 0.0, other = 0.0;
+    for (uint32_t i = leak + 1U; i < SYNTH_N / 2; i++)
+    {
+        uint8_t in_tone = (i + leak >= b1 && i <= b1 + leak) || (i + leak >= b2 && i <= b2 + leak);
+        if (in_tone) tone += pow[i];
+        else other += pow[i];
+    }
+    return 10.0 * log10(other / tone);
+}
+
+static void Synth_Hops(FILE* csv)
+{
+    static float wave[SYNTH_STRATEGY_NUM][SYNTH_N];
+    uint32_t f1 = AD9833_FreqToWord(CS1, SYNTH_F1), f2 = AD9833_FreqToWord(CS1, SYNTH_F2);
+
+    printf("\nhop %.0f Hz -> %.0f Hz at t0 + %u ns\n", SYNTH_F1, SYNTH_F2, (unsigned)SYNTH_HOP_AT_NS);
+    printf("%-14s %8s %10s %12s %10s %10s\n", "strategy", "changes", "bus_us", "transient_us", "max_jump", "spill_dBc");
+
+    for (uint32_t s = 0; s < SYNTH_STRATEGY_NUM; s++)
+    {
+        AD9833_SynthHop hop[SYNTH_HOP_MAX];
+        uint64_t t0 = Synth_Start(SINE_WAVE);
+
+        Mock_Advance(SYNTH_HOP_AT_NS);
+        uint64_t begin = Mock_Now();
+        s_strategy[s].run();
+        uint64_t bus = Mock_Now() - begin;
+
+        uint32_t n = Synth_Render(t0, hop);
+        if (n > SYNTH_HOP_MAX) n = SYNTH_HOP_MAX;
+        memcpy(wave[s], s_wave, sizeof(s_wave));
+
+        // 中间状态: 第一次到最后一次输出变化之间
+        double max_jump = 0.0;
+        uint32_t foreign = 0;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            if (fabs(hop[i].phase_jump) > fabs(max_jump)) max_jump = hop[i].phase_jump;
+            if (hop[i].freq_word != f1 && hop[i].freq_word != f2) foreign++;
+        }
+        double transient = n ? (hop[n - 1U].sample - hop[0].sample) / AD9833_SYNTH_MCLK * 1e6 : 0.0;
+
+        printf("%-14s %8u %10.2f %12.2f %10.2f %10.2f\n", s_strategy[s].name, (unsigned)n,
+               bus / 1000.0, transient, max_jump, Synth_Spill(s_wave));
+        for (uint32_t i = 0; i < n; i++)
+        {
+            printf("    @%6.2fus word 0x%04X freq 0x%07X jump %7.2f ctrl ^0x%04X\n",
+                   hop[i].sample / AD9833_SYNTH_MCLK * 1e6, hop[i].word,
+                   (unsigned)hop[i].freq_word, hop[i].phase_jump, hop[i].ctrl_change);
+        }
+
+        CHECK(n > 0 && hop[n - 1U].freq_word == f2, "%s: does not end on f2", s_strategy[s].name);
+        if (s == 0) CHECK(n == 1 && max_jump == 0.0, "b28_active: expected one phase-continuous change");
+        if (s == 1) CHECK(foreign == 0 && max_jump == 0.0, "pingpong: expected no intermediate frequency");
+        if (s == 2) CHECK(foreign > 0, "hlb_halves: expected an intermediate frequency");
+    }
+
+    if (csv)
+    {
+        for (uint32_t s = 0; s < SYNTH_STRATEGY_NUM; s++) fprintf(csv, "%s%s", s ? "," : "", s_strategy[s].name);
+        fprintf(csv, "\n");
+        for (uint32_t k = 0; k < SYNTH_N; k++)
+        {
+            for (uint32_t s = 0; s < SYNTH_STRATEGY_NUM; s++) fprintf(csv, "%s%.5f", s ? "," : "", wave[s][k]);
+            fprintf(csv, "\n");
+        }
+    }
+}
+
+static void Synth_PhaseStep(void)
+{
+    AD9833_SynthHop hop[SYNTH_HOP_MAX];
+    uint64_t t0 = Synth_Start(SINE_WAVE);
+
+    Mock_Advance(SYNTH_HOP_AT_NS);
+    AD9833_PhaseSet(CS1, 0, 90.0);
+    uint32_t n = Synth_Render(t0, hop);
+
+    printf("\nphase step 0 -> 90 deg: %u change(s), jump %.2f deg\n", (unsigned)n, n ? hop[0].phase_jump : 0.0);
+    CHECK(n == 1 && fabs(hop[0].phase_jump - 90.0) < 0.1, "phase step: expected one 90 deg jump");
+}
+
+int main(int argc, char* argv[])
+{
+    FILE* csv = NULL;
+
+    s_bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    s_bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+    s_bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    s_bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    s_bus.cs_num = 2;
+    Mock_SetBus(&s_bus);
+    Mock_TraceEnable(0);
+
+    if (argc > 1 && !(csv = fopen(argv[1], "w"))) perror(argv[1]);
+
+    Synth_Steady();
+    Synth_Hops(csv);
+    Synth_PhaseStep();
+
+    if (csv) fclose(csv);
+    AD9833_ModelBus_Detach();
+    for (uint8_t i = 0; i < 2; i++) AD9833_SynthLog_Free(&s_log[i]);
+
+    printf("\n[synth] %s (%u failures)\n", s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
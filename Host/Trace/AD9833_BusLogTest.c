@@ -0,0 +1,220 @@
+/**
+******************************************************************************
+  * @file           : AD9833_BusLogTest.c
+  * @brief          : AD9833_BusLog 最近传输记录的主机测试
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-16
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 驱动以 AD9833_BUSLOG_ENABLE 编译 (AD9833_HOST_SOFT / AD9833_HOST_HAL 各一份)，
+  * 检查：
+  * - 上电 (magic 无效) 时清空，复位 (再次调用 AD9833_BusLog_Init) 时保留并
+  *   标出复位点；
+  * - 每个数据字按顺序记录，芯片掩码、数据字和时间戳正确；
+  * - 回绕后只保留最近 AD9833_BUSLOG_DEPTH 条，更早的序号读不到；
+  * - STREX 失败时重试，占了序号却没写完的条目读出为无效；
+  * - AD9833_BusLog_Dump() 的格式。
+  *
+  ******************************************************************************
+  */
+
+#include "Mock_HAL.h"
+#include "AD9833_BusLog.h"
+#include <stdio.h>
+#include <string.h>
+#include "Host_Check.h"
+
+#if defined(AD9833_HOST_HAL)
+#include "AD9833_HAL.h"
+#include "spi.h"
+#define AD9833_CALL(fn, ...)        fn(&hspi2, __VA_ARGS__)
+#define BUSLOG_TRANSPORT            "hal"
+#else
+#include "AD9833_Soft.h"
+#define AD9833_CALL(fn, ...)        fn(__VA_ARGS__)
+#define BUSLOG_TRANSPORT            "soft"
+#endif
+
+static AD9833_InitTypedef s_cfg = {
+    .status = CS1_CS2_DOUBLE,
+    .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+    .AD_CS2 = { SINE_WAVE, 1000.0, 90.0, 0, 0 },
+};
+
+/**
+ * @brief       写入 PHASE0 的数据字 (与驱动的换算相同)
+ * @param       step: 相位字 (0~4095)
+ * @retval      数据字
+ */
+static uint16_t Phase0Word(uint16_t step)
+{
+    return (uint16_t)(0xC000U | (step & 0x0FFFU));
+}
+
+/**
+ * @brief       上电时清空, 驱动写入按顺序记录
+ * @retval      无
+ */
+static void Test_Record(void)
+{
+    AD9833_BusLogEntry e;
+
+    memset(&AD9833_BusLog, 0xA5, sizeof(AD9833_BusLog));   // 上电后 CCMRAM 的随机内容
+    AD9833_BusLog_Init();
+    CHECK(AD9833_BusLog.magic == AD9833_BUSLOG_MAGIC && AD9833_BusLog_Head() == 0U &&
+          AD9833_BusLog.resets == 0U, "cold start not cleared");
+    CHECK(!AD9833_BusLog_Read(0, &e), "empty log returned an entry");
+
+    AD9833_Cmd(&s_cfg);
+    uint32_t start = AD9833_BusLog_Head();
+    CHECK(start >= 8U, "Cmd recorded %u words", (unsigned)start);
+
+    for (uint16_t k = 0; k < 10U; k++)
+    {
+        AD9833_CALL(AD9833_PhaseSet, (k & 1U) ? CS2 : CS1, 0, k * 360.0 / 4096.0);
+    }
+    CHECK(AD9833_BusLog_Head() == start + 10U, "head %u after 10 writes from %u",
+          (unsigned)AD9833_BusLog_Head(), (unsigned)start);
+
+    uint32_t last = 0;
+    for (uint16_t k = 0; k < 10U; k++)
+    {
+        uint8_t ok = AD9833_BusLog_Read(start + k, &e);
+        CHECK(ok && e.word == Phase0Word(k) && e.mask == ((k & 1U) ? CS2 : CS1),
+              "entry %u: valid %u mask 0x%02X word 0x%04X", (unsigned)k, ok, (unsigned)e.mask, (unsigned)e.word);
+        CHECK(k == 0U || e.time > last, "entry %u time %u not after %u", (unsigned)k, (unsigned)e.time, (unsigned)last);
+        last = e.time;
+    }
+    CHECK(last <= DWT->CYCCNT, "time %u after now %u", (unsigned)last, (unsigned)DWT->CYCCNT);
+}
+
+/**
+ * @brief       回绕后只保留最近的记录
+ * @retval      无
+ */
+static void Test_Wrap(void)
+{
+    AD9833_BusLogEntry e;
+    uint32_t start = AD9833_BusLog_Head();
+    uint32_t n = AD9833_BUSLOG_DEPTH + 37U;
+
+    for (uint32_t k = 0; k < n; k++)
+    {
+        AD9833_CALL(AD9833_PhaseSet, CS_BOTH, 0, (k & 0x0FFFU) * 360.0 / 4096.0);
+    }
+    uint32_t head = AD9833_BusLog_Head();
+    CHECK(head == start + n, "head %u, expected %u", (unsigned)head, (unsigned)(start + n));
+    CHECK(!AD9833_BusLog_Read(head - AD9833_BUSLOG_DEPTH - 1U, &e), "overwritten entry still readable");
+    CHECK(!AD9833_BusLog_Read(head, &e), "entry past head readable");
+
+    uint32_t bad = 0;
+    for (uint32_t seq = head - AD9833_BUSLOG_DEPTH; seq != head; seq++)
+    {
+        uint32_t k = seq - start;
+        if (!AD9833_BusLog_Read(seq, &e) || e.mask != CS_BOTH || e.word != Phase0Word((uint16_t)k)) bad++;
+    }
+    CHECK(bad == 0U, "%u of the last %u entries wrong", (unsigned)bad, (unsigned)AD9833_BUSLOG_DEPTH);
+}
+
+/**
+ * @brief       STREX 失败时重试; 占了序号未写完的条目无效
+ * @retval      无
+ */
+static void Test_Atomic(void)
+{
+    AD9833_BusLogEntry e;
+    uint32_t head = AD9833_BusLog_Head();
+
+    Mock_STM32_StrexFail(3);
+    AD9833_BusLog_Record(CS2, 0x1234);
+    CHECK(AD9833_BusLog_Head() == head + 1U, "retry claimed %u slots", (unsigned)(AD9833_BusLog_Head() - head));
+    CHECK(AD9833_BusLog_Read(head, &e) && e.word == 0x1234U && e.mask == CS2, "retried entry wrong");
+
+    AD9833_BusLog.head++;       // 占号后被打断, 没有写入
+    CHECK(!AD9833_BusLog_Read(head + 1U, &e), "unfinished entry reported valid");
+}
+
+/**
+ * @brief       芯片掩码按 chipChose 的全部位记录 (多于8片时不截断)
+ * @retval      无
+ */
+static void Test_WideMask(void)
+{
+    AD9833_BusLogEntry e;
+    uint32_t head = AD9833_BusLog_Head();
+
+    AD9833_BusLog_Record(0x80000101UL, 0x2100);
+    CHECK(AD9833_BusLog_Read(head, &e) && e.mask == 0x80000101UL, "mask 0x%08lX", (unsigned long)e.mask);
+}
+
+/**
+ * @brief       复位后保留记录, 输出中标出复位点
+ * @retval      无
+ */
+static void Test_Reset(void)
+{
+    static char buf[1U << 15];
+    UART_HandleTypeDef uart = { buf, sizeof(buf), 0 };
+    AD9833_BusLogEntry e;
+    char expect[96];
+
+    uint32_t before = AD9833_BusLog_Head();
+    AD9833_BusLog_Init();       // 模拟复位: 记录区不被清零
+    CHECK(AD9833_BusLog.boot_head == before && AD9833_BusLog.resets == 1U, "boot_head %u resets %u",
+          (unsigned)AD9833_BusLog.boot_head, (unsigned)AD9833_BusLog.resets);
+    CHECK(AD9833_BusLog_Read(before - 2U, &e) && e.word == 0x1234U, "record lost across reset");
+
+    AD9833_CALL(AD9833_PhaseSet, CS1, 1, 90.0);
+    AD9833_BusLog_Dump(&uart);
+
+    snprintf(expect, sizeof(expect), "# ad9833_buslog,%u,%lu,%lu,%lu,1\r\nseq,time,mask,word\r\n",
+             (unsigned)AD9833_BUSLOG_FORMAT, (unsigned long)SystemCoreClock, (unsigned long)(before + 1U), (unsigned long)before);
+    CHECK(strncmp(buf, expect, strlen(expect)) == 0, "header: %.60s", buf);
+
+    uint32_t rows = 0;
+    for (const char* p = buf; *p; p++)
+    {
+        if (*p == '\n') rows++;
+    }
+    // 表头2行 + 复位标记 + 回绕后的 DEPTH 条中去掉未写完的一条
+    CHECK(rows == 2U + 1U + AD9833_BUSLOG_DEPTH - 1U, "%u lines", (unsigned)rows);
+
+    snprintf(expect, sizeof(expect), "\r\n# boot\r\n%lu,", (unsigned long)before);
+    CHECK(strstr(buf, expect) != NULL, "boot marker not before seq %u", (unsigned)before);
+    snprintf(expect, sizeof(expect), ",0x01,0x%04X\r\n", (unsigned)(0xE000U | 1024U));
+    CHECK(strstr(buf, expect) != NULL && buf[uart.len - 1U] == '\n', "last PHASE1 row missing");
+}
+
+int main(void)
+{
+    Mock_Bus bus = {0};
+
+#if defined(AD9833_HOST_HAL)
+    bus.sclk = (Mock_Pin){ hspi2.sck_port, hspi2.sck_pin };
+    bus.sdata = (Mock_Pin){ hspi2.mosi_port, hspi2.mosi_pin };
+    s_cfg.hspi = &hspi2;
+#else
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+#endif
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_Reset();
+#if defined(AD9833_HOST_HAL)
+    MX_SPI2_Init();
+#endif
+
+    Test_Record();
+    Test_Wrap();
+    Test_Atomic();
+    Test_Reset();
+    Test_WideMask();
+
+    printf("[%s] buslog %s (%u failures)\n", BUSLOG_TRANSPORT, s_fail ? "FAILED" : "PASSED", (unsigned)s_fail);
+    return s_fail ? 1 : 0;
+}
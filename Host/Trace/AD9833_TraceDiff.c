@@ -0,0 +1,408 @@
+/**
+******************************************************************************
+  * @file           : AD9833_TraceDiff.c
+  * @brief          : 比较两份 AD9833_Trace 记录, 按场景报告数据字的变化
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-15
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 用法: ad9833_trace_diff [-e] [-t] <基准记录> <新记录>
+  *
+  * 按场景名配对，以 (mask, word) 序列的最长公共子序列求出增加和删除的
+  * 数据字，每个场景一行：基准字数、新字数、差值、增加数、删除数和结论：
+  * - same: 序列完全相同 (时间戳不参与比较)
+  * - equivalent: 序列不同，但把两份序列分别写入行为模型 (AD9833_Model)
+  *   后，各片的控制、频率和相位寄存器最终相同，例如去掉了多余的写入
+  * - CHANGED: 最终寄存器不同，同时给出第一处不同和各片的差异
+  * - MISSING / NEW: 场景只出现在基准或新记录中
+  * - INCOMPLETE: 记录中有丢弃 (# dropped)
+  *
+  * 默认只有全部为 same 时返回0；加 -e 时 equivalent 也算通过，用于确认
+  * 性能优化只减少了写入而没有改变输出。加 -t 时同时列出每个场景从第一个
+  * 字到最后一个字的时间跨度 (周期)。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Model.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 芯片掩码的位数
+#define DIFF_CHIP_MAX               32U
+
+// 连续列出的编辑操作条数上限
+#define DIFF_EDIT_SHOW              8U
+
+/**
+ * @brief   一条记录
+ */
+typedef struct
+{
+    uint32_t time;
+    uint32_t mask;
+    uint16_t word;
+} Diff_Entry;
+
+/**
+ * @brief   一个场景的记录
+ */
+typedef struct
+{
+    char name[64];
+    Diff_Entry* entry;
+    uint32_t count;
+    uint32_t cap;
+    uint32_t dropped;
+} Diff_Scenario;
+
+/**
+ * @brief   一份记录文件
+ */
+typedef struct
+{
+    Diff_Scenario* scn;
+    uint32_t count;
+} Diff_File;
+
+/**
+ * @brief       读取记录文件
+ * @param       path: 文件名
+ * @param       file: 输出
+ * @retval      0: 成功; -1: 无法打开或格式错误
+ */
+static int Diff_Load(const char* path, Diff_File* file)
+{
+    FILE* fp = fopen(path, "r");
+    char line[256];
+    uint32_t lineno = 0;
+    Diff_Scenario* cur = NULL;
+
+    memset(file, 0, sizeof(*file));
+    if (!fp)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), fp))
+    {
+        unsigned long time, mask, word, dropped;
+
+        lineno++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0') continue;
+
+        if (strncmp(line, "# ad9833_trace,", 15) == 0)
+        {
+            if (strtoul(line + 15, NULL, 10) != 1UL)
+            {
+                fprintf(stderr, "%s:%u: unsupported format version\n", path, (unsigned)lineno);
+                fclose(fp);
+                return -1;
+            }
+            continue;
+        }
+        if (sscanf(line, "# dropped,%lu", &dropped) == 1)
+        {
+            if (cur) cur->dropped += (uint32_t)dropped;
+            continue;
+        }
+        if (line[0] == '#') continue;
+
+        if (line[0] == '@')
+        {
+            file->scn = realloc(file->scn, (file->count + 1U) * sizeof(Diff_Scenario));
+            cur = &file->scn[file->count++];
+            memset(cur, 0, sizeof(*cur));
+            snprintf(cur->name, sizeof(cur->name), "%s", line + ((line[1] == ' ') ? 2 : 1));
+            continue;
+        }
+
+        if (!cur || sscanf(line, "%lu,%lx,%lx", &time, &mask, &word) != 3)
+        {
+            fprintf(stderr, "%s:%u: bad line '%s'\n", path, (unsigned)lineno, line);
+            fclose(fp);
+            return -1;
+        }
+        if (cur->count == cur->cap)
+        {
+            cur->cap = cur->cap ? 2U * cur->cap : 64U;
+            cur->entry = realloc(cur->entry, cur->cap * sizeof(Diff_Entry));
+        }
+        cur->entry[cur->count++] = (Diff_Entry){ (uint32_t)time, (uint32_t)mask, (uint16_t)word };
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+/**
+ * @brief       释放记录文件
+ * @param       file: 记录
+ * @retval      无
+ */
+static void Diff_Free(Diff_File* file)
+{
+    for (uint32_t i = 0; i < file->count; i++) free(file->scn[i].entry);
+    free(file->scn);
+    memset(file, 0, sizeof(*file));
+}
+
+/**
+ * @brief       按名称查找场景
+ * @param       file: 记录
+ * @param       name: 场景名
+ * @retval      场景, 没有时为 NULL
+ */
+static const Diff_Scenario* Diff_Find(const Diff_File* file, const char* name)
+{
+    for (uint32_t i = 0; i < file->count; i++)
+    {
+        if (strcmp(file->scn[i].name, name) == 0) return &file->scn[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief       两条记录的 (mask, word) 是否相同
+ * @param       a: 记录
+ * @param       b: 记录
+ * @retval      1: 相同; 0: 不同
+ */
+static int Diff_Same(const Diff_Entry* a, const Diff_Entry* b)
+{
+    return a->mask == b->mask && a->word == b->word;
+}
+
+/**
+ * @brief       数据字的寄存器名称
+ * @param       word: 数据字
+ * @retval      名称
+ */
+static const char* Diff_RegName(uint16_t word)
+{
+    switch (word & 0xC000U)
+    {
+        case 0x0000U: return "CTRL";
+        case 0x4000U: return "FREQ0";
+        case 0x8000U: return "FREQ1";
+        default:      return (word & 0x2000U) ? "PHASE1" : "PHASE0";
+    }
+}
+
+/**
+ * @brief       按最长公共子序列求增加和删除的字数, 并列出前几条编辑操作
+ * @param       a: 基准
+ * @param       b: 新记录
+ * @param       ins: 输出增加的字数
+ * @param       del: 输出删除的字数
+ * @param       show: 非0时打印编辑操作
+ * @retval      无
+ */
+static void Diff_Lcs(const Diff_Scenario* a, const Diff_Scenario* b, uint32_t* ins, uint32_t* del, int show)
+{
+    uint32_t n = a->count, m = b->count;
+    uint32_t* dp = calloc((size_t)(n + 1U) * (m + 1U), sizeof(uint32_t));
+    uint32_t shown = 0;
+
+#define DP(i, j) dp[(size_t)(i) * (m + 1U) + (j)]
+    for (uint32_t i = n; i-- > 0;)
+    {
+        for (uint32_t j = m; j-- > 0;)
+        {
+            DP(i, j) = Diff_Same(&a->entry[i], &b->entry[j]) ? DP(i + 1U, j + 1U) + 1U
+                     : (DP(i + 1U, j) > DP(i, j + 1U) ? DP(i + 1U, j) : DP(i, j + 1U));
+        }
+    }
+
+    *ins = m - DP(0, 0);
+    *del = n - DP(0, 0);
+
+    // 沿动态规划表回溯, 列出前 DIFF_EDIT_SHOW 条编辑
+    for (uint32_t i = 0, j = 0; show && (i < n || j < m) && shown < DIFF_EDIT_SHOW;)
+    {
+        if (i < n && j < m && Diff_Same(&a->entry[i], &b->entry[j]))
+        {
+            i++;
+            j++;
+        }
+        else if (j < m && (i == n || DP(i, j + 1U) >= DP(i + 1U, j)))
+        {
+            printf("      + [%u] mask 0x%08X word 0x%04X (%s)\n", (unsigned)j, (unsigned)b->entry[j].mask,
+                   (unsigned)b->entry[j].word, Diff_RegName(b->entry[j].word));
+            j++;
+            shown++;
+        }
+        else
+        {
+            printf("      - [%u] mask 0x%08X word 0x%04X (%s)\n", (unsigned)i, (unsigned)a->entry[i].mask,
+                   (unsigned)a->entry[i].word, Diff_RegName(a->entry[i].word));
+            i++;
+            shown++;
+        }
+    }
+#undef DP
+    free(dp);
+}
+
+/**
+ * @brief       将一个场景写入各片模型
+ * @param       scn: 场景
+ * @param       chip: DIFF_CHIP_MAX 片模型
+ * @retval      涉及的芯片掩码
+ */
+static uint32_t Diff_Replay(const Diff_Scenario* scn, AD9833_Model chip[])
+{
+    uint32_t used = 0;
+
+    for (uint32_t n = 0; n < DIFF_CHIP_MAX; n++) AD9833_Model_Init(&chip[n]);
+    for (uint32_t i = 0; i < scn->count; i++)
+    {
+        used |= scn->entry[i].mask;
+        for (uint32_t m = scn->entry[i].mask; m; m &= m - 1U)
+        {
+            AD9833_Model_Word(&chip[__builtin_ctz(m)], scn->entry[i].word);
+        }
+    }
+    return used;
+}
+
+/**
+ * @brief       比较两份序列写入后的最终寄存器
+ * @param       a: 基准
+ * @param       b: 新记录
+ * @param       show: 非0时打印不同的寄存器
+ * @retval      1: 相同; 0: 不同
+ */
+static int Diff_StateEqual(const Diff_Scenario* a, const Diff_Scenario* b, int show)
+{
+    static AD9833_Model ca[DIFF_CHIP_MAX], cb[DIFF_CHIP_MAX];
+    uint32_t used = Diff_Replay(a, ca) | Diff_Replay(b, cb);
+    int equal = 1;
+
+    for (uint32_t m = used; m; m &= m - 1U)
+    {
+        uint32_t n = (uint32_t)__builtin_ctz(m);
+        const AD9833_Model* x = &ca[n];
+        const AD9833_Model* y = &cb[n];
+
+        if (x->ctrl == y->ctrl && x->freq[0] == y->freq[0] && x->freq[1] == y->freq[1] &&
+            x->phase[0] == y->phase[0] && x->phase[1] == y->phase[1])
+        {
+            continue;
+        }
+        equal = 0;
+        if (show)
+        {
+            printf("      chip %u: ctrl 0x%04X/0x%04X freq0 %u/%u freq1 %u/%u phase0 %u/%u phase1 %u/%u\n",
+                   (unsigned)n, x->ctrl, y->ctrl, (unsigned)x->freq[0], (unsigned)y->freq[0],
+                   (unsigned)x->freq[1], (unsigned)y->freq[1], x->phase[0], y->phase[0], x->phase[1], y->phase[1]);
+        }
+    }
+    return equal;
+}
+
+/**
+ * @brief       场景第一个字到最后一个字的时间跨度
+ * @param       scn: 场景
+ * @retval      周期数
+ */
+static uint32_t Diff_Span(const Diff_Scenario* scn)
+{
+    return scn->count ? scn->entry[scn->count - 1U].time - scn->entry[0].time : 0U;
+}
+
+int main(int argc, char* argv[])
+{
+    Diff_File golden, fresh;
+    int allow_equivalent = 0, timing = 0, argi = 1;
+    uint32_t fail = 0, total_a = 0, total_b = 0;
+
+    for (; argi < argc && argv[argi][0] == '-'; argi++)
+    {
+        if (strcmp(argv[argi], "-e") == 0) allow_equivalent = 1;
+        else if (strcmp(argv[argi], "-t") == 0) timing = 1;
+        else break;
+    }
+    if (argc - argi != 2)
+    {
+        fprintf(stderr, "usage: %s [-e] [-t] golden.trace new.trace\n", argv[0]);
+        return 2;
+    }
+    if (Diff_Load(argv[argi], &golden) || Diff_Load(argv[argi + 1], &fresh)) return 2;
+
+    printf("%-22s %7s %7s %6s %5s %5s  %s\n", "scenario", "golden", "new", "delta", "+", "-", "result");
+
+    for (uint32_t i = 0; i < golden.count; i++)
+    {
+        const Diff_Scenario* a = &golden.scn[i];
+        const Diff_Scenario* b = Diff_Find(&fresh, a->name);
+        uint32_t ins = 0, del = 0;
+        const char* result;
+
+        total_a += a->count;
+        if (!b)
+        {
+            printf("%-22s %7u %7s %6s %5s %5s  MISSING\n", a->name, (unsigned)a->count, "-", "-", "-", "-");
+            fail++;
+            continue;
+        }
+        total_b += b->count;
+
+        Diff_Lcs(a, b, &ins, &del, 0);
+        if (a->dropped || b->dropped)
+        {
+            result = "INCOMPLETE";
+            fail++;
+        }
+        else if (ins == 0 && del == 0)
+        {
+            result = "same";
+        }
+        else if (Diff_StateEqual(a, b, 0))
+        {
+            result = "equivalent";
+            if (!allow_equivalent) fail++;
+        }
+        else
+        {
+            result = "CHANGED";
+            fail++;
+        }
+
+        printf("%-22s %7u %7u %+6d %5u %5u  %s", a->name, (unsigned)a->count, (unsigned)b->count,
+               (int)b->count - (int)a->count, (unsigned)ins, (unsigned)del, result);
+        if (timing)
+        {
+            printf("  (span %u -> %u cycles)", (unsigned)Diff_Span(a), (unsigned)Diff_Span(b));
+        }
+        printf("\n");
+
+        if (ins || del)
+        {
+            Diff_Lcs(a, b, &ins, &del, 1);
+            Diff_StateEqual(a, b, 1);
+        }
+    }
+
+    for (uint32_t i = 0; i < fresh.count; i++)
+    {
+        if (Diff_Find(&golden, fresh.scn[i].name)) continue;
+        printf("%-22s %7s %7u %6s %5s %5s  NEW\n", fresh.scn[i].name, "-", (unsigned)fresh.scn[i].count,
+               "-", "-", "-");
+        total_b += fresh.scn[i].count;
+        fail++;
+    }
+
+    printf("total: %u -> %u words (%+d), %u scenario(s) not passing\n",
+           (unsigned)total_a, (unsigned)total_b, (int)total_b - (int)total_a, (unsigned)fail);
+
+    Diff_Free(&golden);
+    Diff_Free(&fresh);
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,242 @@
+/**
+******************************************************************************
+  * @file           : AD9833_TraceRecord.c
+  * @brief          : 在模拟层上逐个场景记录驱动发出的数据字
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-15
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 驱动以 AD9833_TRACE_ENABLE 编译 (AD9833_HOST_SOFT / AD9833_HOST_HAL 各一份)，
+  * 每个场景先用 AD9833_Cmd() 恢复到相同的初始状态 (不记录)，再开始记录并
+  * 执行场景中的调用，按 AD9833_Trace 的文本格式依次输出。时间戳为模拟层
+  * DWT->CYCCNT 的周期数。
+  *
+  * 输出写到 -o 指定的文件，缺省写标准输出。驱动有意改变写入序列时，用
+  * 本程序的输出替换 Host/Trace/Golden 下的基准记录，并在提交说明中写明
+  * ad9833_trace_diff 报告的变化。
+  *
+  ******************************************************************************
+  */
+
+#include "Mock_HAL.h"
+#include "AD9833_Trace.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(AD9833_HOST_HAL)
+#include "AD9833_HAL.h"
+#include "spi.h"
+#define AD9833_CALL(fn, ...)        fn(&hspi2, __VA_ARGS__)
+#else
+#include "AD9833_Soft.h"
+#define AD9833_CALL(fn, ...)        fn(__VA_ARGS__)
+#endif
+
+/**
+ * @brief   记录场景: 名称与执行函数
+ */
+typedef struct
+{
+    const char* name;
+    void (*run)(void);
+} Trace_Scenario;
+
+static AD9833_InitTypedef s_cfg = {
+    .status = CS1_CS2_DOUBLE,
+    .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+    .AD_CS2 = { SINE_WAVE, 1000.0, 90.0, 0, 0 },
+};
+
+static const int16_t s_comp_offset[4] = { 0, 120, 360, 900 };
+static const AD9833_CompTable s_comp = { s_comp_offset, 4, 22 };
+
+static void Scn_Init(void)          { AD9833_CALL(AD9833_Init, CS1_CS2_DOUBLE); }
+static void Scn_Cmd(void)           { AD9833_Cmd(&s_cfg); }
+static void Scn_CmdSync(void)       { AD9833_Cmd_Sync(&s_cfg); }
+static void Scn_FreqCs1(void)       { AD9833_CALL(AD9833_FreqSet, CS1, 0, 12345.6); }
+static void Scn_FreqBoth(void)      { AD9833_CALL(AD9833_FreqSet, CS_BOTH, 1, 250000.0); }
+static void Scn_PhaseBoth(void)     { AD9833_CALL(AD9833_PhaseSet, CS_BOTH, 1, 123.4); }
+
+/**
+ * @brief       两片控制字不同, 分组启动
+ * @retval      无
+ */
+static void Scn_CmdSyncN(void)
+{
+    DDS_InitTypedef cfg[AD9833_CHIP_NUM] = {
+        { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+        { SQUARE_WAVE, 2000.0, 45.0, 1, 1 },
+    };
+    AD9833_CALL(AD9833_Cmd_SyncN, cfg, CS_ALL);
+}
+
+/**
+ * @brief       两片主时钟不同, 频率字分别写入
+ * @retval      无
+ */
+static void Scn_FreqSplitMclk(void)
+{
+    AD9833_SetMclk(CS2, AD9833_MCLK_NOMINAL + 1250.0);
+    AD9833_CALL(AD9833_FreqSet, CS_BOTH, 0, 1000000.0);
+    AD9833_SetMclk(CS2, AD9833_MCLK_NOMINAL);
+}
+
+/**
+ * @brief       CS2 有相位补偿表, 改频后重写相位
+ * @retval      无
+ */
+static void Scn_FreqComp(void)
+{
+    AD9833_CALL(AD9833_SetCompTable, CS2, &s_comp);
+    AD9833_CALL(AD9833_FreqSet, CS_BOTH, 0, 3000000.0);
+    AD9833_CALL(AD9833_PhaseSet, CS_BOTH, 0, 30.0);
+    AD9833_CALL(AD9833_SetCompTable, CS2, NULL);
+}
+
+/**
+ * @brief       寄存器选择、复位与睡眠
+ * @retval      无
+ */
+static void Scn_Ctrl(void)
+{
+    AD9833_CALL(AD9833_SelectFreqReg, CS_BOTH, 1);
+    AD9833_CALL(AD9833_SelectPhaseReg, CS1, 1);
+    AD9833_CALL(AD9833_Reset, CS1, 1);
+    AD9833_CALL(AD9833_Reset, CS1, 0);
+    AD9833_CALL(AD9833_Sleep, CS2, 1, 1);
+    AD9833_CALL(AD9833_Sleep, CS2, 0, 0);
+}
+
+/**
+ * @brief       依次切换三种波形
+ * @retval      无
+ */
+static void Scn_Wave(void)
+{
+    AD9833_CALL(AD9833_SetWaveformAndStart, CS1, TRIANGLE_WAVE);
+    AD9833_CALL(AD9833_SetWaveformAndStart, CS_BOTH, SQUARE_WAVE);
+    AD9833_CALL(AD9833_SetWaveformAndStart, CS2, SINE_WAVE);
+}
+
+/**
+ * @brief       16步扫频
+ * @retval      无
+ */
+static void Scn_Sweep(void)
+{
+    for (uint32_t k = 0; k < 16U; k++)
+    {
+        AD9833_CALL(AD9833_FreqSet, CS_BOTH, 0, 1000.0 + 500.0 * k);
+    }
+}
+
+/**
+ * @brief       乒乓跳频4次
+ * @retval      无
+ */
+static void Scn_HopPingPong(void)
+{
+    uint8_t active = 0;
+
+    for (uint32_t k = 0; k < 4U; k++)
+    {
+        active ^= 1U;
+        AD9833_CALL(AD9833_FreqSet, CS_BOTH, active, (k & 1U) ? 2000.0 : 5000.0);
+        AD9833_CALL(AD9833_SelectFreqReg, CS_BOTH, active);
+    }
+}
+
+#if !defined(AD9833_HOST_HAL)
+/**
+ * @brief       预置跳频: 一次锁存, 一次放弃 (放弃的字不记录)
+ * @retval      无
+ */
+static void Scn_HopStaged(void)
+{
+    AD9833_FreqSet(CS_BOTH, 1, 7000.0);
+    AD9833_StageSelect(CS_BOTH, 1, 0);
+    AD9833_StageLatch();
+    AD9833_StageRelease();
+
+    AD9833_StageSelect(CS_BOTH, 0, 0);
+    AD9833_StageRelease();
+}
+#endif
+
+static const Trace_Scenario s_scenario[] = {
+    { "init",               Scn_Init },
+    { "cmd",                Scn_Cmd },
+    { "cmd_sync",           Scn_CmdSync },
+    { "cmd_sync_n_groups",  Scn_CmdSyncN },
+    { "freq_set_cs1",       Scn_FreqCs1 },
+    { "freq_set_both",      Scn_FreqBoth },
+    { "freq_set_split_mclk", Scn_FreqSplitMclk },
+    { "freq_set_comp",      Scn_FreqComp },
+    { "phase_set_both",     Scn_PhaseBoth },
+    { "ctrl_bits",          Scn_Ctrl },
+    { "wave_start",         Scn_Wave },
+    { "sweep_16",           Scn_Sweep },
+    { "hop_pingpong",       Scn_HopPingPong },
+#if !defined(AD9833_HOST_HAL)
+    { "hop_staged",         Scn_HopStaged },
+#endif
+};
+
+int main(int argc, char* argv[])
+{
+    static char buf[1U << 18];
+    UART_HandleTypeDef uart = { buf, sizeof(buf), 0 };
+    const char* out = NULL;
+    Mock_Bus bus = {0};
+
+    if (argc == 3 && strcmp(argv[1], "-o") == 0) out = argv[2];
+    else if (argc != 1)
+    {
+        fprintf(stderr, "usage: %s [-o out.trace]\n", argv[0]);
+        return 2;
+    }
+
+#if defined(AD9833_HOST_HAL)
+    bus.sclk = (Mock_Pin){ hspi2.sck_port, hspi2.sck_pin };
+    bus.sdata = (Mock_Pin){ hspi2.mosi_port, hspi2.mosi_pin };
+    s_cfg.hspi = &hspi2;
+#else
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+#endif
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_Reset();
+#if defined(AD9833_HOST_HAL)
+    MX_SPI2_Init();
+#endif
+    // 模拟层的 CYCCNT 始终由虚拟时间换算, 不响应清零; 预先使能, 使第一个场景的起点不被清零打乱
+    Mock_DWT.CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    for (uint32_t i = 0; i < sizeof(s_scenario) / sizeof(s_scenario[0]); i++)
+    {
+        AD9833_Cmd(&s_cfg);
+
+        AD9833_Trace_Start();
+        s_scenario[i].run();
+        AD9833_Trace_Stop();
+
+        AD9833_Trace_Dump(&uart, s_scenario[i].name);
+    }
+
+    FILE* fp = out ? fopen(out, "w") : stdout;
+    if (!fp)
+    {
+        fprintf(stderr, "cannot write %s\n", out);
+        return 2;
+    }
+    fwrite(buf, 1, uart.len, fp);
+    if (out) fclose(fp);
+
+    return (uart.len + 1U < sizeof(buf)) ? 0 : 1;
+}
@@ -0,0 +1,369 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Vcd.c
+  * @brief          : 模拟总线与芯片状态导出为 VCD 波形文件
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 只在值变化时写出；同一时刻的变化写在同一个时间戳下。一个引脚事件先
+  * 写出引脚，再交给模型解码，最后写出解码后有变化的芯片状态，因此
+  * strobe 和寄存器的变化与第16个 SCLK 下降沿 (或 FSYNC 上升沿) 在同一时刻。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Vcd.h"
+#include <string.h>
+
+/**
+ * @brief   信号编号: 总线信号在前, 之后每片 AD9833_VCD_CHIP_SIGS 个
+ */
+enum
+{
+    VCD_SCLK = 0,
+    VCD_SDATA,
+    VCD_SCENARIO,
+    VCD_CHIP_BASE
+};
+
+enum
+{
+    VCD_FSYNC = 0,
+    VCD_WORD,
+    VCD_STROBE,
+    VCD_CTRL,
+    VCD_FSELECT,
+    VCD_PSELECT,
+    VCD_FREQ0,
+    VCD_FREQ1,
+    VCD_PHASE0,
+    VCD_PHASE1,
+    VCD_FREQ_HZ
+};
+
+/**
+ * @brief   每片信号的名称与位宽 (位宽0为 real)
+ */
+static const struct
+{
+    const char* name;
+    uint8_t width;
+} s_chip_sig[AD9833_VCD_CHIP_SIGS] = {
+    { "fsync",   1 },
+    { "word",    16 },
+    { "strobe",  1 },
+    { "ctrl",    16 },
+    { "fselect", 1 },
+    { "pselect", 1 },
+    { "freq0",   28 },
+    { "freq1",   28 },
+    { "phase0",  12 },
+    { "phase1",  12 },
+    { "freq_hz", 0 },
+};
+
+static AD9833_Vcd* s_attached = NULL;
+
+/**
+ * @brief       信号编号转换为 VCD 标识符 ('!' 到 '~' 的94进制)
+ * @param       sig: 信号编号
+ * @param       id: 输出, 至少4字节
+ * @retval      无
+ */
+static void AD9833_Vcd_Id(uint32_t sig, char* id)
+{
+    uint32_t n = 0;
+
+    do
+    {
+        id[n++] = (char)('!' + sig % 94U);
+        sig /= 94U;
+    } while (sig && n < 3U);
+    id[n] = '\0';
+}
+
+/**
+ * @brief       第 chip 片的信号编号
+ */
+static uint32_t AD9833_Vcd_Sig(uint8_t chip, uint32_t offset)
+{
+    return VCD_CHIP_BASE + chip * AD9833_VCD_CHIP_SIGS + offset;
+}
+
+/**
+ * @brief       推进到时刻 t, 上一时刻置位的 strobe 回到0
+ * @param       vcd: 导出状态
+ * @param       t: 时刻 (纳秒), 早于当前时刻时不写时间戳
+ * @retval      无
+ */
+static void AD9833_Vcd_Time(AD9833_Vcd* vcd, uint64_t t)
+{
+    char id[4];
+
+    if (t <= vcd->time) return;
+
+    fprintf(vcd->fp, "#%llu\n", (unsigned long long)t);
+    vcd->time = t;
+
+    for (uint8_t i = 0; vcd->strobe; i++)
+    {
+        if (!(vcd->strobe & (1UL << i))) continue;
+        AD9833_Vcd_Id(AD9833_Vcd_Sig(i, VCD_STROBE), id);
+        fprintf(vcd->fp, "0%s\n", id);
+        vcd->value[AD9833_Vcd_Sig(i, VCD_STROBE)] = 0;
+        vcd->strobe &= ~(1UL << i);
+        vcd->changes++;
+    }
+}
+
+/**
+ * @brief       写出一个整数信号 (值未变化时不写)
+ * @param       vcd: 导出状态
+ * @param       sig: 信号编号
+ * @param       width: 位宽
+ * @param       value: 值
+ * @retval      无
+ */
+static void AD9833_Vcd_Value(AD9833_Vcd* vcd, uint32_t sig, uint8_t width, uint64_t value)
+{
+    char id[4];
+
+    if (vcd->valid[sig] && vcd->value[sig] == value) return;
+    vcd->valid[sig] = 1;
+    vcd->value[sig] = value;
+    vcd->changes++;
+
+    AD9833_Vcd_Id(sig, id);
+    if (width == 1U)
+    {
+        fprintf(vcd->fp, "%u%s\n", (unsigned)(value & 1U), id);
+        return;
+    }
+
+    char bits[65];
+    uint8_t n = 0;
+    for (int b = width - 1; b >= 0; b--)
+    {
+        if (n || ((value >> b) & 1U) || b == 0) bits[n++] = ((value >> b) & 1U) ? '1' : '0';
+    }
+    bits[n] = '\0';
+    fprintf(vcd->fp, "b%s %s\n", bits, id);
+}
+
+/**
+ * @brief       写出第 i 片解码后的状态
+ * @param       vcd: 导出状态
+ * @param       i: 芯片编号
+ * @retval      无
+ */
+static void AD9833_Vcd_Chip(AD9833_Vcd* vcd, uint8_t i)
+{
+    const AD9833_Model* m = &vcd->chip[i];
+    uint8_t fsel = (m->ctrl & AD9833_MODEL_FSELECT) ? 1U : 0U;
+    double hz = m->freq[fsel] * vcd->mclk / 268435456.0;
+
+    AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_CTRL), 16, m->ctrl);
+    AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_FSELECT), 1, fsel);
+    AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_PSELECT), 1, (m->ctrl & AD9833_MODEL_PSELECT) ? 1U : 0U);
+    AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_FREQ0), 28, m->freq[0]);
+    AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_FREQ1), 28, m->freq[1]);
+    AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_PHASE0), 12, m->phase[0]);
+    AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_PHASE1), 12, m->phase[1]);
+
+    uint32_t sig = AD9833_Vcd_Sig(i, VCD_FREQ_HZ);
+    if (!vcd->valid[sig] || vcd->freq_hz[i] != hz)
+    {
+        char id[4];
+
+        vcd->valid[sig] = 1;
+        vcd->freq_hz[i] = hz;
+        vcd->changes++;
+        AD9833_Vcd_Id(sig, id);
+        fprintf(vcd->fp, "r%.17g %s\n", hz, id);
+    }
+}
+
+/**
+ * @brief       模型的数据字回调: 写出数据字并置位 strobe
+ */
+static void AD9833_Vcd_Word(AD9833_Model* model, uint64_t time_ns, uint16_t word, void* ctx)
+{
+    AD9833_Vcd* vcd = (AD9833_Vcd*)ctx;
+    uint8_t i = (uint8_t)(model - vcd->chip);
+
+    AD9833_Vcd_Time(vcd, time_ns);
+    AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_WORD), 16, word);
+    vcd->valid[AD9833_Vcd_Sig(i, VCD_STROBE)] = 0;     // 连续两个时刻都有数据字时也写出
+    AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_STROBE), 1, 1);
+    vcd->strobe |= 1UL << i;
+}
+
+/**
+ * @brief       写出文件头和初始值
+ * @note        引脚初始电平取模拟层的当前电平, 芯片为上电状态
+ * @param       vcd: 导出状态
+ * @param       fp: 输出文件 (由调用者关闭)
+ * @param       bus: 总线引脚
+ * @param       chips: 导出的芯片数 (不超过 AD9833_VCD_CHIP_MAX 和片选数)
+ * @param       mclk: 主时钟 (Hz)
+ * @param       title: 写入文件头注释, 可为 NULL
+ * @retval      0: 成功; -1: 参数无效
+ */
+int AD9833_Vcd_Open(AD9833_Vcd* vcd, FILE* fp, const Mock_Bus* bus, uint8_t chips, double mclk, const char* title)
+{
+    char id[4];
+
+    if (!fp || !chips || chips > AD9833_VCD_CHIP_MAX || chips > bus->cs_num) return -1;
+
+    memset(vcd, 0, sizeof(*vcd));
+    vcd->fp = fp;
+    vcd->mclk = mclk;
+    for (uint8_t i = 0; i < chips; i++)
+    {
+        AD9833_Model_Init(&vcd->chip[i]);
+        vcd->chip[i].word_hook = AD9833_Vcd_Word;
+        vcd->chip[i].word_ctx = vcd;
+    }
+    AD9833_ModelBus_Init(&vcd->mb, vcd->chip, chips, bus);
+
+    if (title) fprintf(fp, "$comment %s $end\n", title);
+    fprintf(fp, "$version ad9833_vcd 1 $end\n$timescale 1ns $end\n");
+    fprintf(fp, "$scope module bus $end\n");
+    AD9833_Vcd_Id(VCD_SCLK, id);
+    fprintf(fp, "$var wire 1 %s sclk $end\n", id);
+    AD9833_Vcd_Id(VCD_SDATA, id);
+    fprintf(fp, "$var wire 1 %s sdata $end\n", id);
+    AD9833_Vcd_Id(VCD_SCENARIO, id);
+    fprintf(fp, "$var string 1 %s scenario $end\n", id);
+    fprintf(fp, "$upscope $end\n");
+
+    for (uint8_t i = 0; i < chips; i++)
+    {
+        fprintf(fp, "$scope module chip%u $end\n", (unsigned)(i + 1U));
+        for (uint32_t k = 0; k < AD9833_VCD_CHIP_SIGS; k++)
+        {
+            AD9833_Vcd_Id(AD9833_Vcd_Sig(i, k), id);
+            if (s_chip_sig[k].width == 0)
+                fprintf(fp, "$var real 64 %s %s $end\n", id, s_chip_sig[k].name);
+            else if (s_chip_sig[k].width == 1)
+                fprintf(fp, "$var wire 1 %s %s $end\n", id, s_chip_sig[k].name);
+            else
+                fprintf(fp, "$var wire %u %s %s [%u:0] $end\n", (unsigned)s_chip_sig[k].width, id,
+                        s_chip_sig[k].name, (unsigned)(s_chip_sig[k].width - 1U));
+        }
+        fprintf(fp, "$upscope $end\n");
+    }
+    fprintf(fp, "$enddefinitions $end\n");
+
+    vcd->time = Mock_Now();
+    fprintf(fp, "#%llu\n$dumpvars\n", (unsigned long long)vcd->time);
+    AD9833_Vcd_Value(vcd, VCD_SCLK, 1, vcd->mb.sclk);
+    AD9833_Vcd_Value(vcd, VCD_SDATA, 1, vcd->mb.sdata);
+    AD9833_Vcd_Id(VCD_SCENARIO, id);
+    fprintf(fp, "sidle %s\n", id);
+    for (uint8_t i = 0; i < chips; i++)
+    {
+        AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_FSYNC), 1, (vcd->mb.fsync >> i) & 1U);
+        AD9833_Vcd_Id(AD9833_Vcd_Sig(i, VCD_WORD), id);
+        fprintf(fp, "bx %s\n", id);
+        AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_STROBE), 1, 0);
+        AD9833_Vcd_Chip(vcd, i);
+    }
+    fprintf(fp, "$end\n");
+    return 0;
+}
+
+/**
+ * @brief       模拟层的引脚变化回调
+ */
+static void AD9833_Vcd_Hook(const Mock_Event* ev, void* ctx)
+{
+    AD9833_Vcd_Edge((AD9833_Vcd*)ctx, ev);
+}
+
+/**
+ * @brief       挂到模拟层上实时导出, 与 AD9833_ModelBus_Attach() 共用同一个回调
+ * @param       vcd: 导出状态
+ * @retval      无
+ */
+void AD9833_Vcd_Attach(AD9833_Vcd* vcd)
+{
+    s_attached = vcd;
+    Mock_SetEdgeHook(AD9833_Vcd_Hook, vcd);
+}
+
+/**
+ * @brief       取消实时导出
+ * @retval      无
+ */
+void AD9833_Vcd_Detach(void)
+{
+    s_attached = NULL;
+    Mock_SetEdgeHook(NULL, NULL);
+}
+
+/**
+ * @brief       处理一个引脚事件
+ * @param       vcd: 导出状态
+ * @param       ev: 事件, 非引脚事件和总线以外的引脚忽略
+ * @retval      无
+ */
+void AD9833_Vcd_Edge(AD9833_Vcd* vcd, const Mock_Event* ev)
+{
+    const Mock_Bus* bus = &vcd->mb.bus;
+    uint8_t level = ev->level ? 1U : 0U;
+    uint32_t cs = 0;
+
+    if (ev->type != MOCK_EVENT_PIN) return;
+
+    uint8_t sclk = (ev->port == bus->sclk.port && (ev->pin & bus->sclk.pin)) ? 1U : 0U;
+    uint8_t sdata = (ev->port == bus->sdata.port && (ev->pin & bus->sdata.pin)) ? 1U : 0U;
+    for (uint8_t i = 0; i < vcd->mb.num; i++)
+    {
+        if (ev->port == bus->cs[i].port && (ev->pin & bus->cs[i].pin)) cs |= 1UL << i;
+    }
+    if (!sclk && !sdata && !cs) return;
+
+    AD9833_Vcd_Time(vcd, ev->time_ns);
+    if (sclk) AD9833_Vcd_Value(vcd, VCD_SCLK, 1, level);
+    if (sdata) AD9833_Vcd_Value(vcd, VCD_SDATA, 1, level);
+    for (uint8_t i = 0; i < vcd->mb.num; i++)
+    {
+        if (cs & (1UL << i)) AD9833_Vcd_Value(vcd, AD9833_Vcd_Sig(i, VCD_FSYNC), 1, level);
+    }
+
+    AD9833_ModelBus_Edge(&vcd->mb, ev);
+    for (uint8_t i = 0; i < vcd->mb.num; i++) AD9833_Vcd_Chip(vcd, i);
+}
+
+/**
+ * @brief       在当前虚拟时刻标记场景
+ * @param       vcd: 导出状态
+ * @param       name: 场景名 (不含空白)
+ * @retval      无
+ */
+void AD9833_Vcd_Scenario(AD9833_Vcd* vcd, const char* name)
+{
+    char id[4];
+
+    AD9833_Vcd_Time(vcd, Mock_Now());
+    AD9833_Vcd_Id(VCD_SCENARIO, id);
+    fprintf(vcd->fp, "s%s %s\n", name, id);
+    vcd->changes++;
+}
+
+/**
+ * @brief       写出结束时刻 (当前虚拟时刻) 并刷新输出, 实时导出时同时取消回调
+ * @param       vcd: 导出状态
+ * @retval      无
+ */
+void AD9833_Vcd_Close(AD9833_Vcd* vcd)
+{
+    if (s_attached == vcd) AD9833_Vcd_Detach();
+    AD9833_Vcd_Time(vcd, Mock_Now() > vcd->time ? Mock_Now() : vcd->time + 1U);
+    fflush(vcd->fp);
+}
@@ -0,0 +1,83 @@
+/**
+******************************************************************************
+  * @file           : AD9833_Vcd.h
+  * @brief          : 模拟总线与芯片状态导出为 VCD 波形文件
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 挂到 Mock_HAL 的引脚变化回调上，把登记总线上的每个边沿写成 Value Change
+  * Dump (IEEE 1364)，同时用 AD9833 行为模型实时解码，导出每片芯片的状态。
+  * 时间单位为 1ns，可直接用 GTKWave 打开。信号：
+  *
+  *     bus.sclk, bus.sdata     总线时钟和数据
+  *     bus.scenario            场景名 (GTKWave 的字符串扩展)
+  *     chipN.fsync             第N片的片选
+  *     chipN.word[15:0]        最近解码到的数据字
+  *     chipN.strobe            数据字完成时为1, 到下一个时刻回到0
+  *     chipN.ctrl[15:0]        控制寄存器
+  *     chipN.fselect, chipN.pselect   当前使用的频率/相位寄存器
+  *     chipN.freq0/freq1[27:0], chipN.phase0/phase1[11:0]   寄存器组
+  *     chipN.freq_hz           当前输出频率 (real, 由 mclk 换算)
+  *
+  * 模型从上电状态开始，应在驱动初始化之前开始导出。
+  *
+  * 使用方法：
+  * 1. 登记总线 (Mock_SetBus) 并复位模拟层后调用 `AD9833_Vcd_Open()`。
+  * 2. 调用 `AD9833_Vcd_Attach()` 开始实时导出，或把记录的事件逐个交给
+  *    `AD9833_Vcd_Edge()`。
+  * 3. 需要时调用 `AD9833_Vcd_Scenario()` 标记场景。
+  * 4. 结束时调用 `AD9833_Vcd_Close()`。
+  *
+  ******************************************************************************
+  */
+
+#ifndef _AD9833_VCD_H
+#define _AD9833_VCD_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "AD9833_Model.h"
+
+// 导出的芯片数上限
+#define AD9833_VCD_CHIP_MAX         4U
+
+// 每片的信号数和总信号数
+#define AD9833_VCD_CHIP_SIGS        11U
+#define AD9833_VCD_SIG_NUM          (3U + AD9833_VCD_CHIP_MAX * AD9833_VCD_CHIP_SIGS)
+
+/**
+ * @brief   导出状态
+ *      @arg fp: 输出文件
+ *      @arg mclk: 主时钟 (Hz), 用于 freq_hz
+ *      @arg mb/chip: 总线模型和各片模型
+ *      @arg changes: 已写出的值变化数
+ *      其余为写出状态
+ */
+typedef struct
+{
+    FILE* fp;
+    double mclk;
+    AD9833_ModelBus mb;
+    AD9833_Model chip[AD9833_VCD_CHIP_MAX];
+    uint32_t changes;
+
+    uint64_t time;
+    uint32_t strobe;
+    uint8_t valid[AD9833_VCD_SIG_NUM];
+    uint64_t value[AD9833_VCD_SIG_NUM];
+    double freq_hz[AD9833_VCD_CHIP_MAX];
+} AD9833_Vcd;
+
+/* 函数声明 */
+int AD9833_Vcd_Open(AD9833_Vcd* vcd, FILE* fp, const Mock_Bus* bus, uint8_t chips, double mclk, const char* title);
+void AD9833_Vcd_Attach(AD9833_Vcd* vcd);
+void AD9833_Vcd_Detach(void);
+void AD9833_Vcd_Edge(AD9833_Vcd* vcd, const Mock_Event* ev);
+void AD9833_Vcd_Scenario(AD9833_Vcd* vcd, const char* name);
+void AD9833_Vcd_Close(AD9833_Vcd* vcd);
+
+#endif /* _AD9833_VCD_H */
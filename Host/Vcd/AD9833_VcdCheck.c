@@ -0,0 +1,343 @@
+/**
+******************************************************************************
+  * @file           : AD9833_VcdCheck.c
+  * @brief          : 读回 VCD 文件, 重新解码引脚并与文件中的芯片状态核对
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 只用文件中的 bus.sclk / bus.sdata / chipN.fsync 三类引脚信号驱动一组新的
+  * 行为模型，检查：
+  * - 每片解码出的数据字序列与文件中 strobe 为1时的 chipN.word 一致；
+  * - 结束时的 ctrl、freq0/1、phase0/1 与文件中的最后值一致。
+  * 同时输出每片的数据字数、最短 SCLK 周期、相邻数据字的最小/最大间隔和
+  * 时序违反数，用于比较两个传输方式的文件。
+  *
+  * 用法: ad9833_vcd_check <文件.vcd> [...]，任一文件不一致时返回1。
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Model.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_CHIP_MAX              4U
+#define CHECK_WORD_MAX              4096U
+#define CHECK_ID_MAX                64U
+
+/**
+ * @brief   信号类别
+ */
+enum
+{
+    SIG_OTHER = 0,
+    SIG_SCLK,
+    SIG_SDATA,
+    SIG_FSYNC,
+    SIG_WORD,
+    SIG_STROBE,
+    SIG_CTRL,
+    SIG_FREQ0,
+    SIG_FREQ1,
+    SIG_PHASE0,
+    SIG_PHASE1
+};
+
+/**
+ * @brief   文件中的一个信号
+ */
+typedef struct
+{
+    char id[8];
+    uint8_t kind;
+    uint8_t chip;
+    uint64_t value;
+} Check_Sig;
+
+/**
+ * @brief   一片的核对状态
+ */
+typedef struct
+{
+    uint16_t file_word[CHECK_WORD_MAX];
+    uint32_t file_num;
+    uint16_t model_word[CHECK_WORD_MAX];
+    uint32_t model_num;
+    uint64_t last_strobe;
+    uint64_t gap_min;
+    uint64_t gap_max;
+} Check_Chip;
+
+static Check_Sig s_sig[CHECK_ID_MAX];
+static uint32_t s_sig_num = 0;
+static Check_Chip s_chip[CHECK_CHIP_MAX];
+static AD9833_Model s_model[CHECK_CHIP_MAX];
+
+/**
+ * @brief       模型的数据字回调: 记下解码出的数据字
+ */
+static void Check_Word(AD9833_Model* model, uint64_t time_ns, uint16_t word, void* ctx)
+{
+    Check_Chip* c = (Check_Chip*)ctx;
+
+    (void)model;
+    (void)time_ns;
+    if (c->model_num < CHECK_WORD_MAX) c->model_word[c->model_num] = word;
+    c->model_num++;
+}
+
+/**
+ * @brief       按名称登记一个信号
+ * @param       scope: 所在的 scope
+ * @param       id: 标识符
+ * @param       name: 信号名
+ * @retval      无
+ */
+static void Check_Var(const char* scope, const char* id, const char* name)
+{
+    static const struct { const char* name; uint8_t kind; } chip_sig[] = {
+        { "fsync", SIG_FSYNC }, { "word", SIG_WORD }, { "strobe", SIG_STROBE }, { "ctrl", SIG_CTRL },
+        { "freq0", SIG_FREQ0 }, { "freq1", SIG_FREQ1 }, { "phase0", SIG_PHASE0 }, { "phase1", SIG_PHASE1 },
+    };
+    Check_Sig* s;
+    unsigned chip = 0;
+
+    if (s_sig_num >= CHECK_ID_MAX) return;
+    s = &s_sig[s_sig_num++];
+    memset(s, 0, sizeof(*s));
+    snprintf(s->id, sizeof(s->id), "%s", id);
+
+    if (strcmp(scope, "bus") == 0)
+    {
+        if (strcmp(name, "sclk") == 0) s->kind = SIG_SCLK;
+        else if (strcmp(name, "sdata") == 0) s->kind = SIG_SDATA;
+    }
+    else if (sscanf(scope, "chip%u", &chip) == 1 && chip >= 1U && chip <= CHECK_CHIP_MAX)
+    {
+        s->chip = (uint8_t)(chip - 1U);
+        for (uint32_t k = 0; k < sizeof(chip_sig) / sizeof(chip_sig[0]); k++)
+        {
+            if (strcmp(name, chip_sig[k].name) == 0) s->kind = chip_sig[k].kind;
+        }
+    }
+}
+
+/**
+ * @brief       按标识符查找信号
+ */
+static Check_Sig* Check_Find(const char* id)
+{
+    for (uint32_t i = 0; i < s_sig_num; i++)
+    {
+        if (strcmp(s_sig[i].id, id) == 0) return &s_sig[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief       处理一个值变化
+ * @param       mb: 总线模型
+ * @param       time: 当前时刻
+ * @param       id: 标识符
+ * @param       value: 新值 (x 视为0)
+ * @retval      无
+ */
+static void Check_Change(AD9833_ModelBus* mb, uint64_t time, const char* id, uint64_t value)
+{
+    Check_Sig* s = Check_Find(id);
+    Mock_Event ev = { time, MOCK_EVENT_PIN, 0, (uint8_t)(value & 1U), 0, 0 };
+
+    if (!s) return;
+    s->value = value;
+
+    switch (s->kind)
+    {
+    case SIG_SCLK:  ev.pin = mb->bus.sclk.pin;  AD9833_ModelBus_Edge(mb, &ev); break;
+    case SIG_SDATA: ev.pin = mb->bus.sdata.pin; AD9833_ModelBus_Edge(mb, &ev); break;
+    case SIG_FSYNC: ev.pin = mb->bus.cs[s->chip].pin; AD9833_ModelBus_Edge(mb, &ev); break;
+    case SIG_STROBE:
+        if (value & 1U)
+        {
+            Check_Chip* c = &s_chip[s->chip];
+            Check_Sig* w = NULL;
+
+            for (uint32_t i = 0; i < s_sig_num; i++)
+            {
+                if (s_sig[i].kind == SIG_WORD && s_sig[i].chip == s->chip) w = &s_sig[i];
+            }
+            if (c->file_num < CHECK_WORD_MAX && w) c->file_word[c->file_num] = (uint16_t)w->value;
+            if (c->file_num)
+            {
+                uint64_t gap = time - c->last_strobe;
+                if (gap < c->gap_min) c->gap_min = gap;
+                if (gap > c->gap_max) c->gap_max = gap;
+            }
+            c->last_strobe = time;
+            c->file_num++;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief       文件中某片某类信号的最后值
+ */
+static uint64_t Check_Last(uint8_t chip, uint8_t kind)
+{
+    for (uint32_t i = 0; i < s_sig_num; i++)
+    {
+        if (s_sig[i].kind == kind && s_sig[i].chip == chip) return s_sig[i].value;
+    }
+    return 0;
+}
+
+/**
+ * @brief       读取并核对一个文件
+ * @param       path: 文件
+ * @retval      不一致的项数, 文件无法读取时为1
+ */
+static uint32_t Check_File(const char* path)
+{
+    FILE* fp = fopen(path, "r");
+    char line[256], scope[32] = "";
+    uint64_t time = 0;
+    uint32_t chips = 0, fail = 0;
+    AD9833_ModelBus mb;
+    Mock_Bus bus = {0};
+
+    if (!fp)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    s_sig_num = 0;
+    memset(s_chip, 0, sizeof(s_chip));
+
+    // 文件头
+    while (fgets(line, sizeof(line), fp))
+    {
+        char type[16], id[8], name[32];
+        unsigned width;
+
+        if (sscanf(line, "$scope module %31s", scope) == 1) continue;
+        if (sscanf(line, "$var %15s %u %7s %31s", type, &width, id, name) == 4)
+        {
+            Check_Var(scope, id, name);
+            if (strcmp(name, "fsync") == 0) chips++;
+            continue;
+        }
+        if (strncmp(line, "$enddefinitions", 15) == 0) break;
+    }
+    if (chips == 0 || chips > CHECK_CHIP_MAX)
+    {
+        fprintf(stderr, "%s: no chip scopes\n", path);
+        fclose(fp);
+        return 1;
+    }
+
+    // 引脚编号只在本程序内使用
+    bus.sclk = (Mock_Pin){ 0, 1U };
+    bus.sdata = (Mock_Pin){ 0, 2U };
+    for (uint32_t i = 0; i < chips; i++) bus.cs[i] = (Mock_Pin){ 0, 4UL << i };
+    bus.cs_num = (uint8_t)chips;
+    for (uint32_t i = 0; i < chips; i++)
+    {
+        AD9833_Model_Init(&s_model[i]);
+        s_model[i].word_hook = Check_Word;
+        s_model[i].word_ctx = &s_chip[i];
+        s_chip[i].gap_min = UINT64_MAX;
+    }
+    AD9833_ModelBus_Init(&mb, s_model, (uint8_t)chips, &bus);
+    mb.sclk = 1;
+    mb.sdata = 0;
+    mb.fsync = (1UL << chips) - 1U;
+    for (uint32_t i = 0; i < chips; i++)
+    {
+        s_model[i].fsync = 1;
+        s_model[i].sclk = 1;
+        s_model[i].sdata = 0;
+    }
+
+    // 值变化
+    while (fgets(line, sizeof(line), fp))
+    {
+        char* p = line;
+        char id[8];
+
+        line[strcspn(line, "\r\n")] = '\0';
+        if (*p == '#') time = strtoull(p + 1, NULL, 10);
+        else if (*p == '0' || *p == '1' || *p == 'x' || *p == 'z')
+        {
+            Check_Change(&mb, time, p + 1, (*p == '1') ? 1U : 0U);
+        }
+        else if (*p == 'b' && sscanf(p, "b%*s %7s", id) == 1)
+        {
+            uint64_t v = 0;
+            for (p++; *p == '0' || *p == '1' || *p == 'x' || *p == 'z'; p++) v = (v << 1) | (*p == '1');
+            Check_Change(&mb, time, id, v);
+        }
+    }
+    fclose(fp);
+
+    for (uint32_t i = 0; i < chips; i++)
+    {
+        Check_Chip* c = &s_chip[i];
+        AD9833_Model* m = &s_model[i];
+        uint32_t bad = 0;
+
+        if (c->file_num != c->model_num)
+        {
+            fprintf(stderr, "  %s chip%u: %u strobes, %u words decoded from pins\n", path, (unsigned)(i + 1U),
+                    (unsigned)c->file_num, (unsigned)c->model_num);
+            bad++;
+        }
+        for (uint32_t k = 0; k < c->file_num && k < c->model_num && k < CHECK_WORD_MAX; k++)
+        {
+            if (c->file_word[k] != c->model_word[k])
+            {
+                fprintf(stderr, "  %s chip%u: word %u is 0x%04X, pins give 0x%04X\n", path, (unsigned)(i + 1U),
+                        (unsigned)k, (unsigned)c->file_word[k], (unsigned)c->model_word[k]);
+                bad++;
+                break;
+            }
+        }
+        if (Check_Last((uint8_t)i, SIG_CTRL) != m->ctrl || Check_Last((uint8_t)i, SIG_FREQ0) != m->freq[0] ||
+            Check_Last((uint8_t)i, SIG_FREQ1) != m->freq[1] || Check_Last((uint8_t)i, SIG_PHASE0) != m->phase[0] ||
+            Check_Last((uint8_t)i, SIG_PHASE1) != m->phase[1])
+        {
+            fprintf(stderr, "  %s chip%u: final registers differ from the pins\n", path, (unsigned)(i + 1U));
+            bad++;
+        }
+
+        printf("%s,chip%u,words=%u,sclk_min_ns=%u,gap_min_ns=%llu,gap_max_ns=%llu,violations=%u\n", path,
+               (unsigned)(i + 1U), (unsigned)c->model_num,
+               (unsigned)(m->period_min == UINT32_MAX ? 0U : m->period_min),
+               (unsigned long long)(c->file_num > 1U ? c->gap_min : 0U),
+               (unsigned long long)(c->file_num > 1U ? c->gap_max : 0U),
+               (unsigned)AD9833_Model_Violations(m));
+        fail += bad;
+    }
+    return fail;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t fail = 0;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s file.vcd [...]\n", argv[0]);
+        return 2;
+    }
+    for (int i = 1; i < argc; i++) fail += Check_File(argv[i]);
+
+    fprintf(stderr, "vcd check %s (%u differences)\n", fail ? "FAILED" : "PASSED", (unsigned)fail);
+    return fail ? 1 : 0;
+}
@@ -0,0 +1,195 @@
+/**
+******************************************************************************
+  * @file           : AD9833_VcdExport.c
+  * @brief          : 在模拟层上运行一组场景并导出 VCD 波形
+  * @author         : 秦泽宇
+  * @version        : v1.0
+  * @date           : 2025-08-18
+  *
+  ******************************************************************************
+  * @attention
+  *
+  * 驱动按传输方式分别编译 (AD9833_HOST_SOFT / AD9833_HOST_HAL)，从上电开始
+  * 依次运行各场景，场景之间空出 VCD_GAP_NS，并在 bus.scenario 上标记场景名。
+  * 两种传输方式的文件用 GTKWave 分别打开，即可比较同一场景的总线时序。参数：
+  *   -o <文件>     输出文件 (默认标准输出)
+  *   -s <场景>     只导出该场景 (初始化仍然执行，其余场景跳过)
+  *
+  ******************************************************************************
+  */
+
+#include "AD9833_Vcd.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(AD9833_HOST_HAL)
+#include "AD9833_HAL.h"
+#include "spi.h"
+#define AD9833_CALL(fn, ...)        fn(&hspi2, __VA_ARGS__)
+#define VCD_TRANSPORT               "hal"
+#else
+#include "AD9833_Soft.h"
+#define AD9833_CALL(fn, ...)        fn(__VA_ARGS__)
+#define VCD_TRANSPORT               "soft"
+#endif
+
+// 场景之间的空闲时间 (纳秒)
+#define VCD_GAP_NS                  2000U
+
+/**
+ * @brief   导出场景: 名称与执行函数
+ */
+typedef struct
+{
+    const char* name;
+    void (*run)(void);
+} Vcd_Scenario;
+
+static AD9833_InitTypedef s_cfg = {
+    .status = CS1_CS2_DOUBLE,
+    .AD_CS1 = { SINE_WAVE, 1000.0, 0.0, 0, 0 },
+    .AD_CS2 = { SINE_WAVE, 1000.0, 90.0, 0, 0 },
+};
+
+static void Scn_CmdSync(void)       { AD9833_Cmd_Sync(&s_cfg); }
+static void Scn_FreqBoth(void)      { AD9833_CALL(AD9833_FreqSet, CS_BOTH, 1, 250000.0); }
+static void Scn_PhaseBoth(void)     { AD9833_CALL(AD9833_PhaseSet, CS_BOTH, 1, 123.4); }
+
+/**
+ * @brief       16步扫频
+ * @retval      无
+ */
+static void Scn_Sweep(void)
+{
+    for (uint32_t k = 0; k < 16U; k++)
+    {
+        AD9833_CALL(AD9833_FreqSet, CS_BOTH, 0, 1000.0 + 500.0 * k);
+    }
+}
+
+/**
+ * @brief       乒乓跳频4次
+ * @retval      无
+ */
+static void Scn_HopPingPong(void)
+{
+    uint8_t active = 0;
+
+    for (uint32_t k = 0; k < 4U; k++)
+    {
+        active ^= 1U;
+        AD9833_CALL(AD9833_FreqSet, CS_BOTH, active, (k & 1U) ? 2000.0 : 5000.0);
+        AD9833_CALL(AD9833_SelectFreqReg, CS_BOTH, active);
+    }
+}
+
+/**
+ * @brief       两片分别切换波形
+ * @retval      无
+ */
+static void Scn_Wave(void)
+{
+    AD9833_CALL(AD9833_SetWaveformAndStart, CS1, TRIANGLE_WAVE);
+    AD9833_CALL(AD9833_SetWaveformAndStart, CS2, SQUARE_WAVE);
+    AD9833_CALL(AD9833_SetWaveformAndStart, CS_BOTH, SINE_WAVE);
+}
+
+#if !defined(AD9833_HOST_HAL)
+/**
+ * @brief       预置跳频: 两片在同一个SCLK下降沿切换
+ * @retval      无
+ */
+static void Scn_HopStaged(void)
+{
+    AD9833_FreqSet(CS_BOTH, 1, 7000.0);
+    AD9833_StageSelect(CS_BOTH, 1, 0);
+    AD9833_StageLatch();
+    AD9833_StageRelease();
+}
+#endif
+
+static const Vcd_Scenario s_scenario[] = {
+    { "cmd_sync",       Scn_CmdSync },
+    { "freq_set_both",  Scn_FreqBoth },
+    { "phase_set_both", Scn_PhaseBoth },
+    { "sweep_16",       Scn_Sweep },
+    { "hop_pingpong",   Scn_HopPingPong },
+    { "wave_start",     Scn_Wave },
+#if !defined(AD9833_HOST_HAL)
+    { "hop_staged",     Scn_HopStaged },
+#endif
+};
+
+int main(int argc, char* argv[])
+{
+    const char* out = NULL;
+    const char* only = NULL;
+    Mock_Bus bus = {0};
+    AD9833_Vcd vcd;
+    uint32_t run = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) out = argv[++i];
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) only = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [-o out.vcd] [-s scenario]\n", argv[0]);
+            return 2;
+        }
+    }
+
+#if defined(AD9833_HOST_HAL)
+    bus.sclk = (Mock_Pin){ hspi2.sck_port, hspi2.sck_pin };
+    bus.sdata = (Mock_Pin){ hspi2.mosi_port, hspi2.mosi_pin };
+    s_cfg.hspi = &hspi2;
+#else
+    bus.sclk = (Mock_Pin){ Mock_STM32_Port(AD9833_SCLK_GPIO_Port), AD9833_SCLK_Pin };
+    bus.sdata = (Mock_Pin){ Mock_STM32_Port(AD9833_MOSI_GPIO_Port), AD9833_MOSI_Pin };
+#endif
+    bus.cs[0] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS1_GPIO_Port), AD9833_CS1_Pin };
+    bus.cs[1] = (Mock_Pin){ Mock_STM32_Port(AD9833_CS2_GPIO_Port), AD9833_CS2_Pin };
+    bus.cs_num = 2;
+    Mock_SetBus(&bus);
+    Mock_Reset();
+    Mock_TraceEnable(0);
+#if defined(AD9833_HOST_HAL)
+    MX_SPI2_Init();
+#endif
+
+    FILE* fp = out ? fopen(out, "w") : stdout;
+    if (!fp)
+    {
+        fprintf(stderr, "cannot write %s\n", out);
+        return 2;
+    }
+
+    AD9833_Vcd_Open(&vcd, fp, &bus, AD9833_CHIP_NUM, AD9833_MCLK_NOMINAL, "ad9833 " VCD_TRANSPORT);
+    AD9833_Vcd_Attach(&vcd);
+
+    AD9833_Vcd_Scenario(&vcd, "init");
+    AD9833_Cmd(&s_cfg);
+
+    for (uint32_t i = 0; i < sizeof(s_scenario) / sizeof(s_scenario[0]); i++)
+    {
+        if (only && strcmp(only, s_scenario[i].name) != 0) continue;
+
+        Mock_Advance(VCD_GAP_NS);
+        AD9833_Vcd_Scenario(&vcd, s_scenario[i].name);
+        s_scenario[i].run();
+        run++;
+    }
+    Mock_Advance(VCD_GAP_NS);
+    AD9833_Vcd_Close(&vcd);
+    if (out) fclose(fp);
+
+    if (only && !run)
+    {
+        fprintf(stderr, "unknown scenario %s\n", only);
+        return 2;
+    }
+    fprintf(stderr, "[%s] %u scenarios, %u value changes, %u words, %u timing violations\n", VCD_TRANSPORT,
+            (unsigned)run, (unsigned)vcd.changes, (unsigned)(vcd.chip[0].words + vcd.chip[1].words),
+            (unsigned)(AD9833_Model_Violations(&vcd.chip[0]) + AD9833_Model_Violations(&vcd.chip[1])));
+    return 0;
+}